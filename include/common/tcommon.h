@@ -254,6 +254,8 @@ typedef struct SQueryTableDataCond {
   int64_t      startVersion;
   int64_t      endVersion;
   bool         notLoadData;    // response the actual data, not only the rows in the attribute of info.row of ssdatablock
+  int32_t      numOfParallel;  // split the scan into sub readers by fileset, 0 or 1 means serial scan
+  bool         unordered;      // blocks of different sub readers can be returned in any order
 } SQueryTableDataCond;
 
 int32_t tEncodeDataBlock(void** buf, const SSDataBlock* pBlock);
@@ -359,9 +361,12 @@ typedef struct {
 typedef struct SSortExecInfo {
   int32_t sortMethod;
   int32_t sortBuffer;
-  int32_t loops;       // loop count
-  int32_t writeBytes;  // write io bytes
-  int32_t readBytes;   // read io bytes
+  int32_t loops;         // loop count
+  int32_t writeBytes;    // write io bytes
+  int32_t readBytes;     // read io bytes
+  int64_t compSrcBytes;  // spilled bytes before compression
+  int64_t compBytes;     // spilled bytes after compression
+  int64_t compUs;        // compress time
 } SSortExecInfo;
 
 typedef struct SNonSortExecInfo {
@@ -55,12 +55,14 @@ extern int32_t tsNumOfRpcThreads;
 extern int32_t tsNumOfRpcSessions;
 extern int32_t tsTimeToGetAvailableConn;
 extern int32_t tsKeepAliveIdle;
+extern int32_t tsRpcConnMaxInflight;
 extern int32_t tsNumOfCommitThreads;
 extern int32_t tsNumOfTaskQueueThreads;
 extern int32_t tsNumOfMnodeQueryThreads;
 extern int32_t tsNumOfMnodeFetchThreads;
 extern int32_t tsNumOfMnodeReadThreads;
 extern int32_t tsNumOfVnodeQueryThreads;
+extern bool    tsVnodeQueryWorkStealing;
 extern float   tsRatioOfVnodeStreamThreads;
 extern int32_t tsNumOfVnodeFetchThreads;
 extern int32_t tsNumOfVnodeRsmaThreads;
@@ -74,6 +76,9 @@ extern int64_t tsRpcQueueMemoryAllowed;
 extern int32_t tsElectInterval;
 extern int32_t tsHeartbeatInterval;
 extern int32_t tsHeartbeatTimeout;
+extern int32_t tsSyncLogReplBatchBytes;
+extern bool    tsSyncSnapReplCompress;
+extern int32_t tsSyncSnapReplMaxRate;
 
 // vnode
 extern int64_t tsVndCommitMaxIntervalMs;
@@ -129,6 +134,12 @@ extern int32_t tsCacheLazyLoadThreshold;  // cost threshold for last/last_row lo
 // query client
 extern int32_t tsQueryPolicy;
 extern int32_t tsQueryRspPolicy;
+extern int32_t tsQueryParallelScan;
+extern int32_t tsQuerySpillCompress;
+extern int32_t tsQuerySortThreads;
+extern int32_t tsQueryHashJoinBufSize;
+extern int32_t tsQueryArenaMaxSize;
+extern bool    tsQueryHllSparse;
 extern int64_t tsQueryMaxConcurrentTables;
 extern int32_t tsQuerySmaOptimize;
 extern int32_t tsQueryRsmaTolerance;
@@ -193,6 +204,11 @@ extern int32_t tmqMaxTopicNum;
 
 // wal
 extern int64_t tsWalFsyncDataSizeLimit;
+extern int32_t tsWalGroupCommitLatency;
+extern int64_t tsWalGroupCommitBytes;
+
+// memtable
+extern int32_t tsMemColumnarRows;
 
 // internal
 extern int32_t tsTransPullupInterval;
@@ -213,6 +229,9 @@ extern int64_t tsStreamBufferSize;
 extern bool    tsFilterScalarMode;
 extern int32_t tsMaxStreamBackendCache;
 extern int32_t tsPQSortMemThreshold;
+extern int32_t tsTsdbPrefetchDepth;
+extern int32_t tsTsdbIoUringDepth;
+extern bool    tsTsdbCompactDirectIO;
 extern int32_t tsResolveFQDNRetryTime;
 
 extern bool tsExperimental;
@@ -1494,6 +1494,12 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t numOfWalGroups;
+  int64_t numOfWalGroupEntries;
+  int64_t walGroupHist[TSDB_WAL_GROUP_HIST_SIZE];
+  int64_t numOfSyncReplMsgs;
+  int64_t numOfSyncReplEntries;
+  int64_t syncReplLag;
   int64_t errors;
 } SVnodesStat;
 
@@ -1518,6 +1524,12 @@ typedef struct {
   int64_t numOfBatchInsertSuccessReqs;
   int32_t numOfCachedTables;
   int32_t learnerProgress;  // use one reservered
+  int64_t numOfWalGroups;   // not serialized, only for monitor
+  int64_t numOfWalGroupEntries;
+  int64_t walGroupHist[TSDB_WAL_GROUP_HIST_SIZE];
+  int64_t numOfSyncReplMsgs;  // not serialized, only for monitor
+  int64_t numOfSyncReplEntries;
+  int64_t syncReplLag;
 } SVnodeLoad;
 
 typedef struct {
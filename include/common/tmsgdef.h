@@ -339,6 +339,8 @@
   TD_DEF_MSG_TYPE(TDMT_SYNC_PREP_SNAPSHOT_REPLY, "sync-prep-snapshot-reply", NULL, NULL)
   TD_DEF_MSG_TYPE(TDMT_SYNC_MAX_MSG, "sync-max", NULL, NULL)
   TD_DEF_MSG_TYPE(TDMT_SYNC_FORCE_FOLLOWER, "sync-force-become-follower", NULL, NULL)
+  TD_DEF_MSG_TYPE(TDMT_SYNC_SNAPSHOT_BLOCK, "sync-snapshot-block", NULL, NULL)   // payload type only
+  TD_DEF_MSG_TYPE(TDMT_SYNC_SNAPSHOT_RESUME, "sync-snapshot-resume", NULL, NULL) // payload type only
   TD_CLOSE_MSG_SEG(TDMT_END_SYNC_MSG)
 
   TD_NEW_MSG_SEG(TDMT_VND_STREAM_MSG) //7 << 8
@@ -115,6 +115,17 @@ void dsGetDataLength(DataSinkHandle handle, int64_t* pLen, bool* pQueryEnd);
  */
 int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput);
 
+/**
+ * Get data in a rpc message buffer of SRetrieveTableRsp, whose data is the one returned by dsGetDataBlock. The
+ * ownership of the buffer is passed to the caller, so it can be sent as the response without copying the data.
+ * @param handle
+ * @param len data length returned by dsGetDataLength
+ * @param pOutput output, pData points into the message
+ * @param ppMsg output, allocated by rpcMallocCont, NULL if there is no more data
+ * @return error code
+ */
+int32_t dsGetDataMsg(DataSinkHandle handle, int64_t len, SOutputData* pOutput, void** ppMsg);
+
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize);
 
 /**
@@ -175,6 +175,7 @@ typedef struct TsdReader {
 
   int32_t      (*tsdReaderRetrieveBlockSMAInfo)();
   SSDataBlock *(*tsdReaderRetrieveDataBlock)();
+  int32_t      (*tsdReaderRetrieveLateCols)(void* pReader, bool required);
 
   void         (*tsdReaderReleaseDataBlock)();
 
@@ -222,7 +222,8 @@ typedef struct tExprNode {
     } _function;
 
     struct {
-      struct SNode *pRootNode;
+      struct SNode          *pRootNode;
+      struct SScalarProgram *pProgram;  // compiled from pRootNode, NULL if it is not supported
     } _optrRoot;
   };
 } tExprNode;
@@ -147,6 +147,7 @@ typedef struct SAggLogicNode {
   bool       isGroupTb;
   bool       isPartTb;  // true if partition keys has tbname
   bool       hasGroup;
+  bool       isPartialAgg;  // the results are merged again by the parent agg node
 } SAggLogicNode;
 
 typedef struct SProjectLogicNode {
@@ -434,6 +435,7 @@ typedef struct STableScanPhysiNode {
   bool           assignBlockUid;
   int8_t         igCheckUpdate;
   bool           filesetDelimited;
+  bool           unorderedScan;  // the parent does not require ordered input, e.g. aggregation without timeline function
 } STableScanPhysiNode;
 
 typedef STableScanPhysiNode STableSeqScanPhysiNode;
@@ -519,6 +521,7 @@ typedef struct SAggPhysiNode {
   SNodeList* pAggFuncs;
   bool       mergeDataBlock;
   bool       groupKeyOptimized;
+  bool       isPartialAgg;  // a group may be output more than once, since the parent agg node merges them
 } SAggPhysiNode;
 
 typedef struct SDownstreamSourceNode {
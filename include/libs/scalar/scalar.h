@@ -23,7 +23,8 @@ extern "C" {
 #include "nodes.h"
 #include "querynodes.h"
 
-typedef struct SFilterInfo SFilterInfo;
+typedef struct SFilterInfo    SFilterInfo;
+typedef struct SScalarProgram SScalarProgram;
 
 int32_t scalarGetOperatorResultType(SOperatorNode *pOp);
 
@@ -39,6 +40,21 @@ pDst need to freed in caller
 */
 int32_t scalarCalculate(SNode *pNode, SArray *pBlockList, SScalarParam *pDst);
 
+/*
+compile the arithmetic expression of numeric columns and constants into a linear program of vector ops,
+*pProgram is NULL if the expression is not supported, and it should be calculated by scalarCalculate.
+*pProgram need to freed by scalarFreeProgram in caller
+*/
+int32_t scalarCompile(SNode *pNode, SScalarProgram **pProgram);
+
+/*
+the result is written into the double column pDst from the row of startIndex,
+pDst should have the capacity of startIndex + rows of the input block
+*/
+int32_t scalarExecProgram(SScalarProgram *pProgram, SArray *pBlockList, SColumnInfoData *pDst, int32_t startIndex,
+                          int32_t *numOfRows);
+void    scalarFreeProgram(SScalarProgram *pProgram);
+
 int32_t scalarGetOperatorParamNum(EOperatorType type);
 int32_t scalarGenerateSetFromList(void **data, void *pNode, uint32_t type);
 
@@ -39,10 +39,11 @@ extern "C" {
 
 #define SYNC_WAL_LOG_RETENTION_SIZE (8LL * 1024 * 1024 * 1024)
 
-#define SYNC_MAX_RETRY_BACKOFF         5
-#define SYNC_LOG_REPL_RETRY_WAIT_MS    100
-#define SYNC_APPEND_ENTRIES_TIMEOUT_MS 10000
-#define SYNC_HEART_TIMEOUT_MS          1000 * 15
+#define SYNC_MAX_RETRY_BACKOFF          5
+#define SYNC_LOG_REPL_RETRY_WAIT_MS     100
+#define SYNC_LOG_REPL_BATCH_MAX_ENTRIES 64
+#define SYNC_APPEND_ENTRIES_TIMEOUT_MS  10000
+#define SYNC_HEART_TIMEOUT_MS           1000 * 15
 
 #define SYNC_HEARTBEAT_SLOW_MS       1500
 #define SYNC_HEARTBEAT_REPLY_SLOW_MS 1500
@@ -262,6 +263,12 @@ typedef struct SSyncState {
   int64_t    startTimeMs;
 } SSyncState;
 
+typedef struct SSyncReplStat {
+  int64_t numOfMsgs;     // append entries msgs sent to peers
+  int64_t numOfEntries;  // raft entries carried by them
+  int64_t maxLag;        // max number of entries a peer is behind the leader, not accumulated
+} SSyncReplStat;
+
 int32_t syncInit();
 void    syncCleanUp();
 int64_t syncOpen(SSyncInfo* pSyncInfo, int32_t vnodeVersion);
@@ -270,6 +277,8 @@ void    syncStop(int64_t rid);
 void    syncPreStop(int64_t rid);
 void    syncPostStop(int64_t rid);
 int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak, int64_t* seq);
+bool    syncBeginGroupCommit(int64_t rid);
+int32_t syncEndGroupCommit(int64_t rid);
 int32_t syncCheckMember(int64_t rid);
 int32_t syncIsCatchUp(int64_t rid);
 ESyncRole syncGetRole(int64_t rid);
@@ -286,6 +295,8 @@ int32_t   syncSendTimeoutRsp(int64_t rid, int64_t seq);
 int32_t   syncForceBecomeFollower(SSyncNode* ths, const SRpcMsg* pRpcMsg);
 
 SSyncState  syncGetState(int64_t rid);
+void        syncGetReplStat(int64_t rid, SSyncReplStat* pStat);
+void        syncResetReplStat(int64_t rid, const SSyncReplStat* pStat);
 void        syncGetRetryEpSet(int64_t rid, SEpSet* pEpSet);
 const char* syncStr(ESyncState state);
 
@@ -48,6 +48,7 @@ typedef struct SRpcHandleInfo {
   int8_t  persistHandle;  // persist handle or not
   int8_t  hasEpSet;
   int32_t cliVer;
+  tmsg_t  reqType;        // msg type of the req, used by server to set up the resp msg type
 
   // app info
   void *ahandle;  // app handle set by client
@@ -122,6 +123,7 @@ typedef struct SRpcInit {
   int32_t timeToGetConn;
   int8_t  supportBatch;  // 0: no batch, 1. batch
   int32_t batchSize;
+  int32_t connMaxInflight;  // max reqs in flight on one conn, 0/1: no multiplexing
   void   *parent;
 } SRpcInit;
 
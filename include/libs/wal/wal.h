@@ -59,6 +59,12 @@ typedef struct {
   EWalType level;  // wal level
 } SWalCfg;
 
+typedef struct {
+  int64_t numOfGroups;
+  int64_t numOfEntries;
+  int64_t hist[TSDB_WAL_GROUP_HIST_SIZE];  // bucket i counts the groups of [2^i, 2^(i+1)) entries
+} SWalGroupStat;
+
 typedef struct {
   int64_t firstVer;
   int64_t verInSnapshotting;
@@ -120,7 +126,14 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
-  // reusable write head
+  // group commit, entries written in an open group share one fsync
+  int8_t        groupOpen;
+  int32_t       groupEntries;   // entries not synced yet
+  int64_t       groupFirstVer;  // first of the entries not synced yet
+  int64_t       groupBytes;
+  int64_t       groupStartUs;
+  SWalGroupStat groupStat;
+  // reusable write head, ends with a flexible array so it stays the last member
   SWalCkHead writeHead;
 } SWal;
 
@@ -179,6 +192,16 @@ int64_t walAppendLog(SWal *, int64_t index, tmsg_t msgType, SWalSyncInfo syncMet
 
 void walFsync(SWal *, bool force);
 
+// group commit, only takes effect with fsync on every write and walGroupCommitLatency > 0. A failed fsync leaves the
+// entries pending, until walEndGroup or walSyncGroup syncs them.
+bool    walBeginGroup(SWal *);
+int32_t walEndGroup(SWal *);
+int32_t walSyncGroup(SWal *);
+bool    walGroupPending(SWal *);
+int64_t walGetSyncedVer(SWal *);
+void    walGetGroupStat(SWal *, SWalGroupStat *pStat);
+void    walResetGroupStat(SWal *, const SWalGroupStat *pStat);
+
 // apis for lifecycle management
 int32_t walCommit(SWal *, int64_t ver);
 int32_t walRollback(SWal *, int64_t ver);
@@ -54,6 +54,13 @@ extern "C" {
 
 typedef struct TdFile *TdFilePtr;
 
+#define TD_FILE_IOV_MAX 16
+
+typedef struct {
+  void   *buf;
+  int64_t len;
+} TdFileIoVec;
+
 #define TD_FILE_CREATE        0x0001
 #define TD_FILE_WRITE         0x0002
 #define TD_FILE_READ          0x0004
@@ -65,6 +72,9 @@ typedef struct TdFile *TdFilePtr;
 #define TD_FILE_STREAM        0x0100  // Only support taosFprintfFile, taosGetLineFile, taosEOFFile
 #define TD_FILE_WRITE_THROUGH 0x0200
 #define TD_FILE_CLOEXEC       0x0400
+#define TD_FILE_DIRECT        0x0800  // O_DIRECT on linux, buffers, offsets and sizes must be TD_FILE_DIRECT_ALIGN aligned
+
+#define TD_FILE_DIRECT_ALIGN 4096
 
 TdFilePtr taosOpenFile(const char *path, int32_t tdFileOptions);
 TdFilePtr taosCreateFile(const char *path, int32_t tdFileOptions);
@@ -92,8 +102,37 @@ int64_t taosReadFile(TdFilePtr pFile, void *buf, int64_t count);
 int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset);
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count);
 int64_t taosPWriteFile(TdFilePtr pFile, const void *buf, int64_t count, int64_t offset);
+int64_t taosWritevFile(TdFilePtr pFile, const TdFileIoVec *iov, int32_t iovcnt);
 void    taosFprintfFile(TdFilePtr pFile, const char *format, ...);
 
+// io_uring of one thread, not thread safe. The reqs are submitted together to let the device work on them in parallel.
+// A NULL ring is returned if it is not supported (built without USE_URING, or refused by the kernel), the functions
+// below then do the same with synchronous calls.
+typedef struct TdFileRing *TdFileRingPtr;
+
+typedef struct {
+  TdFilePtr pFile;
+  void     *buf;
+  int64_t   len;
+  int64_t   offset;
+  int64_t   res;  // bytes done, less than len only at the end of file
+  int32_t   err;  // errno of the failure, a ring shared by several files reports it to the owner of the req only
+  int8_t    write;
+} TdFileIoReq;
+
+TdFileRingPtr taosCreateFileRing(int32_t depth);
+void          taosDestroyFileRing(TdFileRingPtr *ppRing);
+// the ring of the calling thread, created once with the given depth and shared by all the files it reads and writes
+TdFileRingPtr taosGetThreadFileRing(int32_t depth);
+// called by the thread before it exits
+void          taosDestroyThreadFileRing();
+// returns when all the reqs are read, together with the writes queued before
+int32_t taosPReadFileBatch(TdFileRingPtr pRing, TdFileIoReq *reqs, int32_t num);
+// the req and its buffer must be kept until taosWaitFileRing returns, its failure is then in req->err
+int32_t taosPWriteFileAsync(TdFileRingPtr pRing, TdFileIoReq *req);
+// waits for all the queued writes
+int32_t taosWaitFileRing(TdFileRingPtr pRing);
+
 int64_t taosGetLineFile(TdFilePtr pFile, char **__restrict ptrBuf);
 int64_t taosGetsFile(TdFilePtr pFile, int32_t maxSize, char *__restrict buf);
 
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_ARENA_H_
+#define _TD_UTIL_ARENA_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+
+Arena of one owner, e.g. a query task. Small allocations are carved from large chunks and rounded up to a power of
+two size class, a freed one is kept in the free list of its class for reuse, and the chunks are only released when
+the arena is destroyed. Allocations larger than ARENA_MAX_CLASS_SIZE get their own chunk, which is released on free.
+
+Every chunk is charged to the charge function before it is allocated, so that the owner can account the memory and
+refuse it beyond its quota. The arena is not thread safe.
+
+*/
+
+#define ARENA_MAX_CLASS_SIZE 4096
+#define ARENA_CHUNK_SIZE     (64 * 1024)
+
+typedef struct SArena SArena;
+
+// size > 0 is charged before a chunk is allocated, a non-zero return refuses the allocation; size < 0 is returned
+typedef int32_t (*FArenaCharge)(void *param, int64_t size);
+
+SArena *taosArenaCreate(FArenaCharge chargeFn, void *param);
+void    taosArenaDestroy(SArena *pArena);
+void   *taosArenaMalloc(SArena *pArena, int64_t size);
+void   *taosArenaCalloc(SArena *pArena, int64_t num, int64_t size);
+void   *taosArenaRealloc(SArena *pArena, void *p, int64_t size);
+void    taosArenaFree(SArena *pArena, void *p);
+int64_t taosArenaChunkSize(const SArena *pArena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_ARENA_H_*/
@@ -351,6 +351,7 @@ typedef enum ELogicConditionType {
 #define TSDB_MIN_WAL_LEVEL              1
 #define TSDB_MAX_WAL_LEVEL              2
 #define TSDB_DEFAULT_WAL_LEVEL          1
+#define TSDB_WAL_GROUP_HIST_SIZE        8  // buckets of wal group commit sizes, 1, 2-3, 4-7, ..., 128+
 #define TSDB_MIN_PRECISION              TSDB_TIME_PRECISION_MILLI
 #define TSDB_MAX_PRECISION              TSDB_TIME_PRECISION_NANO
 #define TSDB_DEFAULT_PRECISION          TSDB_TIME_PRECISION_MILLI
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_KLL_H_
+#define _TD_UTIL_KLL_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+
+KLL quantile sketch (Karnin, Lang, Liberty). Items are kept in a stack of compactors, an item of level h stands for
+2^h input values. When the buffer is full, the lowest level reaching its capacity is sorted and every other item of
+it is promoted to the next level. The capacity of a level shrinks by 2/3 per level below the top one.
+
+The sketch lives in a caller provided buffer of KLL_SIZE bytes without any pointer, so it can be copied around as
+the intermediate result of a distributed aggregation, and two sketches are merged level by level.
+
+*/
+
+#define KLL_K          200
+#define KLL_MAX_LEVELS 61
+#define KLL_CAPACITY   (3 * KLL_K + 2 * KLL_MAX_LEVELS)
+#define KLL_SIZE       (sizeof(SKll))
+
+typedef struct SKll {
+  int64_t  n;
+  double   min;
+  double   max;
+  uint32_t seed;
+  int32_t  numLevels;
+  int32_t  levels[KLL_MAX_LEVELS + 1];  // items of level h are in [levels[h], levels[h + 1]), level 0 grows downward
+  double   items[KLL_CAPACITY];
+} SKll;
+
+SKll  *tKllNewFrom(void *pBuf);
+void   tKllAdd(SKll *pKll, double v);
+void   tKllMerge(SKll *pKll, const SKll *pSrc);
+double tKllQuantile(const SKll *pKll, double q);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_KLL_H_*/
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_UTIL_LFQUEUE_H_
+#define _TD_UTIL_LFQUEUE_H_
+
+#include "os.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+
+Bounded multi-producer multi-consumer queue without lock. Each cell carries a sequence number, a producer
+(consumer) claims a position by CAS on the enqueue (dequeue) cursor and then publishes the cell by storing
+the next sequence number. Push fails when the ring is full, pop fails when the ring is empty, neither blocks.
+
+The capacity is rounded up to the power of 2.
+
+*/
+
+typedef struct STaosLfQueue STaosLfQueue;
+
+STaosLfQueue *taosLfQueueOpen(int32_t capacity);
+void          taosLfQueueClose(STaosLfQueue *queue);
+bool          taosLfQueuePush(STaosLfQueue *queue, void *data);
+bool          taosLfQueuePop(STaosLfQueue *queue, void **ppData);
+int32_t       taosLfQueueCapacity(STaosLfQueue *queue);
+int32_t       taosLfQueueSize(STaosLfQueue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_UTIL_LFQUEUE_H_*/
@@ -32,6 +32,10 @@ typedef struct SFilePage {
   char    data[];
 } SFilePage;
 
+#define BUF_PAGE_COMP_NONE  0
+#define BUF_PAGE_COMP_LZ4   1  // fast
+#define BUF_PAGE_COMP_LZ4HC 2  // dense, slower to compress, as fast to decompress
+
 typedef struct SDiskbasedBufStatis {
   int64_t flushBytes;
   int64_t loadBytes;
@@ -39,6 +43,11 @@ typedef struct SDiskbasedBufStatis {
   int32_t getPages;
   int32_t releasePages;
   int32_t flushPages;
+  int32_t compPages;     // pages passed to the compressor
+  int64_t compSrcBytes;  // page bytes before compression
+  int64_t compBytes;     // page bytes after compression
+  int64_t compUs;
+  int64_t decompUs;
 } SDiskbasedBufStatis;
 
 /**
@@ -146,10 +155,12 @@ bool isAllDataInMemBuf(const SDiskbasedBuf* pBuf);
 void setBufPageDirty(void* pPage, bool dirty);
 
 /**
- * Set the compress/ no-compress flag for paged buffer, when flushing data in disk.
+ * Set the compress algorithm for paged buffer, when flushing data in disk. Pages that do not shrink are kept raw.
  * @param pBuf
+ * @param comp BUF_PAGE_COMP_NONE, BUF_PAGE_COMP_LZ4 or BUF_PAGE_COMP_LZ4HC
+ * @return
  */
-void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
+int32_t setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, int8_t comp);
 
 /**
  * Set the pageId page buffer is not need
@@ -17,6 +17,7 @@
 #define _TD_UTIL_QUEUE_H_
 
 #include "os.h"
+#include "tlfqueue.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,10 @@ Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
 3: read/write operation APIs are multi-thread safe
+4: a qset opened by taosOpenStealQset keeps the items in lock-free rings, one ring for each reader thread.
+   Writers spread items over the rings, a reader pops its own ring (qinfo->workerId) first and steals from
+   the others when its own ring is empty. Items written into such a qset can only be read from the qset,
+   and the queue shall be empty when it is closed.
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection.
@@ -56,6 +61,11 @@ typedef enum {
   RPC_QITEM = 1,
 } EQItype;
 
+typedef enum {
+  QSET_TYPE_DEFAULT = 0,
+  QSET_TYPE_STEAL = 1,
+} EQsetType;
+
 typedef void (*FItem)(SQueueInfo *pInfo, void *pItem);
 typedef void (*FItems)(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfItems);
 
@@ -86,15 +96,22 @@ struct STaosQueue {
   int64_t       threadId;
   int64_t       memLimit;
   int64_t       itemLimit;
+  int8_t        stealing;  // items are kept in the rings of the qset
 };
 
 struct STaosQset {
-  STaosQueue   *head;
-  STaosQueue   *current;
-  TdThreadMutex mutex;
-  tsem_t        sem;
-  int32_t       numOfQueues;
-  int32_t       numOfItems;
+  STaosQueue    *head;
+  STaosQueue    *current;
+  TdThreadMutex  mutex;
+  tsem_t         sem;
+  int32_t        numOfQueues;
+  int32_t        numOfItems;
+  int8_t         type;  // EQsetType
+  int8_t         quit;
+  int32_t        numOfRings;
+  int32_t        numOfSleepers;
+  int64_t        nextRing;
+  STaosLfQueue **rings;
 };
 
 struct STaosQall {
@@ -131,6 +148,7 @@ int64_t    taosQallUnAccessedItemSize(STaosQall *qall);
 int64_t    taosQallUnAccessedMemSize(STaosQall *qall);
 
 STaosQset *taosOpenQset();
+STaosQset *taosOpenStealQset(int32_t numOfRings, int32_t capacity);
 void       taosCloseQset(STaosQset *qset);
 void       taosQsetThreadResume(STaosQset *qset);
 int32_t    taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle);
@@ -37,6 +37,7 @@ typedef struct SQWorkerPool {
   int32_t       max;  // max number of workers
   int32_t       min;  // min number of workers
   int32_t       num;  // current number of workers
+  bool          stealing;  // each worker owns a lock-free ring and steals from the others when idle
   STaosQset    *qset;
   const char   *name;
   SQueueWorker *workers;
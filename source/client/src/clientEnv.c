@@ -176,6 +176,7 @@ void *openTransporter(const char *user, const char *auth, int32_t numOfThread) {
   connLimitNum = TMAX(connLimitNum, 10);
   connLimitNum = TMIN(connLimitNum, 1000);
   rpcInit.connLimitNum = connLimitNum;
+  rpcInit.connMaxInflight = tsRpcConnMaxInflight;
   rpcInit.timeToGetConn = tsTimeToGetAvailableConn;
 
   taosVersionStrToInt(version, &(rpcInit.compatibilityVer));
@@ -51,6 +51,7 @@ int32_t tsNumOfRpcThreads = 1;
 int32_t tsNumOfRpcSessions = 30000;
 int32_t tsTimeToGetAvailableConn = 500000;
 int32_t tsKeepAliveIdle = 60;
+int32_t tsRpcConnMaxInflight = 1;  // max reqs multiplexed on one rpc conn, 1: no multiplexing
 
 int32_t tsNumOfCommitThreads = 2;
 int32_t tsNumOfTaskQueueThreads = 4;
@@ -58,6 +59,7 @@ int32_t tsNumOfMnodeQueryThreads = 4;
 int32_t tsNumOfMnodeFetchThreads = 1;
 int32_t tsNumOfMnodeReadThreads = 1;
 int32_t tsNumOfVnodeQueryThreads = 4;
+bool    tsVnodeQueryWorkStealing = false;  // vnode query workers own lock-free rings and steal from each other
 float   tsRatioOfVnodeStreamThreads = 4.0;
 int32_t tsNumOfVnodeFetchThreads = 4;
 int32_t tsNumOfVnodeRsmaThreads = 2;
@@ -67,11 +69,19 @@ int32_t tsNumOfSnodeStreamThreads = 4;
 int32_t tsNumOfSnodeWriteThreads = 1;
 int32_t tsMaxStreamBackendCache = 128;  // M
 int32_t tsPQSortMemThreshold = 16;      // M
+int32_t tsTsdbPrefetchDepth = 0;        // number of file blocks read ahead, 0 means disabled
+int32_t tsTsdbIoUringDepth = 0;         // io_uring entries of each thread doing tsdb io, 0 means synchronous io
+bool    tsTsdbCompactDirectIO = false;  // merge writes tsdb files with O_DIRECT to keep the page cache for queries
 
 // sync raft
 int32_t tsElectInterval = 25 * 1000;
 int32_t tsHeartbeatInterval = 1000;
 int32_t tsHeartbeatTimeout = 20 * 1000;
+// max bytes of the entries sent in one append entries msg, 0 to send one by one as the nodes without the batch msg
+// expect, so it is only set after all the dnodes are upgraded
+int32_t tsSyncLogReplBatchBytes = 0;
+bool    tsSyncSnapReplCompress = true;         // compress the snapshot blocks sent to a replica with lz4
+int32_t tsSyncSnapReplMaxRate = 0;             // MB/s of the snapshot sent to each replica, 0 means unlimited
 
 // mnode
 int64_t tsMndSdbWriteDelta = 200;
@@ -143,6 +153,14 @@ int32_t tmqMaxTopicNum = 20;
 // query
 int32_t tsQueryPolicy = 1;
 int32_t tsQueryRspPolicy = 0;
+int32_t tsQueryParallelScan = 0;  // number of sub readers a vnode table scan is split into by fileset, 0 means serial
+int32_t tsQuerySpillCompress = 1;  // compress the spilled pages, 0: none, 1: lz4, 2: lz4hc
+int32_t tsQuerySortThreads = 0;    // threads of the pool sorting the runs of external sorts, 0 or 1 means serial
+int32_t tsQueryHashJoinBufSize = 512;  // MB, build rows a hash join keeps in memory before spilling partitions
+int32_t tsQueryArenaMaxSize = 0;  // MB, memory of the arena of one query task, 0 means no limit
+// ship the hyperloglog partial results with few buckets set in the sparse form, which the nodes before it can not
+// merge, so it is only set after all the nodes are upgraded
+bool tsQueryHllSparse = false;
 int64_t tsQueryMaxConcurrentTables = 200;  // unit is TSDB_TABLE_NUM_UNIT
 bool    tsEnableQueryHb = true;
 bool    tsEnableScience = false;  // on taos-cli show float and doulbe with scientific notation if true
@@ -238,6 +256,13 @@ bool    tsStartUdfd = true;
 
 // wal
 int64_t tsWalFsyncDataSizeLimit = (100 * 1024 * 1024L);
+int32_t tsWalGroupCommitLatency = 0;  // max ms the first entry of a group waits for fsync, 0 means group commit off
+int64_t tsWalGroupCommitBytes = (4 * 1024 * 1024L);  // max bytes of a group before it is fsynced
+
+// memtable
+// min rows of a table in one submit to store them in column format, 0 means off. It is decided for each submit, the
+// rows of smaller submits are stored as rows, so rows written a few at a time do not benefit from it.
+int32_t tsMemColumnarRows = 0;
 
 // ttl
 bool    tsTtlChangeOnWrite = false;  // if true, ttl delete time changes on last write
@@ -522,6 +547,8 @@ static int32_t taosAddClientCfg(SConfig *pCfg) {
 
   tsKeepAliveIdle = TRANGE(tsKeepAliveIdle, 1, 72000);
   if (cfgAddInt32(pCfg, "keepAliveIdle", tsKeepAliveIdle, 1, 7200000, CFG_SCOPE_BOTH, CFG_DYN_ENT_BOTH) != 0) return -1;
+  if (cfgAddInt32(pCfg, "rpcConnMaxInflight", tsRpcConnMaxInflight, 1, 1024, CFG_SCOPE_BOTH, CFG_DYN_NONE) != 0)
+    return -1;
 
   tsNumOfTaskQueueThreads = tsNumOfCores / 2;
   tsNumOfTaskQueueThreads = TMAX(tsNumOfTaskQueueThreads, 4);
@@ -592,6 +619,19 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "queryBufferSize", tsQueryBufferSize, -1, 500000000000, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
   if (cfgAddInt32(pCfg, "queryRspPolicy", tsQueryRspPolicy, 0, 1, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
+  if (cfgAddInt32(pCfg, "queryParallelScan", tsQueryParallelScan, 0, 64, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "querySpillCompress", tsQuerySpillCompress, 0, 2, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "querySortThreads", tsQuerySortThreads, 0, 64, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "queryHashJoinBufSize", tsQueryHashJoinBufSize, 1, 1048576, CFG_SCOPE_SERVER,
+                  CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "queryArenaMaxSize", tsQueryArenaMaxSize, 0, 1048576, CFG_SCOPE_SERVER,
+                  CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddBool(pCfg, "queryHllSparse", tsQueryHllSparse, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0) return -1;
 
   tsNumOfRpcThreads = tsNumOfCores / 2;
   tsNumOfRpcThreads = TRANGE(tsNumOfRpcThreads, 2, TSDB_MAX_RPC_THREADS);
@@ -621,6 +661,9 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
       0)
     return -1;
 
+  if (cfgAddBool(pCfg, "vnodeQueryWorkStealing", tsVnodeQueryWorkStealing, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
+
   if (cfgAddFloat(pCfg, "ratioOfVnodeStreamThreads", tsRatioOfVnodeStreamThreads, 0.01, 100, CFG_SCOPE_SERVER,
                   CFG_DYN_NONE) != 0)
     return -1;
@@ -673,6 +716,14 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt32(pCfg, "syncHeartbeatTimeout", tsHeartbeatTimeout, 10, 1000 * 60 * 24 * 2, CFG_SCOPE_SERVER,
                   CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "syncLogReplBatchBytes", tsSyncLogReplBatchBytes, 0, 16 * 1024 * 1024, CFG_SCOPE_SERVER,
+                  CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddBool(pCfg, "syncSnapReplCompress", tsSyncSnapReplCompress, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "syncSnapReplMaxRate", tsSyncSnapReplMaxRate, 0, 64 * 1024, CFG_SCOPE_SERVER,
+                  CFG_DYN_ENT_SERVER) != 0)
+    return -1;
 
   if (cfgAddInt64(pCfg, "mndSdbWriteDelta", tsMndSdbWriteDelta, 20, 10000, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
     return -1;
@@ -739,6 +790,14 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
   if (cfgAddInt64(pCfg, "walFsyncDataSizeLimit", tsWalFsyncDataSizeLimit, 100 * 1024 * 1024, INT64_MAX,
                   CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "walGroupCommitLatency", tsWalGroupCommitLatency, 0, 100, CFG_SCOPE_SERVER,
+                  CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt64(pCfg, "walGroupCommitBytes", tsWalGroupCommitBytes, 4 * 1024, 1024 * 1024 * 1024, CFG_SCOPE_SERVER,
+                  CFG_DYN_ENT_SERVER) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "memColumnarRows", tsMemColumnarRows, 0, 1000000, CFG_SCOPE_SERVER, CFG_DYN_ENT_SERVER) != 0)
+    return -1;
 
   if (cfgAddBool(pCfg, "udf", tsStartUdfd, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddString(pCfg, "udfdResFuncs", tsUdfdResFuncs, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
@@ -771,6 +830,11 @@ static int32_t taosAddServerCfg(SConfig *pCfg) {
     return -1;
   if (cfgAddInt32(pCfg, "pqSortMemThreshold", tsPQSortMemThreshold, 1, 10240, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
+  if (cfgAddInt32(pCfg, "tsdbPrefetchDepth", tsTsdbPrefetchDepth, 0, 64, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddInt32(pCfg, "tsdbIoUringDepth", tsTsdbIoUringDepth, 0, 1024, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
+    return -1;
+  if (cfgAddBool(pCfg, "tsdbCompactDirectIO", tsTsdbCompactDirectIO, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0) return -1;
   if (cfgAddInt32(pCfg, "resolveFQDNRetryTime", tsResolveFQDNRetryTime, 1, 10240, CFG_SCOPE_SERVER, CFG_DYN_NONE) != 0)
     return -1;
 
@@ -1086,6 +1150,7 @@ static int32_t taosSetClientCfg(SConfig *pCfg) {
   tsTimeToGetAvailableConn = cfgGetItem(pCfg, "timeToGetAvailableConn")->i32;
 
   tsKeepAliveIdle = cfgGetItem(pCfg, "keepAliveIdle")->i32;
+  tsRpcConnMaxInflight = cfgGetItem(pCfg, "rpcConnMaxInflight")->i32;
 
   tsExperimental = cfgGetItem(pCfg, "experimental")->bval;
   return 0;
@@ -1129,6 +1194,7 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsNumOfCommitThreads = cfgGetItem(pCfg, "numOfCommitThreads")->i32;
   tsNumOfMnodeReadThreads = cfgGetItem(pCfg, "numOfMnodeReadThreads")->i32;
   tsNumOfVnodeQueryThreads = cfgGetItem(pCfg, "numOfVnodeQueryThreads")->i32;
+  tsVnodeQueryWorkStealing = cfgGetItem(pCfg, "vnodeQueryWorkStealing")->bval;
   tsRatioOfVnodeStreamThreads = cfgGetItem(pCfg, "ratioOfVnodeStreamThreads")->fval;
   tsNumOfVnodeFetchThreads = cfgGetItem(pCfg, "numOfVnodeFetchThreads")->i32;
   tsNumOfVnodeRsmaThreads = cfgGetItem(pCfg, "numOfVnodeRsmaThreads")->i32;
@@ -1148,6 +1214,12 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsMonitorMaxLogs = cfgGetItem(pCfg, "monitorMaxLogs")->i32;
   tsMonitorComp = cfgGetItem(pCfg, "monitorComp")->bval;
   tsQueryRspPolicy = cfgGetItem(pCfg, "queryRspPolicy")->i32;
+  tsQueryParallelScan = cfgGetItem(pCfg, "queryParallelScan")->i32;
+  tsQuerySpillCompress = cfgGetItem(pCfg, "querySpillCompress")->i32;
+  tsQuerySortThreads = cfgGetItem(pCfg, "querySortThreads")->i32;
+  tsQueryHashJoinBufSize = cfgGetItem(pCfg, "queryHashJoinBufSize")->i32;
+  tsQueryArenaMaxSize = cfgGetItem(pCfg, "queryArenaMaxSize")->i32;
+  tsQueryHllSparse = cfgGetItem(pCfg, "queryHllSparse")->bval;
 
   tsEnableAudit = cfgGetItem(pCfg, "audit")->bval;
   tsEnableAuditCreateTable = cfgGetItem(pCfg, "auditCreateTable")->bval;
@@ -1178,10 +1250,16 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsTimeSeriesThreshold = cfgGetItem(pCfg, "timeseriesThreshold")->i32;
 
   tsWalFsyncDataSizeLimit = cfgGetItem(pCfg, "walFsyncDataSizeLimit")->i64;
+  tsWalGroupCommitLatency = cfgGetItem(pCfg, "walGroupCommitLatency")->i32;
+  tsWalGroupCommitBytes = cfgGetItem(pCfg, "walGroupCommitBytes")->i64;
+  tsMemColumnarRows = cfgGetItem(pCfg, "memColumnarRows")->i32;
 
   tsElectInterval = cfgGetItem(pCfg, "syncElectInterval")->i32;
   tsHeartbeatInterval = cfgGetItem(pCfg, "syncHeartbeatInterval")->i32;
   tsHeartbeatTimeout = cfgGetItem(pCfg, "syncHeartbeatTimeout")->i32;
+  tsSyncLogReplBatchBytes = cfgGetItem(pCfg, "syncLogReplBatchBytes")->i32;
+  tsSyncSnapReplCompress = cfgGetItem(pCfg, "syncSnapReplCompress")->bval;
+  tsSyncSnapReplMaxRate = cfgGetItem(pCfg, "syncSnapReplMaxRate")->i32;
 
   tsMndSdbWriteDelta = cfgGetItem(pCfg, "mndSdbWriteDelta")->i64;
   tsMndLogRetention = cfgGetItem(pCfg, "mndLogRetention")->i64;
@@ -1214,6 +1292,9 @@ static int32_t taosSetServerCfg(SConfig *pCfg) {
   tsFilterScalarMode = cfgGetItem(pCfg, "filterScalarMode")->bval;
   tsMaxStreamBackendCache = cfgGetItem(pCfg, "maxStreamBackendCache")->i32;
   tsPQSortMemThreshold = cfgGetItem(pCfg, "pqSortMemThreshold")->i32;
+  tsTsdbPrefetchDepth = cfgGetItem(pCfg, "tsdbPrefetchDepth")->i32;
+  tsTsdbIoUringDepth = cfgGetItem(pCfg, "tsdbIoUringDepth")->i32;
+  tsTsdbCompactDirectIO = cfgGetItem(pCfg, "tsdbCompactDirectIO")->bval;
   tsResolveFQDNRetryTime = cfgGetItem(pCfg, "resolveFQDNRetryTime")->i32;
   tsMinDiskFreeSize = cfgGetItem(pCfg, "minDiskFreeSize")->i64;
 
@@ -1480,7 +1561,13 @@ static int32_t taosCfgDynamicOptionsForServer(SConfig *pCfg, char *name) {
         {"maxStreamBackendCache", &tsMaxStreamBackendCache},
         {"mqRebalanceInterval", &tsMqRebalanceInterval},
         {"numOfLogLines", &tsNumOfLogLines},
+        {"queryArenaMaxSize", &tsQueryArenaMaxSize},
+        {"queryHashJoinBufSize", &tsQueryHashJoinBufSize},
+        {"queryHllSparse", &tsQueryHllSparse},
+        {"queryParallelScan", &tsQueryParallelScan},
         {"queryRspPolicy", &tsQueryRspPolicy},
+        {"querySortThreads", &tsQuerySortThreads},
+        {"querySpillCompress", &tsQuerySpillCompress},
         {"timeseriesThreshold", &tsTimeSeriesThreshold},
         {"tmqMaxTopicNum", &tmqMaxTopicNum},
         {"transPullupInterval", &tsTransPullupInterval},
@@ -1494,6 +1581,12 @@ static int32_t taosCfgDynamicOptionsForServer(SConfig *pCfg, char *name) {
         {"s3PageCacheSize", &tsS3PageCacheSize},
         {"s3UploadDelaySec", &tsS3UploadDelaySec},
         {"supportVnodes", &tsNumOfSupportVnodes},
+        {"syncLogReplBatchBytes", &tsSyncLogReplBatchBytes},
+        {"syncSnapReplCompress", &tsSyncSnapReplCompress},
+        {"syncSnapReplMaxRate", &tsSyncSnapReplMaxRate},
+        {"walGroupCommitLatency", &tsWalGroupCommitLatency},
+        {"walGroupCommitBytes", &tsWalGroupCommitBytes},
+        {"memColumnarRows", &tsMemColumnarRows},
         {"experimental", &tsExperimental}
     };
 
@@ -80,6 +80,12 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   int64_t numOfInsertSuccessReqs = 0;
   int64_t numOfBatchInsertReqs = 0;
   int64_t numOfBatchInsertSuccessReqs = 0;
+  int64_t numOfWalGroups = 0;
+  int64_t numOfWalGroupEntries = 0;
+  int64_t walGroupHist[TSDB_WAL_GROUP_HIST_SIZE] = {0};
+  int64_t numOfSyncReplMsgs = 0;
+  int64_t numOfSyncReplEntries = 0;
+  int64_t syncReplLag = 0;
 
   for (int32_t i = 0; i < taosArrayGetSize(pVloads); ++i) {
     SVnodeLoad *pLoad = taosArrayGet(pVloads, i);
@@ -88,6 +94,14 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
     numOfInsertSuccessReqs += pLoad->numOfInsertSuccessReqs;
     numOfBatchInsertReqs += pLoad->numOfBatchInsertReqs;
     numOfBatchInsertSuccessReqs += pLoad->numOfBatchInsertSuccessReqs;
+    numOfWalGroups += pLoad->numOfWalGroups;
+    numOfWalGroupEntries += pLoad->numOfWalGroupEntries;
+    for (int32_t j = 0; j < TSDB_WAL_GROUP_HIST_SIZE; ++j) {
+      walGroupHist[j] += pLoad->walGroupHist[j];
+    }
+    numOfSyncReplMsgs += pLoad->numOfSyncReplMsgs;
+    numOfSyncReplEntries += pLoad->numOfSyncReplEntries;
+    syncReplLag = TMAX(syncReplLag, pLoad->syncReplLag);
     if (pLoad->syncState == TAOS_SYNC_STATE_LEADER) masterNum++;
     totalVnodes++;
   }
@@ -99,6 +113,12 @@ void vmGetMonitorInfo(SVnodeMgmt *pMgmt, SMonVmInfo *pInfo) {
   pInfo->vstat.numOfInsertSuccessReqs = numOfInsertSuccessReqs;            // delta
   pInfo->vstat.numOfBatchInsertReqs = numOfBatchInsertReqs;                // delta
   pInfo->vstat.numOfBatchInsertSuccessReqs = numOfBatchInsertSuccessReqs;  // delta
+  pInfo->vstat.numOfWalGroups = numOfWalGroups;                            // delta
+  pInfo->vstat.numOfWalGroupEntries = numOfWalGroupEntries;                // delta
+  memcpy(pInfo->vstat.walGroupHist, walGroupHist, sizeof(walGroupHist));  // delta
+  pInfo->vstat.numOfSyncReplMsgs = numOfSyncReplMsgs;                      // delta
+  pInfo->vstat.numOfSyncReplEntries = numOfSyncReplEntries;                // delta
+  pInfo->vstat.syncReplLag = syncReplLag;
   pMgmt->state.totalVnodes = totalVnodes;
   pMgmt->state.masterNum = masterNum;
   pMgmt->state.numOfSelectReqs = numOfSelectReqs;
@@ -156,6 +176,7 @@ static void vmGenerateVnodeCfg(SCreateVnodeReq *pCreate, SVnodeCfg *pCfg) {
   pCfg->hashPrefix = pCreate->hashPrefix;
   pCfg->hashSuffix = pCreate->hashSuffix;
   pCfg->tsdbPageSize = pCreate->tsdbPageSize * 1024;
+  pCfg->tsdbPrefetchDepth = tsTsdbPrefetchDepth;
 
   pCfg->standby = 0;
   pCfg->syncCfg.replicaNum = 0;
@@ -394,6 +394,7 @@ int32_t vmStartWorker(SVnodeMgmt *pMgmt) {
   pQPool->name = "vnode-query";
   pQPool->min = tsNumOfVnodeQueryThreads;
   pQPool->max = tsNumOfVnodeQueryThreads;
+  pQPool->stealing = tsVnodeQueryWorkStealing;
   if (tQWorkerInit(pQPool) != 0) return -1;
 
   SAutoQWorkerPool *pStreamPool = &pMgmt->streamPool;
@@ -373,6 +373,9 @@ typedef struct {
   int    flush_count;
 } SCacheFlushState;
 
+#define TSDB_CACHE_SHARD_BITS 4
+#define TSDB_CACHE_LOCK_NUM   (1 << TSDB_CACHE_SHARD_BITS)
+
 struct STsdb {
   char                *path;
   SVnode              *pVnode;
@@ -384,7 +387,7 @@ struct STsdb {
   STsdbFS              fs;  // old
   SLRUCache           *lruCache;
   SCacheFlushState     flushState;
-  TdThreadMutex        lruMutex;
+  TdThreadMutex        lruMutex[TSDB_CACHE_LOCK_NUM];  // striped by uid, serializes loads and updates of a table
   SLRUCache           *biCache;
   TdThreadMutex        biMutex;
   SLRUCache           *bCache;
@@ -655,6 +658,9 @@ struct SRowMerger {
   SArray   *pArray;  // SArray<SColVal>
 };
 
+#define TSDB_FD_WBUF_NUM  4
+#define TSDB_FD_WBUF_SIZE (256 * 1024)
+
 typedef struct {
   char       *path;
   int32_t     szPage;
@@ -669,6 +675,17 @@ typedef struct {
   int32_t     fid;
   int64_t     cid;
   int64_t     blkno;
+  // with io_uring, new pages are gathered into large sequential writes, and batch reads are submitted together
+  TdFileRingPtr pRing;  // the ring of the writing thread, not owned
+  int8_t        ringTried;
+  uint8_t      *aWBuf[TSDB_FD_WBUF_NUM];
+  TdFileIoReq   aWReq[TSDB_FD_WBUF_NUM];
+  int32_t       iWBuf;       // the buffer being filled
+  int32_t       nWPage;      // pages in it
+  int64_t       wPgno;       // first page in it
+  int32_t       nWInflight;  // buffers written and not waited
+  uint8_t      *pRBuf;       // pages of a batch read
+  int64_t       szRBuf;
 } STsdbFD;
 
 struct SDelFWriter {
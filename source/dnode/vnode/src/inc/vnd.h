@@ -73,7 +73,7 @@ int32_t vnodeACancel(SVAsync* async, int64_t taskId);
 int32_t vnodeAsyncSetWorkers(SVAsync* async, int32_t numWorkers);
 
 // vnodeModule.c
-extern SVAsync* vnodeAsyncHandle[2];
+extern SVAsync* vnodeAsyncHandle[4];
 
 // vnodeBufPool.c
 typedef struct SVBufPoolNode SVBufPoolNode;
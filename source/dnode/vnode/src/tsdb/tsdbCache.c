@@ -283,16 +283,9 @@ static void tsdbCloseRocksCache(STsdb *pTsdb) {
 }
 
 static void rocksMayWrite(STsdb *pTsdb, bool force, bool read, bool lock) {
-  rocksdb_writebatch_t *wb = pTsdb->rCache.writebatch;
-  if (read) {
-    if (lock) {
-      taosThreadMutexLock(&pTsdb->lruMutex);
-    }
-    wb = pTsdb->rCache.rwritebatch;
-  } else {
-    if (lock) {
-      taosThreadMutexLock(&pTsdb->rCache.rMutex);
-    }
+  rocksdb_writebatch_t *wb = read ? pTsdb->rCache.rwritebatch : pTsdb->rCache.writebatch;
+  if (lock) {
+    taosThreadMutexLock(&pTsdb->rCache.rMutex);
   }
 
   int count = rocksdb_writebatch_count(wb);
@@ -311,11 +304,23 @@ static void rocksMayWrite(STsdb *pTsdb, bool force, bool read, bool lock) {
   }
 
   if (lock) {
-    if (read) {
-      taosThreadMutexUnlock(&pTsdb->lruMutex);
-    } else {
-      taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
-    }
+    taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
+  }
+}
+
+static FORCE_INLINE TdThreadMutex *tsdbCacheGetMutex(STsdb *pTsdb, tb_uid_t uid) {
+  return &pTsdb->lruMutex[(uint64_t)uid % TSDB_CACHE_LOCK_NUM];
+}
+
+static void tsdbCacheLockAll(STsdb *pTsdb) {
+  for (int32_t i = 0; i < TSDB_CACHE_LOCK_NUM; ++i) {
+    taosThreadMutexLock(&pTsdb->lruMutex[i]);
+  }
+}
+
+static void tsdbCacheUnlockAll(STsdb *pTsdb) {
+  for (int32_t i = TSDB_CACHE_LOCK_NUM - 1; i >= 0; --i) {
+    taosThreadMutexUnlock(&pTsdb->lruMutex[i]);
   }
 }
 
@@ -411,15 +416,15 @@ int32_t tsdbCacheCommit(STsdb *pTsdb) {
   SLRUCache            *pCache = pTsdb->lruCache;
   rocksdb_writebatch_t *wb = pTsdb->rCache.writebatch;
 
-  taosThreadMutexLock(&pTsdb->lruMutex);
+  tsdbCacheLockAll(pTsdb);
 
   taosLRUCacheApply(pCache, tsdbCacheFlushDirty, &pTsdb->flushState);
 
-  rocksMayWrite(pTsdb, true, false, false);
-  rocksMayWrite(pTsdb, true, true, false);
+  rocksMayWrite(pTsdb, true, false, true);
+  rocksMayWrite(pTsdb, true, true, true);
   rocksdb_flush(pTsdb->rCache.db, pTsdb->rCache.flushoptions, &err);
 
-  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  tsdbCacheUnlockAll(pTsdb);
 
   if (NULL != err) {
     tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, __LINE__, err);
@@ -480,6 +485,54 @@ typedef struct {
   SLastKey key;
 } SIdxKey;
 
+static int32_t tsdbCacheInsertCol(STsdb *pTsdb, SLastKey *key, SLastCol *pLastCol) {
+  size_t charge = sizeof(*pLastCol);
+  if (IS_VAR_DATA_TYPE(pLastCol->colVal.type)) {
+    charge += pLastCol->colVal.value.nData;
+  }
+
+  LRUStatus status = taosLRUCacheInsert(pTsdb->lruCache, key, ROCKS_KEY_LEN, pLastCol, charge, tsdbCacheDeleter, NULL,
+                                        TAOS_LRU_PRIORITY_LOW, &pTsdb->flushState);
+  if (status != TAOS_LRU_STATUS_OK && status != TAOS_LRU_STATUS_OK_OVERWRITTEN) {
+    return -1;
+  }
+
+  return 0;
+}
+
+// A cached value is never modified in place, since readers copy it out holding only a reference of the handle. The
+// new value is published by replacing the entry, and the old one is freed once the last reader releases it. The new
+// value is left dirty and written back to rocksdb in batch by commit or eviction.
+static int32_t tsdbCacheNewCol(STsdb *pTsdb, SLastKey *key, TSKEY keyTs, SColVal *pColVal) {
+  SLastCol *pLastCol = taosMemoryCalloc(1, sizeof(SLastCol));
+  if (NULL == pLastCol) {
+    return -1;
+  }
+
+  pLastCol->ts = keyTs;
+  pLastCol->dirty = 1;
+  pLastCol->colVal = *pColVal;
+  reallocVarData(&pLastCol->colVal);
+
+  return tsdbCacheInsertCol(pTsdb, key, pLastCol);
+}
+
+static int32_t tsdbCacheUpdateCol(STsdb *pTsdb, LRUHandle *h, SLastKey *key, TSKEY keyTs, SColVal *pColVal) {
+  SLRUCache *pCache = pTsdb->lruCache;
+  SLastCol  *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
+
+  if (pLastCol->ts > keyTs) {
+    taosLRUCacheRelease(pCache, h, false);
+    return 0;
+  }
+
+  // superseded by the new value, do not write it back when it is freed
+  pLastCol->dirty = 0;
+  taosLRUCacheRelease(pCache, h, false);
+
+  return tsdbCacheNewCol(pTsdb, key, keyTs, pColVal);
+}
+
 int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow) {
   int32_t code = 0;
 
@@ -506,12 +559,13 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
   tsdbRowClose(&iter);
 
   // 3, build keys & multi get from rocks
-  int        num_keys = TARRAY_SIZE(aColVal);
-  TSKEY      keyTs = TSDBROW_TS(pRow);
-  SArray    *remainCols = NULL;
-  SLRUCache *pCache = pTsdb->lruCache;
+  int            num_keys = TARRAY_SIZE(aColVal);
+  TSKEY          keyTs = TSDBROW_TS(pRow);
+  SArray        *remainCols = NULL;
+  SLRUCache     *pCache = pTsdb->lruCache;
+  TdThreadMutex *pMutex = tsdbCacheGetMutex(pTsdb, uid);
 
-  taosThreadMutexLock(&pTsdb->lruMutex);
+  taosThreadMutexLock(pMutex);
   for (int i = 0; i < num_keys; ++i) {
     SColVal *pColVal = (SColVal *)taosArrayGet(aColVal, i);
     int16_t  cid = pColVal->cid;
@@ -520,34 +574,9 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
     size_t     klen = ROCKS_KEY_LEN;
     LRUHandle *h = taosLRUCacheLookup(pCache, key, klen);
     if (h) {
-      SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
-
-      if (pLastCol->ts <= keyTs) {
-        uint8_t *pVal = NULL;
-        int      nData = pLastCol->colVal.value.nData;
-        if (IS_VAR_DATA_TYPE(pColVal->type)) {
-          pVal = pLastCol->colVal.value.pData;
-        }
-        pLastCol->ts = keyTs;
-        pLastCol->colVal = *pColVal;
-        if (IS_VAR_DATA_TYPE(pColVal->type)) {
-          if (nData < pColVal->value.nData) {
-            taosMemoryFree(pVal);
-            pLastCol->colVal.value.pData = taosMemoryCalloc(1, pColVal->value.nData);
-          } else {
-            pLastCol->colVal.value.pData = pVal;
-          }
-          if (pColVal->value.nData) {
-            memcpy(pLastCol->colVal.value.pData, pColVal->value.pData, pColVal->value.nData);
-          }
-        }
-
-        if (!pLastCol->dirty) {
-          pLastCol->dirty = 1;
-        }
+      if (tsdbCacheUpdateCol(pTsdb, h, key, keyTs, pColVal) != 0) {
+        code = -1;
       }
-
-      taosLRUCacheRelease(pCache, h, false);
     } else {
       if (!remainCols) {
         remainCols = taosArrayInit(num_keys * 2, sizeof(SIdxKey));
@@ -559,34 +588,9 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
       key->ltype = 1;
       LRUHandle *h = taosLRUCacheLookup(pCache, key, klen);
       if (h) {
-        SLastCol *pLastCol = (SLastCol *)taosLRUCacheValue(pCache, h);
-
-        if (pLastCol->ts <= keyTs) {
-          uint8_t *pVal = NULL;
-          int      nData = pLastCol->colVal.value.nData;
-          if (IS_VAR_DATA_TYPE(pColVal->type)) {
-            pVal = pLastCol->colVal.value.pData;
-          }
-          pLastCol->ts = keyTs;
-          pLastCol->colVal = *pColVal;
-          if (IS_VAR_DATA_TYPE(pColVal->type)) {
-            if (nData < pColVal->value.nData) {
-              taosMemoryFree(pVal);
-              pLastCol->colVal.value.pData = taosMemoryCalloc(1, pColVal->value.nData);
-            } else {
-              pLastCol->colVal.value.pData = pVal;
-            }
-            if (pColVal->value.nData) {
-              memcpy(pLastCol->colVal.value.pData, pColVal->value.pData, pColVal->value.nData);
-            }
-          }
-
-          if (!pLastCol->dirty) {
-            pLastCol->dirty = 1;
-          }
+        if (tsdbCacheUpdateCol(pTsdb, h, key, keyTs, pColVal) != 0) {
+          code = -1;
         }
-
-        taosLRUCacheRelease(pCache, h, false);
       } else {
         if (!remainCols) {
           remainCols = taosArrayInit(num_keys * 2, sizeof(SIdxKey));
@@ -621,7 +625,6 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
     taosMemoryFree(keys_list_sizes);
     taosMemoryFree(values_list_sizes);
 
-    rocksdb_writebatch_t *wb = pTsdb->rCache.writebatch;
     for (int i = 0; i < num_keys; ++i) {
       SIdxKey *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[i];
       SColVal *pColVal = (SColVal *)TARRAY_DATA(aColVal) + idxKey->idx;
@@ -629,83 +632,23 @@ int32_t tsdbCacheUpdate(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSDBROW *pRow
 
       SLastCol *pLastCol = tsdbCacheDeserialize(values_list[i]);
 
-      if (idxKey->key.ltype == 0) {
+      if (idxKey->key.ltype == 0 || COL_VAL_IS_VALUE(pColVal)) {
         if (NULL == pLastCol || pLastCol->ts <= keyTs) {
-          char  *value = NULL;
-          size_t vlen = 0;
-          tsdbCacheSerialize(&(SLastCol){.ts = keyTs, .colVal = *pColVal}, &value, &vlen);
-          // SLastKey key = (SLastKey){.ltype = 0, .uid = uid, .cid = pColVal->cid};
-          taosThreadMutexLock(&pTsdb->rCache.rMutex);
-
-          rocksdb_writebatch_put(wb, (char *)&idxKey->key, ROCKS_KEY_LEN, value, vlen);
-
-          taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
-
-          pLastCol = (SLastCol *)value;
-          SLastCol *pTmpLastCol = taosMemoryCalloc(1, sizeof(SLastCol));
-          *pTmpLastCol = *pLastCol;
-          pLastCol = pTmpLastCol;
-
-          reallocVarData(&pLastCol->colVal);
-          size_t charge = sizeof(*pLastCol);
-          if (IS_VAR_DATA_TYPE(pLastCol->colVal.type)) {
-            charge += pLastCol->colVal.value.nData;
-          }
-
-          LRUStatus status = taosLRUCacheInsert(pTsdb->lruCache, &idxKey->key, ROCKS_KEY_LEN, pLastCol, charge,
-                                                tsdbCacheDeleter, NULL, TAOS_LRU_PRIORITY_LOW, &pTsdb->flushState);
-          if (status != TAOS_LRU_STATUS_OK) {
+          if (tsdbCacheNewCol(pTsdb, &idxKey->key, keyTs, pColVal) != 0) {
             code = -1;
           }
-
-          taosMemoryFree(value);
-        }
-      } else {
-        if (COL_VAL_IS_VALUE(pColVal)) {
-          if (NULL == pLastCol || pLastCol->ts <= keyTs) {
-            char  *value = NULL;
-            size_t vlen = 0;
-            tsdbCacheSerialize(&(SLastCol){.ts = keyTs, .colVal = *pColVal}, &value, &vlen);
-            // SLastKey key = (SLastKey){.ltype = 1, .uid = uid, .cid = pColVal->cid};
-            taosThreadMutexLock(&pTsdb->rCache.rMutex);
-
-            rocksdb_writebatch_put(wb, (char *)&idxKey->key, ROCKS_KEY_LEN, value, vlen);
-
-            taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
-
-            pLastCol = (SLastCol *)value;
-            SLastCol *pTmpLastCol = taosMemoryCalloc(1, sizeof(SLastCol));
-            *pTmpLastCol = *pLastCol;
-            pLastCol = pTmpLastCol;
-
-            reallocVarData(&pLastCol->colVal);
-            size_t charge = sizeof(*pLastCol);
-            if (IS_VAR_DATA_TYPE(pLastCol->colVal.type)) {
-              charge += pLastCol->colVal.value.nData;
-            }
-
-            LRUStatus status = taosLRUCacheInsert(pTsdb->lruCache, &idxKey->key, ROCKS_KEY_LEN, pLastCol, charge,
-                                                  tsdbCacheDeleter, NULL, TAOS_LRU_PRIORITY_LOW, &pTsdb->flushState);
-            if (status != TAOS_LRU_STATUS_OK) {
-              code = -1;
-            }
-
-            taosMemoryFree(value);
-          }
         }
       }
 
       rocksdb_free(values_list[i]);
     }
 
-    rocksMayWrite(pTsdb, true, false, true);
-
     taosMemoryFree(values_list);
 
     taosArrayDestroy(remainCols);
   }
 
-  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  taosThreadMutexUnlock(pMutex);
 
 _exit:
   taosArrayDestroy(aColVal);
@@ -949,12 +892,14 @@ static int32_t tsdbCacheLoadFromRaw(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArr
 
     SLastKey *key = &idxKey->key;
     size_t    klen = ROCKS_KEY_LEN;
+    taosThreadMutexLock(&pTsdb->rCache.rMutex);
     rocksdb_writebatch_put(wb, (char *)key, klen, value, vlen);
+    taosThreadMutexUnlock(&pTsdb->rCache.rMutex);
     taosMemoryFree(value);
   }
 
   if (wb) {
-    rocksMayWrite(pTsdb, false, true, false);
+    rocksMayWrite(pTsdb, false, true, true);
   }
 
   taosArrayDestroy(pTmpColArray);
@@ -1072,7 +1017,8 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
   }
 
   if (remainCols && TARRAY_SIZE(remainCols) > 0) {
-    taosThreadMutexLock(&pTsdb->lruMutex);
+    TdThreadMutex *pMutex = tsdbCacheGetMutex(pTsdb, uid);
+    taosThreadMutexLock(pMutex);
     for (int i = 0; i < TARRAY_SIZE(remainCols);) {
       SIdxKey   *idxKey = &((SIdxKey *)TARRAY_DATA(remainCols))[i];
       LRUHandle *h = taosLRUCacheLookup(pCache, &idxKey->key, ROCKS_KEY_LEN);
@@ -1094,7 +1040,7 @@ int32_t tsdbCacheGetBatch(STsdb *pTsdb, tb_uid_t uid, SArray *pLastArray, SCache
     // tsdbTrace("tsdb/cache: vgId: %d, load %" PRId64 " from rocks", TD_VID(pTsdb->pVnode), uid);
     code = tsdbCacheLoadFromRocks(pTsdb, uid, pLastArray, remainCols, pr, ltype);
 
-    taosThreadMutexUnlock(&pTsdb->lruMutex);
+    taosThreadMutexUnlock(pMutex);
 
     if (remainCols) {
       taosArrayDestroy(remainCols);
@@ -1138,7 +1084,8 @@ int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKE
 
   (void)tsdbCacheCommit(pTsdb);
 
-  taosThreadMutexLock(&pTsdb->lruMutex);
+  TdThreadMutex *pMutex = tsdbCacheGetMutex(pTsdb, uid);
+  taosThreadMutexLock(pMutex);
 
   taosThreadMutexLock(&pTsdb->rCache.rMutex);
   // rocksMayWrite(pTsdb, true, false, false);
@@ -1169,7 +1116,6 @@ int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKE
     rocksdb_free(values_list[i]);
     rocksdb_free(values_list[i + num_keys]);
 
-    // taosThreadMutexLock(&pTsdb->lruMutex);
 
     bool       erase = false;
     LRUHandle *h = taosLRUCacheLookup(pTsdb->lruCache, keys_list[i], klen);
@@ -1198,7 +1144,6 @@ int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKE
     if (erase) {
       taosLRUCacheErase(pTsdb->lruCache, keys_list[num_keys + i], klen);
     }
-    // taosThreadMutexUnlock(&pTsdb->lruMutex);
   }
   for (int i = 0; i < num_keys; ++i) {
     taosMemoryFree(keys_list[i]);
@@ -1210,7 +1155,7 @@ int32_t tsdbCacheDel(STsdb *pTsdb, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKE
 
   rocksMayWrite(pTsdb, true, false, true);
 
-  taosThreadMutexUnlock(&pTsdb->lruMutex);
+  taosThreadMutexUnlock(pMutex);
 
 _exit:
   taosMemoryFree(pTSchema);
@@ -1223,7 +1168,7 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
   SLRUCache *pCache = NULL;
   size_t     cfgCapacity = pTsdb->pVnode->config.cacheLastSize * 1024 * 1024;
 
-  pCache = taosLRUCacheInit(cfgCapacity, 0, .5);
+  pCache = taosLRUCacheInit(cfgCapacity, TSDB_CACHE_SHARD_BITS, .5);
   if (pCache == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _err;
@@ -1255,7 +1200,9 @@ int32_t tsdbOpenCache(STsdb *pTsdb) {
 
   taosLRUCacheSetStrictCapacity(pCache, false);
 
-  taosThreadMutexInit(&pTsdb->lruMutex, NULL);
+  for (int32_t i = 0; i < TSDB_CACHE_LOCK_NUM; ++i) {
+    taosThreadMutexInit(&pTsdb->lruMutex[i], NULL);
+  }
 
   pTsdb->flushState.pTsdb = pTsdb;
   pTsdb->flushState.flush_count = 0;
@@ -1272,7 +1219,9 @@ void tsdbCloseCache(STsdb *pTsdb) {
 
     taosLRUCacheCleanup(pCache);
 
-    taosThreadMutexDestroy(&pTsdb->lruMutex);
+    for (int32_t i = 0; i < TSDB_CACHE_LOCK_NUM; ++i) {
+      taosThreadMutexDestroy(&pTsdb->lruMutex[i]);
+    }
   }
 
   tsdbCloseBICache(pTsdb);
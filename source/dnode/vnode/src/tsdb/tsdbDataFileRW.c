@@ -247,6 +247,95 @@ _exit:
   return code;
 }
 
+// the columns with values are read in one batch, so that their reads are submitted together, and decompressed after
+// it. The SBlockCol of the block are in bufArr[0], and offset is where the column data starts.
+int32_t tsdbFileReadBlockColData(STsdbFD *fd, int64_t offset, const SDiskDataHdr *hdr, SBlockData *bData,
+                                 uint8_t **bufArr) {
+  int32_t    code = 0;
+  int32_t    lino = 0;
+  int32_t    nValCol = 0;
+  int64_t    szValCol = 0;
+  SFDataPtr *aPtr = NULL;
+  SBlockCol *aBlockCol = NULL;
+
+  aPtr = taosMemoryMalloc(bData->nColData * (sizeof(SFDataPtr) + sizeof(SBlockCol)));
+  if (aPtr == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+  aBlockCol = (SBlockCol *)(aPtr + bData->nColData);
+
+  SBlockCol  bc[1] = {{.cid = 0}};
+  SBlockCol *blockCol = bc;
+
+  int32_t size = 0;
+  for (int32_t i = 0; i < bData->nColData; i++) {
+    SColData *colData = tBlockDataGetColDataByIdx(bData, i);
+
+    while (blockCol && blockCol->cid < colData->cid) {
+      if (size < hdr->szBlkCol) {
+        size += tGetBlockCol(bufArr[0] + size, blockCol);
+      } else {
+        ASSERT(size == hdr->szBlkCol);
+        blockCol = NULL;
+      }
+    }
+
+    if (blockCol == NULL || blockCol->cid > colData->cid) {
+      for (int32_t iRow = 0; iRow < hdr->nRow; iRow++) {
+        code = tColDataAppendValue(colData, &COL_VAL_NONE(colData->cid, colData->type));
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    } else {
+      ASSERT(blockCol->type == colData->type);
+      ASSERT(blockCol->flag && blockCol->flag != HAS_NONE);
+
+      if (blockCol->flag == HAS_NULL) {
+        for (int32_t iRow = 0; iRow < hdr->nRow; iRow++) {
+          code = tColDataAppendValue(colData, &COL_VAL_NULL(blockCol->cid, blockCol->type));
+          TSDB_CHECK_CODE(code, lino, _exit);
+        }
+      } else {
+        aBlockCol[nValCol] = *blockCol;
+        aPtr[nValCol].offset = offset + blockCol->offset;
+        aPtr[nValCol].size = blockCol->szBitmap + blockCol->szOffset + blockCol->szValue;
+        szValCol += aPtr[nValCol].size;
+        nValCol++;
+      }
+    }
+  }
+
+  if (nValCol == 0) {
+    goto _exit;
+  }
+
+  code = tRealloc(&bufArr[1], szValCol);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbReadFileBatch(fd, aPtr, nValCol, bufArr[1]);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  szValCol = 0;
+  for (int32_t i = 0, j = 0; i < bData->nColData && j < nValCol; i++) {
+    SColData *colData = tBlockDataGetColDataByIdx(bData, i);
+    if (colData->cid != aBlockCol[j].cid) {
+      continue;
+    }
+
+    code = tsdbDecmprColData(bufArr[1] + szValCol, &aBlockCol[j], hdr->cmprAlg, hdr->nRow, colData, &bufArr[2]);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    szValCol += aPtr[j].size;
+    j++;
+  }
+
+_exit:
+  if (code) {
+    tsdbError("%s failed at line %d since %s", __func__, lino, tstrerror(code));
+  }
+  taosMemoryFree(aPtr);
+  return code;
+}
+
 int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRecord *record, SBlockData *bData,
                                           STSchema *pTSchema, int16_t cids[], int32_t ncid) {
   int32_t code = 0;
@@ -302,89 +391,10 @@ int32_t tsdbDataFileReadBlockDataByColumn(SDataFileReader *reader, const SBrinRe
       TSDB_CHECK_CODE(code, lino, _exit);
     }
 
-    int64_t szHint = 0;
-    if (bData->nColData > 3) {
-      int64_t    offset = 0;
-      SBlockCol  bc = {.cid = 0};
-      SBlockCol *blockCol = &bc;
-
-      size = 0;
-      SColData *colData = tBlockDataGetColDataByIdx(bData, 0);
-      while (blockCol && blockCol->cid < colData->cid) {
-        if (size < hdr->szBlkCol) {
-          size += tGetBlockCol(reader->config->bufArr[0] + size, blockCol);
-        } else {
-          ASSERT(size == hdr->szBlkCol);
-          blockCol = NULL;
-        }
-      }
-
-      if (blockCol && blockCol->flag == HAS_VALUE) {
-        offset = blockCol->offset;
-
-        SColData *colDataEnd = tBlockDataGetColDataByIdx(bData, bData->nColData - 1);
-        while (blockCol && blockCol->cid < colDataEnd->cid) {
-          if (size < hdr->szBlkCol) {
-            size += tGetBlockCol(reader->config->bufArr[0] + size, blockCol);
-          } else {
-            ASSERT(size == hdr->szBlkCol);
-            blockCol = NULL;
-          }
-        }
-
-        if (blockCol && blockCol->flag == HAS_VALUE) {
-          szHint = blockCol->offset + blockCol->szBitmap + blockCol->szOffset + blockCol->szValue - offset;
-        }
-      }
-    }
-
-    SBlockCol  bc[1] = {{.cid = 0}};
-    SBlockCol *blockCol = bc;
-
-    size = 0;
-    for (int32_t i = 0; i < bData->nColData; i++) {
-      SColData *colData = tBlockDataGetColDataByIdx(bData, i);
-
-      while (blockCol && blockCol->cid < colData->cid) {
-        if (size < hdr->szBlkCol) {
-          size += tGetBlockCol(reader->config->bufArr[0] + size, blockCol);
-        } else {
-          ASSERT(size == hdr->szBlkCol);
-          blockCol = NULL;
-        }
-      }
-
-      if (blockCol == NULL || blockCol->cid > colData->cid) {
-        for (int32_t iRow = 0; iRow < hdr->nRow; iRow++) {
-          code = tColDataAppendValue(colData, &COL_VAL_NONE(colData->cid, colData->type));
-          TSDB_CHECK_CODE(code, lino, _exit);
-        }
-      } else {
-        ASSERT(blockCol->type == colData->type);
-        ASSERT(blockCol->flag && blockCol->flag != HAS_NONE);
-
-        if (blockCol->flag == HAS_NULL) {
-          for (int32_t iRow = 0; iRow < hdr->nRow; iRow++) {
-            code = tColDataAppendValue(colData, &COL_VAL_NULL(blockCol->cid, blockCol->type));
-            TSDB_CHECK_CODE(code, lino, _exit);
-          }
-        } else {
-          int32_t size1 = blockCol->szBitmap + blockCol->szOffset + blockCol->szValue;
-
-          code = tRealloc(&reader->config->bufArr[1], size1);
-          TSDB_CHECK_CODE(code, lino, _exit);
-
-          code = tsdbReadFile(reader->fd[TSDB_FTYPE_DATA],
-                              record->blockOffset + record->blockKeySize + hdr->szBlkCol + blockCol->offset,
-                              reader->config->bufArr[1], size1, i > 0 ? 0 : szHint);
-          TSDB_CHECK_CODE(code, lino, _exit);
-
-          code = tsdbDecmprColData(reader->config->bufArr[1], blockCol, hdr->cmprAlg, hdr->nRow, colData,
-                                   &reader->config->bufArr[2]);
-          TSDB_CHECK_CODE(code, lino, _exit);
-        }
-      }
-    }
+    code = tsdbFileReadBlockColData(reader->fd[TSDB_FTYPE_DATA],
+                                    record->blockOffset + record->blockKeySize + hdr->szBlkCol, hdr, bData,
+                                    reader->config->bufArr);
+    TSDB_CHECK_CODE(code, lino, _exit);
   }
 
 _exit:
@@ -1619,6 +1629,9 @@ static int32_t tsdbDataFileWriterOpenDataFD(SDataFileWriter *writer) {
     if (writer->files[ftype].size == 0) {
       flag |= (TD_FILE_CREATE | TD_FILE_TRUNC);
     }
+    if (writer->config->directIO) {
+      flag |= TD_FILE_DIRECT;
+    }
 
     tsdbTFileName(writer->config->tsdb, &writer->files[ftype], fname);
     code = tsdbOpenFile(fname, writer->config->tsdb, flag, &writer->fd[ftype]);
@@ -1788,6 +1801,9 @@ static int32_t tsdbDataFileWriterOpenTombFD(SDataFileWriter *writer) {
   ASSERT(writer->files[ftype].size == 0);
 
   int32_t flag = (TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  if (writer->config->directIO) {
+    flag |= TD_FILE_DIRECT;
+  }
 
   tsdbTFileName(writer->config->tsdb, writer->files + ftype, fname);
   code = tsdbOpenFile(fname, writer->config->tsdb, flag, &writer->fd[ftype]);
@@ -79,6 +79,7 @@ typedef struct SDataFileWriterConfig {
   int64_t cid;
   SDiskID did;
   int64_t compactVersion;
+  bool    directIO;
   struct {
     bool   exist;
     STFile file;
@@ -109,6 +110,8 @@ int32_t tsdbFileWriteTombBlk(STsdbFD *fd, const TTombBlkArray *tombBlkArray, SFD
 int32_t tsdbFileWriteTombFooter(STsdbFD *fd, const STombFooter *footer, int64_t *fileSize);
 
 // utils
+int32_t tsdbFileReadBlockColData(STsdbFD *fd, int64_t offset, const SDiskDataHdr *hdr, SBlockData *bData,
+                                 uint8_t **bufArr);
 int32_t tsdbWriterUpdVerRange(SVersionRange *range, int64_t minVer, int64_t maxVer);
 int32_t tsdbTFileUpdVerRange(STFile *f, SVersionRange range);
 
@@ -35,6 +35,7 @@ extern int32_t tsdbOpenFile(const char *path, STsdb *pTsdb, int32_t flag, STsdbF
 extern void    tsdbCloseFile(STsdbFD **ppFD);
 extern int32_t tsdbWriteFile(STsdbFD *pFD, int64_t offset, const uint8_t *pBuf, int64_t size);
 extern int32_t tsdbReadFile(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size, int64_t szHint);
+extern int32_t tsdbReadFileBatch(STsdbFD *pFD, const SFDataPtr *aRange, int32_t nRange, uint8_t *pBuf);
 extern int32_t tsdbFsyncFile(STsdbFD *pFD);
 
 #ifdef __cplusplus
@@ -146,6 +146,7 @@ int32_t tsdbFSetWriterOpen(SFSetWriterConfig *config, SFSetWriter **writer) {
         .cid = config->cid,
         .did = config->did,
         .compactVersion = config->compactVersion,
+        .directIO = config->directIO,
         .skmTb = writer[0]->skmTb,
         .skmRow = writer[0]->skmRow,
         .bufArr = writer[0]->bufArr,
@@ -166,6 +167,7 @@ int32_t tsdbFSetWriterOpen(SFSetWriterConfig *config, SFSetWriter **writer) {
       .szPage = config->szPage,
       .cmprAlg = config->cmprAlg,
       .compactVersion = config->compactVersion,
+      .directIO = config->directIO,
       .did = config->did,
       .fid = config->fid,
       .cid = config->cid,
@@ -29,6 +29,7 @@ typedef struct {
   STsdb  *tsdb;
   bool    toSttOnly;
   int64_t compactVersion;
+  bool    directIO;  // write the files bypassing the page cache
   int32_t minRow;
   int32_t maxRow;
   int32_t szPage;
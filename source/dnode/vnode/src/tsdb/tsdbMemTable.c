@@ -37,6 +37,8 @@ static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
 static int32_t tsdbInsertColDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
+static int32_t tsdbInsertRowDataAsColToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
+                                             SSubmitTbData *pSubmitTbData, int32_t *affectedRows);
 
 static int32_t tTbDataCmprFn(const SRBTreeNode *n1, const SRBTreeNode *n2) {
   STbData *tbData1 = TCONTAINER_OF(n1, STbData, rbtn);
@@ -115,6 +117,24 @@ STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t
   return pTbData;
 }
 
+// store the rows of a table in column format if there are enough of them in one submit, and all of them are of the
+// same schema version
+static bool tsdbRowDataInColFmt(SSubmitTbData *pSubmitTbData) {
+  int32_t nRow = TARRAY_SIZE(pSubmitTbData->aRowP);
+  if (tsMemColumnarRows <= 0 || nRow < tsMemColumnarRows) {
+    return false;
+  }
+
+  SRow **aRow = (SRow **)TARRAY_DATA(pSubmitTbData->aRowP);
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    if (aRow[iRow]->sver != pSubmitTbData->sver) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
 int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t    code = 0;
   SMemTable *pMemTable = pTsdb->mem;
@@ -131,6 +151,8 @@ int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitTbData *pSubmi
   // do insert impl
   if (pSubmitTbData->flags & SUBMIT_REQ_COLUMN_DATA_FORMAT) {
     code = tsdbInsertColDataToTable(pMemTable, pTbData, version, pSubmitTbData, affectedRows);
+  } else if (tsdbRowDataInColFmt(pSubmitTbData)) {
+    code = tsdbInsertRowDataAsColToTable(pMemTable, pTbData, version, pSubmitTbData, affectedRows);
   } else {
     code = tsdbInsertRowDataToTable(pMemTable, pTbData, version, pSubmitTbData, affectedRows);
   }
@@ -702,6 +724,62 @@ _exit:
   return code;
 }
 
+// transpose the rows into column data, then the rows are put into the skiplist as column format rows, out-of-order
+// rows included, and both scan and commit read them by column without decoding each row
+static int32_t tsdbInsertRowDataAsColToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
+                                             SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
+  int32_t   code = 0;
+  int32_t   nRow = TARRAY_SIZE(pSubmitTbData->aRowP);
+  SRow    **aRow = (SRow **)TARRAY_DATA(pSubmitTbData->aRowP);
+  STSchema *pTSchema = NULL;
+  SArray   *aCol = NULL;
+
+  code = metaGetTbTSchemaEx(pMemTable->pTsdb->pVnode->pMeta, pTbData->suid, pTbData->uid, pSubmitTbData->sver,
+                            &pTSchema);
+  if (code) goto _exit;
+
+  if (pTSchema->numOfCols <= 1) {
+    code = tsdbInsertRowDataToTable(pMemTable, pTbData, version, pSubmitTbData, affectedRows);
+    goto _exit;
+  }
+
+  aCol = taosArrayInit(pTSchema->numOfCols, sizeof(SColData));
+  if (aCol == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+    STColumn *pTColumn = &pTSchema->columns[iCol];
+    SColData *pColData = taosArrayReserve(aCol, 1);
+    if (pColData == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    tColDataInit(pColData, pTColumn->colId, pTColumn->type, (pTColumn->flags & COL_SMA_ON) ? 1 : 0);
+  }
+
+  SColData *aColData = (SColData *)TARRAY_DATA(aCol);
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    SColVal cv = COL_VAL_VALUE(PRIMARYKEY_TIMESTAMP_COL_ID, TSDB_DATA_TYPE_TIMESTAMP, (SValue){.val = aRow[iRow]->ts});
+    code = tColDataAppendValue(&aColData[0], &cv);
+    if (code) goto _exit;
+
+    code = tRowUpsertColData(aRow[iRow], pTSchema, aColData + 1, pTSchema->numOfCols - 1, 0 /* append */);
+    if (code) goto _exit;
+  }
+
+  SSubmitTbData submitTbData = *pSubmitTbData;
+  submitTbData.flags |= SUBMIT_REQ_COLUMN_DATA_FORMAT;
+  submitTbData.aCol = aCol;
+  code = tsdbInsertColDataToTable(pMemTable, pTbData, version, &submitTbData, affectedRows);
+
+_exit:
+  taosArrayDestroyEx(aCol, tColDataDestroy);
+  taosMemoryFree(pTSchema);
+  return code;
+}
+
 static int32_t tsdbInsertRowDataToTable(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                         SSubmitTbData *pSubmitTbData, int32_t *affectedRows) {
   int32_t code = 0;
@@ -297,6 +297,7 @@ static int32_t tsdbMergeFileSetBeginOpenWriter(SMerger *merger) {
       .tsdb = merger->tsdb,
       .toSttOnly = true,
       .compactVersion = merger->compactVersion,
+      .directIO = tsTsdbCompactDirectIO,
       .minRow = merger->minRow,
       .maxRow = merger->maxRow,
       .szPage = merger->szPage,
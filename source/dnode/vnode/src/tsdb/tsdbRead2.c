@@ -77,6 +77,8 @@ static void          updateComposedBlockInfo(STsdbReader* pReader, double el, ST
 static bool outOfTimeWindow(int64_t ts, STimeWindow* pWindow) { return (ts > pWindow->ekey) || (ts < pWindow->skey); }
 
 static void resetPreFilesetMemTableListIndex(SReaderStatus* pStatus);
+static STsdbReader* getStepReader(STsdbReader* pReader);
+static int32_t      doFinishLateLoad(STsdbReader* pReader, bool required);
 
 static int32_t setColumnIdSlotList(SBlockLoadSuppInfo* pSupInfo, SColumnInfo* pCols, const int32_t* pSlotIdList,
                                    int32_t numOfCols) {
@@ -200,6 +202,7 @@ static int32_t filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader, bo
       tsdbDataFileReaderClose(&pReader->pFileReader);
     }
 
+    resetBlockPrefetcher(&pReader->prefetcher);
     pReader->status.pCurrentFileset = pIter->pFilesetList->data[pIter->index];
 
     STFileObj** pFileObj = pReader->status.pCurrentFileset->farr;
@@ -233,6 +236,7 @@ static int32_t filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader, bo
         goto _err;
       }
 
+      setBlockPrefetcherFile(&pReader->prefetcher, filesName[TSDB_FTYPE_DATA], &conf);
       pReader->cost.headFileLoad += 1;
     }
 
@@ -353,6 +357,11 @@ static int32_t tsdbReleaseReader(STsdbReader* pReader) {
 
 void tsdbReleaseDataBlock2(STsdbReader* pReader) {
   SReaderStatus* pStatus = &pReader->status;
+  if (getStepReader(pReader)->status.lateLoad.pending) {
+    tsdbRetrieveLateCols2(pReader, false);
+    return;
+  }
+
   if (!pStatus->composedDataBlock) {
     tsdbReleaseReader(pReader);
   }
@@ -422,6 +431,12 @@ static int32_t tsdbReaderCreate(SVnode* pVnode, SQueryTableDataCond* pCond, void
     goto _end;
   }
 
+  code = initBlockPrefetcher(&pReader->prefetcher, pVnode->config.tsdbPrefetchDepth, pReader->idStr);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+    goto _end;
+  }
+
   if (pReader->suppInfo.colId[0] != PRIMARYKEY_TIMESTAMP_COL_ID) {
     tsdbError("the first column isn't primary timestamp, %d, %s", pReader->suppInfo.colId[0], pReader->idStr);
     code = TSDB_CODE_INVALID_PARA;
@@ -886,7 +901,66 @@ static void copyNumericCols(const SColData* pData, SFileBlockDumpInfo* pDumpInfo
   }
 }
 
-static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
+// copy the given columns of dumpedRows rows from current file block, columns that do not exist in the loaded block data
+// are filled with null value. The column id list should be a subset of the queried columns, ordered by id.
+static int32_t copyBlockColumns(STsdbReader* pReader, SFileBlockDumpInfo* pDumpInfo, int32_t dumpedRows,
+                                const int16_t* pColId, int32_t numOfCols) {
+  SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
+  SBlockData*         pBlockData = &pReader->status.fileBlockData;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+  int32_t             step = ASCENDING_TRAVERSE(pReader->info.order) ? 1 : -1;
+  int32_t             num = pBlockData->nColData;
+  int32_t             colIndex = 0;
+  int32_t             k = 0;
+  SColVal             cv = {0};
+
+  for (int32_t i = 0; i < pSupInfo->numOfCols && k < numOfCols; ++i) {
+    if (pSupInfo->colId[i] != pColId[k]) {  // not required this time
+      continue;
+    }
+
+    k += 1;
+
+    SColData* pData = NULL;
+    while (colIndex < num) {
+      SColData* p = tBlockDataGetColDataByIdx(pBlockData, colIndex);
+      if (p->cid < pSupInfo->colId[i]) {
+        colIndex += 1;
+        continue;
+      }
+
+      if (p->cid == pSupInfo->colId[i]) {
+        pData = p;
+        colIndex += 1;
+      }
+      break;
+    }
+
+    SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
+
+    // the specified column does not exist in file block, fill with null data
+    if (pData == NULL || pData->flag == HAS_NONE || pData->flag == HAS_NULL ||
+        pData->flag == (HAS_NULL | HAS_NONE)) {
+      colDataSetNNULL(pColData, 0, dumpedRows);
+    } else if (IS_MATHABLE_TYPE(pColData->info.type)) {
+      copyNumericCols(pData, pDumpInfo, pColData, dumpedRows, ASCENDING_TRAVERSE(pReader->info.order));
+    } else {  // varchar/nchar type
+      int32_t rowIndex = 0;
+      for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
+        tColDataGetValue(pData, j, &cv);
+        int32_t code = doCopyColVal(pColData, rowIndex++, i, &cv, pSupInfo);
+        if (code) {
+          return code;
+        }
+      }
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// copy the rows of current file block in a batch, rows with keys from keyBound on (in the scan order) are not copied
+static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, int64_t keyBound) {
   SReaderStatus*      pStatus = &pReader->status;
   SDataBlockIter*     pBlockIter = &pStatus->blockIter;
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
@@ -895,10 +969,9 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
   SBlockData*         pBlockData = &pStatus->fileBlockData;
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(pBlockIter);
   SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
-  int32_t             numOfOutputCols = pSupInfo->numOfCols;
+  SLateLoadInfo*      pLateLoad = &pStatus->lateLoad;
   int32_t             code = TSDB_CODE_SUCCESS;
 
-  SColVal cv = {0};
   int64_t st = taosGetTimestampUs();
   bool    asc = ASCENDING_TRAVERSE(pReader->info.order);
   int32_t step = asc ? 1 : -1;
@@ -967,6 +1040,16 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if ((asc && pBlockData->aTSKEY[endIndex] >= keyBound) || (!asc && pBlockData->aTSKEY[endIndex] <= keyBound)) {
+    int64_t key = asc ? keyBound - 1 : keyBound + 1;
+    int32_t pos = doBinarySearchKey(pBlockData->aTSKEY, pRecord->numRow, pDumpInfo->rowIndex, key, pReader->info.order);
+    if (pos == -1) {  // the first row is overlapped already, leave it to the merge procedure
+      pResBlock->info.rows = 0;
+      return TSDB_CODE_SUCCESS;
+    }
+    endIndex = pos;
+  }
+
   endIndex += step;
   int32_t dumpedRows = asc ? (endIndex - pDumpInfo->rowIndex) : (pDumpInfo->rowIndex - endIndex);
   if (dumpedRows > pReader->resBlockInfo.capacity) {  // output buffer check
@@ -976,56 +1059,20 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader) {
     return TSDB_CODE_SUCCESS;
   }
 
-  int32_t i = 0;
-  int32_t rowIndex = 0;
-
-  SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-  if (pSupInfo->colId[i] == PRIMARYKEY_TIMESTAMP_COL_ID) {
-    copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
-    i += 1;
-  }
-
-  int32_t colIndex = 0;
-  int32_t num = pBlockData->nColData;
-  while (i < numOfOutputCols && colIndex < num) {
-    rowIndex = 0;
-
-    SColData* pData = tBlockDataGetColDataByIdx(pBlockData, colIndex);
-    if (pData->cid < pSupInfo->colId[i]) {
-      colIndex += 1;
-    } else if (pData->cid == pSupInfo->colId[i]) {
-      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-
-      if (pData->flag == HAS_NONE || pData->flag == HAS_NULL || pData->flag == (HAS_NULL | HAS_NONE)) {
-        colDataSetNNULL(pColData, 0, dumpedRows);
-      } else {
-        if (IS_MATHABLE_TYPE(pColData->info.type)) {
-          copyNumericCols(pData, pDumpInfo, pColData, dumpedRows, asc);
-        } else {  // varchar/nchar type
-          for (int32_t j = pDumpInfo->rowIndex; rowIndex < dumpedRows; j += step) {
-            tColDataGetValue(pData, j, &cv);
-            code = doCopyColVal(pColData, rowIndex++, i, &cv, pSupInfo);
-            if (code) {
-              return code;
-            }
-          }
-        }
-      }
+  SColumnInfoData* pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[0]);
+  copyPrimaryTsCol(pBlockData, pDumpInfo, pColData, dumpedRows, asc);
 
-      colIndex += 1;
-      i += 1;
-    } else {  // the specified column does not exist in file block, fill with null data
-      pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-      colDataSetNNULL(pColData, 0, dumpedRows);
-      i += 1;
-    }
+  // only the early columns are loaded, the late ones are copied after the filter is applied
+  if (pLateLoad->pending) {
+    code = copyBlockColumns(pReader, pDumpInfo, dumpedRows, pSupInfo->earlyColId, pSupInfo->numOfEarlyCols);
+    pLateLoad->rowIndex = pDumpInfo->rowIndex;
+    pLateLoad->rows = dumpedRows;
+  } else {
+    code = copyBlockColumns(pReader, pDumpInfo, dumpedRows, &pSupInfo->colId[1], pSupInfo->numOfCols - 1);
   }
 
-  // fill the mis-matched columns with null value
-  while (i < numOfOutputCols) {
-    pColData = taosArrayGet(pResBlock->pDataBlock, pSupInfo->slotId[i]);
-    colDataSetNNULL(pColData, 0, dumpedRows);
-    i += 1;
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
   }
 
   pResBlock->info.dataLoad = 1;
@@ -1076,8 +1123,8 @@ static FORCE_INLINE STSchema* getTableSchemaImpl(STsdbReader* pReader, uint64_t
   return pReader->info.pSchema;
 }
 
-static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
-                                   uint64_t uid) {
+static int32_t doLoadFileBlockColumns(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                      uint64_t uid, int16_t* colId, int32_t numOfCols) {
   int32_t   code = 0;
   STSchema* pSchema = pReader->info.pSchema;
   int64_t   st = taosGetTimestampUs();
@@ -1092,21 +1139,24 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
     }
   }
 
-  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(pBlockIter);
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
   SBrinRecord* pRecord = &pBlockInfo->record;
-  code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, &pSup->colId[1],
-                                           pSup->numOfCols - 1);
-  if (code != TSDB_CODE_SUCCESS) {
-    tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
-              ", rows:%d, code:%s %s",
-              pReader, pBlockIter->index, pBlockInfo->tbBlockIdx, pBlockInfo->record.firstKey,
-              pBlockInfo->record.lastKey, pBlockInfo->record.numRow, tstrerror(code), pReader->idStr);
-    return code;
+  if (!takePrefetchedBlock(&pReader->prefetcher, pRecord, colId, pBlockData, &pReader->cost)) {
+    code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, pRecord, pBlockData, pSchema, colId, numOfCols);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbError("%p error occurs in loading file block, global index:%d, table index:%d, brange:%" PRId64 "-%" PRId64
+                ", rows:%d, code:%s %s",
+                pReader, pBlockIter->index, pBlockInfo->tbBlockIdx, pBlockInfo->record.firstKey,
+                pBlockInfo->record.lastKey, pBlockInfo->record.numRow, tstrerror(code), pReader->idStr);
+      return code;
+    }
   }
 
+  // issue the read of the following blocks, while the current block is being merged and copied
+  scheduleBlockPrefetch(&pReader->prefetcher, pBlockIter, pReader->info.pSchema, colId, numOfCols);
+
   double elapsedTime = (taosGetTimestampUs() - st) / 1000.0;
 
   tsdbDebug("%p load file block into buffer, global index:%d, index in table block list:%d, brange:%" PRId64 "-%" PRId64
@@ -1120,6 +1170,12 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   return TSDB_CODE_SUCCESS;
 }
 
+static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
+                                   uint64_t uid) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  return doLoadFileBlockColumns(pReader, pBlockIter, pBlockData, uid, &pSup->colId[1], pSup->numOfCols - 1);
+}
+
 /**
  * This is an two rectangles overlap cases.
  */
@@ -2279,6 +2335,64 @@ void updateComposedBlockInfo(STsdbReader* pReader, double el, STableBlockScanInf
   pReader->cost.buildComposedBlockTime += el;
 }
 
+// the key from which the rows of file block need to be merged with the rows in buffer or stt files
+static int64_t getOverlapKeyOfFileBlock(STableBlockScanInfo* pScanInfo, TSDBKEY keyInBuf, bool asc) {
+  int64_t key = asc ? INT64_MAX : INT64_MIN;
+  if (keyInBuf.ts != TSKEY_INITIAL_VAL) {
+    key = keyInBuf.ts;
+  }
+
+  if (pScanInfo->sttKeyInfo.status == STT_FILE_HAS_DATA) {
+    int64_t keyInStt = pScanInfo->sttKeyInfo.nextProcKey;
+    key = asc ? TMIN(key, keyInStt) : TMAX(key, keyInStt);
+  }
+
+  return key;
+}
+
+// copy the rows of the file block ahead of the first key to merge in a batch. The rows are still decoded, the block
+// SMA covers the whole block and can not be used for a part of it.
+static int32_t copyNonOverlapRowsInFileBlock(STsdbReader* pReader, STableBlockScanInfo* pScanInfo,
+                                             SFileDataBlockInfo* pBlockInfo, TSDBKEY keyInBuf) {
+  bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
+  int32_t             step = asc ? 1 : -1;
+  SBlockData*         pBlockData = &pReader->status.fileBlockData;
+  SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
+  SSDataBlock*        pResBlock = pReader->resBlockInfo.pResBlock;
+
+  if (pBlockData->nRow == 0 || pBlockData->uid != pScanInfo->uid || pDumpInfo->allDumped ||
+      pDumpInfo->rowIndex < 0 || pDumpInfo->rowIndex >= pBlockData->nRow) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  // every row in the block is valid, the only reason to merge is the overlap with buffer or stt files
+  SDataBlockToLoadInfo info = {0};
+  getBlockToLoadInfo(&info, pBlockInfo, pScanInfo, keyInBuf, pReader);
+  if (info.overlapWithNeighborBlock || info.hasDupTs || info.overlapWithDelInfo || info.partiallyRequired) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t ts = pBlockData->aTSKEY[pDumpInfo->rowIndex];
+  if ((asc && ts <= pScanInfo->lastProcKey) || (!asc && ts >= pScanInfo->lastProcKey)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int64_t keyBound = getOverlapKeyOfFileBlock(pScanInfo, keyInBuf, asc);
+  if ((asc && ts >= keyBound) || (!asc && ts <= keyBound)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t code = copyBlockDataToSDataBlock(pReader, keyBound);
+  if (code != TSDB_CODE_SUCCESS || pResBlock->info.rows == 0) {
+    return code;
+  }
+
+  // record the last key value, the dump index has been moved to the next row
+  pScanInfo->lastProcKey = pBlockData->aTSKEY[pDumpInfo->rowIndex - step];
+  pReader->cost.bulkCopiedRows += pResBlock->info.rows;
+  return code;
+}
+
 static int32_t buildComposedDataBlock(STsdbReader* pReader) {
   int32_t             code = TSDB_CODE_SUCCESS;
   bool                asc = ASCENDING_TRAVERSE(pReader->info.order);
@@ -2316,7 +2430,7 @@ static int32_t buildComposedDataBlock(STsdbReader* pReader) {
   if (isCleanFileDataBlock(pReader, pBlockInfo, pBlockScanInfo, keyInBuf) && (pRecord->numRow <= cap)) {
     if (((asc && (pRecord->firstKey < keyInBuf.ts)) || (!asc && (pRecord->lastKey > keyInBuf.ts))) &&
         (pBlockScanInfo->sttKeyInfo.status == STT_FILE_NO_DATA)) {
-      code = copyBlockDataToSDataBlock(pReader);
+      code = copyBlockDataToSDataBlock(pReader, asc ? INT64_MAX : INT64_MIN);
       if (code) {
         goto _end;
       }
@@ -2330,6 +2444,14 @@ static int32_t buildComposedDataBlock(STsdbReader* pReader) {
   SBlockData* pBlockData = &pReader->status.fileBlockData;
   initSttBlockReader(pSttBlockReader, pBlockScanInfo, pReader);
 
+  // rows ahead of the data in buffer and stt files need no merge, copy them in a batch
+  if (pResBlock->info.rows == 0) {
+    code = copyNonOverlapRowsInFileBlock(pReader, pBlockScanInfo, pBlockInfo, keyInBuf);
+    if (code || pResBlock->info.rows > 0) {
+      goto _end;
+    }
+  }
+
   while (1) {
     bool hasBlockData = false;
     {
@@ -3776,6 +3898,9 @@ int32_t buildDataBlockFromBufImpl(STableBlockScanInfo* pBlockScanInfo, int64_t e
 int32_t tsdbSetTableList2(STsdbReader* pReader, const void* pTableList, int32_t num) {
   int32_t size = tSimpleHashGetSize(pReader->status.pTableMap);
 
+  // the sub readers are created with the new table list in the next scan
+  resetParallelScan(pReader, NULL);
+
   STableBlockScanInfo** p = NULL;
   int32_t               iter = 0;
 
@@ -4002,6 +4127,11 @@ int32_t tsdbReaderOpen2(void* pVnode, SQueryTableDataCond* pCond, void* pTableLi
     goto _err;
   }
 
+  code = initParallelScan(pReader, pCond);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _err;
+  }
+
   pReader->flag = READER_STATUS_SUSPEND;
   pReader->info.execMode = pCond->notLoadData? READER_EXEC_ROWS : READER_EXEC_DATA;
 
@@ -4026,6 +4156,7 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   }
 
   tsdbAcquireReader(pReader);
+  getStepReader(pReader)->status.lateLoad.pending = false;
 
   {
     if (pReader->innerReader[0] != NULL || pReader->innerReader[1] != NULL) {
@@ -4040,6 +4171,8 @@ void tsdbReaderClose2(STsdbReader* pReader) {
     }
   }
 
+  destroyParallelScan(pReader);
+
   SBlockLoadSuppInfo* pSupInfo = &pReader->suppInfo;
   TARRAY2_DESTROY(&pSupInfo->colAggArray, NULL);
   for (int32_t i = 0; i < pSupInfo->numOfCols; ++i) {
@@ -4053,6 +4186,8 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   }
 
   taosMemoryFree(pSupInfo->colId);
+  taosMemoryFree(pSupInfo->earlyColId);
+  taosMemoryFree(pSupInfo->lateColId);
   tBlockDataDestroy(&pReader->status.fileBlockData);
   cleanupDataBlockIterator(&pReader->status.blockIter);
 
@@ -4063,6 +4198,7 @@ void tsdbReaderClose2(STsdbReader* pReader) {
     pReader->status.pTableMap = NULL;
   }
 
+  destroyBlockPrefetcher(&pReader->prefetcher);
   if (pReader->pFileReader != NULL) {
     tsdbDataFileReaderClose(&pReader->pFileReader);
   }
@@ -4078,8 +4214,11 @@ void tsdbReaderClose2(STsdbReader* pReader) {
   destroySttBlockReader(pReader->status.pLDataIterArray, &pCost->sttCost);
   taosMemoryFreeClear(pReader->status.uidList.tableUidList);
 
+  // the snapshot of a sub reader is owned by the parallel scan
   qTrace("tsdb/reader-close: %p, untake snapshot", pReader);
-  tsdbUntakeReadSnap2(pReader, pReader->pReadSnap, true);
+  if (pReader->pScanReader == NULL) {
+    tsdbUntakeReadSnap2(pReader, pReader->pReadSnap, true);
+  }
   pReader->pReadSnap = NULL;
 
   tsem_destroy(&pReader->resumeAfterSuspend);
@@ -4092,13 +4231,14 @@ void tsdbReaderClose2(STsdbReader* pReader) {
       ", fileBlocks-load-time:%.2f ms, "
       "build in-memory-block-time:%.2f ms, sttBlocks:%" PRId64 ", sttBlocks-time:%.2f ms, sttStatisBlock:%" PRId64
       ", stt-statis-Block-time:%.2f ms, composed-blocks:%" PRId64
-      ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,createSkylineIterTime:%.2f "
-      "ms, initSttBlockReader:%.2fms, %s",
+      ", composed-blocks-time:%.2fms, bulk-copied-rows:%" PRId64 ", STableBlockScanInfo size:%.2f Kb, createTime:%.2f ms,createSkylineIterTime:%.2f "
+      "ms, initSttBlockReader:%.2fms, prefetch hit:%" PRId64 ", prefetch miss:%" PRId64 ", %s",
       pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime, pCost->numOfBlocks,
       pCost->blockLoadTime, pCost->buildmemBlock, pCost->sttCost.loadBlocks, pCost->sttCost.blockElapsedTime,
       pCost->sttCost.loadStatisBlocks, pCost->sttCost.statisElapsedTime, pCost->composedBlocks,
-      pCost->buildComposedBlockTime, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
-      pCost->createSkylineIterTime, pCost->initSttBlockReader, pReader->idStr);
+      pCost->buildComposedBlockTime, pCost->bulkCopiedRows, numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
+      pCost->createSkylineIterTime, pCost->initSttBlockReader, pCost->prefetchHit, pCost->prefetchMiss,
+      pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
 
@@ -4113,6 +4253,7 @@ static int32_t doSuspendCurrentReader(STsdbReader* pCurrentReader) {
   SReaderStatus* pStatus = &pCurrentReader->status;
 
   if (pStatus->loadFromFile) {
+    resetBlockPrefetcher(&pCurrentReader->prefetcher);
     tsdbDataFileReaderClose(&pCurrentReader->pFileReader);
 
     SReadCostSummary* pCost = &pCurrentReader->cost;
@@ -4186,6 +4327,12 @@ static int32_t tsdbSetQueryReseek(void* pQHandle) {
       return code;
     }
 
+    // the executor is applying the filter to a block whose late columns are not loaded yet
+    if (getStepReader(pReader)->status.lateLoad.pending) {
+      tsdbReleaseReader(pReader);
+      return TSDB_CODE_VND_QUERY_BUSY;
+    }
+
     tsdbReaderSuspend2(pReader);
     tsdbReleaseReader(pReader);
 
@@ -4198,6 +4345,72 @@ static int32_t tsdbSetQueryReseek(void* pQHandle) {
   }
 }
 
+/*
+ * The sub readers of a parallel scan share the snapshot of the scan. When the memory table is recycled, the snapshot is
+ * released once all the sub readers are suspended, and the first one resumed takes it again.
+ */
+static int32_t tsdbSetParallelScanReseek(void* pQHandle) {
+  STsdbReader*   pReader = pQHandle;
+  SParallelScan* pScan = pReader->pParallelScan;
+  int32_t        code = TSDB_CODE_SUCCESS;
+  int32_t        num = 0;
+
+  // the lock is held while the snapshot is taken, which is done with the lock of the buffer pool held
+  if (taosThreadMutexTryLock(&pScan->lock) != 0) {
+    return TSDB_CODE_VND_QUERY_BUSY;
+  }
+
+  for (; num < pScan->numOfReaders; ++num) {
+    STsdbReader* pSubReader = pScan->pSlots[num].pReader;
+    if (pSubReader != NULL && tsdbTryAcquireReader(pSubReader) != 0) {
+      code = TSDB_CODE_VND_QUERY_BUSY;
+      break;
+    }
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    for (int32_t i = 0; i < pScan->numOfReaders; ++i) {
+      STsdbReader* pSubReader = pScan->pSlots[i].pReader;
+      if (pSubReader != NULL && pSubReader->flag != READER_STATUS_SUSPEND) {
+        pSubReader->status.suspendInvoked = true;
+        doSuspendCurrentReader(pSubReader);
+        pSubReader->pReadSnap = NULL;
+        pSubReader->flag = READER_STATUS_SUSPEND;
+      }
+    }
+
+    tsdbUntakeReadSnap2(pReader, pScan->pSnap, false);
+    pScan->pSnap = NULL;
+    tsdbDebug("%p parallel scan suspended, %s", pReader, pReader->idStr);
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    if (pScan->pSlots[i].pReader != NULL) {
+      tsdbReleaseReader(pScan->pSlots[i].pReader);
+    }
+  }
+
+  taosThreadMutexUnlock(&pScan->lock);
+  return code;
+}
+
+// the lock of SParallelScan should be held
+int32_t tsdbTakeParallelScanSnap(STsdbReader* pReader) {
+  SParallelScan* pScan = pReader->pParallelScan;
+  if (pScan->pSnap != NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  return tsdbTakeReadSnap2(pReader, tsdbSetParallelScanReseek, &pScan->pSnap);
+}
+
+// the lock of SParallelScan should be held
+void tsdbUntakeParallelScanSnap(STsdbReader* pReader) {
+  SParallelScan* pScan = pReader->pParallelScan;
+  tsdbUntakeReadSnap2(pReader, pScan->pSnap, true);
+  pScan->pSnap = NULL;
+}
+
 int32_t tsdbReaderResume2(STsdbReader* pReader) {
   int32_t               code = 0;
   STableBlockScanInfo** pBlockScanInfo = pReader->status.pTableIter;
@@ -4206,7 +4419,16 @@ int32_t tsdbReaderResume2(STsdbReader* pReader) {
   int32_t numOfTables = tSimpleHashGetSize(pReader->status.pTableMap);
   if (numOfTables > 0) {
     qTrace("tsdb/reader: %p, take snapshot", pReader);
-    code = tsdbTakeReadSnap2(pReader, tsdbSetQueryReseek, &pReader->pReadSnap);
+    if (pReader->pScanReader != NULL) {
+      SParallelScan* pScan = pReader->pScanReader->pParallelScan;
+      taosThreadMutexLock(&pScan->lock);
+      code = tsdbTakeParallelScanSnap(pReader->pScanReader);
+      pReader->pReadSnap = pScan->pSnap;
+      taosThreadMutexUnlock(&pScan->lock);
+    } else {
+      code = tsdbTakeReadSnap2(pReader, tsdbSetQueryReseek, &pReader->pReadSnap);
+    }
+
     if (code != TSDB_CODE_SUCCESS) {
       goto _err;
     }
@@ -4381,6 +4603,14 @@ int32_t tsdbNextDataBlock2(STsdbReader* pReader, bool* hasNext) {
     return (pReader->code != TSDB_CODE_SUCCESS) ? pReader->code : code;
   }
 
+  // the sub readers share the snapshot of the scan, the reader itself is resumed only if it falls back to serial scan
+  if (PARALLEL_SCAN_ACTIVE(pReader)) {
+    code = nextParallelScanBlock(pReader, hasNext);
+    if (code != TSDB_CODE_SUCCESS || PARALLEL_SCAN_ACTIVE(pReader)) {
+      return code;
+    }
+  }
+
   SReaderStatus* pStatus = &pReader->status;
 
   // NOTE: the following codes is used to perform test for suspend/resume for tsdbReader when it blocks the commit
@@ -4396,6 +4626,14 @@ int32_t tsdbNextDataBlock2(STsdbReader* pReader, bool* hasNext) {
   code = tsdbAcquireReader(pReader);
   qTrace("tsdb/read: %p, take read mutex, code: %d", pReader, code);
 
+  // the late columns of the last block are dropped if the filter did not finish, the partially dumped block is then
+  // loaded again as a whole
+  code = doFinishLateLoad(pReader, false);
+  if (code != TSDB_CODE_SUCCESS) {
+    tsdbReleaseReader(pReader);
+    return code;
+  }
+
   if (pReader->flag == READER_STATUS_SUSPEND) {
     code = tsdbReaderResume2(pReader);
     if (code != TSDB_CODE_SUCCESS) {
@@ -4619,8 +4857,66 @@ int32_t tsdbRetrieveDatablockSMA2(STsdbReader* pReader, SSDataBlock* pDataBlock,
   return code;
 }
 
+// split the queried data columns into the ones required by the filter, and the others
+static int32_t initLateLoadCols(SBlockLoadSuppInfo* pSup, SArray* pIdList) {
+  int32_t numOfCols = pSup->numOfCols - 1;
+
+  pSup->lateColInit = true;
+  pSup->earlyColId = taosMemoryMalloc(sizeof(int16_t) * numOfCols);
+  pSup->lateColId = taosMemoryMalloc(sizeof(int16_t) * numOfCols);
+  if (pSup->earlyColId == NULL || pSup->lateColId == NULL) {
+    taosMemoryFreeClear(pSup->earlyColId);
+    taosMemoryFreeClear(pSup->lateColId);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (int32_t i = 1; i < pSup->numOfCols; ++i) {
+    bool early = false;
+    for (int32_t j = 0; j < taosArrayGetSize(pIdList); ++j) {
+      if (*(int16_t*)taosArrayGet(pIdList, j) == pSup->colId[i]) {
+        early = true;
+        break;
+      }
+    }
+
+    if (early) {
+      pSup->earlyColId[pSup->numOfEarlyCols++] = pSup->colId[i];
+    } else {
+      pSup->lateColId[pSup->numOfLateCols++] = pSup->colId[i];
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the late columns of a file block are loaded only when it is not filtered out, which requires the whole remain rows
+// of the block can be dumped at once, since the rows are decoded by column chunk, not by row range.
+static bool lateLoadApplicable(STsdbReader* pReader, SArray* pIdList) {
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  if (pIdList == NULL || pReader->code != TSDB_CODE_SUCCESS) {
+    return false;
+  }
+
+  if (!pSup->lateColInit) {
+    int32_t code = initLateLoadCols(pSup, pIdList);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbWarn("%p failed to init late load columns, code:%s, %s", pReader, tstrerror(code), pReader->idStr);
+      return false;
+    }
+  }
+
+  if (pSup->numOfLateCols == 0) {
+    return false;
+  }
+
+  SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(&pReader->status.blockIter);
+  return pBlockInfo != NULL && pBlockInfo->record.numRow <= pReader->resBlockInfo.capacity;
+}
+
 static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
   SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SLateLoadInfo*      pLateLoad = &pStatus->lateLoad;
   int32_t             code = TSDB_CODE_SUCCESS;
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
 
@@ -4633,14 +4929,21 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
     return NULL;
   }
 
-  code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+  if (pLateLoad->pending) {
+    pLateLoad->rows = 0;
+    code = doLoadFileBlockColumns(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid,
+                                  pSup->earlyColId, pSup->numOfEarlyCols);
+  } else {
+    code = doLoadFileBlockData(pReader, &pStatus->blockIter, &pStatus->fileBlockData, pBlockScanInfo->uid);
+  }
+
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataReset(&pStatus->fileBlockData);
     terrno = code;
     return NULL;
   }
 
-  code = copyBlockDataToSDataBlock(pReader);
+  code = copyBlockDataToSDataBlock(pReader, ASCENDING_TRAVERSE(pReader->info.order) ? INT64_MAX : INT64_MIN);
   if (code != TSDB_CODE_SUCCESS) {
     tBlockDataReset(&pStatus->fileBlockData);
     terrno = code;
@@ -4650,22 +4953,102 @@ static SSDataBlock* doRetrieveDataBlock(STsdbReader* pReader) {
   return pReader->resBlockInfo.pResBlock;
 }
 
-SSDataBlock* tsdbRetrieveDataBlock2(STsdbReader* pReader, SArray* pIdList) {
-  STsdbReader* pTReader = pReader;
+// copy the late columns of the rows that are dumped by the last retrieve, if they are required
+static int32_t doRetrieveLateCols(STsdbReader* pReader, bool required) {
+  SReaderStatus*      pStatus = &pReader->status;
+  SBlockLoadSuppInfo* pSup = &pReader->suppInfo;
+  SLateLoadInfo*      pLateLoad = &pStatus->lateLoad;
+  SBlockData*         pBlockData = &pStatus->fileBlockData;
+  SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(&pStatus->blockIter);
+  int64_t             st = taosGetTimestampUs();
+  int32_t             code = TSDB_CODE_SUCCESS;
+
+  if (pLateLoad->rows == 0 || pBlockInfo == NULL || pReader->info.pSchema == NULL) {
+    return code;
+  }
+
+  if (required) {
+    tBlockDataReset(pBlockData);
+    code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, &pBlockInfo->record, pBlockData,
+                                             pReader->info.pSchema, pSup->lateColId, pSup->numOfLateCols);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbError("%p failed to load late columns of file block, global index:%d, uid:%" PRIu64 ", code:%s %s", pReader,
+                pStatus->blockIter.index, pBlockInfo->uid, tstrerror(code), pReader->idStr);
+      return code;
+    }
+
+    SFileBlockDumpInfo dumpInfo = {.rowIndex = pLateLoad->rowIndex};
+    code = copyBlockColumns(pReader, &dumpInfo, pLateLoad->rows, pSup->lateColId, pSup->numOfLateCols);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  // the partially dumped block is merged with other data later, which requires all columns
+  if (!pStatus->fBlockDumpInfo.allDumped) {
+    tBlockDataReset(pBlockData);
+    code = tsdbDataFileReadBlockDataByColumn(pReader->pFileReader, &pBlockInfo->record, pBlockData,
+                                             pReader->info.pSchema, &pSup->colId[1], pSup->numOfCols - 1);
+  }
+
+  pReader->cost.blockLoadTime += (taosGetTimestampUs() - st) / 1000.0;
+  return code;
+}
+
+static STsdbReader* getStepReader(STsdbReader* pReader) {
   if (pReader->type == TIMEWINDOW_RANGE_EXTERNAL) {
     if (pReader->step == EXTERNAL_ROWS_PREV) {
-      pTReader = pReader->innerReader[0];
+      return pReader->innerReader[0];
     } else if (pReader->step == EXTERNAL_ROWS_NEXT) {
-      pTReader = pReader->innerReader[1];
+      return pReader->innerReader[1];
     }
   }
 
+  return pReader;
+}
+
+// finish the late load of the block returned by the last retrieve, the read mutex should be held
+static int32_t doFinishLateLoad(STsdbReader* pReader, bool required) {
+  STsdbReader*   pTReader = getStepReader(pReader);
+  SReaderStatus* pStatus = &pTReader->status;
+  int32_t        code = TSDB_CODE_SUCCESS;
+
+  if (!pStatus->lateLoad.pending) {
+    return code;
+  }
+
+  // the file block is gone with the snapshot once the reader is suspended, which is refused by tsdbSetQueryReseek
+  if (pReader->flag == READER_STATUS_SUSPEND) {
+    tsdbError("%p late columns lost since reader is suspended, %s", pReader, pReader->idStr);
+    code = TSDB_CODE_APP_ERROR;
+  } else {
+    code = doRetrieveLateCols(pTReader, required);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    tBlockDataReset(&pStatus->fileBlockData);
+  }
+
+  pStatus->lateLoad.pending = false;
+  return code;
+}
+
+SSDataBlock* tsdbRetrieveDataBlock2(STsdbReader* pReader, SArray* pIdList) {
+  STsdbReader* pTReader = getStepReader(pReader);
+
   SReaderStatus* pStatus = &pTReader->status;
   if (pStatus->composedDataBlock || pReader->info.execMode == READER_EXEC_ROWS) {
     return pTReader->resBlockInfo.pResBlock;
   }
 
+  // only the columns in pIdList are loaded, the others are loaded by tsdbRetrieveLateCols2 after the filter is applied.
+  // The read mutex is not held in between, while the reader is not suspended since the late load is pending.
+  pStatus->lateLoad.pending = lateLoadApplicable(pTReader, pIdList);
+
   SSDataBlock* ret = doRetrieveDataBlock(pTReader);
+  if (ret == NULL || pStatus->lateLoad.rows == 0) {
+    pStatus->lateLoad.pending = false;
+  }
 
   qTrace("tsdb/read-retrieve: %p, unlock read mutex", pReader);
   tsdbReleaseReader(pReader);
@@ -4673,12 +5056,34 @@ SSDataBlock* tsdbRetrieveDataBlock2(STsdbReader* pReader, SArray* pIdList) {
   return ret;
 }
 
+int32_t tsdbRetrieveLateCols2(STsdbReader* pReader, bool required) {
+  if (!getStepReader(pReader)->status.lateLoad.pending) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  tsdbAcquireReader(pReader);
+  qTrace("tsdb/read-retrieve-late: %p, take read mutex", pReader);
+
+  int32_t code = doFinishLateLoad(pReader, required);
+
+  qTrace("tsdb/read-retrieve-late: %p, unlock read mutex", pReader);
+  tsdbReleaseReader(pReader);
+
+  return code;
+}
+
 int32_t tsdbReaderReset2(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   int32_t code = TSDB_CODE_SUCCESS;
 
+  // the sub readers are closed, and created with the new condition in the next scan
+  resetParallelScan(pReader, pCond);
+
   qTrace("tsdb/reader-reset: %p, take read mutex", pReader);
   tsdbAcquireReader(pReader);
 
+  // the block of the late load is not scanned any more
+  getStepReader(pReader)->status.lateLoad.pending = false;
+
   if (pReader->flag == READER_STATUS_SUSPEND) {
     code = tsdbReaderResume2(pReader);
     if (code != TSDB_CODE_SUCCESS) {
@@ -4706,6 +5111,7 @@ int32_t tsdbReaderReset2(STsdbReader* pReader, SQueryTableDataCond* pCond) {
   memset(&pReader->suppInfo.tsColAgg, 0, sizeof(SColumnDataAgg));
 
   pReader->suppInfo.tsColAgg.colId = PRIMARYKEY_TIMESTAMP_COL_ID;
+  resetBlockPrefetcher(&pReader->prefetcher);
   tsdbDataFileReaderClose(&pReader->pFileReader);
 
   int32_t numOfTables = tSimpleHashGetSize(pStatus->pTableMap);
@@ -5080,7 +5486,9 @@ void tsdbUntakeReadSnap2(STsdbReader* pReader, STsdbReadSnap* pSnap, bool proact
 void tsdbReaderSetId2(STsdbReader* pReader, const char* idstr) {
   taosMemoryFreeClear(pReader->idStr);
   pReader->idStr = taosStrdup(idstr);
-  pReader->status.fileIter.pSttBlockReader->mergeTree.idStr = pReader->idStr;
+  if (pReader->status.fileIter.pSttBlockReader != NULL) {
+    pReader->status.fileIter.pSttBlockReader->mergeTree.idStr = pReader->idStr;
+  }
 }
 
 void tsdbReaderSetCloseFlag(STsdbReader* pReader) { /*pReader->code = TSDB_CODE_TSC_QUERY_CANCELLED;*/
@@ -21,6 +21,7 @@
 #include "tsdbMerge.h"
 #include "tsdbUtil2.h"
 #include "tsimplehash.h"
+#include "vnd.h"
 
 static bool overlapWithDelSkylineWithoutVer(STableBlockScanInfo* pBlockScanInfo, const SBrinRecord* pRecord,
                                             int32_t order);
@@ -494,6 +495,671 @@ bool blockIteratorNext(SDataBlockIter* pBlockIter, const char* idStr) {
   return true;
 }
 
+int32_t initBlockPrefetcher(SBlockPrefetcher* pPrefetcher, int32_t depth, const char* idStr) {
+  pPrefetcher->idStr = idStr;
+  pPrefetcher->depth = 0;
+
+  // prefetch is disabled, or the vnode module is not initialized
+  if (depth <= 0 || vnodeAsyncHandle[2] == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pPrefetcher->pSlots = taosMemoryCalloc(depth, sizeof(SBlockPrefetchSlot));
+  if (pPrefetcher->pSlots == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pPrefetcher->depth = depth;
+  for (int32_t i = 0; i < depth; ++i) {
+    SBlockPrefetchSlot* pSlot = &pPrefetcher->pSlots[i];
+    pSlot->pPrefetcher = pPrefetcher;
+    pSlot->status = BLOCK_PREFETCH_IDLE;
+
+    int32_t code = tBlockDataCreate(&pSlot->data);
+    if (code != TSDB_CODE_SUCCESS) {
+      destroyBlockPrefetcher(pPrefetcher);
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+void resetBlockPrefetcher(SBlockPrefetcher* pPrefetcher) {
+  if (pPrefetcher->depth <= 0) {
+    return;
+  }
+
+  // cancel the waiting tasks, and wait for the running one to complete
+  if (VNODE_ASYNC_VALID_CHANNEL_ID(pPrefetcher->channelId)) {
+    vnodeAChannelDestroy(vnodeAsyncHandle[2], pPrefetcher->channelId, true);
+    pPrefetcher->channelId = 0;
+  }
+
+  for (int32_t i = 0; i < pPrefetcher->depth; ++i) {
+    atomic_store_8(&pPrefetcher->pSlots[i].status, BLOCK_PREFETCH_IDLE);
+  }
+
+  tsdbDataFileReaderClose(&pPrefetcher->pFileReader);
+  pPrefetcher->dataFileName = NULL;
+}
+
+void destroyBlockPrefetcher(SBlockPrefetcher* pPrefetcher) {
+  if (pPrefetcher->pSlots == NULL) {
+    return;
+  }
+
+  resetBlockPrefetcher(pPrefetcher);
+  for (int32_t i = 0; i < pPrefetcher->depth; ++i) {
+    tBlockDataDestroy(&pPrefetcher->pSlots[i].data);
+  }
+
+  taosMemoryFreeClear(pPrefetcher->pSlots);
+  pPrefetcher->depth = 0;
+}
+
+void setBlockPrefetcherFile(SBlockPrefetcher* pPrefetcher, const char* pDataFileName,
+                            const SDataFileReaderConfig* pConf) {
+  resetBlockPrefetcher(pPrefetcher);
+  if (pPrefetcher->depth <= 0) {
+    return;
+  }
+
+  // the file is opened when the first block is about to be prefetched
+  pPrefetcher->dataFileName = pDataFileName;
+  pPrefetcher->conf = *pConf;
+  pPrefetcher->conf.bufArr = NULL;
+}
+
+static int32_t doPrefetchFileBlock(void* arg) {
+  SBlockPrefetchSlot* pSlot = arg;
+  SBlockPrefetcher*   pPrefetcher = pSlot->pPrefetcher;
+
+  tBlockDataReset(&pSlot->data);
+  int32_t code = tsdbDataFileReadBlockDataByColumn(pPrefetcher->pFileReader, &pSlot->record, &pSlot->data,
+                                                   pPrefetcher->pSchema, pSlot->colId, pSlot->numOfCols);
+
+  // the block data and the code are published to the query thread by the store of the status
+  atomic_store_32(&pSlot->code, code);
+  atomic_store_8(&pSlot->status, BLOCK_PREFETCH_READY);
+  return code;
+}
+
+static SBlockPrefetchSlot* getPrefetchSlot(SBlockPrefetcher* pPrefetcher, const SBrinRecord* pRecord) {
+  for (int32_t i = 0; i < pPrefetcher->depth; ++i) {
+    SBlockPrefetchSlot* pSlot = &pPrefetcher->pSlots[i];
+    if (atomic_load_8(&pSlot->status) != BLOCK_PREFETCH_IDLE && pSlot->record.uid == pRecord->uid &&
+        pSlot->record.blockOffset == pRecord->blockOffset) {
+      return pSlot;
+    }
+  }
+
+  return NULL;
+}
+
+static SBlockPrefetchSlot* getIdlePrefetchSlot(SBlockPrefetcher* pPrefetcher, int32_t index, bool asc) {
+  SBlockPrefetchSlot* pIdle = NULL;
+
+  for (int32_t i = 0; i < pPrefetcher->depth; ++i) {
+    SBlockPrefetchSlot* pSlot = &pPrefetcher->pSlots[i];
+
+    // the block iterator has passed this block without loading it, e.g., only the SMA is required
+    bool passed = asc ? (pSlot->index <= index) : (pSlot->index >= index);
+    if (passed && atomic_load_8(&pSlot->status) == BLOCK_PREFETCH_READY) {
+      atomic_store_8(&pSlot->status, BLOCK_PREFETCH_IDLE);
+    }
+
+    if (pIdle == NULL && atomic_load_8(&pSlot->status) == BLOCK_PREFETCH_IDLE) {
+      pIdle = pSlot;
+    }
+  }
+
+  return pIdle;
+}
+
+void scheduleBlockPrefetch(SBlockPrefetcher* pPrefetcher, SDataBlockIter* pBlockIter, STSchema* pSchema,
+                           int16_t* colId, int32_t numOfCols) {
+  if (pPrefetcher->depth <= 0 || pPrefetcher->dataFileName == NULL || pSchema == NULL) {
+    return;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pPrefetcher->pFileReader == NULL) {
+    const char* filesName[TSDB_FTYPE_MAX] = {0};
+    filesName[TSDB_FTYPE_DATA] = pPrefetcher->dataFileName;
+
+    code = tsdbDataFileReaderOpen(filesName, &pPrefetcher->conf, &pPrefetcher->pFileReader);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbWarn("failed to open data file for prefetch, code:%s, %s", tstrerror(code), pPrefetcher->idStr);
+      tsdbDataFileReaderClose(&pPrefetcher->pFileReader);
+      pPrefetcher->dataFileName = NULL;
+      return;
+    }
+  }
+
+  if (!VNODE_ASYNC_VALID_CHANNEL_ID(pPrefetcher->channelId)) {
+    code = vnodeAChannelInit(vnodeAsyncHandle[2], &pPrefetcher->channelId);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbWarn("failed to init prefetch channel, code:%s, %s", tstrerror(code), pPrefetcher->idStr);
+      return;
+    }
+  }
+
+  pPrefetcher->pSchema = pSchema;
+
+  bool    asc = ASCENDING_TRAVERSE(pBlockIter->order);
+  int32_t step = asc ? 1 : -1;
+
+  for (int32_t i = 1; i <= pPrefetcher->depth; ++i) {
+    int32_t index = pBlockIter->index + i * step;
+    if (index < 0 || index >= pBlockIter->numOfBlocks) {
+      break;
+    }
+
+    SFileDataBlockInfo* pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+    if (getPrefetchSlot(pPrefetcher, &pBlockInfo->record) != NULL) {
+      continue;
+    }
+
+    SBlockPrefetchSlot* pSlot = getIdlePrefetchSlot(pPrefetcher, pBlockIter->index, asc);
+    if (pSlot == NULL) {
+      break;
+    }
+
+    pSlot->record = pBlockInfo->record;
+    pSlot->index = index;
+    pSlot->colId = colId;
+    pSlot->numOfCols = numOfCols;
+    atomic_store_32(&pSlot->code, TSDB_CODE_SUCCESS);
+    atomic_store_8(&pSlot->status, BLOCK_PREFETCH_LOADING);
+
+    code = vnodeAsyncC(vnodeAsyncHandle[2], pPrefetcher->channelId, EVA_PRIORITY_NORMAL, doPrefetchFileBlock, NULL,
+                       pSlot, &pSlot->taskId);
+    if (code != TSDB_CODE_SUCCESS) {
+      atomic_store_8(&pSlot->status, BLOCK_PREFETCH_IDLE);
+      break;
+    }
+  }
+}
+
+bool takePrefetchedBlock(SBlockPrefetcher* pPrefetcher, const SBrinRecord* pRecord, const int16_t* colId,
+                         SBlockData* pBlockData, SReadCostSummary* pCost) {
+  if (pPrefetcher->depth <= 0) {
+    return false;
+  }
+
+  SBlockPrefetchSlot* pSlot = getPrefetchSlot(pPrefetcher, pRecord);
+  if (pSlot == NULL) {
+    pCost->prefetchMiss += 1;
+    return false;
+  }
+
+  if (atomic_load_8(&pSlot->status) == BLOCK_PREFETCH_LOADING) {
+    vnodeAWait(vnodeAsyncHandle[2], pSlot->taskId);
+  }
+
+  // fall back to the synchronous load if the prefetch task failed or was cancelled, or other columns are required
+  bool hit = (atomic_load_8(&pSlot->status) == BLOCK_PREFETCH_READY) &&
+             (atomic_load_32(&pSlot->code) == TSDB_CODE_SUCCESS) && (pSlot->colId == colId);
+  if (hit) {
+    SBlockData tmp = *pBlockData;
+    *pBlockData = pSlot->data;
+    pSlot->data = tmp;
+    pCost->prefetchHit += 1;
+  } else {
+    pCost->prefetchMiss += 1;
+  }
+
+  atomic_store_8(&pSlot->status, BLOCK_PREFETCH_IDLE);
+  return hit;
+}
+
+#define PARALLEL_SCAN_QUEUE_DEPTH 4  // max number of blocks produced ahead by each sub reader
+
+int32_t initParallelScan(STsdbReader* pReader, const SQueryTableDataCond* pCond) {
+  // only the plain scan of data blocks is split, and the vnode module should be initialized
+  if (pCond->numOfParallel <= 1 || pCond->type != TIMEWINDOW_RANGE_CONTAINED || pCond->notLoadData ||
+      vnodeAsyncHandle[3] == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SParallelScan* pScan = taosMemoryCalloc(1, sizeof(SParallelScan));
+  if (pScan == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the column list of the query condition is owned by the caller, keep a copy for the sub readers
+  pScan->cond = *pCond;
+  pScan->cond.colList = taosMemoryMalloc(sizeof(SColumnInfo) * pCond->numOfCols);
+  pScan->cond.pSlotList = NULL;
+  if (pScan->cond.colList == NULL) {
+    taosMemoryFree(pScan);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  memcpy(pScan->cond.colList, pCond->colList, sizeof(SColumnInfo) * pCond->numOfCols);
+  if (pCond->pSlotList != NULL) {
+    pScan->cond.pSlotList = taosMemoryMalloc(sizeof(int32_t) * pCond->numOfCols);
+    if (pScan->cond.pSlotList == NULL) {
+      taosMemoryFree(pScan->cond.colList);
+      taosMemoryFree(pScan);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    memcpy(pScan->cond.pSlotList, pCond->pSlotList, sizeof(int32_t) * pCond->numOfCols);
+  }
+
+  pScan->cond.numOfParallel = 0;
+  pScan->maxReaders = pCond->numOfParallel;
+  pScan->unordered = pCond->unordered;
+  taosThreadMutexInit(&pScan->lock, NULL);
+  taosThreadCondInit(&pScan->notEmpty, NULL);
+
+  pReader->pParallelScan = pScan;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void destroyBlockList(SArray* pBlocks) {
+  for (int32_t i = 0; i < taosArrayGetSize(pBlocks); ++i) {
+    blockDataDestroy(*(SSDataBlock**)taosArrayGet(pBlocks, i));
+  }
+  taosArrayDestroy(pBlocks);
+}
+
+static void stopParallelScan(STsdbReader* pReader) {
+  SParallelScan* pScan = pReader->pParallelScan;
+
+  taosThreadMutexLock(&pScan->lock);
+  pScan->stop = true;
+  taosThreadMutexUnlock(&pScan->lock);
+
+  // cancel the waiting tasks, and wait for the running ones to complete
+  for (int32_t i = 0; i < pScan->numOfReaders; ++i) {
+    SSubReaderSlot* pSlot = &pScan->pSlots[i];
+    if (VNODE_ASYNC_VALID_CHANNEL_ID(pSlot->channelId)) {
+      vnodeAChannelDestroy(vnodeAsyncHandle[3], pSlot->channelId, true);
+    }
+  }
+
+  // the shared snapshot is not released by the recycle of the memory table while the sub readers are closed
+  taosThreadMutexLock(&pScan->lock);
+  for (int32_t i = 0; i < pScan->numOfReaders; ++i) {
+    SSubReaderSlot* pSlot = &pScan->pSlots[i];
+    tsdbReaderClose2(pSlot->pReader);
+    blockDataDestroy(pSlot->pResBlock);
+    destroyBlockList(pSlot->pBlocks);
+    destroyBlockList(pSlot->pFreeBlocks);
+  }
+
+  tsdbUntakeParallelScanSnap(pReader);
+  taosThreadMutexUnlock(&pScan->lock);
+
+  taosMemoryFreeClear(pScan->pSlots);
+  pScan->numOfReaders = 0;
+  pScan->current = 0;
+  pScan->started = false;
+  pScan->serial = false;
+  pScan->stop = false;
+}
+
+void destroyParallelScan(STsdbReader* pReader) {
+  SParallelScan* pScan = pReader->pParallelScan;
+  if (pScan == NULL) {
+    return;
+  }
+
+  stopParallelScan(pReader);
+  taosMemoryFree(pScan->cond.colList);
+  taosMemoryFree(pScan->cond.pSlotList);
+  taosThreadCondDestroy(&pScan->notEmpty);
+  taosThreadMutexDestroy(&pScan->lock);
+  taosMemoryFreeClear(pReader->pParallelScan);
+}
+
+void resetParallelScan(STsdbReader* pReader, const SQueryTableDataCond* pCond) {
+  SParallelScan* pScan = pReader->pParallelScan;
+  if (pScan == NULL) {
+    return;
+  }
+
+  stopParallelScan(pReader);
+  if (pCond != NULL) {
+    pScan->cond.twindows = pCond->twindows;
+    pScan->cond.order = pCond->order;
+  }
+}
+
+/*
+ * Move the columns loaded by the reader from pSrc to pDst, which gives its own columns to pSrc in exchange, instead of
+ * copying the rows. The blocks are created from the same result block, so only the capacity may differ.
+ */
+static int32_t handOverBlock(SSDataBlock* pDst, SSDataBlock* pSrc, const SBlockLoadSuppInfo* pSup) {
+  uint32_t capacity = TMAX(pDst->info.capacity, pSrc->info.capacity);
+  int32_t  code = blockDataEnsureCapacity(pDst, capacity);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = blockDataEnsureCapacity(pSrc, capacity);
+  }
+
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  for (int32_t i = 0; i < pSup->numOfCols; ++i) {
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, pSup->slotId[i]);
+    SColumnInfoData* pSrcCol = taosArrayGet(pSrc->pDataBlock, pSup->slotId[i]);
+    SColumnInfoData  col = *pDstCol;
+    *pDstCol = *pSrcCol;
+    *pSrcCol = col;
+  }
+
+  pDst->info = pSrc->info;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t doScanSubReader(void* arg) {
+  SSubReaderSlot* pSlot = arg;
+  SParallelScan*  pScan = pSlot->pScan;
+  int32_t         code = TSDB_CODE_SUCCESS;
+  bool            hasNext = false;
+
+  while (1) {
+    code = tsdbNextDataBlock2(pSlot->pReader, &hasNext);
+    if (code != TSDB_CODE_SUCCESS || !hasNext) {
+      break;
+    }
+
+    SSDataBlock* pBlock = tsdbRetrieveDataBlock2(pSlot->pReader, NULL);
+    if (pBlock == NULL) {
+      code = terrno;
+      break;
+    }
+
+    // the result block is overwritten by the next block of the sub reader, hand it over to a block returned before
+    SSDataBlock* pNext = NULL;
+    taosThreadMutexLock(&pScan->lock);
+    if (taosArrayGetSize(pSlot->pFreeBlocks) > 0) {
+      pNext = *(SSDataBlock**)taosArrayPop(pSlot->pFreeBlocks);
+    }
+    taosThreadMutexUnlock(&pScan->lock);
+
+    if (pNext == NULL) {
+      pNext = createOneDataBlock(pBlock, false);
+      if (pNext == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+    }
+
+    code = handOverBlock(pNext, pBlock, &pSlot->pReader->suppInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      blockDataDestroy(pNext);
+      break;
+    }
+
+    taosThreadMutexLock(&pScan->lock);
+    if (taosArrayPush(pSlot->pBlocks, &pNext) == NULL) {
+      taosThreadMutexUnlock(&pScan->lock);
+      blockDataDestroy(pNext);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      break;
+    }
+
+    // do not block the worker when the queue is full, the task is scheduled again once a block is taken
+    bool yield = pScan->stop || taosArrayGetSize(pSlot->pBlocks) >= PARALLEL_SCAN_QUEUE_DEPTH;
+    if (yield) {
+      pSlot->status = SUB_READER_IDLE;
+    }
+
+    taosThreadCondSignal(&pScan->notEmpty);
+    taosThreadMutexUnlock(&pScan->lock);
+
+    if (yield) {
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
+  taosThreadMutexLock(&pScan->lock);
+  pSlot->code = code;
+  pSlot->status = SUB_READER_DONE;
+  taosThreadCondSignal(&pScan->notEmpty);
+  taosThreadMutexUnlock(&pScan->lock);
+  return code;
+}
+
+// the lock of SParallelScan should be held
+static void scheduleSubReader(SSubReaderSlot* pSlot) {
+  if (pSlot->pScan->stop || pSlot->status != SUB_READER_IDLE) {
+    return;
+  }
+
+  pSlot->status = SUB_READER_RUNNING;
+  int32_t code = vnodeAsyncC(vnodeAsyncHandle[3], pSlot->channelId, EVA_PRIORITY_NORMAL, doScanSubReader, NULL, pSlot,
+                             &pSlot->taskId);
+  if (code != TSDB_CODE_SUCCESS) {
+    pSlot->code = code;
+    pSlot->status = SUB_READER_DONE;
+  }
+}
+
+static int32_t openSubReader(STsdbReader* pReader, SSubReaderSlot* pSlot, STableKeyInfo* pList, int32_t numOfTables) {
+  SQueryTableDataCond cond = pReader->pParallelScan->cond;
+  cond.twindows = pSlot->window;
+  cond.order = pReader->info.order;
+
+  pSlot->pBlocks = taosArrayInit(PARALLEL_SCAN_QUEUE_DEPTH, POINTER_BYTES);
+  pSlot->pFreeBlocks = taosArrayInit(PARALLEL_SCAN_QUEUE_DEPTH, POINTER_BYTES);
+  pSlot->pResBlock = createOneDataBlock(pReader->resBlockInfo.pResBlock, false);
+  if (pSlot->pBlocks == NULL || pSlot->pFreeBlocks == NULL || pSlot->pResBlock == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = tsdbReaderOpen2(pReader->pTsdb->pVnode, &cond, pList, numOfTables, pSlot->pResBlock,
+                                 (void**)&pSlot->pReader, pReader->idStr, NULL);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  // the sub reader takes the snapshot of the scan when it is resumed
+  pSlot->pReader->pScanReader = pReader;
+
+  return vnodeAChannelInit(vnodeAsyncHandle[3], &pSlot->channelId);
+}
+
+static int32_t startParallelScan(STsdbReader* pReader) {
+  SParallelScan* pScan = pReader->pParallelScan;
+  STsdb*         pTsdb = pReader->pTsdb;
+  STimeWindow*   pWindow = &pReader->info.window;
+  int32_t        numOfTables = tSimpleHashGetSize(pReader->status.pTableMap);
+  int32_t        code = TSDB_CODE_SUCCESS;
+
+  pScan->started = true;
+
+  // the notification and fileset delimited output depend on the fileset order of one reader
+  if (numOfTables == 0 || pReader->notifyFn != NULL || pReader->bFilesetDelimited) {
+    pScan->serial = true;
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SArray* pFids = taosArrayInit(16, sizeof(int32_t));
+  if (pFids == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the filesets are split by the snapshot shared by the sub readers
+  taosThreadMutexLock(&pScan->lock);
+  code = tsdbTakeParallelScanSnap(pReader);
+  if (code == TSDB_CODE_SUCCESS) {
+    STFileSet* pFileSet = NULL;
+    TARRAY2_FOREACH(pScan->pSnap->pfSetArray, pFileSet) {
+      TSKEY minKey = 0, maxKey = 0;
+      tsdbFidKeyRange(pFileSet->fid, pTsdb->keepCfg.days, pTsdb->keepCfg.precision, &minKey, &maxKey);
+      if (maxKey >= pWindow->skey && minKey <= pWindow->ekey && taosArrayPush(pFids, &pFileSet->fid) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        break;
+      }
+    }
+  }
+  taosThreadMutexUnlock(&pScan->lock);
+
+  int32_t        numOfFiles = taosArrayGetSize(pFids);
+  int32_t        num = TMIN(pScan->maxReaders, numOfFiles);
+  STableKeyInfo* pList = NULL;
+  if (code != TSDB_CODE_SUCCESS || num <= 1) {
+    pScan->serial = (code == TSDB_CODE_SUCCESS);
+    goto _end;
+  }
+
+  pList = taosMemoryCalloc(numOfTables, sizeof(STableKeyInfo));
+  pScan->pSlots = taosMemoryCalloc(num, sizeof(SSubReaderSlot));
+  if (pList == NULL || pScan->pSlots == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  for (int32_t i = 0; i < numOfTables; ++i) {
+    pList[i].uid = pReader->status.uidList.tableUidList[i];
+  }
+
+  // sub reader i scans the filesets in [first, next) of the ascending fid list, the data in the memory table and the
+  // gaps between filesets are assigned to the sub reader covering the time range, so the windows are contiguous.
+  bool asc = ASCENDING_TRAVERSE(pReader->info.order);
+  pScan->numOfReaders = num;
+  for (int32_t i = 0; i < num && code == TSDB_CODE_SUCCESS; ++i) {
+    int32_t first = i * numOfFiles / num;
+    int32_t next = (i + 1) * numOfFiles / num;
+    TSKEY   skey = pWindow->skey, ekey = pWindow->ekey, key = 0;
+
+    if (i > 0) {
+      tsdbFidKeyRange(*(int32_t*)taosArrayGet(pFids, first), pTsdb->keepCfg.days, pTsdb->keepCfg.precision, &skey,
+                      &key);
+    }
+
+    if (i < num - 1) {
+      tsdbFidKeyRange(*(int32_t*)taosArrayGet(pFids, next), pTsdb->keepCfg.days, pTsdb->keepCfg.precision, &ekey,
+                      &key);
+      ekey -= 1;
+    }
+
+    // the sub readers are drained in the scan order
+    SSubReaderSlot* pSlot = &pScan->pSlots[asc ? i : num - 1 - i];
+    pSlot->pScan = pScan;
+    pSlot->window.skey = TMAX(skey, pWindow->skey);
+    pSlot->window.ekey = TMIN(ekey, pWindow->ekey);
+    code = openSubReader(pReader, pSlot, pList, numOfTables);
+  }
+
+  if (code == TSDB_CODE_SUCCESS) {
+    taosThreadMutexLock(&pScan->lock);
+    for (int32_t i = 0; i < num; ++i) {
+      scheduleSubReader(&pScan->pSlots[i]);
+    }
+    taosThreadMutexUnlock(&pScan->lock);
+
+    tsdbDebug("%p split scan into %d sub readers, numOfFiles:%d, unordered:%d, %s", pReader, num, numOfFiles,
+              pScan->unordered, pReader->idStr);
+  }
+
+_end:
+  // the reader scans by itself with its own snapshot
+  if (pScan->numOfReaders == 0) {
+    taosThreadMutexLock(&pScan->lock);
+    tsdbUntakeParallelScanSnap(pReader);
+    taosThreadMutexUnlock(&pScan->lock);
+  }
+
+  taosArrayDestroy(pFids);
+  taosMemoryFree(pList);
+  return code;
+}
+
+int32_t nextParallelScanBlock(STsdbReader* pReader, bool* hasNext) {
+  SParallelScan* pScan = pReader->pParallelScan;
+  int32_t        code = TSDB_CODE_SUCCESS;
+
+  *hasNext = false;
+  if (!pScan->started) {
+    code = startParallelScan(pReader);
+    if (pScan->serial) {
+      pReader->status.composedDataBlock = false;
+    }
+
+    if (code != TSDB_CODE_SUCCESS || pScan->serial) {
+      return code;
+    }
+  }
+
+  SSubReaderSlot* pSlot = NULL;
+  SSDataBlock*    pBlock = NULL;
+
+  taosThreadMutexLock(&pScan->lock);
+  while (1) {
+    // skip the drained sub readers
+    while (pScan->current < pScan->numOfReaders) {
+      SSubReaderSlot* p = &pScan->pSlots[pScan->current];
+      if (p->status != SUB_READER_DONE || taosArrayGetSize(p->pBlocks) > 0) {
+        break;
+      }
+
+      if (p->code != TSDB_CODE_SUCCESS) {
+        code = p->code;
+        break;
+      }
+
+      pScan->current += 1;
+    }
+
+    if (code != TSDB_CODE_SUCCESS || pScan->current >= pScan->numOfReaders) {
+      break;
+    }
+
+    int32_t last = pScan->unordered ? pScan->numOfReaders : pScan->current + 1;
+    for (int32_t i = pScan->current; i < last; ++i) {
+      SSubReaderSlot* p = &pScan->pSlots[i];
+      if (taosArrayGetSize(p->pBlocks) > 0) {
+        pSlot = p;
+        break;
+      }
+
+      if (p->status == SUB_READER_DONE && p->code != TSDB_CODE_SUCCESS) {
+        code = p->code;
+        break;
+      }
+    }
+
+    if (pSlot != NULL || code != TSDB_CODE_SUCCESS) {
+      break;
+    }
+
+    taosThreadCondWait(&pScan->notEmpty, &pScan->lock);
+  }
+
+  if (pSlot != NULL) {
+    pBlock = *(SSDataBlock**)taosArrayGet(pSlot->pBlocks, 0);
+    taosArrayRemove(pSlot->pBlocks, 0);
+
+    // the columns not loaded by the reader are filled by the caller
+    SSDataBlock* pResBlock = pReader->resBlockInfo.pResBlock;
+    blockDataCleanup(pResBlock);
+    code = handOverBlock(pResBlock, pBlock, &pReader->suppInfo);
+
+    // the block takes a later block of the sub reader
+    if (taosArrayPush(pSlot->pFreeBlocks, &pBlock) == NULL) {
+      blockDataDestroy(pBlock);
+    }
+
+    scheduleSubReader(pSlot);
+  }
+  taosThreadMutexUnlock(&pScan->lock);
+
+  if (pBlock != NULL) {
+    // the block is fully loaded, no file block is held by the reader
+    pReader->status.composedDataBlock = true;
+    *hasNext = (code == TSDB_CODE_SUCCESS);
+  }
+
+  return code;
+}
+
 typedef enum {
   BLK_CHECK_CONTINUE = 0x1,
   BLK_CHECK_QUIT = 0x2,
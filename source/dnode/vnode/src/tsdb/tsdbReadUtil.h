@@ -123,9 +123,12 @@ typedef struct SReadCostSummary {
   SSttBlockLoadCostInfo sttCost;
   int64_t composedBlocks;
   double  buildComposedBlockTime;
+  int64_t bulkCopiedRows;  // rows of composed blocks copied without merge
   double  createScanInfoList;
   double  createSkylineIterTime;
   double  initSttBlockReader;
+  int64_t prefetchHit;
+  int64_t prefetchMiss;
 } SReadCostSummary;
 
 typedef struct STableUidList {
@@ -159,6 +162,11 @@ typedef struct SBlockLoadSuppInfo {
   int32_t             numOfCols;
   char**              buildBuf;  // build string tmp buffer, todo remove it later after all string format being updated.
   bool                smaValid;  // the sma on all queried columns are activated
+  bool                lateColInit;  // the early/late column lists are built
+  int16_t*            earlyColId;   // columns loaded before the filter of a file block is applied, ordered by id
+  int32_t             numOfEarlyCols;
+  int16_t*            lateColId;  // the other queried columns except the primary timestamp, ordered by id
+  int32_t             numOfLateCols;
 } SBlockLoadSuppInfo;
 
 // each blocks in stt file not overlaps with in-memory/data-file/tomb-files, and not overlap with any other blocks in stt-file
@@ -195,6 +203,71 @@ typedef struct SDataBlockIter {
   SSHashObj* pTableMap;
 } SDataBlockIter;
 
+typedef enum {
+  BLOCK_PREFETCH_IDLE = 0x0,
+  BLOCK_PREFETCH_LOADING = 0x1,
+  BLOCK_PREFETCH_READY = 0x2,
+} EBlockPrefetchStatus;
+
+typedef struct SBlockPrefetchSlot {
+  struct SBlockPrefetcher* pPrefetcher;
+  int32_t                  index;   // position in block iterator when the read is issued
+  int8_t                   status;  // EBlockPrefetchStatus, accessed atomically, updated by the background task
+  int32_t                  code;    // accessed atomically, set by the background task
+  int64_t                  taskId;
+  SBrinRecord              record;
+  int16_t*                 colId;  // the columns read by the task
+  int32_t                  numOfCols;
+  SBlockData               data;
+} SBlockPrefetchSlot;
+
+// read ahead the file blocks in the block iterator on the vnode-prefetch async pool
+typedef struct SBlockPrefetcher {
+  int32_t               depth;      // max number of file blocks read ahead, 0 means disabled
+  int64_t               channelId;  // tasks of one reader are executed one after another in the channel
+  const char*           dataFileName;
+  SDataFileReaderConfig conf;
+  SDataFileReader*      pFileReader;  // dedicated reader, since the file reader can not be shared among threads
+  STSchema*             pSchema;
+  SBlockPrefetchSlot*   pSlots;
+  const char*           idStr;
+} SBlockPrefetcher;
+
+typedef enum {
+  SUB_READER_IDLE = 0x0,  // no scan task is scheduled
+  SUB_READER_RUNNING = 0x1,
+  SUB_READER_DONE = 0x2,  // all blocks are produced, or the scan failed
+} ESubReaderStatus;
+
+typedef struct SSubReaderSlot {
+  struct SParallelScan* pScan;
+  STsdbReader*          pReader;
+  SSDataBlock*          pResBlock;  // result block of the sub reader
+  STimeWindow           window;     // time range of the filesets scanned by the sub reader
+  int64_t               channelId;
+  int64_t               taskId;
+  int8_t                status;   // ESubReaderStatus, protected by the lock of SParallelScan
+  int32_t               code;
+  SArray*               pBlocks;      // SArray<SSDataBlock*>, produced blocks waiting to be returned
+  SArray*               pFreeBlocks;  // SArray<SSDataBlock*>, returned blocks that take the next produced ones
+} SSubReaderSlot;
+
+// split the scan by fileset into sub readers executed on the vnode-scan async pool
+typedef struct SParallelScan {
+  int32_t             maxReaders;
+  bool                unordered;  // return blocks of any sub reader, otherwise sub readers are drained in time order
+  bool                started;
+  bool                serial;  // not worth splitting, the reader scans by itself
+  bool                stop;
+  SQueryTableDataCond cond;
+  int32_t             numOfReaders;
+  int32_t             current;  // the first sub reader not drained
+  SSubReaderSlot*     pSlots;
+  STsdbReadSnap*      pSnap;  // shared by the sub readers, taken again by the first one resumed once it is released
+  TdThreadMutex       lock;
+  TdThreadCond        notEmpty;
+} SParallelScan;
+
 typedef struct SFileBlockDumpInfo {
   int32_t totalRows;
   int32_t rowIndex;
@@ -202,6 +275,13 @@ typedef struct SFileBlockDumpInfo {
   bool    allDumped;
 } SFileBlockDumpInfo;
 
+// the file block whose early columns are copied into the result block, and the late ones are not yet
+typedef struct SLateLoadInfo {
+  bool    pending;
+  int32_t rowIndex;  // the first row of the file block that is copied
+  int32_t rows;
+} SLateLoadInfo;
+
 typedef struct SReaderStatus {
   bool                  suspendInvoked;
   bool                  loadFromFile;       // check file stage
@@ -210,6 +290,7 @@ typedef struct SReaderStatus {
   STableBlockScanInfo** pTableIter;         // table iterator used in building in-memory buffer data blocks.
   STableUidList         uidList;            // check tables in uid order, to avoid the repeatly load of blocks in STT.
   SFileBlockDumpInfo    fBlockDumpInfo;
+  SLateLoadInfo         lateLoad;
   STFileSet*            pCurrentFileset;  // current opened file set
   SBlockData            fileBlockData;
   SFilesetIter          fileIter;
@@ -247,6 +328,9 @@ struct STsdbReader {
   SHashObj**         pIgnoreTables;
   SSHashObj*         pSchemaMap;   // keep the retrieved schema info, to avoid the overhead by repeatly load schema
   SDataFileReader*   pFileReader;  // the file reader
+  SBlockPrefetcher   prefetcher;
+  SParallelScan*     pParallelScan;
+  STsdbReader*       pScanReader;  // the reader a sub reader of the parallel scan belongs to
   SBlockInfoBuf      blockInfoBuf;
   EContentData       step;
   STsdbReader*       innerReader[2];
@@ -288,6 +372,27 @@ void         clearBrinBlockIter(SBrinRecordIter* pIter);
 int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIter, int32_t numOfBlocks, SArray* pTableList);
 bool    blockIteratorNext(SDataBlockIter* pBlockIter, const char* idStr);
 
+// file block prefetch API
+int32_t initBlockPrefetcher(SBlockPrefetcher* pPrefetcher, int32_t depth, const char* idStr);
+void    destroyBlockPrefetcher(SBlockPrefetcher* pPrefetcher);
+void    resetBlockPrefetcher(SBlockPrefetcher* pPrefetcher);
+void    setBlockPrefetcherFile(SBlockPrefetcher* pPrefetcher, const char* pDataFileName,
+                               const SDataFileReaderConfig* pConf);
+void    scheduleBlockPrefetch(SBlockPrefetcher* pPrefetcher, SDataBlockIter* pBlockIter, STSchema* pSchema,
+                              int16_t* colId, int32_t numOfCols);
+bool    takePrefetchedBlock(SBlockPrefetcher* pPrefetcher, const SBrinRecord* pRecord, const int16_t* colId,
+                            SBlockData* pBlockData, SReadCostSummary* pCost);
+
+// parallel scan API
+#define PARALLEL_SCAN_ACTIVE(_r) ((_r)->pParallelScan != NULL && !(_r)->pParallelScan->serial)
+
+int32_t initParallelScan(STsdbReader* pReader, const SQueryTableDataCond* pCond);
+void    destroyParallelScan(STsdbReader* pReader);
+void    resetParallelScan(STsdbReader* pReader, const SQueryTableDataCond* pCond);
+int32_t nextParallelScanBlock(STsdbReader* pReader, bool* hasNext);
+int32_t tsdbTakeParallelScanSnap(STsdbReader* pReader);
+void    tsdbUntakeParallelScanSnap(STsdbReader* pReader);
+
 // load tomb data API (stt/mem only for one table each, tomb data from data files are load for all tables at one time)
 void    loadMemTombData(SArray** ppMemDelData, STbData* pMemTbData, STbData* piMemTbData, int64_t ver);
 int32_t loadDataFileTombDataForAll(STsdbReader* pReader);
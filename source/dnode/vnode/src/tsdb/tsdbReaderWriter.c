@@ -15,6 +15,15 @@
 
 #include "cos.h"
 #include "tsdb.h"
+#include "tsdbDef.h"
+
+static void *tsdbMallocFileBuf(STsdbFD *pFD, int64_t size) {
+  // the memory of O_DIRECT transfers must be aligned
+  if (pFD->flag & TD_FILE_DIRECT) {
+    return taosMemoryMallocAlign(TD_FILE_DIRECT_ALIGN, size);
+  }
+  return taosMemoryMalloc(size);
+}
 
 static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
   int32_t     code = 0;
@@ -22,7 +31,20 @@ static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
   int32_t     szPage = pFD->szPage;
   int32_t     flag = pFD->flag;
 
+  if ((flag & TD_FILE_DIRECT) && szPage % TD_FILE_DIRECT_ALIGN != 0) {
+    tsdbWarn("file:%s, page size %d is not aligned for direct io, use page cache", path, szPage);
+    flag &= ~TD_FILE_DIRECT;
+    pFD->flag = flag;
+  }
+
   pFD->pFD = taosOpenFile(path, flag);
+  if (pFD->pFD == NULL && (flag & TD_FILE_DIRECT) && errno == EINVAL) {
+    // the file system, tmpfs for example, refuses O_DIRECT
+    tsdbWarn("file:%s, direct io not supported, use page cache", path);
+    flag &= ~TD_FILE_DIRECT;
+    pFD->flag = flag;
+    pFD->pFD = taosOpenFile(path, flag);
+  }
   if (pFD->pFD == NULL) {
     int         errsv = errno;
     const char *object_name = taosDirEntryBaseName((char *)path);
@@ -65,13 +87,14 @@ static int32_t tsdbOpenFileImpl(STsdbFD *pFD) {
     }
   }
 
-  pFD->pBuf = taosMemoryCalloc(1, szPage);
+  pFD->pBuf = tsdbMallocFileBuf(pFD, szPage);
   if (pFD->pBuf == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     // taosCloseFile(&pFD->pFD);
     // taosMemoryFree(pFD);
     goto _exit;
   }
+  memset(pFD->pBuf, 0, szPage);
 
   // not check file size when reading data files.
   if (flag != TD_FILE_READ && !pFD->s3File) {
@@ -91,6 +114,28 @@ _exit:
   return code;
 }
 
+// the ring of the calling thread, shared by all the files it writes or reads in batch
+static TdFileRingPtr tsdbGetFileRing(STsdbFD *pFD) {
+  if (tsTsdbIoUringDepth <= 0 || pFD->s3File) {
+    return NULL;
+  }
+
+  TdFileRingPtr pRing = taosGetThreadFileRing(tsTsdbIoUringDepth);
+  if (pRing == NULL && !pFD->ringTried) {
+    pFD->ringTried = 1;
+    tsdbDebug("file:%s, io_uring not used", pFD->path);
+  }
+  return pRing;
+}
+
+// the file is written and closed by one thread, its writes are queued to the ring of that thread
+static TdFileRingPtr tsdbGetWriteRing(STsdbFD *pFD) {
+  if (pFD->pRing == NULL) {
+    pFD->pRing = tsdbGetFileRing(pFD);
+  }
+  return pFD->pRing;
+}
+
 // =============== PAGE-WISE FILE ===============
 int32_t tsdbOpenFile(const char *path, STsdb *pTsdb, int32_t flag, STsdbFD **ppFD) {
   int32_t  code = 0;
@@ -122,6 +167,12 @@ _exit:
 void tsdbCloseFile(STsdbFD **ppFD) {
   STsdbFD *pFD = *ppFD;
   if (pFD) {
+    // the writes in flight are waited before their buffers are freed
+    (void)taosWaitFileRing(pFD->pRing);
+    for (int32_t i = 0; i < TSDB_FD_WBUF_NUM; ++i) {
+      taosMemoryFree(pFD->aWBuf[i]);
+    }
+    taosMemoryFree(pFD->pRBuf);
     taosMemoryFree(pFD->pBuf);
     if (!pFD->s3File) {
       taosCloseFile(&pFD->pFD);
@@ -131,6 +182,85 @@ void tsdbCloseFile(STsdbFD **ppFD) {
   }
 }
 
+// the ring may hold the io of other files, only the failures of the writes of this file are returned
+static int32_t tsdbWaitFileWrites(STsdbFD *pFD) {
+  pFD->nWInflight = 0;
+  if (taosWaitFileRing(pFD->pRing) < 0) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+  for (int32_t i = 0; i < TSDB_FD_WBUF_NUM; ++i) {
+    if (pFD->aWReq[i].err != 0) {
+      return TAOS_SYSTEM_ERROR(pFD->aWReq[i].err);
+    }
+  }
+  return 0;
+}
+
+// the buffers are reused in turn, all of them are waited when the last one is written
+static int32_t tsdbSubmitWriteBuf(STsdbFD *pFD) {
+  if (pFD->nWPage == 0) {
+    return 0;
+  }
+
+  TdFileIoReq *pReq = &pFD->aWReq[pFD->iWBuf];
+  pReq->pFile = pFD->pFD;
+  pReq->buf = pFD->aWBuf[pFD->iWBuf];
+  pReq->len = (int64_t)pFD->nWPage * pFD->szPage;
+  pReq->offset = PAGE_OFFSET(pFD->wPgno, pFD->szPage);
+  if (taosPWriteFileAsync(pFD->pRing, pReq) < 0) {
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+
+  pFD->nWPage = 0;
+  pFD->iWBuf = (pFD->iWBuf + 1) % TSDB_FD_WBUF_NUM;
+  if (++pFD->nWInflight == TSDB_FD_WBUF_NUM) {
+    return tsdbWaitFileWrites(pFD);
+  }
+  return 0;
+}
+
+// the pages written asynchronously must be on the file before it is read, rewritten or synced
+static int32_t tsdbDrainFileWrites(STsdbFD *pFD) {
+  if (pFD->pRing == NULL) {
+    return 0;
+  }
+
+  int32_t code = tsdbSubmitWriteBuf(pFD);
+  if (code) {
+    return code;
+  }
+  if (pFD->nWInflight > 0) {
+    return tsdbWaitFileWrites(pFD);
+  }
+  return 0;
+}
+
+static int32_t tsdbWriteFilePageAsync(STsdbFD *pFD) {
+  int32_t code = 0;
+  int32_t nPage = TMAX(TSDB_FD_WBUF_SIZE / pFD->szPage, 1);
+
+  if (pFD->nWPage > 0 && pFD->wPgno + pFD->nWPage != pFD->pgno) {
+    code = tsdbSubmitWriteBuf(pFD);
+    if (code) return code;
+  }
+
+  if (pFD->aWBuf[pFD->iWBuf] == NULL) {
+    pFD->aWBuf[pFD->iWBuf] = tsdbMallocFileBuf(pFD, (int64_t)nPage * pFD->szPage);
+    if (pFD->aWBuf[pFD->iWBuf] == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (pFD->nWPage == 0) {
+    pFD->wPgno = pFD->pgno;
+  }
+  memcpy(pFD->aWBuf[pFD->iWBuf] + (int64_t)pFD->nWPage * pFD->szPage, pFD->pBuf, pFD->szPage);
+  if (++pFD->nWPage == nPage) {
+    code = tsdbSubmitWriteBuf(pFD);
+  }
+  return code;
+}
+
 static int32_t tsdbWriteFilePage(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -145,7 +275,18 @@ static int32_t tsdbWriteFilePage(STsdbFD *pFD) {
     tsdbWarn("%s file: %s", __func__, pFD->path);
     return code;
   }
-  if (pFD->pgno > 0) {
+  if (pFD->pgno > 0 && pFD->pgno > pFD->szFile && tsdbGetWriteRing(pFD) != NULL) {
+    // a new page appended to the file, the rewritten ones are written synchronously below
+    taosCalcChecksumAppend(0, pFD->pBuf, pFD->szPage);
+
+    code = tsdbWriteFilePageAsync(pFD);
+    if (code) goto _exit;
+
+    pFD->szFile = pFD->pgno;
+  } else if (pFD->pgno > 0) {
+    code = tsdbDrainFileWrites(pFD);
+    if (code) goto _exit;
+
     int64_t n = taosLSeekFile(pFD->pFD, PAGE_OFFSET(pFD->pgno, pFD->szPage), SEEK_SET);
     if (n < 0) {
       code = TAOS_SYSTEM_ERROR(errno);
@@ -181,6 +322,9 @@ static int32_t tsdbReadFilePage(STsdbFD *pFD, int64_t pgno) {
     }
   }
 
+  code = tsdbDrainFileWrites(pFD);
+  if (code) goto _exit;
+
   int64_t offset = PAGE_OFFSET(pgno, pFD->szPage);
 
   if (pFD->s3File) {
@@ -265,6 +409,8 @@ _exit:
   return code;
 }
 
+static int32_t tsdbReadFileRanges(STsdbFD *pFD, const SFDataPtr *aPtr, int32_t num, uint8_t *pBuf);
+
 static int32_t tsdbReadFileImp(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int64_t size) {
   int32_t code = 0;
   int64_t n = 0;
@@ -276,6 +422,12 @@ static int32_t tsdbReadFileImp(STsdbFD *pFD, int64_t offset, uint8_t *pBuf, int6
   // ASSERT(pgno && pgno <= pFD->szFile);
   ASSERT(bOffset < szPgCont);
 
+  // a range over pages is read with one call instead of page by page
+  if (!pFD->s3File && !(pFD->flag & TD_FILE_WRITE) && bOffset + size > szPgCont && pFD->pgno != pgno) {
+    SFDataPtr ptr = {.offset = offset, .size = size};
+    return tsdbReadFileRanges(pFD, &ptr, 1, pBuf);
+  }
+
   while (n < size) {
     if (pFD->pgno != pgno) {
       code = tsdbReadFilePage(pFD, pgno);
@@ -414,6 +566,158 @@ _exit:
   return code;
 }
 
+// the pages of the ranges are read with one request each, bypassing the page kept in pFD->pBuf
+static int32_t tsdbReadFileRanges(STsdbFD *pFD, const SFDataPtr *aPtr, int32_t num, uint8_t *pBuf) {
+  int32_t      code = 0;
+  int32_t      szPage = pFD->szPage;
+  int32_t      szPgCont = PAGE_CONTENT_SIZE(szPage);
+  TdFileIoReq  req[1] = {0};
+  TdFileIoReq *aReq = req;
+
+  if (num > 1) {
+    aReq = taosMemoryCalloc(num, sizeof(TdFileIoReq));
+    if (aReq == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+
+  // the pages of each range are read into one buffer
+  int64_t szBuf = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    int64_t pgno = 0, nPage = 0;
+    if (aPtr[i].size > 0) {
+      pgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(aPtr[i].offset, szPage), szPage);
+      nPage = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(aPtr[i].offset + aPtr[i].size - 1, szPage), szPage) - pgno + 1;
+    }
+    aReq[i].pFile = pFD->pFD;
+    aReq[i].offset = PAGE_OFFSET(pgno, szPage);
+    aReq[i].len = nPage * szPage;
+    szBuf += aReq[i].len;
+  }
+
+  if (szBuf > pFD->szRBuf) {
+    taosMemoryFree(pFD->pRBuf);
+    pFD->szRBuf = 0;
+    pFD->pRBuf = tsdbMallocFileBuf(pFD, szBuf);
+    if (pFD->pRBuf == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+    pFD->szRBuf = szBuf;
+  }
+
+  szBuf = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    aReq[i].buf = pFD->pRBuf + szBuf;
+    szBuf += aReq[i].len;
+  }
+
+  // one range is already a single read
+  if (taosPReadFileBatch(num > 1 ? tsdbGetFileRing(pFD) : NULL, aReq, num) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < num; ++i) {
+    if (aReq[i].res < aReq[i].len) {
+      code = TSDB_CODE_FILE_CORRUPTED;
+      goto _exit;
+    }
+
+    uint8_t *pPage = aReq[i].buf;
+    int64_t  fOffset = LOGIC_TO_FILE_OFFSET(aPtr[i].offset, szPage);
+    int64_t  pgno = OFFSET_PGNO(fOffset, szPage);
+    int64_t  bOffset = fOffset % szPage;
+    int64_t  n = 0;
+    while (n < aPtr[i].size) {
+      if (pgno > 1 && !taosCheckChecksumWhole(pPage, szPage)) {
+        code = TSDB_CODE_FILE_CORRUPTED;
+        goto _exit;
+      }
+
+      int64_t nRead = TMIN(szPgCont - bOffset, aPtr[i].size - n);
+      memcpy(pBuf + n, pPage + bOffset, nRead);
+
+      n += nRead;
+      pgno++;
+      pPage += szPage;
+      bOffset = 0;
+    }
+    pBuf += aPtr[i].size;
+  }
+
+  // keep the last page for the reads following it
+  TdFileIoReq *pLast = &aReq[num - 1];
+  if (pLast->len > 0) {
+    memcpy(pFD->pBuf, (uint8_t *)pLast->buf + pLast->len - szPage, szPage);
+    pFD->pgno = OFFSET_PGNO(pLast->offset + pLast->len - 1, szPage);
+  }
+
+_exit:
+  if (aReq != req) {
+    taosMemoryFree(aReq);
+  }
+  return code;
+}
+
+// the ranges are read into pBuf one after another
+int32_t tsdbReadFileBatch(STsdbFD *pFD, const SFDataPtr *aRange, int32_t nRange, uint8_t *pBuf) {
+  int32_t    code = 0;
+  SFDataPtr  ptr[1] = {0};
+  SFDataPtr *aPtr = ptr;
+  int32_t    num = 0;
+
+  if (nRange <= 0) {
+    return code;
+  }
+
+  if (!pFD->pFD) {
+    code = tsdbOpenFileImpl(pFD);
+    if (code) {
+      goto _exit;
+    }
+  }
+
+  // the ranges following each other, the columns of a block for example, are read as one
+  if (nRange > 1) {
+    aPtr = taosMemoryMalloc(nRange * sizeof(SFDataPtr));
+    if (aPtr == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    }
+  }
+  aPtr[0] = aRange[0];
+  for (int32_t i = 1; i < nRange; ++i) {
+    if (aRange[i].offset == aPtr[num].offset + aPtr[num].size) {
+      aPtr[num].size += aRange[i].size;
+    } else {
+      aPtr[++num] = aRange[i];
+    }
+  }
+  num++;
+
+  if (pFD->s3File || (pFD->flag & TD_FILE_WRITE) || tsdbGetFileRing(pFD) == NULL) {
+    // the extent of all the ranges is fetched from s3 with the first one, and a file being written is read page by
+    // page, since its current page may be not written yet. Without io_uring, the ranges sharing a page read it once.
+    int64_t szHint = aPtr[num - 1].offset + aPtr[num - 1].size - aPtr[0].offset;
+    for (int32_t i = 0; i < num; ++i) {
+      code = tsdbReadFile(pFD, aPtr[i].offset, pBuf, aPtr[i].size, (i == 0 && szHint > aPtr[0].size) ? szHint : 0);
+      if (code) goto _exit;
+      pBuf += aPtr[i].size;
+    }
+    goto _exit;
+  }
+
+  code = tsdbReadFileRanges(pFD, aPtr, num, pBuf);
+
+_exit:
+  if (aPtr != ptr) {
+    taosMemoryFree(aPtr);
+  }
+  return code;
+}
+
 int32_t tsdbFsyncFile(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -424,6 +728,9 @@ int32_t tsdbFsyncFile(STsdbFD *pFD) {
   code = tsdbWriteFilePage(pFD);
   if (code) goto _exit;
 
+  code = tsdbDrainFileWrites(pFD);
+  if (code) goto _exit;
+
   if (taosFsyncFile(pFD->pFD) < 0) {
     code = TAOS_SYSTEM_ERROR(errno);
     goto _exit;
@@ -80,6 +80,7 @@ struct SSttFileWriterConfig {
   int32_t   szPage;
   int8_t    cmprAlg;
   int64_t   compactVersion;
+  bool      directIO;
   SDiskID   did;
   int32_t   fid;
   int64_t   cid;
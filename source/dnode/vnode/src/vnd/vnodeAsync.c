@@ -214,6 +214,7 @@ static void *vnodeAsyncLoop(void *arg) {
         worker->state = EVA_WORKER_STATE_STOP;
         async->numLaunchWorkers--;
         taosThreadMutexUnlock(&async->mutex);
+        taosDestroyThreadFileRing();
         return NULL;
       }
 
@@ -48,6 +48,7 @@ void initTsdbReaderAPI(TsdReader* pReader) {
   pReader->tsdNextDataBlock = tsdbNextDataBlock2;
 
   pReader->tsdReaderRetrieveDataBlock = tsdbRetrieveDataBlock2;
+  pReader->tsdReaderRetrieveLateCols = (int32_t (*)(void*, bool))tsdbRetrieveLateCols2;
   pReader->tsdReaderReleaseDataBlock = tsdbReleaseDataBlock2;
 
   pReader->tsdReaderRetrieveBlockSMAInfo = tsdbRetrieveDatablockSMA2;
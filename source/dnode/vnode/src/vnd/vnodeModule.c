@@ -18,7 +18,7 @@
 
 static volatile int32_t VINIT = 0;
 
-SVAsync* vnodeAsyncHandle[2];
+SVAsync* vnodeAsyncHandle[4];
 
 int vnodeInit(int nthreads) {
   int32_t init;
@@ -36,6 +36,14 @@ int vnodeInit(int nthreads) {
   vnodeAsyncInit(&vnodeAsyncHandle[1], "vnode-merge");
   vnodeAsyncSetWorkers(vnodeAsyncHandle[1], nthreads);
 
+  // vnode-prefetch
+  vnodeAsyncInit(&vnodeAsyncHandle[2], "vnode-prefetch");
+  vnodeAsyncSetWorkers(vnodeAsyncHandle[2], nthreads);
+
+  // vnode-scan
+  vnodeAsyncInit(&vnodeAsyncHandle[3], "vnode-scan");
+  vnodeAsyncSetWorkers(vnodeAsyncHandle[3], TMAX((int32_t)tsNumOfCores, nthreads));
+
   if (walInit() < 0) {
     return -1;
   }
@@ -50,6 +58,8 @@ void vnodeCleanup() {
   // set stop
   vnodeAsyncDestroy(&vnodeAsyncHandle[0]);
   vnodeAsyncDestroy(&vnodeAsyncHandle[1]);
+  vnodeAsyncDestroy(&vnodeAsyncHandle[2]);
+  vnodeAsyncDestroy(&vnodeAsyncHandle[3]);
 
   walCleanUp();
   smaCleanUp();
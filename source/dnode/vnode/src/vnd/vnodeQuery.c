@@ -397,6 +397,18 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = atomic_load_64(&pVnode->statis.nInsertSuccess);
   pLoad->numOfBatchInsertReqs = atomic_load_64(&pVnode->statis.nBatchInsert);
   pLoad->numOfBatchInsertSuccessReqs = atomic_load_64(&pVnode->statis.nBatchInsertSuccess);
+
+  SWalGroupStat groupStat = {0};
+  walGetGroupStat(pVnode->pWal, &groupStat);
+  pLoad->numOfWalGroups = groupStat.numOfGroups;
+  pLoad->numOfWalGroupEntries = groupStat.numOfEntries;
+  memcpy(pLoad->walGroupHist, groupStat.hist, sizeof(pLoad->walGroupHist));
+
+  SSyncReplStat replStat = {0};
+  syncGetReplStat(pVnode->sync, &replStat);
+  pLoad->numOfSyncReplMsgs = replStat.numOfMsgs;
+  pLoad->numOfSyncReplEntries = replStat.numOfEntries;
+  pLoad->syncReplLag = replStat.maxLag;
   return 0;
 }
 
@@ -421,6 +433,13 @@ void vnodeResetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsert, pLoad->numOfBatchInsertReqs, 64, "nBatchInsert");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsertSuccess, pLoad->numOfBatchInsertSuccessReqs, 64,
                             "nBatchInsertSuccess");
+
+  SWalGroupStat groupStat = {.numOfGroups = pLoad->numOfWalGroups, .numOfEntries = pLoad->numOfWalGroupEntries};
+  memcpy(groupStat.hist, pLoad->walGroupHist, sizeof(groupStat.hist));
+  walResetGroupStat(pVnode->pWal, &groupStat);
+
+  SSyncReplStat replStat = {.numOfMsgs = pLoad->numOfSyncReplMsgs, .numOfEntries = pLoad->numOfSyncReplEntries};
+  syncResetReplStat(pVnode->sync, &replStat);
 }
 
 void vnodeGetInfo(void *pVnode, const char **dbname, int32_t *vgId, int64_t *numOfTables, int64_t *numOfNormalTables) {
@@ -275,6 +275,9 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
   SRpcMsg *pMsg = NULL;
   vTrace("vgId:%d, get %d msgs from vnode-write queue", vgId, numOfMsgs);
 
+  // the msgs of one batch share a wal fsync, and are acked after it
+  bool grouped = (numOfMsgs > 1) && syncBeginGroupCommit(pVnode->sync);
+
   for (int32_t msg = 0; msg < numOfMsgs; msg++) {
     if (taosGetQitem(qall, (void **)&pMsg) == 0) continue;
     bool isWeak = vnodeIsMsgWeak(pMsg->msgType);
@@ -305,11 +308,28 @@ void vnodeProposeWriteMsg(SQueueInfo *pInfo, STaosQall *qall, int32_t numOfMsgs)
       continue;
     }
 
+    // a blocking msg waits for its own apply, so it can not be held back by the group
+    bool isBlock = vnodeIsMsgBlock(pMsg->msgType);
+    if (grouped && isBlock) {
+      if (syncEndGroupCommit(pVnode->sync) != 0) {
+        vError("vgId:%d, failed to end group commit since %s, msgs are acked after the wal is synced", vgId, terrstr());
+      }
+      grouped = false;
+    }
+
     code = vnodeProposeMsg(pVnode, pMsg, isWeak);
 
     vGTrace("vgId:%d, msg:%p is freed, code:0x%x", vgId, pMsg, code);
     rpcFreeCont(pMsg->pCont);
     taosFreeQitem(pMsg);
+
+    if (isBlock && msg < numOfMsgs - 1) {
+      grouped = syncBeginGroupCommit(pVnode->sync);
+    }
+  }
+
+  if (grouped && syncEndGroupCommit(pVnode->sync) != 0) {
+    vError("vgId:%d, failed to end group commit since %s, msgs are acked after the wal is synced", vgId, terrstr());
   }
 }
 
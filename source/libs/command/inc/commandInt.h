@@ -72,6 +72,7 @@ extern "C" {
 
 #define EXPLAIN_PLANNING_TIME_FORMAT "Planning Time: %.3f ms"
 #define EXPLAIN_EXEC_TIME_FORMAT "Execution Time: %.3f ms"
+#define EXPLAIN_SPILL_COMP_FORMAT "  spill:%.2f Kb -> %.2f Kb compress:%.3f ms"
 
 //append area
 #define EXPLAIN_LIMIT_FORMAT "limit=%" PRId64
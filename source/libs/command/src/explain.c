@@ -830,6 +830,10 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
         }
 
         EXPLAIN_ROW_APPEND("  loops:%d", pExecInfo->loops);
+        if (pExecInfo->compSrcBytes > 0) {
+          EXPLAIN_ROW_APPEND(EXPLAIN_SPILL_COMP_FORMAT, pExecInfo->compSrcBytes / 1024.0, pExecInfo->compBytes / 1024.0,
+                             pExecInfo->compUs / 1000.0);
+        }
         EXPLAIN_ROW_END();
         QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
       }
@@ -1187,6 +1191,10 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
           }
 
           EXPLAIN_ROW_APPEND("  loops:%d", pExecInfo->loops);
+          if (pExecInfo->compSrcBytes > 0) {
+            EXPLAIN_ROW_APPEND(EXPLAIN_SPILL_COMP_FORMAT, pExecInfo->compSrcBytes / 1024.0, pExecInfo->compBytes / 1024.0,
+                               pExecInfo->compUs / 1000.0);
+          }
           EXPLAIN_ROW_END();
           QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
         }
@@ -1409,6 +1417,10 @@ int32_t qExplainResNodeToRowsImpl(SExplainResNode *pResNode, SExplainCtx *ctx, i
         }
 
         EXPLAIN_ROW_APPEND("  loops:%d", pExecInfo->loops);
+        if (pExecInfo->compSrcBytes > 0) {
+          EXPLAIN_ROW_APPEND(EXPLAIN_SPILL_COMP_FORMAT, pExecInfo->compSrcBytes / 1024.0, pExecInfo->compBytes / 1024.0,
+                             pExecInfo->compUs / 1000.0);
+        }
         EXPLAIN_ROW_END();
         QRY_ERR_RET(qExplainResAppendRow(ctx, tbuf, tlen, level));
       }
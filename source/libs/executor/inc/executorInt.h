@@ -44,6 +44,7 @@ extern "C" {
 #include "tlrucache.h"
 
 typedef int32_t (*__block_search_fn_t)(char* data, int32_t num, int64_t key, int32_t order);
+typedef int32_t (*__filter_result_fn_t)(void* param, int32_t status);
 
 typedef struct STsdbReader STsdbReader;
 typedef struct STqReader   STqReader;
@@ -254,6 +255,8 @@ typedef struct STableScanBase {
   // there are more than one table list exists in one task, if only one vnode exists.
   STableListInfo* pTableListInfo;
   TsdReader       readerAPI;
+  SArray*         pEarlyColIds;  // SArray<int16_t>, data columns required by the filter, the others are loaded later
+  STopNThreshold* pTopN;         // published by the top-N sort above, owned by the sort operator
 } STableScanBase;
 
 typedef struct STableScanInfo {
@@ -744,6 +747,8 @@ int32_t     getBufferPgSize(int32_t rowSize, uint32_t* defaultPgsz, uint32_t* de
 extern void doDestroyExchangeOperatorInfo(void* param);
 
 int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo);
+int32_t doFilterEx(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo,
+                   __filter_result_fn_t fp, void* param);
 int32_t addTagPseudoColumnData(SReadHandle* pHandle, const SExprInfo* pExpr, int32_t numOfExpr, SSDataBlock* pBlock,
                                int32_t rows, const char* idStr, STableMetaCacheInfo* pCache);
 
@@ -20,6 +20,10 @@ extern "C" {
 #endif
 
 #define HASH_JOIN_DEFAULT_PAGE_SIZE 10485760
+#define HASH_JOIN_MIN_PAGE_SIZE     65536
+#define HASH_JOIN_RADIX_BITS        4
+#define HASH_JOIN_PART_NUM          (1 << HASH_JOIN_RADIX_BITS)
+#define HASH_JOIN_SPILL_MEM_SIZE    4194304
 
 #pragma pack(push, 1) 
 typedef struct SBufRowInfo {
@@ -29,9 +33,22 @@ typedef struct SBufRowInfo {
 } SBufRowInfo;
 #pragma pack(pop)
 
+typedef struct SHJoinPartition {
+  bool         spilled;
+  int64_t      memSize;
+  SSHashObj*   pKeyHash;
+  SArray*      pRowBufs;       // SArray<SBufPageInfo>
+  char*        pBuildPage;     // page being filled with the records of the spilled build rows
+  int32_t      buildPageId;
+  SArray*      pBuildPages;    // SArray<int32_t>
+  SSDataBlock* pProbeBlk;      // spilled probe rows not written into a page yet
+  SArray*      pProbePages;    // SArray<int32_t>
+} SHJoinPartition;
+
 typedef struct SHJoinCtx {
-  bool         rowRemains;
-  SBufRowInfo* pBuildRow;
+  bool             rowRemains;
+  SHJoinPartition* pPart;
+  SBufRowInfo*     pBuildRow;
   SSDataBlock* pProbeData;
   int32_t      probeIdx;
 } SHJoinCtx;
@@ -90,6 +107,9 @@ typedef struct SHJoinExecInfo {
   int64_t probeBlkRows;
   int64_t resRows;
   int64_t expectRows;
+  int64_t spillParts;
+  int64_t spillBuildRows;
+  int64_t spillProbeRows;
 } SHJoinExecInfo;
 
 
@@ -101,9 +121,18 @@ typedef struct SHJoinOperatorInfo {
   SSDataBlock*     pRes;
   int32_t          pResColNum;
   int8_t*          pResColMap;
-  SArray*          pRowBufs;
   SNode*           pCond;
-  SSHashObj*       pKeyHash;
+  _hash_fn_t       hashFp;
+  SHJoinPartition  parts[HASH_JOIN_PART_NUM];  // radix partitions by the high bits of the key hash
+  int64_t          memSize;
+  int64_t          memLimit;
+  SDiskbasedBuf*   pBuildSpillBuf;
+  SDiskbasedBuf*   pProbeSpillBuf;
+  int32_t          probeRowsPerPage;
+  SSDataBlock*     pSpillBlk;
+  int32_t          spillPartIdx;
+  int32_t          spillPageIdx;
+  bool             probeDone;
   bool             keyHashBuilt;
   SHJoinCtx        ctx;
   SHJoinExecInfo   execInfo;
@@ -16,6 +16,8 @@
 #ifndef TDENGINE_QUERYTASK_H
 #define TDENGINE_QUERYTASK_H
 
+#include "tarena.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -97,6 +99,7 @@ struct SExecTaskInfo {
   int8_t                dynamicTask;
   SOperatorParam*       pOpParam;
   bool                  paramSet;
+  SArena*               pArena;  // short-lived allocations of the operators, released together with the task
 };
 
 void           buildTaskId(uint64_t taskId, uint64_t queryId, char* dst);
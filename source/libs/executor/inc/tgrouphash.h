@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TDENGINE_TGROUPHASH_H
+#define TDENGINE_TGROUPHASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "executil.h"
+
+/*
+ * Open addressing hash table that maps the normalized group keys to the result rows of the group by operator.
+ *
+ * A slot of 8 bytes keeps the hash value and the index of the entry, so that probing walks a cache line of 8
+ * slots without touching any key. The entries are split into GROUP_HASH_PARTITIONS partitions by the high bits
+ * of the hash value, and the keys are copied into large chunks, so the groups of a partition are iterated, and
+ * their result rows are allocated, close to each other.
+ */
+
+#define GROUP_HASH_PARTITION_BITS 4
+#define GROUP_HASH_PARTITIONS     (1 << GROUP_HASH_PARTITION_BITS)
+
+typedef struct SGroupHashEntry {
+  uint64_t           groupId;
+  SResultRowPosition pos;
+  char*              pKey;
+  int32_t            keyLen;
+  uint32_t           hashVal;
+} SGroupHashEntry;
+
+typedef struct SGroupHash SGroupHash;
+
+SGroupHash* tGroupHashInit(int32_t capacity);
+void        tGroupHashCleanup(SGroupHash* pHash);
+void        tGroupHashClear(SGroupHash* pHash);
+
+int32_t tGroupHashGetSize(const SGroupHash* pHash);
+int64_t tGroupHashGetMemSize(const SGroupHash* pHash);
+
+/**
+ * find the entry of the key, or add a new one with the pos of {-1, -1} if it does not exist
+ * @param pNew   set to be true if the entry is added by this call
+ * @return NULL if out of memory
+ */
+SGroupHashEntry* tGroupHashPut(SGroupHash* pHash, const char* pKey, int32_t keyLen, bool* pNew);
+SGroupHashEntry* tGroupHashGet(SGroupHash* pHash, const char* pKey, int32_t keyLen);
+
+int32_t          tGroupHashGetPartition(uint32_t hashVal);
+int32_t          tGroupHashGetPartitionSize(const SGroupHash* pHash, int32_t partition);
+SGroupHashEntry* tGroupHashGetEntry(const SGroupHash* pHash, int32_t partition, int32_t index);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // TDENGINE_TGROUPHASH_H
@@ -21,6 +21,7 @@ extern "C" {
 #endif
 
 #include "os.h"
+#include "tarena.h"
 #include "tcommon.h"
 
 enum {
@@ -60,11 +61,27 @@ typedef struct SMsortComparParam {
   int32_t tsSlotId;
   int32_t order;
   __compar_fn_t cmpFn;
+
+  // normalized sort key of the current row of each source, compared by memcmp, disabled if keyCap is 0
+  char*    pKeyBuf;
+  int32_t* pKeyLen;
+  int32_t  keyCap;
+  int32_t  numOfKeys;
 } SMsortComparParam;
 
 typedef struct SSortHandle  SSortHandle;
 typedef struct STupleHandle STupleHandle;
 
+// the first sort key value that a row should beat to enter the result of a top-N sort, which is published by the
+// priority queue sort once it holds enough rows, and is used by the scan to skip data blocks by block SMA.
+typedef struct STopNThreshold {
+  bool    valid;
+  bool    nullFirst;
+  int32_t order;
+  int32_t slotId;  // the slot of the first sort key in the input data block
+  double  key;
+} STopNThreshold;
+
 typedef SSDataBlock* (*_sort_fetch_block_fn_t)(void* param);
 typedef int32_t (*_sort_merge_compar_fn_t)(const void* p1, const void* p2, void* param);
 
@@ -82,6 +99,20 @@ SSortHandle* tsortCreateSortHandle(SArray* pOrderInfo, int32_t type, int32_t pag
 
 void tsortSetForceUsePQSort(SSortHandle* pHandle);
 
+/**
+ * publish the threshold of the priority queue sort to pThreshold, during the sort is opened
+ * @param pHandle
+ * @param pThreshold
+ */
+void tsortSetTopNThreshold(SSortHandle* pHandle, STopNThreshold* pThreshold);
+
+/**
+ * allocate the tuples kept by the priority queue sort from pArena, which must outlive the sort handle
+ * @param pHandle
+ * @param pArena
+ */
+void tsortSetArena(SSortHandle* pHandle, SArena* pArena);
+
 /**
  *
  * @param pSortHandle
@@ -494,6 +494,7 @@ int32_t doInitAggInfoSup(SAggSupporter* pAggSup, SqlFunctionCtx* pCtx, int32_t n
     qError("Create agg result buf failed since %s, %s", tstrerror(code), pKey);
     return code;
   }
+  (void)setBufPageCompressOnDisk(pAggSup->pResultBuf, tsQuerySpillCompress);
 
   return code;
 }
@@ -21,13 +21,16 @@
 #include "tdatablock.h"
 #include "tglobal.h"
 #include "tqueue.h"
+#include "trpc.h"
 
 extern SDataSinkStat gDataSinkStat;
 
+// the data block is encoded right behind the SRetrieveTableRsp header of a rpc message buffer, so that the buffer can
+// be sent as the fetch response without being copied again
 typedef struct SDataDispatchBuf {
   int32_t useSize;
   int32_t allocSize;
-  char*   pData;
+  char*   pData;  // allocated by rpcMallocCont, SRetrieveTableRsp followed by the encoded block
 } SDataDispatchBuf;
 
 typedef struct SDataCacheEntry {
@@ -35,15 +38,19 @@ typedef struct SDataCacheEntry {
   int32_t numOfRows;
   int32_t numOfCols;
   int8_t  compressed;
-  char    data[];
 } SDataCacheEntry;
 
+typedef struct SDataDispatchItem {
+  SDataCacheEntry  entry;
+  SDataDispatchBuf buf;
+} SDataDispatchItem;
+
 typedef struct SDataDispatchHandle {
   SDataSinkHandle     sink;
   SDataSinkManager*   pManager;
   SDataBlockDescNode* pSchema;
   STaosQueue*         pDataBlocks;
-  SDataDispatchBuf    nextOutput;
+  SDataDispatchItem   nextOutput;
   int32_t             status;
   bool                queryEnd;
   uint64_t            useconds;
@@ -53,14 +60,14 @@ typedef struct SDataDispatchHandle {
 
 // clang-format off
 // data format:
-// +----------------+------------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
-// |SDataCacheEntry |  version         | total length | numOfRows    |     group id     | col1_schema | col2_schema | col3_schema... | column#1 length, column#2 length...| col1 bitmap | col1 data | col2 bitmap | col2 data |
-// |                |  sizeof(int32_t) |sizeof(int32) | sizeof(int32)| sizeof(uint64_t) | (sizeof(int8_t)+sizeof(int32_t))*numOfCols | sizeof(int32_t) * numOfCols        | actual size |           |                         |
-// +----------------+------------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
+// +-----------------+-----------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
+// |SRetrieveTableRsp| version         | total length | numOfRows    |     group id     | col1_schema | col2_schema | col3_schema... | column#1 length, column#2 length...| col1 bitmap | col1 data | col2 bitmap | col2 data |
+// |                 | sizeof(int32_t) |sizeof(int32) | sizeof(int32)| sizeof(uint64_t) | (sizeof(int8_t)+sizeof(int32_t))*numOfCols | sizeof(int32_t) * numOfCols        | actual size |           |                         |
+// +-----------------+-----------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
 // The length of bitmap is decided by number of rows of this data block, and the length of each column data is
 // recorded in the first segment, next to the struct header
 // clang-format on
-static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
+static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchItem* pItem) {
   int32_t numOfCols = 0;
   SNode*  pNode;
   FOREACH(pNode, pHandle->pSchema->pSlots) {
@@ -69,14 +76,17 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
       ++numOfCols;
     }
   }
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
+  SDataCacheEntry*   pEntry = &pItem->entry;
+  SDataDispatchBuf*  pBuf = &pItem->buf;
+  SRetrieveTableRsp* pRsp = (SRetrieveTableRsp*)pBuf->pData;
+  memset(pRsp, 0, sizeof(SRetrieveTableRsp));
   pEntry->compressed = 0;
   pEntry->numOfRows = pInput->pData->info.rows;
   pEntry->numOfCols = numOfCols;
   pEntry->dataLen = 0;
 
-  pBuf->useSize = sizeof(SDataCacheEntry);
-  pEntry->dataLen = blockEncode(pInput->pData, pEntry->data, numOfCols);
+  pBuf->useSize = sizeof(SRetrieveTableRsp);
+  pEntry->dataLen = blockEncode(pInput->pData, pRsp->data, numOfCols);
   //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
   //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
@@ -96,9 +106,9 @@ static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput,
     }
   */
 
-  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  pBuf->allocSize = sizeof(SRetrieveTableRsp) + blockGetEncodeSize(pInput->pData);
 
-  pBuf->pData = taosMemoryMalloc(pBuf->allocSize);
+  pBuf->pData = rpcMallocCont(pBuf->allocSize);
   if (pBuf->pData == NULL) {
     qError("SinkNode failed to malloc memory, size:%d, code:%d", pBuf->allocSize, TAOS_SYSTEM_ERROR(errno));
   }
@@ -127,18 +137,18 @@ static int32_t getStatus(SDataDispatchHandle* pDispatcher) {
 static int32_t putDataBlock(SDataSinkHandle* pHandle, const SInputData* pInput, bool* pContinue) {
   int32_t              code = 0;
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
-  SDataDispatchBuf*    pBuf = taosAllocateQitem(sizeof(SDataDispatchBuf), DEF_QITEM, 0);
-  if (NULL == pBuf) {
+  SDataDispatchItem*   pItem = taosAllocateQitem(sizeof(SDataDispatchItem), DEF_QITEM, 0);
+  if (NULL == pItem) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  if (!allocBuf(pDispatcher, pInput, pBuf)) {
-    taosFreeQitem(pBuf);
+  if (!allocBuf(pDispatcher, pInput, &pItem->buf)) {
+    taosFreeQitem(pItem);
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  toDataCacheEntry(pDispatcher, pInput, pBuf);
-  code = taosWriteQitem(pDispatcher->pDataBlocks, pBuf);
+  toDataCacheEntry(pDispatcher, pInput, pItem);
+  code = taosWriteQitem(pDispatcher->pDataBlocks, pItem);
   if (code != 0) {
     return code;
   }
@@ -171,37 +181,33 @@ static void getDataLength(SDataSinkHandle* pHandle, int64_t* pLen, bool* pQueryE
     return;
   }
 
-  SDataDispatchBuf* pBuf = NULL;
-  taosReadQitem(pDispatcher->pDataBlocks, (void**)&pBuf);
-  if (pBuf != NULL) {
-    memcpy(&pDispatcher->nextOutput, pBuf, sizeof(SDataDispatchBuf));
-    taosFreeQitem(pBuf);
+  SDataDispatchItem* pItem = NULL;
+  taosReadQitem(pDispatcher->pDataBlocks, (void**)&pItem);
+  if (pItem != NULL) {
+    memcpy(&pDispatcher->nextOutput, pItem, sizeof(SDataDispatchItem));
+    taosFreeQitem(pItem);
   }
 
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)pDispatcher->nextOutput.pData;
+  SDataCacheEntry* pEntry = &pDispatcher->nextOutput.entry;
   *pLen = pEntry->dataLen;
 
   //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
   //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
   *pQueryEnd = pDispatcher->queryEnd;
-  qDebug("got data len %" PRId64 ", row num %d in sink", *pLen,
-         ((SDataCacheEntry*)(pDispatcher->nextOutput.pData))->numOfRows);
+  qDebug("got data len %" PRId64 ", row num %d in sink", *pLen, pEntry->numOfRows);
 }
 
+static void setEndOutput(SDataDispatchHandle* pDispatcher, SOutputData* pOutput) {
+  ASSERT(pDispatcher->queryEnd);
+  pOutput->useconds = pDispatcher->useconds;
+  pOutput->precision = pDispatcher->pSchema->precision;
+  pOutput->bufStatus = DS_BUF_EMPTY;
+  pOutput->queryEnd = pDispatcher->queryEnd;
+}
 
-static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
-  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
-  if (NULL == pDispatcher->nextOutput.pData) {
-    ASSERT(pDispatcher->queryEnd);
-    pOutput->useconds = pDispatcher->useconds;
-    pOutput->precision = pDispatcher->pSchema->precision;
-    pOutput->bufStatus = DS_BUF_EMPTY;
-    pOutput->queryEnd = pDispatcher->queryEnd;
-    return TSDB_CODE_SUCCESS;
-  }
-  SDataCacheEntry* pEntry = (SDataCacheEntry*)(pDispatcher->nextOutput.pData);
-  memcpy(pOutput->pData, pEntry->data, pEntry->dataLen);
+static void setNextOutput(SDataDispatchHandle* pDispatcher, SOutputData* pOutput) {
+  SDataCacheEntry* pEntry = &pDispatcher->nextOutput.entry;
   pOutput->numOfRows = pEntry->numOfRows;
   pOutput->numOfCols = pEntry->numOfCols;
   pOutput->compressed = pEntry->compressed;
@@ -209,27 +215,58 @@ static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
   atomic_sub_fetch_64(&pDispatcher->cachedSize, pEntry->dataLen);
   atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pEntry->dataLen);
 
-  taosMemoryFreeClear(pDispatcher->nextOutput.pData);  // todo persistent
   pOutput->bufStatus = updateStatus(pDispatcher);
   taosThreadMutexLock(&pDispatcher->mutex);
   pOutput->queryEnd = pDispatcher->queryEnd;
   pOutput->useconds = pDispatcher->useconds;
   pOutput->precision = pDispatcher->pSchema->precision;
   taosThreadMutexUnlock(&pDispatcher->mutex);
+}
+
+static int32_t getDataBlock(SDataSinkHandle* pHandle, SOutputData* pOutput) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  if (NULL == pDispatcher->nextOutput.buf.pData) {
+    setEndOutput(pDispatcher, pOutput);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SRetrieveTableRsp* pRsp = (SRetrieveTableRsp*)pDispatcher->nextOutput.buf.pData;
+  memcpy(pOutput->pData, pRsp->data, pDispatcher->nextOutput.entry.dataLen);
+  rpcFreeCont(pDispatcher->nextOutput.buf.pData);
+  pDispatcher->nextOutput.buf.pData = NULL;
+
+  setNextOutput(pDispatcher, pOutput);
+  return TSDB_CODE_SUCCESS;
+}
+
+// hand over the rpc message buffer that the next block is encoded in, instead of copying the block out of it
+static int32_t getDataMsg(SDataSinkHandle* pHandle, SOutputData* pOutput, void** ppMsg) {
+  SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
+  *ppMsg = NULL;
+  if (NULL == pDispatcher->nextOutput.buf.pData) {
+    setEndOutput(pDispatcher, pOutput);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  *ppMsg = pDispatcher->nextOutput.buf.pData;
+  pOutput->pData = ((SRetrieveTableRsp*)*ppMsg)->data;
+  pDispatcher->nextOutput.buf.pData = NULL;
 
+  setNextOutput(pDispatcher, pOutput);
   return TSDB_CODE_SUCCESS;
 }
 
 static int32_t destroyDataSinker(SDataSinkHandle* pHandle) {
   SDataDispatchHandle* pDispatcher = (SDataDispatchHandle*)pHandle;
   atomic_sub_fetch_64(&gDataSinkStat.cachedSize, pDispatcher->cachedSize);
-  taosMemoryFreeClear(pDispatcher->nextOutput.pData);
+  rpcFreeCont(pDispatcher->nextOutput.buf.pData);
+  pDispatcher->nextOutput.buf.pData = NULL;
   while (!taosQueueEmpty(pDispatcher->pDataBlocks)) {
-    SDataDispatchBuf* pBuf = NULL;
-    taosReadQitem(pDispatcher->pDataBlocks, (void**)&pBuf);
-    if (pBuf != NULL) {
-      taosMemoryFreeClear(pBuf->pData);
-      taosFreeQitem(pBuf);
+    SDataDispatchItem* pItem = NULL;
+    taosReadQitem(pDispatcher->pDataBlocks, (void**)&pItem);
+    if (pItem != NULL) {
+      rpcFreeCont(pItem->buf.pData);
+      taosFreeQitem(pItem);
     }
   }
   taosCloseQueue(pDispatcher->pDataBlocks);
@@ -256,6 +293,7 @@ int32_t createDataDispatcher(SDataSinkManager* pManager, const SDataSinkNode* pD
   dispatcher->sink.fReset = resetDispatcher;
   dispatcher->sink.fGetLen = getDataLength;
   dispatcher->sink.fGetData = getDataBlock;
+  dispatcher->sink.fGetDataMsg = getDataMsg;
   dispatcher->sink.fDestroy = destroyDataSinker;
   dispatcher->sink.fGetCacheSize = getCacheSize;
   dispatcher->pManager = pManager;
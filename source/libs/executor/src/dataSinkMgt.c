@@ -17,6 +17,7 @@
 #include "dataSinkInt.h"
 #include "planner.h"
 #include "tarray.h"
+#include "trpc.h"
 
 SDataSinkStat           gDataSinkStat = {0};
 
@@ -85,6 +86,29 @@ int32_t dsGetDataBlock(DataSinkHandle handle, SOutputData* pOutput) {
   return pHandleImpl->fGetData(pHandleImpl, pOutput);
 }
 
+int32_t dsGetDataMsg(DataSinkHandle handle, int64_t len, SOutputData* pOutput, void** ppMsg) {
+  SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
+  if (pHandleImpl->fGetDataMsg != NULL) {
+    return pHandleImpl->fGetDataMsg(pHandleImpl, pOutput, ppMsg);
+  }
+
+  SRetrieveTableRsp* pRsp = rpcMallocCont(sizeof(SRetrieveTableRsp) + len);
+  if (pRsp == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  memset(pRsp, 0, sizeof(SRetrieveTableRsp));
+  pOutput->pData = pRsp->data;
+  int32_t code = pHandleImpl->fGetData(pHandleImpl, pOutput);
+  if (code != TSDB_CODE_SUCCESS) {
+    rpcFreeCont(pRsp);
+    return code;
+  }
+
+  *ppMsg = pRsp;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t dsGetCacheSize(DataSinkHandle handle, uint64_t* pSize) {
   SDataSinkHandle* pHandleImpl = (SDataSinkHandle*)handle;
   return pHandleImpl->fGetCacheSize(pHandleImpl, pSize);
@@ -1490,6 +1490,11 @@ void createExprFromOneNode(SExprInfo* pExp, SNode* pNode, int16_t slotId) {
     pExp->base.resSchema =
         createResSchema(pType->type, pType->bytes, slotId, pType->scale, pType->precision, pOpNode->node.aliasName);
     pExp->pExpr->_optrRoot.pRootNode = pNode;
+
+    // the arithmetic of numeric columns is evaluated by the compiled program, others go to scalarCalculate
+    if (scalarCompile(pNode, &pExp->pExpr->_optrRoot.pProgram) != TSDB_CODE_SUCCESS) {
+      pExp->pExpr->_optrRoot.pProgram = NULL;
+    }
   } else if (type == QUERY_NODE_CASE_WHEN) {
     pExp->pExpr->nodeType = QUERY_NODE_OPERATOR;
     SCaseWhenNode* pCaseNode = (SCaseWhenNode*)pNode;
@@ -1733,6 +1738,8 @@ int32_t initQueryTableDataCond(SQueryTableDataCond* pCond, const STableScanPhysi
   pCond->startVersion = -1;
   pCond->endVersion = -1;
   pCond->skipRollup = readHandle->skipRollup;
+  pCond->numOfParallel = 0;
+  pCond->unordered = false;
 
   // allowed read stt file optimization mode
   pCond->notLoadData = (pTableScanNode->dataRequired == FUNC_DATA_REQUIRED_NOT_LOAD) &&
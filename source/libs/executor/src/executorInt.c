@@ -501,8 +501,14 @@ void clearResultRowInitFlag(SqlFunctionCtx* pCtx, int32_t numOfOutput) {
 }
 
 int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo) {
+  return doFilterEx(pBlock, pFilterInfo, pColMatchInfo, NULL, NULL);
+}
+
+// fp is invoked with the filter result before the qualified rows are extracted, even if the filter fails
+int32_t doFilterEx(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* pColMatchInfo,
+                   __filter_result_fn_t fp, void* param) {
   if (pFilterInfo == NULL || pBlock->info.rows == 0) {
-    return TSDB_CODE_SUCCESS;
+    return (fp != NULL) ? fp(param, FILTER_RESULT_ALL_QUALIFIED) : TSDB_CODE_SUCCESS;
   }
 
   SFilterColumnParam param1 = {.numOfCols = taosArrayGetSize(pBlock->pDataBlock), .pDataBlock = pBlock->pDataBlock};
@@ -519,6 +525,14 @@ int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* p
     goto _err;
   }
 
+  if (fp != NULL) {
+    code = fp(param, status);
+    fp = NULL;
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _err;
+    }
+  }
+
   extractQualifiedTupleByFilterResult(pBlock, p, status);
 
   if (pColMatchInfo != NULL) {
@@ -537,6 +551,10 @@ int32_t doFilter(SSDataBlock* pBlock, SFilterInfo* pFilterInfo, SColMatchInfo* p
   code = TSDB_CODE_SUCCESS;
 
 _err:
+  if (fp != NULL) {
+    fp(param, FILTER_RESULT_NONE_QUALIFIED);
+  }
+
   colDataDestroy(p);
   taosMemoryFree(p);
   return code;
@@ -845,6 +863,10 @@ void destroyExprInfo(SExprInfo* pExpr, int32_t numOfExprs) {
       }
     }
 
+    if (pExprInfo->pExpr != NULL && pExprInfo->pExpr->nodeType == QUERY_NODE_OPERATOR) {
+      scalarFreeProgram(pExprInfo->pExpr->_optrRoot.pProgram);
+    }
+
     taosMemoryFree(pExprInfo->base.pParam);
     taosMemoryFree(pExprInfo->pExpr);
   }
@@ -25,9 +25,15 @@
 #include "operator.h"
 #include "querytask.h"
 #include "tcompare.h"
+#include "tgrouphash.h"
 #include "thash.h"
 #include "ttypes.h"
 
+// the number of input rows to see before deciding if the partial aggregation reduces the rows enough
+#define GROUP_AGG_SAMPLE_ROWS 100000
+// switch the partial aggregation to pass through if the groups are more than this percentage of the input rows
+#define GROUP_AGG_PASS_THROUGH_PERCENT 80
+
 typedef struct SGroupbyOperatorInfo {
   SOptrBasicInfo binfo;
   SAggSupporter  aggSup;
@@ -38,6 +44,16 @@ typedef struct SGroupbyOperatorInfo {
   int32_t        groupKeyLen;    // total group by column width
   SGroupResInfo  groupResInfo;
   SExprSupp      scalarSup;
+  SGroupHash*    pGroupHash;                       // group keys -> result row
+  int32_t        pageIds[GROUP_HASH_PARTITIONS];   // current page of each partition for the new result rows
+  int32_t        outputPartition;                  // the next group to output, partition and index in it
+  int32_t        outputIndex;
+  bool           partialAgg;      // a group may be output more than once, since the parent agg merges them
+  bool           passThrough;     // the groups are flushed after each input block
+  bool           flushing;        // returning the groups of a flush, the downstream is not exhausted yet
+  int64_t        numOfInputRows;  // input rows since the last flush
+  int64_t        memBudget;       // flush the groups of partial agg if they take more memory than it
+  int32_t        numOfFlushes;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -87,6 +103,7 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+  tGroupHashCleanup(pInfo->pGroupHash);
   taosMemoryFreeClear(param);
 }
 
@@ -319,8 +336,8 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
     int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
                                           len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
-    if (ret != TSDB_CODE_SUCCESS) {  // null data, too many state code
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    if (ret != TSDB_CODE_SUCCESS) {  // out of memory, too many groups
+      T_LONG_JMP(pTaskInfo->env, ret);
     }
 
     int32_t rowIndex = j - num;
@@ -338,7 +355,7 @@ static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
     int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
                                           len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
     if (ret != TSDB_CODE_SUCCESS) {
-      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+      T_LONG_JMP(pTaskInfo->env, ret);
     }
 
     int32_t rowIndex = pBlock->info.rows - num;
@@ -370,16 +387,73 @@ static SSDataBlock* buildGroupResultDataBlock(SOperatorInfo* pOperator) {
   return (pRes->info.rows == 0) ? NULL : pRes;
 }
 
-bool hasRemainResultByHash(SOperatorInfo* pOperator) {
+static bool hasRemainResultByHash(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  return pInfo->outputPartition < GROUP_HASH_PARTITIONS;
+}
+
+// the groups are copied partition by partition, so the result rows are read in the order of their pages
+static void doCopyToSDataBlockByGroupHash(SOperatorInfo* pOperator, SSDataBlock* pBlock, bool ignoreGroup) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
-  SSHashObj* pHashmap = pInfo->aggSup.pResultRowHashTable;
-  return pInfo->groupResInfo.index < tSimpleHashGetSize(pHashmap);
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SExprSupp*            pSup = &pOperator->exprSupp;
+  SDiskbasedBuf*        pBuf = pInfo->aggSup.pResultBuf;
+  int32_t               threshold = pOperator->resultInfo.threshold;
+
+  for (; pInfo->outputPartition < GROUP_HASH_PARTITIONS; pInfo->outputPartition += 1, pInfo->outputIndex = 0) {
+    int32_t size = tGroupHashGetPartitionSize(pInfo->pGroupHash, pInfo->outputPartition);
+    while (pInfo->outputIndex < size) {
+      SGroupHashEntry* pEntry = tGroupHashGetEntry(pInfo->pGroupHash, pInfo->outputPartition, pInfo->outputIndex);
+
+      SFilePage* page = getBufPage(pBuf, pEntry->pos.pageId);
+      if (page == NULL) {
+        qError("failed to get buffer, code:%s, %s", tstrerror(terrno), GET_TASKID(pTaskInfo));
+        T_LONG_JMP(pTaskInfo->env, terrno);
+      }
+
+      SResultRow* pRow = (SResultRow*)((char*)page + pEntry->pos.offset);
+      doUpdateNumOfRows(pSup->pCtx, pRow, pSup->numOfExprs, pSup->rowEntryInfoOffset);
+
+      // no results, continue to check the next one
+      if (pRow->numOfRows == 0) {
+        pInfo->outputIndex += 1;
+        releaseBufPage(pBuf, page);
+        continue;
+      }
+
+      if (!ignoreGroup) {
+        if (pBlock->info.id.groupId == 0) {
+          pBlock->info.id.groupId = pEntry->groupId;
+        } else if (pBlock->info.id.groupId != pEntry->groupId) {
+          // current value belongs to different group, it can't be packed into one datablock
+          releaseBufPage(pBuf, page);
+          return;
+        }
+      }
+
+      if (pBlock->info.rows + pRow->numOfRows > pBlock->info.capacity) {
+        int32_t code = blockDataEnsureCapacity(pBlock, pBlock->info.rows + pRow->numOfRows);
+        if (code != TSDB_CODE_SUCCESS) {
+          releaseBufPage(pBuf, page);
+          T_LONG_JMP(pTaskInfo->env, code);
+        }
+      }
+
+      pInfo->outputIndex += 1;
+      copyResultrowToDataBlock(pSup->pExprInfo, pSup->numOfExprs, pRow, pSup->pCtx, pBlock, pSup->rowEntryInfoOffset,
+                               pTaskInfo);
+
+      releaseBufPage(pBuf, page);
+      pBlock->info.rows += pRow->numOfRows;
+      if (pBlock->info.rows >= threshold) {
+        return;
+      }
+    }
+  }
 }
 
-void doBuildResultDatablockByHash(SOperatorInfo* pOperator, SOptrBasicInfo* pbInfo, SGroupResInfo* pGroupResInfo,
-                                  SDiskbasedBuf* pBuf) {
+static void doBuildResultDatablockByHash(SOperatorInfo* pOperator) {
   SGroupbyOperatorInfo* pInfo = pOperator->info;
-  SSHashObj*            pHashmap = pInfo->aggSup.pResultRowHashTable;
   SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
 
   SSDataBlock* pBlock = pInfo->binfo.pRes;
@@ -394,21 +468,58 @@ void doBuildResultDatablockByHash(SOperatorInfo* pOperator, SOptrBasicInfo* pbIn
 
   pBlock->info.id.groupId = 0;
   if (!pInfo->binfo.mergeResultBlock) {
-    doCopyToSDataBlockByHash(pTaskInfo, pBlock, &pOperator->exprSupp, pInfo->aggSup.pResultBuf, &pInfo->groupResInfo,
-                             pHashmap, pOperator->resultInfo.threshold, false);
+    doCopyToSDataBlockByGroupHash(pOperator, pBlock, false);
   } else {
-    while (hasRemainResultByHash(pOperator)) {
-      doCopyToSDataBlockByHash(pTaskInfo, pBlock, &pOperator->exprSupp, pInfo->aggSup.pResultBuf, &pInfo->groupResInfo,
-                               pHashmap, pOperator->resultInfo.threshold, true);
-      if (pBlock->info.rows >= pOperator->resultInfo.threshold) {
-        break;
-      }
-      pBlock->info.id.groupId = 0;
-    }
+    doCopyToSDataBlockByGroupHash(pOperator, pBlock, true);
 
     // clear the group id info in SSDataBlock, since the client does not need it
     pBlock->info.id.groupId = 0;
   }
+
+  qDebug("%s result generated, rows:%" PRId64 ", groupId:%" PRIu64, GET_TASKID(pTaskInfo), pBlock->info.rows,
+         pBlock->info.id.groupId);
+  pBlock->info.dataLoad = 1;
+  blockDataUpdateTsWindow(pBlock, 0);
+}
+
+// drop all groups after they are flushed to the parent agg, and start over with the following input blocks
+static void resetGroupHashAgg(SGroupbyOperatorInfo* pInfo) {
+  tGroupHashClear(pInfo->pGroupHash);
+  clearDiskbasedBuf(pInfo->aggSup.pResultBuf);
+  for (int32_t i = 0; i < GROUP_HASH_PARTITIONS; ++i) {
+    pInfo->pageIds[i] = -1;
+  }
+
+  pInfo->binfo.resultRowInfo.cur.pageId = -1;
+  pInfo->outputPartition = 0;
+  pInfo->outputIndex = 0;
+  pInfo->numOfInputRows = 0;
+  pInfo->flushing = false;
+}
+
+// Only the partial agg is allowed to flush its groups before the downstream is exhausted. It is flushed when the
+// groups are going to spill out of the in-memory pages, or after each block once the aggregation turns out to reduce
+// few rows, in which case maintaining a large hash table costs more than sending the rows to the parent agg.
+static bool groupAggShouldFlush(SOperatorInfo* pOperator) {
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  if (!pInfo->partialAgg) {
+    return false;
+  }
+
+  if (pInfo->passThrough) {
+    return true;
+  }
+
+  int64_t numOfGroups = tGroupHashGetSize(pInfo->pGroupHash);
+  if (pInfo->numOfInputRows >= GROUP_AGG_SAMPLE_ROWS &&
+      numOfGroups * 100 > pInfo->numOfInputRows * GROUP_AGG_PASS_THROUGH_PERCENT) {
+    pInfo->passThrough = true;
+    qDebug("%s partial group agg switched to pass through, groups:%" PRId64 ", rows:%" PRId64,
+           GET_TASKID(pOperator->pTaskInfo), numOfGroups, pInfo->numOfInputRows);
+    return true;
+  }
+
+  return tGroupHashGetMemSize(pInfo->pGroupHash) + numOfGroups * pInfo->aggSup.resultRowSize > pInfo->memBudget;
 }
 
 static SSDataBlock* buildGroupResultDataBlockByHash(SOperatorInfo* pOperator) {
@@ -417,14 +528,16 @@ static SSDataBlock* buildGroupResultDataBlockByHash(SOperatorInfo* pOperator) {
 
   // after filter, if result block turn to null, get next from whole set
   while (1) {
-    doBuildResultDatablockByHash(pOperator, &pInfo->binfo, &pInfo->groupResInfo, pInfo->aggSup.pResultBuf);
+    doBuildResultDatablockByHash(pOperator);
 
     doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
     if (!hasRemainResultByHash(pOperator)) {
-      setOperatorCompleted(pOperator);
-      // clean hash after completed
-      tSimpleHashCleanup(pInfo->aggSup.pResultRowHashTable);
-      pInfo->aggSup.pResultRowHashTable = NULL;
+      if (!pInfo->flushing) {
+        setOperatorCompleted(pOperator);
+        // clean hash after completed
+        tGroupHashCleanup(pInfo->pGroupHash);
+        pInfo->pGroupHash = NULL;
+      }
       break;
     }
     if (pRes->info.rows > 0) {
@@ -447,11 +560,17 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
   if (pOperator->status == OP_RES_TO_RETURN) {
     return buildGroupResultDataBlockByHash(pOperator);
   }
-  SGroupResInfo* pGroupResInfo = &pInfo->groupResInfo;
-  
+
+  if (pInfo->flushing) {
+    SSDataBlock* pRes = buildGroupResultDataBlockByHash(pOperator);
+    if (pRes != NULL) {
+      return pRes;
+    }
+    resetGroupHashAgg(pInfo);
+  }
+
   int32_t order = pInfo->binfo.inputTsOrder;
   int64_t        st = taosGetTimestampUs();
-  SOperatorInfo* downstream = pOperator->pDownstream[0];
 
   while (1) {
     SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, 0);
@@ -474,37 +593,32 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
     }
 
     doHashGroupbyAgg(pOperator, pBlock);
-  }
+    pInfo->numOfInputRows += pBlock->info.rows;
 
-  pOperator->status = OP_RES_TO_RETURN;
+    if (groupAggShouldFlush(pOperator)) {
+      pInfo->flushing = true;
+      pInfo->numOfFlushes += 1;
+      pOperator->cost.openCost += (taosGetTimestampUs() - st) / 1000.0;
 
-#if 0
-  if(pOperator->fpSet.encodeResultRow){
-    char *result = NULL;
-    int32_t length = 0;
-    pOperator->fpSet.encodeResultRow(pOperator, &result, &length);
-    SAggSupporter* pSup = &pInfo->aggSup;
-    taosHashClear(pSup->pResultRowHashTable);
-    pInfo->binfo.resultRowInfo.size = 0;
-    pOperator->fpSet.decodeResultRow(pOperator, result);
-    if(result){
-      taosMemoryFree(result);
+      SSDataBlock* pRes = buildGroupResultDataBlockByHash(pOperator);
+      if (pRes != NULL) {
+        return pRes;
+      }
+      resetGroupHashAgg(pInfo);
+      st = taosGetTimestampUs();
     }
   }
-#endif
-  // initGroupedResultInfo(&pInfo->groupResInfo, pInfo->aggSup.pResultRowHashTable, 0);
-  if (pGroupResInfo->pRows != NULL) {
-    taosArrayDestroy(pGroupResInfo->pRows);
-  }
-  if (pGroupResInfo->pBuf) {
-    taosMemoryFree(pGroupResInfo->pBuf);
-    pGroupResInfo->pBuf = NULL;
+
+  pOperator->status = OP_RES_TO_RETURN;
+  pInfo->outputPartition = 0;
+  pInfo->outputIndex = 0;
+
+  if (pInfo->numOfFlushes > 0) {
+    qDebug("%s partial group agg flushed %d times, passThrough:%d", GET_TASKID(pTaskInfo), pInfo->numOfFlushes,
+           pInfo->passThrough);
   }
-  pGroupResInfo->index = 0;
-  pGroupResInfo->iter = 0;
-  pGroupResInfo->dataPos = NULL;
 
-  pOperator->cost.openCost = (taosGetTimestampUs() - st) / 1000.0;
+  pOperator->cost.openCost += (taosGetTimestampUs() - st) / 1000.0;
   return buildGroupResultDataBlockByHash(pOperator);
 }
 
@@ -553,6 +667,21 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
     goto _error;
   }
 
+  pInfo->pGroupHash = tGroupHashInit(4096);
+  if (pInfo->pGroupHash == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  for (int32_t i = 0; i < GROUP_HASH_PARTITIONS; ++i) {
+    pInfo->pageIds[i] = -1;
+  }
+
+  // the groups of partial agg are flushed to the parent agg instead of spilled to disk
+  SDiskbasedBuf* pResultBuf = pInfo->aggSup.pResultBuf;
+  pInfo->memBudget = (int64_t)getNumOfInMemBufPages(pResultBuf) * getBufPageSize(pResultBuf);
+  pInfo->partialAgg = pAggNode->isPartialAgg;
+
   initResultRowInfo(&pInfo->binfo.resultRowInfo);
   setOperatorInfo(pOperator, "GroupbyAggOperator", 0, true, OP_NOT_OPENED, pInfo, pTaskInfo);
 
@@ -979,6 +1108,7 @@ SOperatorInfo* createPartitionOperatorInfo(SOperatorInfo* downstream, SPartition
     pTaskInfo->code = code;
     goto _error;
   }
+  (void)setBufPageCompressOnDisk(pInfo->pBuf, tsQuerySpillCompress);
 
   pInfo->rowCapacity = blockDataGetCapacityInRow(pInfo->binfo.pRes, getBufPageSize(pInfo->pBuf),
                                                  blockDataGetSerialMetaSize(taosArrayGetSize(pInfo->binfo.pRes->pDataBlock)));
@@ -1015,14 +1145,61 @@ _error:
   return NULL;
 }
 
+/**
+ * the key in group hash table is the same as the one of doSetResultOutBufByKey
+ * +----------+---------------+
+ * | group id |   key data    |
+ * | 8 bytes  | actual length |
+ * +----------+---------------+
+ */
 int32_t setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo* binfo, int32_t numOfCols, char* pData,
                                 int32_t bytes, uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup) {
-  SExecTaskInfo*  pTaskInfo = pOperator->pTaskInfo;
-  SResultRowInfo* pResultRowInfo = &binfo->resultRowInfo;
-  SqlFunctionCtx* pCtx = pOperator->exprSupp.pCtx;
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SResultRowInfo*       pResultRowInfo = &binfo->resultRowInfo;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+
+  SET_RES_WINDOW_KEY(pAggSup->keyBuf, pData, bytes, groupId);
+
+  bool             newGroup = false;
+  SGroupHashEntry* pEntry =
+      tGroupHashPut(pInfo->pGroupHash, pAggSup->keyBuf, GET_RES_WINDOW_KEY_LEN(bytes), &newGroup);
+  if (pEntry == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SResultRow* pResultRow = NULL;
+  if (newGroup) {
+    // the result rows of a partition are allocated from its own pages, the pages of the cold partitions are spilled
+    int32_t* pPageId = &pInfo->pageIds[tGroupHashGetPartition(pEntry->hashVal)];
+    pResultRow = getNewResultRow(pBuf, pPageId, pAggSup->resultRowSize);
+    if (pResultRow == NULL) {
+      return terrno;
+    }
 
-  SResultRow* pResultRow =
-      doSetResultOutBufByKey(pBuf, pResultRowInfo, (char*)pData, bytes, true, groupId, pTaskInfo, false, pAggSup, false);
+    pEntry->groupId = calcGroupId(pAggSup->keyBuf, GET_RES_WINDOW_KEY_LEN(bytes));
+    pEntry->pos = (SResultRowPosition){.pageId = pResultRow->pageId, .offset = pResultRow->offset};
+  } else {
+    pResultRow = getResultRowByPos(pBuf, &pEntry->pos, true);
+    if (pResultRow == NULL) {
+      return terrno;
+    }
+  }
+
+  // release the page of the previous group
+  if (pResultRowInfo->cur.pageId != -1 && pResultRowInfo->cur.pageId != pEntry->pos.pageId) {
+    SFilePage* pPage = getBufPage(pBuf, pResultRowInfo->cur.pageId);
+    if (pPage == NULL) {
+      qError("failed to get buffer, code:%s, %s", tstrerror(terrno), GET_TASKID(pTaskInfo));
+      return terrno;
+    }
+    releaseBufPage(pBuf, pPage);
+  }
+  pResultRowInfo->cur = pEntry->pos;
+
+  if (pTaskInfo->execModel == OPTR_EXEC_MODEL_BATCH && tGroupHashGetSize(pInfo->pGroupHash) > MAX_INTERVAL_TIME_WINDOW) {
+    return TSDB_CODE_QRY_TOO_MANY_TIMEWINDOW;
+  }
 
   setResultRowInitCtx(pResultRow, pCtx, numOfCols, pOperator->exprSupp.rowEntryInfoOffset);
   return TSDB_CODE_SUCCESS;
@@ -24,9 +24,13 @@
 #include "tdatablock.h"
 #include "thash.h"
 #include "tmsg.h"
+#include "tpagedbuf.h"
 #include "ttypes.h"
 #include "hashjoin.h"
 
+// | keyLen:uint16 | valLen:int32 | key | val |, the record of a spilled build row
+#define HJOIN_REC_HEAD_SIZE (sizeof(uint16_t) + sizeof(int32_t))
+
 
 static int64_t getSingleKeyRowsNum(SBufRowInfo* pRow) {
   int64_t rows = 0;
@@ -241,26 +245,70 @@ static int32_t buildHJoinResColMap(SHJoinOperatorInfo* pInfo, SHashJoinPhysiNode
 }
 
 
-static FORCE_INLINE int32_t addPageToHJoinBuf(SArray* pRowBufs) {
-  SBufPageInfo page;
-  page.pageSize = HASH_JOIN_DEFAULT_PAGE_SIZE;
+static FORCE_INLINE void addHJoinMemSize(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, int64_t size) {
+  pPart->memSize += size;
+  pJoin->memSize += size;
+}
+
+// the pages of a partition start small and double up to the default page size, so that small partitions stay small
+static FORCE_INLINE int32_t addPageToHJoinBuf(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, int32_t bufSize) {
+  SBufPageInfo* pLast = taosArrayGetLast(pPart->pRowBufs);
+  SBufPageInfo  page;
+  page.pageSize = (NULL == pLast) ? HASH_JOIN_MIN_PAGE_SIZE : TMIN(pLast->pageSize * 2, HASH_JOIN_DEFAULT_PAGE_SIZE);
+  page.pageSize = TMAX(page.pageSize, bufSize);
   page.offset = 0;
   page.data = taosMemoryMalloc(page.pageSize);
   if (NULL == page.data) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  taosArrayPush(pRowBufs, &page);
+  if (NULL == taosArrayPush(pPart->pRowBufs, &page)) {
+    taosMemoryFree(page.data);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  addHJoinMemSize(pJoin, pPart, page.pageSize);
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t initHJoinBufPages(SHJoinOperatorInfo* pInfo) {
-  pInfo->pRowBufs = taosArrayInit(32, sizeof(SBufPageInfo));
-  if (NULL == pInfo->pRowBufs) {
+static int32_t initHJoinPartHash(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, size_t hashCap) {
+  pPart->pRowBufs = taosArrayInit(8, sizeof(SBufPageInfo));
+  if (NULL == pPart->pRowBufs) {
     return TSDB_CODE_OUT_OF_MEMORY;
   }
 
-  return addPageToHJoinBuf(pInfo->pRowBufs);
+  pPart->pKeyHash = tSimpleHashInit(hashCap, pJoin->hashFp);
+  if (NULL == pPart->pKeyHash) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t initHJoinPartitions(SHJoinOperatorInfo* pInfo) {
+  size_t hashCap = pInfo->pBuild->inputStat.inputRowNum > 0
+                       ? (pInfo->pBuild->inputStat.inputRowNum * 1.5 / HASH_JOIN_PART_NUM)
+                       : (1024 / HASH_JOIN_PART_NUM);
+
+  pInfo->hashFp = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
+  pInfo->memLimit = (int64_t)tsQueryHashJoinBufSize * 1048576;
+  pInfo->spillPartIdx = -1;
+
+  for (int32_t i = 0; i < HASH_JOIN_PART_NUM; ++i) {
+    SHJoinPartition* pPart = &pInfo->parts[i];
+    pPart->pBuildPages = taosArrayInit(4, sizeof(int32_t));
+    pPart->pProbePages = taosArrayInit(4, sizeof(int32_t));
+    if (NULL == pPart->pBuildPages || NULL == pPart->pProbePages) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    int32_t code = initHJoinPartHash(pInfo, pPart, TMAX(hashCap, 64));
+    if (code) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
 }
 
 static void freeHJoinTableInfo(SHJoinTableInfo* pTable) {
@@ -297,25 +345,56 @@ static void destroyHJoinKeyHash(SSHashObj** ppHash) {
   *ppHash = NULL;
 }
 
+static void destroyHJoinPartHash(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  destroyHJoinKeyHash(&pPart->pKeyHash);
+  taosArrayDestroyEx(pPart->pRowBufs, freeHJoinBufPage);
+  pPart->pRowBufs = NULL;
+  pJoin->memSize -= pPart->memSize;
+  pPart->memSize = 0;
+}
+
+static void destroyHJoinPartitions(SHJoinOperatorInfo* pJoin) {
+  for (int32_t i = 0; i < HASH_JOIN_PART_NUM; ++i) {
+    SHJoinPartition* pPart = &pJoin->parts[i];
+    destroyHJoinPartHash(pJoin, pPart);
+    taosArrayDestroy(pPart->pBuildPages);
+    taosArrayDestroy(pPart->pProbePages);
+    pPart->pProbeBlk = blockDataDestroy(pPart->pProbeBlk);
+    pPart->pBuildPages = NULL;
+    pPart->pProbePages = NULL;
+  }
+
+  destroyDiskbasedBuf(pJoin->pBuildSpillBuf);
+  destroyDiskbasedBuf(pJoin->pProbeSpillBuf);
+  pJoin->pBuildSpillBuf = NULL;
+  pJoin->pProbeSpillBuf = NULL;
+  pJoin->pSpillBlk = blockDataDestroy(pJoin->pSpillBlk);
+}
+
 static void destroyHashJoinOperator(void* param) {
   SHJoinOperatorInfo* pJoinOperator = (SHJoinOperatorInfo*)param;
-  qError("hashJoin exec info, buildBlk:%" PRId64 ", buildRows:%" PRId64 ", probeBlk:%" PRId64 ", probeRows:%" PRId64 ", resRows:%" PRId64, 
-         pJoinOperator->execInfo.buildBlkNum, pJoinOperator->execInfo.buildBlkRows, pJoinOperator->execInfo.probeBlkNum, 
-         pJoinOperator->execInfo.probeBlkRows, pJoinOperator->execInfo.resRows);
+  qError("hashJoin exec info, buildBlk:%" PRId64 ", buildRows:%" PRId64 ", probeBlk:%" PRId64 ", probeRows:%" PRId64 ", resRows:%" PRId64
+         ", spillParts:%" PRId64 ", spillBuildRows:%" PRId64 ", spillProbeRows:%" PRId64,
+         pJoinOperator->execInfo.buildBlkNum, pJoinOperator->execInfo.buildBlkRows, pJoinOperator->execInfo.probeBlkNum,
+         pJoinOperator->execInfo.probeBlkRows, pJoinOperator->execInfo.resRows, pJoinOperator->execInfo.spillParts,
+         pJoinOperator->execInfo.spillBuildRows, pJoinOperator->execInfo.spillProbeRows);
 
-  destroyHJoinKeyHash(&pJoinOperator->pKeyHash);
+  destroyHJoinPartitions(pJoinOperator);
 
   freeHJoinTableInfo(&pJoinOperator->tbs[0]);
   freeHJoinTableInfo(&pJoinOperator->tbs[1]);
   pJoinOperator->pRes = blockDataDestroy(pJoinOperator->pRes);
   taosMemoryFreeClear(pJoinOperator->pResColMap);
-  taosArrayDestroyEx(pJoinOperator->pRowBufs, freeHJoinBufPage);
   nodesDestroyNode(pJoinOperator->pCond);
 
   taosMemoryFreeClear(param);
 }
 
 static FORCE_INLINE char* retrieveColDataFromRowBufs(SArray* pRowBufs, SBufRowInfo* pRow) {
+  if (UINT16_MAX == pRow->pageId) {
+    return NULL;  // no value column
+  }
+
   SBufPageInfo *pPage = taosArrayGet(pRowBufs, pRow->pageId);
   return pPage->data + pRow->offset;
 }
@@ -329,7 +408,7 @@ static FORCE_INLINE int32_t copyHJoinResRowsToBlock(SHJoinOperatorInfo* pJoin, i
   int32_t code = 0;
 
   for (int32_t r = 0; r < rowNum; ++r) {
-    char* pData = retrieveColDataFromRowBufs(pJoin->pRowBufs, pRow);
+    char* pData = retrieveColDataFromRowBufs(pJoin->ctx.pPart->pRowBufs, pRow);
     char* pValData = pData + pBuild->valBitMapSize;
     char* pKeyData = pProbe->keyData;
     buildIdx = buildValIdx = probeIdx = 0;
@@ -436,6 +515,171 @@ static FORCE_INLINE void copyKeyColsDataToBuf(SHJoinTableInfo* pTable, int32_t r
 }
 
 
+static FORCE_INLINE SHJoinPartition* getHJoinPartition(SHJoinOperatorInfo* pJoin, const char* pKey, size_t keyLen) {
+  uint32_t hashVal = (*pJoin->hashFp)(pKey, (uint32_t)keyLen);
+  return &pJoin->parts[hashVal >> (32 - HASH_JOIN_RADIX_BITS)];
+}
+
+static int32_t initHJoinSpillBuf(SDiskbasedBuf** ppBuf, int32_t pageSize, const char* id) {
+  if (NULL != *ppBuf) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (!osTempSpaceAvailable()) {
+    terrno = TSDB_CODE_NO_DISKSPACE;
+    qError("hash join spill failed since %s, tempDir:%s", terrstr(), tsTempDir);
+    return terrno;
+  }
+
+  // the current page of each spilled partition stays pinned in memory while it is being filled
+  int32_t inMemSize = TMAX(HASH_JOIN_SPILL_MEM_SIZE, pageSize * (HASH_JOIN_PART_NUM + 1));
+  int32_t code = createDiskbasedBuf(ppBuf, pageSize, inMemSize, id, tsTempDir);
+  if (code) {
+    return code;
+  }
+
+  dBufSetPrintInfo(*ppBuf);
+  (void)setBufPageCompressOnDisk(*ppBuf, tsQuerySpillCompress);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t flushHJoinProbePage(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  if (NULL == pPart->pProbeBlk || pPart->pProbeBlk->info.rows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t pageId = -1;
+  void*   pPage = getNewBufPage(pJoin->pProbeSpillBuf, &pageId);
+  if (NULL == pPage) {
+    return terrno;
+  }
+
+  blockDataToBuf(pPage, pPart->pProbeBlk);
+  setBufPageDirty(pPage, true);
+  releaseBufPage(pJoin->pProbeSpillBuf, pPage);
+
+  if (NULL == taosArrayPush(pPart->pProbePages, &pageId)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  blockDataCleanup(pPart->pProbeBlk);
+  return TSDB_CODE_SUCCESS;
+}
+
+// probe rows of a spilled partition are kept in the probe block layout, and probed again once the partition is loaded
+static int32_t addProbeRowToSpill(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, SSDataBlock* pBlock,
+                                  int32_t rowIdx) {
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  if (NULL == pJoin->pProbeSpillBuf) {
+    int32_t pageSize = TMAX(HASH_JOIN_MIN_PAGE_SIZE, blockDataGetRowSize(pBlock) * 4 + blockDataGetSerialMetaSize(numOfCols));
+    int32_t code = initHJoinSpillBuf(&pJoin->pProbeSpillBuf, pageSize, "hashJoinProbe");
+    if (code) {
+      return code;
+    }
+
+    pJoin->probeRowsPerPage = (pageSize - blockDataGetSerialMetaSize(numOfCols)) / blockDataGetSerialRowSize(pBlock);
+    pJoin->pSpillBlk = createOneDataBlock(pBlock, false);
+    if (NULL == pJoin->pSpillBlk) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (NULL == pPart->pProbeBlk) {
+    pPart->pProbeBlk = createOneDataBlock(pBlock, false);
+    if (NULL == pPart->pProbeBlk || blockDataEnsureCapacity(pPart->pProbeBlk, pJoin->probeRowsPerPage)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SSDataBlock* pDst = pPart->pProbeBlk;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pSrcCol = taosArrayGet(pBlock->pDataBlock, i);
+    SColumnInfoData* pDstCol = taosArrayGet(pDst->pDataBlock, i);
+    if (colDataIsNull_s(pSrcCol, rowIdx)) {
+      colDataSetNULL(pDstCol, pDst->info.rows);
+    } else {
+      int32_t code = colDataSetVal(pDstCol, pDst->info.rows, colDataGetData(pSrcCol, rowIdx), false);
+      if (code) {
+        return code;
+      }
+    }
+  }
+
+  pDst->info.rows++;
+  pJoin->execInfo.spillProbeRows++;
+
+  if (pDst->info.rows >= pJoin->probeRowsPerPage) {
+    return flushHJoinProbePage(pJoin, pPart);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t finishHJoinProbeSpill(SHJoinOperatorInfo* pJoin) {
+  for (int32_t i = 0; i < HASH_JOIN_PART_NUM; ++i) {
+    SHJoinPartition* pPart = &pJoin->parts[i];
+    if (!pPart->spilled) {
+      destroyHJoinPartHash(pJoin, pPart);  // all probe rows of the partition are done
+      continue;
+    }
+
+    int32_t code = flushHJoinProbePage(pJoin, pPart);
+    if (code) {
+      return code;
+    }
+    pPart->pProbeBlk = blockDataDestroy(pPart->pProbeBlk);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t loadHJoinSpilledPartition(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart);
+
+// load the spilled partitions one by one, and return their spilled probe rows a page at a time
+static int32_t getNextHJoinSpillBlock(SHJoinOperatorInfo* pJoin, SSDataBlock** ppBlock) {
+  *ppBlock = NULL;
+
+  while (true) {
+    if (pJoin->spillPartIdx >= 0) {
+      SHJoinPartition* pPart = &pJoin->parts[pJoin->spillPartIdx];
+      if (pJoin->spillPageIdx < taosArrayGetSize(pPart->pProbePages)) {
+        int32_t* pageId = taosArrayGet(pPart->pProbePages, pJoin->spillPageIdx++);
+        void*    pPage = getBufPage(pJoin->pProbeSpillBuf, *pageId);
+        if (NULL == pPage) {
+          return terrno;
+        }
+
+        int32_t code = blockDataFromBuf(pJoin->pSpillBlk, pPage);
+        releaseBufPage(pJoin->pProbeSpillBuf, pPage);
+        if (code) {
+          return code;
+        }
+
+        *ppBlock = pJoin->pSpillBlk;
+        return TSDB_CODE_SUCCESS;
+      }
+
+      destroyHJoinPartHash(pJoin, pPart);
+    }
+
+    do {
+      pJoin->spillPartIdx++;
+    } while (pJoin->spillPartIdx < HASH_JOIN_PART_NUM &&
+             !(pJoin->parts[pJoin->spillPartIdx].spilled &&
+               taosArrayGetSize(pJoin->parts[pJoin->spillPartIdx].pProbePages) > 0));
+
+    if (pJoin->spillPartIdx >= HASH_JOIN_PART_NUM) {
+      return TSDB_CODE_SUCCESS;
+    }
+
+    pJoin->spillPageIdx = 0;
+    int32_t code = loadHJoinSpilledPartition(pJoin, &pJoin->parts[pJoin->spillPartIdx]);
+    if (code) {
+      return code;
+    }
+  }
+}
+
 static void doHashJoinImpl(struct SOperatorInfo* pOperator) {
   SHJoinOperatorInfo* pJoin = pOperator->info;
   SHJoinTableInfo* pProbe = pJoin->pProbe;
@@ -459,7 +703,17 @@ static void doHashJoinImpl(struct SOperatorInfo* pOperator) {
 
   for (; pCtx->probeIdx < pCtx->pProbeData->info.rows; ++pCtx->probeIdx) {
     copyKeyColsDataToBuf(pProbe, pCtx->probeIdx, &bufLen);
-    SGroupData* pGroup = tSimpleHashGet(pJoin->pKeyHash, pProbe->keyData, bufLen);
+    SHJoinPartition* pPart = getHJoinPartition(pJoin, pProbe->keyData, bufLen);
+    if (pPart->spilled) {
+      int32_t code = addProbeRowToSpill(pJoin, pPart, pCtx->pProbeData, pCtx->probeIdx);
+      if (code) {
+        pOperator->pTaskInfo->code = code;
+        T_LONG_JMP(pOperator->pTaskInfo->env, code);
+      }
+      continue;
+    }
+
+    SGroupData* pGroup = tSimpleHashGet(pPart->pKeyHash, pProbe->keyData, bufLen);
 /*
     size_t keySize = 0;
     int32_t* pKey = tSimpleHashGetKey(pGroup, &keySize);
@@ -469,6 +723,7 @@ static void doHashJoinImpl(struct SOperatorInfo* pOperator) {
     qTrace("hash_key:%d, rows:%" PRId64, *pKey, rows);
 */
     if (pGroup) {
+      pCtx->pPart = pPart;
       pCtx->pBuildRow = pGroup->rows;
       appendHJoinResToBlock(pOperator, pRes, &allFetched);
       if (pRes->info.rows >= pRes->info.capacity) {
@@ -571,7 +826,8 @@ static FORCE_INLINE void copyValColsDataToBuf(SHJoinTableInfo* pTable, int32_t r
 }
 
 
-static FORCE_INLINE int32_t getValBufFromPages(SArray* pPages, int32_t bufSize, char** pBuf, SBufRowInfo* pRow) {
+static FORCE_INLINE int32_t getValBufFromPages(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, int32_t bufSize,
+                                               char** pBuf, SBufRowInfo* pRow) {
   if (0 == bufSize) {
     pRow->pageId = -1;
     return TSDB_CODE_SUCCESS;
@@ -583,16 +839,16 @@ static FORCE_INLINE int32_t getValBufFromPages(SArray* pPages, int32_t bufSize,
   }
   
   do {
-    SBufPageInfo* page = taosArrayGetLast(pPages);
-    if ((page->pageSize - page->offset) >= bufSize) {
+    SBufPageInfo* page = taosArrayGetLast(pPart->pRowBufs);
+    if (page && (page->pageSize - page->offset) >= bufSize) {
       *pBuf = page->data + page->offset;
-      pRow->pageId = taosArrayGetSize(pPages) - 1;
+      pRow->pageId = taosArrayGetSize(pPart->pRowBufs) - 1;
       pRow->offset = page->offset;
       page->offset += bufSize;
       return TSDB_CODE_SUCCESS;
     }
 
-    int32_t code = addPageToHJoinBuf(pPages);
+    int32_t code = addPageToHJoinBuf(pJoin, pPart, bufSize);
     if (code) {
       return code;
     }
@@ -609,6 +865,9 @@ static FORCE_INLINE int32_t getHJoinValBufSize(SHJoinTableInfo* pTable, int32_t
   int32_t varColNum = taosArrayGetSize(pTable->valVarCols);
   for (int32_t i = 0; i < varColNum; ++i) {
     varColIdx = taosArrayGet(pTable->valVarCols, i);
+    if (pTable->valCols[*varColIdx].keyCol || -1 == pTable->valCols[*varColIdx].offset[rowIdx]) {
+      continue;
+    }
     char* pData = pTable->valCols[*varColIdx].data + pTable->valCols[*varColIdx].offset[rowIdx];
     bufLen += varDataTLen(pData);
   }
@@ -616,8 +875,24 @@ static FORCE_INLINE int32_t getHJoinValBufSize(SHJoinTableInfo* pTable, int32_t
   return bufLen;
 }
 
+// the length of a value buffer written by copyValColsDataToBuf
+static int32_t getHJoinRowValLen(SHJoinTableInfo* pTable, const char* pData) {
+  int32_t len = pTable->valBitMapSize;
+  for (int32_t i = 0, m = 0; i < pTable->valNum; ++i) {
+    if (pTable->valCols[i].keyCol) {
+      continue;
+    }
+    if (!colDataIsNull_f(pData, m)) {
+      len += pTable->valCols[i].vardata ? varDataTLen(pData + len) : pTable->valCols[i].bytes;
+    }
+    m++;
+  }
+
+  return len;
+}
 
-static int32_t addRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, SHJoinTableInfo* pTable, size_t keyLen, int32_t rowIdx) {
+static int32_t addRowToHashImpl(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, SGroupData* pGroup,
+                                SHJoinTableInfo* pTable, size_t keyLen, int32_t bufSize) {
   SGroupData group = {0};
   SBufRowInfo* pRow = NULL;
 
@@ -634,7 +909,7 @@ static int32_t addRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, S
     }
   }
 
-  int32_t code = getValBufFromPages(pJoin->pRowBufs, getHJoinValBufSize(pTable, rowIdx), &pTable->valData, pRow);
+  int32_t code = getValBufFromPages(pJoin, pPart, bufSize, &pTable->valData, pRow);
   if (code) {
     taosMemoryFree(pRow);
     return code;
@@ -642,32 +917,201 @@ static int32_t addRowToHashImpl(SHJoinOperatorInfo* pJoin, SGroupData* pGroup, S
 
   if (NULL == pGroup) {
     pRow->next = NULL;
-    if (tSimpleHashPut(pJoin->pKeyHash, pTable->keyData, keyLen, &group, sizeof(group))) {
+    if (tSimpleHashPut(pPart->pKeyHash, pTable->keyData, keyLen, &group, sizeof(group))) {
       taosMemoryFree(pRow);
       return TSDB_CODE_OUT_OF_MEMORY;
     }
+    addHJoinMemSize(pJoin, pPart, keyLen + sizeof(SGroupData) + sizeof(SBufRowInfo));
   } else {
     pRow->next = pGroup->rows;
     pGroup->rows = pRow;
+    addHJoinMemSize(pJoin, pPart, sizeof(SBufRowInfo));
   }
 
   return TSDB_CODE_SUCCESS;
 }
 
-static int32_t addRowToHash(SHJoinOperatorInfo* pJoin, SSDataBlock* pBlock, size_t keyLen, int32_t rowIdx) {
+static int32_t addRowToHash(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, size_t keyLen, int32_t rowIdx) {
   SHJoinTableInfo* pBuild = pJoin->pBuild;
-  int32_t code = setValColsData(pBlock, pBuild);
+  SGroupData* pGroup = tSimpleHashGet(pPart->pKeyHash, pBuild->keyData, keyLen);
+  int32_t code = addRowToHashImpl(pJoin, pPart, pGroup, pBuild, keyLen, getHJoinValBufSize(pBuild, rowIdx));
   if (code) {
     return code;
   }
+  
+  copyValColsDataToBuf(pBuild, rowIdx);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static void releaseHJoinBuildPage(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  if (NULL != pPart->pBuildPage) {
+    setBufPageDirty(pPart->pBuildPage, true);
+    releaseBufPage(pJoin->pBuildSpillBuf, pPart->pBuildPage);
+    pPart->pBuildPage = NULL;
+  }
+}
+
+// a page of the spilled build rows is | used length:int32 | record | record |...|
+static int32_t writeHJoinBuildRecord(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, const char* pKey,
+                                     size_t keyLen, int32_t valLen, char** ppVal) {
+  int32_t recLen = HJOIN_REC_HEAD_SIZE + keyLen + valLen;
+  if (NULL != pPart->pBuildPage && *(int32_t*)pPart->pBuildPage + recLen > getBufPageSize(pJoin->pBuildSpillBuf)) {
+    releaseHJoinBuildPage(pJoin, pPart);
+  }
 
-  SGroupData* pGroup = tSimpleHashGet(pJoin->pKeyHash, pBuild->keyData, keyLen);
-  code = addRowToHashImpl(pJoin, pGroup, pBuild, keyLen, rowIdx);
+  if (NULL == pPart->pBuildPage) {
+    pPart->pBuildPage = getNewBufPage(pJoin->pBuildSpillBuf, &pPart->buildPageId);
+    if (NULL == pPart->pBuildPage) {
+      return terrno;
+    }
+    if (NULL == taosArrayPush(pPart->pBuildPages, &pPart->buildPageId)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    *(int32_t*)pPart->pBuildPage = sizeof(int32_t);
+  }
+
+  char* pRec = pPart->pBuildPage + *(int32_t*)pPart->pBuildPage;
+  *(uint16_t*)pRec = (uint16_t)keyLen;
+  *(int32_t*)(pRec + sizeof(uint16_t)) = valLen;
+  memcpy(pRec + HJOIN_REC_HEAD_SIZE, pKey, keyLen);
+  *ppVal = pRec + HJOIN_REC_HEAD_SIZE + keyLen;
+
+  *(int32_t*)pPart->pBuildPage += recLen;
+  pJoin->execInfo.spillBuildRows++;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t addRowToSpill(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart, size_t keyLen, int32_t rowIdx) {
+  SHJoinTableInfo* pBuild = pJoin->pBuild;
+  int32_t code = writeHJoinBuildRecord(pJoin, pPart, pBuild->keyData, keyLen, getHJoinValBufSize(pBuild, rowIdx),
+                                       &pBuild->valData);
   if (code) {
     return code;
   }
-  
+
   copyValColsDataToBuf(pBuild, rowIdx);
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t initHJoinBuildSpillBuf(SHJoinOperatorInfo* pJoin) {
+  SHJoinTableInfo* pBuild = pJoin->pBuild;
+  int32_t          maxRecLen = HJOIN_REC_HEAD_SIZE + pBuild->valBufSize;
+  for (int32_t i = 0; i < pBuild->keyNum; ++i) {
+    maxRecLen += pBuild->keyCols[i].bytes;
+  }
+  for (int32_t i = 0; i < pBuild->valNum; ++i) {
+    if (!pBuild->valCols[i].keyCol && pBuild->valCols[i].vardata) {
+      maxRecLen += pBuild->valCols[i].bytes;
+    }
+  }
+
+  return initHJoinSpillBuf(&pJoin->pBuildSpillBuf, TMAX(HASH_JOIN_MIN_PAGE_SIZE, maxRecLen + sizeof(int32_t)),
+                           "hashJoinBuild");
+}
+
+// move all the build rows of an in-memory partition to disk, the following rows of it are spilled directly
+static int32_t spillHJoinPartition(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  SHJoinTableInfo* pBuild = pJoin->pBuild;
+  int32_t          code = initHJoinBuildSpillBuf(pJoin);
+  if (code) {
+    return code;
+  }
+
+  qDebug("hash join spill partition %d, memSize:%" PRId64 ", total memSize:%" PRId64, (int32_t)(pPart - pJoin->parts),
+         pPart->memSize, pJoin->memSize);
+
+  SGroupData* pGroup = NULL;
+  int32_t     iter = 0;
+  while (NULL != (pGroup = tSimpleHashIterate(pPart->pKeyHash, pGroup, &iter))) {
+    size_t keyLen = 0;
+    char*  pKey = tSimpleHashGetKey(pGroup, &keyLen);
+    for (SBufRowInfo* pRow = pGroup->rows; pRow != NULL; pRow = pRow->next) {
+      char*   pData = retrieveColDataFromRowBufs(pPart->pRowBufs, pRow);
+      int32_t valLen = (NULL == pData) ? 0 : getHJoinRowValLen(pBuild, pData);
+      char*   pVal = NULL;
+      code = writeHJoinBuildRecord(pJoin, pPart, pKey, keyLen, valLen, &pVal);
+      if (code) {
+        return code;
+      }
+      if (valLen > 0) {
+        memcpy(pVal, pData, valLen);
+      }
+    }
+  }
+
+  destroyHJoinPartHash(pJoin, pPart);
+  pPart->spilled = true;
+  pJoin->execInfo.spillParts++;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t checkHJoinMemLimit(SHJoinOperatorInfo* pJoin) {
+  while (pJoin->memSize > pJoin->memLimit) {
+    SHJoinPartition* pMax = NULL;
+    for (int32_t i = 0; i < HASH_JOIN_PART_NUM; ++i) {
+      SHJoinPartition* pPart = &pJoin->parts[i];
+      if (!pPart->spilled && (NULL == pMax || pPart->memSize > pMax->memSize)) {
+        pMax = pPart;
+      }
+    }
+
+    if (NULL == pMax || pMax->memSize <= 0) {
+      break;
+    }
+
+    int32_t code = spillHJoinPartition(pJoin, pMax);
+    if (code) {
+      return code;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t loadHJoinSpilledPartition(SHJoinOperatorInfo* pJoin, SHJoinPartition* pPart) {
+  SHJoinTableInfo* pBuild = pJoin->pBuild;
+  int32_t          code = initHJoinPartHash(pJoin, pPart, 1024);
+  if (code) {
+    return code;
+  }
+
+  int32_t pageNum = taosArrayGetSize(pPart->pBuildPages);
+  for (int32_t i = 0; i < pageNum; ++i) {
+    int32_t* pageId = taosArrayGet(pPart->pBuildPages, i);
+    char*    pPage = getBufPage(pJoin->pBuildSpillBuf, *pageId);
+    if (NULL == pPage) {
+      return terrno;
+    }
+
+    int32_t used = *(int32_t*)pPage;
+    int32_t offset = sizeof(int32_t);
+    while (offset < used) {
+      uint16_t keyLen = *(uint16_t*)(pPage + offset);
+      int32_t  valLen = *(int32_t*)(pPage + offset + sizeof(uint16_t));
+      pBuild->keyData = pPage + offset + HJOIN_REC_HEAD_SIZE;
+
+      SGroupData* pGroup = tSimpleHashGet(pPart->pKeyHash, pBuild->keyData, keyLen);
+      code = addRowToHashImpl(pJoin, pPart, pGroup, pBuild, keyLen, valLen);
+      if (code) {
+        releaseBufPage(pJoin->pBuildSpillBuf, pPage);
+        return code;
+      }
+      if (valLen > 0) {
+        memcpy(pBuild->valData, pBuild->keyData + keyLen, valLen);
+      }
+
+      offset += HJOIN_REC_HEAD_SIZE + keyLen + valLen;
+    }
+
+    releaseBufPage(pJoin->pBuildSpillBuf, pPage);
+  }
+
+  pPart->spilled = false;
+  if (pJoin->memSize > pJoin->memLimit) {
+    qWarn("hash join partition %d exceeds the buffer size after loaded, memSize:%" PRId64 ", limit:%" PRId64,
+          (int32_t)(pPart - pJoin->parts), pJoin->memSize, pJoin->memLimit);
+  }
 
   return TSDB_CODE_SUCCESS;
 }
@@ -678,17 +1122,26 @@ static int32_t addBlockRowsToHash(SSDataBlock* pBlock, SHJoinOperatorInfo* pJoin
   if (code) {
     return code;
   }
+  code = setValColsData(pBlock, pBuild);
+  if (code) {
+    return code;
+  }
 
   size_t bufLen = 0;
   for (int32_t i = 0; i < pBlock->info.rows; ++i) {
     copyKeyColsDataToBuf(pBuild, i, &bufLen);
-    code = addRowToHash(pJoin, pBlock, bufLen, i);
+    SHJoinPartition* pPart = getHJoinPartition(pJoin, pBuild->keyData, bufLen);
+    if (pPart->spilled) {
+      code = addRowToSpill(pJoin, pPart, bufLen, i);
+    } else {
+      code = addRowToHash(pJoin, pPart, bufLen, i);
+    }
     if (code) {
       return code;
     }
   }
 
-  return code;
+  return checkHJoinMemLimit(pJoin);
 }
 
 static int32_t buildHJoinKeyHash(struct SOperatorInfo* pOperator) {
@@ -711,6 +1164,10 @@ static int32_t buildHJoinKeyHash(struct SOperatorInfo* pOperator) {
     }
   }
 
+  for (int32_t i = 0; i < HASH_JOIN_PART_NUM; ++i) {
+    releaseHJoinBuildPage(pJoin, &pJoin->parts[i]);
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -740,7 +1197,7 @@ static void setHJoinDone(struct SOperatorInfo* pOperator) {
   setOperatorCompleted(pOperator);
 
   SHJoinOperatorInfo* pInfo = pOperator->info;
-  destroyHJoinKeyHash(&pInfo->pKeyHash);
+  destroyHJoinPartitions(pInfo);
 
   qError("hash Join done");  
 }
@@ -770,12 +1227,10 @@ static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
       T_LONG_JMP(pTaskInfo->env, code);
     }
 
-    if (tSimpleHashGetSize(pJoin->pKeyHash) <= 0) {
+    if (pJoin->execInfo.buildBlkRows <= 0) {
       setHJoinDone(pOperator);
       goto _return;
     }
-
-    //qTrace("build table rows:%" PRId64, getRowsNumOfKeyHash(pJoin->pKeyHash));
   }
 
   if (pJoin->ctx.rowRemains) {
@@ -790,14 +1245,31 @@ static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
   }
 
   while (true) {
-    SSDataBlock* pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+    SSDataBlock* pBlock = NULL;
+    if (!pJoin->probeDone) {
+      pBlock = getNextBlockFromDownstream(pOperator, pJoin->pProbe->downStreamIdx);
+      if (NULL == pBlock) {
+        pJoin->probeDone = true;
+        code = finishHJoinProbeSpill(pJoin);
+      } else {
+        pJoin->execInfo.probeBlkNum++;
+        pJoin->execInfo.probeBlkRows += pBlock->info.rows;
+      }
+    }
+
+    // join the spilled partitions one by one after all the probe rows are read
+    if (TSDB_CODE_SUCCESS == code && NULL == pBlock) {
+      code = getNextHJoinSpillBlock(pJoin, &pBlock);
+    }
+    if (code) {
+      pTaskInfo->code = code;
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+
     if (NULL == pBlock) {
       setHJoinDone(pOperator);
       break;
     }
-
-    pJoin->execInfo.probeBlkNum++;
-    pJoin->execInfo.probeBlkRows += pBlock->info.rows;
     
     code = launchBlockHashJoin(pOperator, pBlock);
     if (code) {
@@ -853,18 +1325,11 @@ SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t n
     goto _error;
   }
 
-  code = initHJoinBufPages(pInfo);
+  code = initHJoinPartitions(pInfo);
   if (code) {
     goto _error;
   }
 
-  size_t hashCap = pInfo->pBuild->inputStat.inputRowNum > 0 ? (pInfo->pBuild->inputStat.inputRowNum * 1.5) : 1024;
-  pInfo->pKeyHash = tSimpleHashInit(hashCap, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY));
-  if (pInfo->pKeyHash == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _error;
-  }
-
   if (pJoinNode->pFilterConditions != NULL && pJoinNode->node.pConditions != NULL) {
     pInfo->pCond = nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
     if (pInfo->pCond == NULL) {
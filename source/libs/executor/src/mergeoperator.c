@@ -51,6 +51,7 @@ typedef struct SMultiwayMergeOperatorInfo {
     SColsMergeInfo    colsMergeInfo;
   };
   SLimitInfo     limitInfo;
+  bool           limitReached;  // no more rows are required, the exchanges below are not fetched any more
   bool           groupMerge;
   bool           ignoreGroupId;
   uint64_t       groupId;
@@ -157,6 +158,9 @@ SSDataBlock* doSortMerge(SOperatorInfo* pOperator) {
   qDebug("start to merge final sorted rows, %s", GET_TASKID(pTaskInfo));
 
   blockDataCleanup(pDataBlock);
+  if (pInfo->limitReached) {
+    return NULL;
+  }
 
   if (pSortMergeInfo->pIntermediateBlock == NULL) {
     pSortMergeInfo->pIntermediateBlock = tsortGetSortedDataBlock(pHandle);
@@ -182,9 +186,14 @@ SSDataBlock* doSortMerge(SOperatorInfo* pOperator) {
       resetLimitInfoForNextGroup(&pInfo->limitInfo);
     }
 
-    applyLimitOffset(&pInfo->limitInfo, p, pTaskInfo);
+    bool limitReached = applyLimitOffset(&pInfo->limitInfo, p, pTaskInfo);
+
+    // the rows of the following groups are still required, if the merge is done by group
+    if (limitReached && !pInfo->groupMerge && !pInfo->inputWithGroupId) {
+      pInfo->limitReached = true;
+    }
 
-    if (p->info.rows > 0) {
+    if (p->info.rows > 0 || pInfo->limitReached) {
       break;
     }
   }
@@ -792,6 +792,27 @@ int32_t projectApplyFunctions(SExprInfo* pExpr, SSDataBlock* pResult, SSDataBloc
       }
 
       numOfRows = pSrcBlock->info.rows;
+    } else if (pExpr[k].pExpr->nodeType == QUERY_NODE_OPERATOR && pExpr[k].pExpr->_optrRoot.pProgram != NULL) {
+      SArray* pBlockList = taosArrayInit(1, POINTER_BYTES);
+      taosArrayPush(pBlockList, &pSrcBlock);
+
+      // the compiled program writes the result into the output column directly
+      SColumnInfoData* pResColData = taosArrayGet(pResult->pDataBlock, outputSlotId);
+      int32_t          startOffset = createNewColModel ? 0 : pResult->info.rows;
+
+      int32_t code = TSDB_CODE_SUCCESS;
+      if (startOffset + pSrcBlock->info.rows > pResult->info.capacity) {
+        code = blockDataEnsureCapacity(pResult, startOffset + pSrcBlock->info.rows);
+      }
+
+      if (code == TSDB_CODE_SUCCESS) {
+        code = scalarExecProgram(pExpr[k].pExpr->_optrRoot.pProgram, pBlockList, pResColData, startOffset, &numOfRows);
+      }
+
+      taosArrayDestroy(pBlockList);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
     } else if (pExpr[k].pExpr->nodeType == QUERY_NODE_OPERATOR) {
       SArray* pBlockList = taosArrayInit(4, POINTER_BYTES);
       taosArrayPush(pBlockList, &pSrcBlock);
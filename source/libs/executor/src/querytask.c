@@ -22,6 +22,7 @@
 #include "tname.h"
 
 #include "tdatablock.h"
+#include "tglobal.h"
 #include "tmsg.h"
 
 #include "executorInt.h"
@@ -35,6 +36,17 @@
 
 #define CLEAR_QUERY_STATUS(q, st) ((q)->status &= (~(st)))
 
+// the arena of a task is capped by queryArenaMaxSize
+static int32_t chargeTaskArena(void* param, int64_t size) {
+  SExecTaskInfo* pTaskInfo = param;
+  int64_t        limit = (int64_t)tsQueryArenaMaxSize * 1024 * 1024;
+  if (size > 0 && limit > 0 && taosArenaChunkSize(pTaskInfo->pArena) + size > limit) {
+    qError("%s arena exceeds the limit %" PRId64 " bytes", GET_TASKID(pTaskInfo), limit);
+    return terrno = TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 SExecTaskInfo* doCreateTask(uint64_t queryId, uint64_t taskId, int32_t vgId, EOPTR_EXEC_MODEL model, SStorageAPI* pAPI) {
   SExecTaskInfo* pTaskInfo = taosMemoryCalloc(1, sizeof(SExecTaskInfo));
   if (pTaskInfo == NULL) {
@@ -58,7 +70,12 @@ SExecTaskInfo* doCreateTask(uint64_t queryId, uint64_t taskId, int32_t vgId, EOP
   pTaskInfo->id.str = taosMemoryMalloc(64);
   buildTaskId(taskId, queryId, pTaskInfo->id.str);
   pTaskInfo->schemaInfos = taosArrayInit(1, sizeof(SSchemaInfo));
-  
+  pTaskInfo->pArena = taosArenaCreate(chargeTaskArena, pTaskInfo);
+  if (pTaskInfo->pArena == NULL) {
+    doDestroyTask(pTaskInfo);
+    return NULL;
+  }
+
   return pTaskInfo;
 }
 
@@ -233,6 +250,7 @@ void doDestroyTask(SExecTaskInfo* pTaskInfo) {
   taosArrayDestroy(pTaskInfo->stopInfo.pStopInfo);
   taosMemoryFreeClear(pTaskInfo->sql);
   taosMemoryFreeClear(pTaskInfo->id.str);
+  taosArenaDestroy(pTaskInfo->pArena);
   taosMemoryFreeClear(pTaskInfo);
 }
 
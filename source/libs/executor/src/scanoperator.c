@@ -34,6 +34,7 @@
 #include "querytask.h"
 
 #include "storageapi.h"
+#include "tglobal.h"
 #include "wal.h"
 
 int32_t scanDebug = 0;
@@ -230,6 +231,36 @@ static bool doFilterByBlockSMA(SFilterInfo* pFilterInfo, SColumnDataAgg** pColsA
   return keep;
 }
 
+// no row of the data block can enter the result of the top-N sort above, if the best value of the sort key in the
+// block does not beat the threshold.
+static bool doSkipBlockByTopN(STopNThreshold* pTopN, SSDataBlock* pBlock) {
+  if (pTopN == NULL || !pTopN->valid || pBlock->pBlockAgg == NULL) {
+    return false;
+  }
+
+  SColumnDataAgg*  pAgg = pBlock->pBlockAgg[pTopN->slotId];
+  SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pTopN->slotId);
+  if (pAgg == NULL || pCol == NULL || (pAgg->numOfNull > 0 && pTopN->nullFirst)) {
+    return false;
+  }
+
+  if (pAgg->numOfNull == pBlock->info.rows) {
+    return !pTopN->nullFirst;
+  }
+
+  double  v = 0;
+  int64_t* pVal = (pTopN->order == TSDB_ORDER_ASC) ? &pAgg->min : &pAgg->max;
+  if (IS_FLOAT_TYPE(pCol->info.type)) {
+    v = GET_DOUBLE_VAL(pVal);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(pCol->info.type)) {
+    v = (double)GET_UINT64_VAL(pVal);
+  } else {
+    v = (double)GET_INT64_VAL(pVal);
+  }
+
+  return (pTopN->order == TSDB_ORDER_ASC) ? (v > pTopN->key) : (v < pTopN->key);
+}
+
 static bool doLoadBlockSMA(STableScanBase* pTableScanInfo, SSDataBlock* pBlock, SExecTaskInfo* pTaskInfo) {
   SStorageAPI* pAPI = &pTaskInfo->storageAPI;
 
@@ -293,6 +324,17 @@ bool applyLimitOffset(SLimitInfo* pLimitInfo, SSDataBlock* pBlock, SExecTaskInfo
   return false;
 }
 
+typedef struct SLateColParam {
+  TsdReader* pAPI;
+  void*      dataReader;
+} SLateColParam;
+
+// the late columns are decoded only if there are rows remain after the filter is applied
+static int32_t doRetrieveLateCols(void* param, int32_t status) {
+  SLateColParam* p = param;
+  return p->pAPI->tsdReaderRetrieveLateCols(p->dataReader, status != FILTER_RESULT_NONE_QUALIFIED);
+}
+
 static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableScanInfo, SSDataBlock* pBlock,
                              uint32_t* status) {
   SExecTaskInfo*          pTaskInfo = pOperator->pTaskInfo;
@@ -364,6 +406,24 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
     }
   }
 
+  // try to skip data block according to the threshold of the top-N sort above
+  if (pTableScanInfo->pTopN != NULL && pTableScanInfo->pTopN->valid) {
+    if (pBlock->pBlockAgg == NULL) {
+      doLoadBlockSMA(pTableScanInfo, pBlock, pTaskInfo);
+    }
+
+    if (doSkipBlockByTopN(pTableScanInfo->pTopN, pBlock)) {
+      qDebug("%s data block skipped by top-N threshold, brange:%" PRId64 "-%" PRId64 ", rows:%" PRId64,
+             GET_TASKID(pTaskInfo), pBlockInfo->window.skey, pBlockInfo->window.ekey, pBlockInfo->rows);
+      pCost->skipBlocks += 1;
+      (*status) = FUNC_DATA_REQUIRED_FILTEROUT;
+
+      taosMemoryFreeClear(pBlock->pBlockAgg);
+      pAPI->tsdReader.tsdReaderReleaseDataBlock(pTableScanInfo->dataReader);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
   // free the sma info, since it should not be involved in later computing process.
   taosMemoryFreeClear(pBlock->pBlockAgg);
 
@@ -387,7 +447,10 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalCheckedRows += pBlock->info.rows;
   pCost->loadBlocks += 1;
 
-  SSDataBlock* p = pAPI->tsdReader.tsdReaderRetrieveDataBlock(pTableScanInfo->dataReader, NULL);
+  SLateColParam lateParam = {.pAPI = &pAPI->tsdReader, .dataReader = pTableScanInfo->dataReader};
+
+  // only the columns required by the filter are loaded, the others are loaded by doFilterEx after the filter is applied
+  SSDataBlock* p = pAPI->tsdReader.tsdReaderRetrieveDataBlock(pTableScanInfo->dataReader, pTableScanInfo->pEarlyColIds);
   if (p == NULL) {
     return terrno;
   }
@@ -399,7 +462,8 @@ static int32_t loadDataBlock(SOperatorInfo* pOperator, STableScanBase* pTableSca
   pCost->totalRows -= pBlock->info.rows;
 
   if (pOperator->exprSupp.pFilterInfo != NULL) {
-    int32_t code = doFilter(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo);
+    int32_t code = doFilterEx(pBlock, pOperator->exprSupp.pFilterInfo, &pTableScanInfo->matchInfo,
+                              (pTableScanInfo->pEarlyColIds != NULL) ? doRetrieveLateCols : NULL, &lateParam);
     if (code != TSDB_CODE_SUCCESS) return code;
 
     int64_t st = taosGetTimestampUs();
@@ -1006,6 +1070,7 @@ static void destroyTableScanBase(STableScanBase* pBase, TsdReader* pAPI) {
   tableListDestroy(pBase->pTableListInfo);
   taosLRUCacheCleanup(pBase->metaCache.pTableMetaEntryCache);
   cleanupExprSupp(&pBase->pseudoSup);
+  taosArrayDestroy(pBase->pEarlyColIds);
 }
 
 static void destroyTableScanOperatorInfo(void* param) {
@@ -1016,6 +1081,43 @@ static void destroyTableScanOperatorInfo(void* param) {
   taosMemoryFreeClear(param);
 }
 
+static EDealRes collectFilterColId(SNode* pNode, void* pContext) {
+  if (QUERY_NODE_COLUMN == nodeType(pNode)) {
+    SColumnNode* pCol = (SColumnNode*)pNode;
+    if (pCol->colType == COLUMN_TYPE_COLUMN && pCol->colId != PRIMARYKEY_TIMESTAMP_COL_ID) {
+      taosArrayPush(pContext, &pCol->colId);
+    }
+  }
+
+  return DEAL_RES_CONTINUE;
+}
+
+// the data columns that are required by the filter are loaded first, and the others are loaded for the blocks
+// that have qualified rows only
+static int32_t initEarlyColIds(STableScanBase* pBase, SNode* pConditions) {
+  if (pConditions == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SArray* pList = taosArrayInit(4, sizeof(int16_t));
+  if (pList == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  nodesWalkExpr(pConditions, collectFilterColId, pList);
+  taosArraySort(pList, compareInt16Val);
+  taosArrayRemoveDuplicate(pList, compareInt16Val, NULL);
+
+  // no column is left to be loaded later
+  if (taosArrayGetSize(pList) >= pBase->cond.numOfCols - 1) {
+    taosArrayDestroy(pList);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pBase->pEarlyColIds = pList;
+  return TSDB_CODE_SUCCESS;
+}
+
 SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode, SReadHandle* readHandle,
                                            STableListInfo* pTableListInfo, SExecTaskInfo* pTaskInfo) {
   int32_t         code = 0;
@@ -1042,6 +1144,12 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
     goto _error;
   }
 
+  // only the batch query splits the scan of a vnode into sub readers
+  if (pTaskInfo->execModel == OPTR_EXEC_MODEL_BATCH) {
+    pInfo->base.cond.numOfParallel = tsQueryParallelScan;
+    pInfo->base.cond.unordered = pTableScanNode->unorderedScan;
+  }
+
   if (pScanNode->pScanPseudoCols != NULL) {
     SExprSupp* pSup = &pInfo->base.pseudoSup;
     pSup->pExprInfo = createExprInfo(pScanNode->pScanPseudoCols, NULL, &pSup->numOfExprs);
@@ -1067,6 +1175,11 @@ SOperatorInfo* createTableScanOperatorInfo(STableScanPhysiNode* pTableScanNode,
     goto _error;
   }
 
+  code = initEarlyColIds(&pInfo->base, pTableScanNode->scan.node.pConditions);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
   pInfo->currentGroupId = -1;
   pInfo->assignBlockUid = pTableScanNode->assignBlockUid;
   pInfo->hasGroupByTag = pTableScanNode->pGroupTags ? true : false;
@@ -3454,6 +3567,9 @@ void stopDurationForGroupTableMergeScan(SOperatorInfo* pOperator) {
   pInfo->sortExecInfo.loops += sortExecInfo.loops;
   pInfo->sortExecInfo.readBytes += sortExecInfo.readBytes;
   pInfo->sortExecInfo.writeBytes += sortExecInfo.writeBytes;
+  pInfo->sortExecInfo.compSrcBytes += sortExecInfo.compSrcBytes;
+  pInfo->sortExecInfo.compBytes += sortExecInfo.compBytes;
+  pInfo->sortExecInfo.compUs += sortExecInfo.compUs;
 
   tsortDestroySortHandle(pInfo->pSortHandle);
   pInfo->pSortHandle = NULL;
@@ -41,6 +41,7 @@ typedef struct SSortOperatorInfo {
   uint64_t            maxTupleLength;
   int64_t             maxRows;
   SSortOpGroupIdCalc* pGroupIdCalc;
+  STopNThreshold*     pTopN;
 } SSortOperatorInfo;
 
 static SSDataBlock* doSort(SOperatorInfo* pOperator);
@@ -51,6 +52,8 @@ static void destroySortOperatorInfo(void* param);
 static int32_t calcSortOperMaxTupleLength(SSortOperatorInfo* pSortOperInfo, SNodeList* pSortKeys);
 
 static void destroySortOpGroupIdCalc(SSortOpGroupIdCalc* pCalc);
+static int32_t initTopNThreshold(SSortOperatorInfo* pInfo, SSortPhysiNode* pSortNode, SExprSupp* pSup,
+                                 SOperatorInfo* downstream);
 
 // todo add limit/offset impl
 SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode* pSortNode, SExecTaskInfo* pTaskInfo) {
@@ -138,6 +141,11 @@ SOperatorInfo* createSortOperatorInfo(SOperatorInfo* downstream, SSortPhysiNode*
     goto _error;
   }
 
+  code = initTopNThreshold(pInfo, pSortNode, &pOperator->exprSupp, downstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
   return pOperator;
 
 _error:
@@ -299,6 +307,10 @@ int32_t doOpenSortOperator(SOperatorInfo* pOperator) {
                                              pInfo->maxRows, pInfo->maxTupleLength, tsPQSortMemThreshold * 1024 * 1024);
 
   tsortSetFetchRawDataFp(pInfo->pSortHandle, loadNextDataBlock, applyScalarFunction, pOperator);
+  if (pInfo->pTopN != NULL) {
+    tsortSetTopNThreshold(pInfo->pSortHandle, pInfo->pTopN);
+  }
+  tsortSetArena(pInfo->pSortHandle, pTaskInfo->pArena);
 
   SSortSource* ps = taosMemoryCalloc(1, sizeof(SSortSource));
   ps->param = pOperator->pDownstream[0];
@@ -374,6 +386,7 @@ void destroySortOperatorInfo(void* param) {
   taosArrayDestroy(pInfo->pSortInfo);
   taosArrayDestroy(pInfo->matchInfo.pList);
   destroySortOpGroupIdCalc(pInfo->pGroupIdCalc);
+  taosMemoryFree(pInfo->pTopN);
   taosMemoryFreeClear(param);
 }
 
@@ -410,6 +423,49 @@ static void destroySortOpGroupIdCalc(SSortOpGroupIdCalc* pCalc) {
   }
 }
 
+// the table scan right below the top-N sort skips the data blocks whose first sort key can not beat the threshold,
+// if the sort key is a numeric column of the scan, and no rows are filtered out after being sorted.
+static int32_t initTopNThreshold(SSortOperatorInfo* pInfo, SSortPhysiNode* pSortNode, SExprSupp* pSup,
+                                 SOperatorInfo* downstream) {
+  if (pInfo->maxRows <= 0 || pSortNode->node.pConditions != NULL || pSortNode->calcGroupId ||
+      downstream->operatorType != QUERY_NODE_PHYSICAL_PLAN_TABLE_SCAN || taosArrayGetSize(pInfo->pSortInfo) == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SBlockOrderInfo* pOrder = taosArrayGet(pInfo->pSortInfo, 0);
+  for (int32_t i = 0; i < pSup->numOfExprs; ++i) {
+    if (pSup->pExprInfo[i].base.resSchema.slotId == pOrder->slotId) {  // calculated by the sort operator
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
+  STableScanInfo* pScanInfo = downstream->info;
+  SColMatchItem*  pItem = NULL;
+  for (int32_t i = 0; i < taosArrayGetSize(pScanInfo->base.matchInfo.pList); ++i) {
+    SColMatchItem* p = taosArrayGet(pScanInfo->base.matchInfo.pList, i);
+    if (p->dstSlotId == pOrder->slotId) {
+      pItem = p;
+      break;
+    }
+  }
+
+  int32_t type = (pItem != NULL) ? pItem->dataType.type : TSDB_DATA_TYPE_NULL;
+  if (!IS_NUMERIC_TYPE(type) && type != TSDB_DATA_TYPE_TIMESTAMP) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  pInfo->pTopN = taosMemoryCalloc(1, sizeof(STopNThreshold));
+  if (pInfo->pTopN == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pInfo->pTopN->order = pOrder->order;
+  pInfo->pTopN->nullFirst = pOrder->nullFirst;
+  pInfo->pTopN->slotId = pOrder->slotId;
+  pScanInfo->base.pTopN = pInfo->pTopN;
+  return TSDB_CODE_SUCCESS;
+}
+
 //=====================================================================================
 // Group Sort Operator
 typedef enum EChildOperatorStatus { CHILD_OP_NEW_GROUP, CHILD_OP_SAME_GROUP, CHILD_OP_FINISHED } EChildOperatorStatus;
@@ -539,6 +595,9 @@ int32_t finishSortGroup(SOperatorInfo* pOperator) {
   pInfo->sortExecInfo.loops += sortExecInfo.loops;
   pInfo->sortExecInfo.readBytes += sortExecInfo.readBytes;
   pInfo->sortExecInfo.writeBytes += sortExecInfo.writeBytes;
+  pInfo->sortExecInfo.compSrcBytes += sortExecInfo.compSrcBytes;
+  pInfo->sortExecInfo.compBytes += sortExecInfo.compBytes;
+  pInfo->sortExecInfo.compUs += sortExecInfo.compUs;
 
   tsortDestroySortHandle(pInfo->pCurrSortHandle);
   pInfo->pCurrSortHandle = NULL;
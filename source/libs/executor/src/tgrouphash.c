@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tgrouphash.h"
+#include "taoserror.h"
+#include "thash.h"
+
+#define GROUP_HASH_MIN_CAPACITY 64
+#define GROUP_HASH_KEY_CHUNK    (64 * 1024)
+
+// the hash value is in the high 32 bits of a slot, and the index of the entry in its partition plus one is in the
+// low 32 bits, an empty slot is 0
+#define GROUP_SLOT_HASH(_s)      ((uint32_t)((_s) >> 32))
+#define GROUP_SLOT_INDEX(_s)     ((int32_t)((_s)&0xFFFFFFFF) - 1)
+#define GROUP_SLOT_MAKE(_h, _i)  (((uint64_t)(_h) << 32) | (uint32_t)((_i) + 1))
+#define GROUP_HASH_OVERLOAD(_p)  (((int64_t)(_p)->size + 1) * 4 > ((int64_t)(_p)->mask + 1) * 3)
+
+struct SGroupHash {
+  uint64_t* pSlots;
+  uint32_t  mask;  // the number of slots minus one
+  int32_t   size;
+  int32_t   initSlots;
+  SArray*   pEntries[GROUP_HASH_PARTITIONS];  // SArray<SGroupHashEntry>
+  SArray*   pChunks;                          // SArray<char*>, the copies of keys
+  int32_t   chunkOffset;                      // the used bytes of the last chunk
+  int64_t   chunkMemSize;
+};
+
+static uint32_t groupHashRoundUp(int32_t capacity) {
+  uint32_t n = GROUP_HASH_MIN_CAPACITY;
+  while (n < (uint32_t)capacity) {
+    n <<= 1;
+  }
+  return n;
+}
+
+static FORCE_INLINE SGroupHashEntry* groupHashEntryOfSlot(const SGroupHash* pHash, uint64_t slot) {
+  SArray* pEntries = pHash->pEntries[tGroupHashGetPartition(GROUP_SLOT_HASH(slot))];
+  return (SGroupHashEntry*)TARRAY_GET_ELEM(pEntries, GROUP_SLOT_INDEX(slot));
+}
+
+// return the slot of the key, or the empty slot where the key should be put
+static uint32_t groupHashProbe(const SGroupHash* pHash, uint32_t hashVal, const char* pKey, int32_t keyLen,
+                               bool* pFound) {
+  uint32_t i = hashVal & pHash->mask;
+  while (1) {
+    uint64_t slot = pHash->pSlots[i];
+    if (slot == 0) {
+      *pFound = false;
+      return i;
+    }
+
+    if (GROUP_SLOT_HASH(slot) == hashVal) {
+      SGroupHashEntry* pEntry = groupHashEntryOfSlot(pHash, slot);
+      if (pEntry->keyLen == keyLen && memcmp(pEntry->pKey, pKey, keyLen) == 0) {
+        *pFound = true;
+        return i;
+      }
+    }
+
+    i = (i + 1) & pHash->mask;
+  }
+}
+
+static int32_t groupHashResize(SGroupHash* pHash, uint32_t numOfSlots) {
+  uint64_t* pSlots = taosMemoryCalloc(numOfSlots, sizeof(uint64_t));
+  if (pSlots == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // the hash value is kept in the slot, no entry is touched
+  uint32_t mask = numOfSlots - 1;
+  for (uint32_t i = 0; i <= pHash->mask; ++i) {
+    uint64_t slot = pHash->pSlots[i];
+    if (slot == 0) {
+      continue;
+    }
+
+    uint32_t j = GROUP_SLOT_HASH(slot) & mask;
+    while (pSlots[j] != 0) {
+      j = (j + 1) & mask;
+    }
+    pSlots[j] = slot;
+  }
+
+  taosMemoryFree(pHash->pSlots);
+  pHash->pSlots = pSlots;
+  pHash->mask = mask;
+  return TSDB_CODE_SUCCESS;
+}
+
+static char* groupHashCopyKey(SGroupHash* pHash, const char* pKey, int32_t keyLen) {
+  int32_t numOfChunks = taosArrayGetSize(pHash->pChunks);
+  if (numOfChunks == 0 || pHash->chunkOffset + keyLen > GROUP_HASH_KEY_CHUNK) {
+    int32_t size = TMAX(keyLen, GROUP_HASH_KEY_CHUNK);
+    char*   pChunk = taosMemoryMalloc(size);
+    if (pChunk == NULL || taosArrayPush(pHash->pChunks, &pChunk) == NULL) {
+      taosMemoryFree(pChunk);
+      return NULL;
+    }
+
+    pHash->chunkOffset = 0;
+    pHash->chunkMemSize += size;
+  }
+
+  char* pChunk = *(char**)taosArrayGetLast(pHash->pChunks);
+  char* p = pChunk + pHash->chunkOffset;
+  memcpy(p, pKey, keyLen);
+  pHash->chunkOffset += keyLen;
+  return p;
+}
+
+SGroupHash* tGroupHashInit(int32_t capacity) {
+  SGroupHash* pHash = taosMemoryCalloc(1, sizeof(SGroupHash));
+  if (pHash == NULL) {
+    return NULL;
+  }
+
+  // keep the load factor below 3/4 for the expected capacity
+  pHash->initSlots = groupHashRoundUp(capacity / 3 * 4);
+  pHash->mask = pHash->initSlots - 1;
+  pHash->pSlots = taosMemoryCalloc(pHash->initSlots, sizeof(uint64_t));
+  pHash->pChunks = taosArrayInit(4, POINTER_BYTES);
+  if (pHash->pSlots == NULL || pHash->pChunks == NULL) {
+    tGroupHashCleanup(pHash);
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < GROUP_HASH_PARTITIONS; ++i) {
+    pHash->pEntries[i] = taosArrayInit(pHash->initSlots / GROUP_HASH_PARTITIONS, sizeof(SGroupHashEntry));
+    if (pHash->pEntries[i] == NULL) {
+      tGroupHashCleanup(pHash);
+      return NULL;
+    }
+  }
+
+  return pHash;
+}
+
+void tGroupHashCleanup(SGroupHash* pHash) {
+  if (pHash == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < GROUP_HASH_PARTITIONS; ++i) {
+    taosArrayDestroy(pHash->pEntries[i]);
+  }
+
+  if (pHash->pChunks != NULL) {
+    for (int32_t i = 0; i < taosArrayGetSize(pHash->pChunks); ++i) {
+      taosMemoryFree(*(char**)taosArrayGet(pHash->pChunks, i));
+    }
+    taosArrayDestroy(pHash->pChunks);
+  }
+
+  taosMemoryFree(pHash->pSlots);
+  taosMemoryFree(pHash);
+}
+
+void tGroupHashClear(SGroupHash* pHash) {
+  // shrink the slots grown by the previous round, the memset of a large and sparse table costs more than the probing
+  if (pHash->mask + 1 > pHash->initSlots) {
+    uint64_t* pSlots = taosMemoryRealloc(pHash->pSlots, pHash->initSlots * sizeof(uint64_t));
+    if (pSlots != NULL) {
+      pHash->pSlots = pSlots;
+      pHash->mask = pHash->initSlots - 1;
+    }
+  }
+  memset(pHash->pSlots, 0, ((size_t)pHash->mask + 1) * sizeof(uint64_t));
+
+  for (int32_t i = 0; i < GROUP_HASH_PARTITIONS; ++i) {
+    taosArrayClear(pHash->pEntries[i]);
+  }
+
+  // keep the first chunk for the next round
+  int32_t numOfChunks = taosArrayGetSize(pHash->pChunks);
+  for (int32_t i = 1; i < numOfChunks; ++i) {
+    taosMemoryFree(*(char**)taosArrayGet(pHash->pChunks, i));
+  }
+  if (numOfChunks > 1) {
+    char* pFirst = *(char**)taosArrayGet(pHash->pChunks, 0);
+    taosArrayClear(pHash->pChunks);
+    taosArrayPush(pHash->pChunks, &pFirst);
+    pHash->chunkMemSize = GROUP_HASH_KEY_CHUNK;
+  }
+
+  pHash->chunkOffset = 0;
+  pHash->size = 0;
+}
+
+int32_t tGroupHashGetSize(const SGroupHash* pHash) { return pHash->size; }
+
+int64_t tGroupHashGetMemSize(const SGroupHash* pHash) {
+  int64_t size = sizeof(SGroupHash) + ((int64_t)pHash->mask + 1) * sizeof(uint64_t) + pHash->chunkMemSize;
+  for (int32_t i = 0; i < GROUP_HASH_PARTITIONS; ++i) {
+    size += taosArrayGetSize(pHash->pEntries[i]) * sizeof(SGroupHashEntry);
+  }
+  return size;
+}
+
+SGroupHashEntry* tGroupHashPut(SGroupHash* pHash, const char* pKey, int32_t keyLen, bool* pNew) {
+  uint32_t hashVal = MurmurHash3_32(pKey, keyLen);
+  bool     found = false;
+  uint32_t i = groupHashProbe(pHash, hashVal, pKey, keyLen, &found);
+  if (found) {
+    *pNew = false;
+    return groupHashEntryOfSlot(pHash, pHash->pSlots[i]);
+  }
+
+  if (GROUP_HASH_OVERLOAD(pHash)) {
+    if (groupHashResize(pHash, (pHash->mask + 1) << 1) != TSDB_CODE_SUCCESS) {
+      return NULL;
+    }
+    i = groupHashProbe(pHash, hashVal, pKey, keyLen, &found);
+  }
+
+  SGroupHashEntry entry = {.pos = {.pageId = -1, .offset = -1}, .keyLen = keyLen, .hashVal = hashVal};
+  entry.pKey = groupHashCopyKey(pHash, pKey, keyLen);
+  if (entry.pKey == NULL) {
+    return NULL;
+  }
+
+  SArray*          pEntries = pHash->pEntries[tGroupHashGetPartition(hashVal)];
+  SGroupHashEntry* pEntry = taosArrayPush(pEntries, &entry);
+  if (pEntry == NULL) {
+    return NULL;
+  }
+
+  pHash->pSlots[i] = GROUP_SLOT_MAKE(hashVal, taosArrayGetSize(pEntries) - 1);
+  pHash->size += 1;
+  *pNew = true;
+  return pEntry;
+}
+
+SGroupHashEntry* tGroupHashGet(SGroupHash* pHash, const char* pKey, int32_t keyLen) {
+  bool     found = false;
+  uint32_t i = groupHashProbe(pHash, MurmurHash3_32(pKey, keyLen), pKey, keyLen, &found);
+  return found ? groupHashEntryOfSlot(pHash, pHash->pSlots[i]) : NULL;
+}
+
+int32_t tGroupHashGetPartition(uint32_t hashVal) { return hashVal >> (32 - GROUP_HASH_PARTITION_BITS); }
+
+int32_t tGroupHashGetPartitionSize(const SGroupHash* pHash, int32_t partition) {
+  return taosArrayGetSize(pHash->pEntries[partition]);
+}
+
+SGroupHashEntry* tGroupHashGetEntry(const SGroupHash* pHash, int32_t partition, int32_t index) {
+  return (SGroupHashEntry*)taosArrayGet(pHash->pEntries[partition], index);
+}
@@ -262,7 +262,7 @@ SLHashObj* tHashInit(int32_t inMemPages, int32_t pageSize, _hash_fn_t fn, int32_
   }
 
   // disable compress when flushing to disk
-  setBufPageCompressOnDisk(pHashObj->pBuf, false);
+  (void)setBufPageCompressOnDisk(pHashObj->pBuf, BUF_PAGE_COMP_NONE);
 
   /**
    * The number of bits in the hash value, which is used to decide the exact bucket where the object should be located
@@ -25,6 +25,7 @@
 #include "tsort.h"
 #include "tutil.h"
 #include "tsimplehash.h"
+#include "tworker.h"
 #include "executil.h"
 
 struct STupleHandle {
@@ -50,6 +51,8 @@ struct SSortHandle {
   bool             forceUsePQSort;
   BoundedQueue*    pBoundedQueue;
   uint32_t         tmpRowIdx;
+  STopNThreshold*  pThreshold;
+  SArena*          pArena;
 
   int64_t          mergeLimit;
   int64_t          currMergeLimitTs;          
@@ -75,8 +78,27 @@ struct SSortHandle {
 
   bool (*abortCheckFn)(void* param);
   void* abortCheckParam;
+
+  int32_t numOfSortThreads;
+  SArray* pRunTasks;    // SArray<SSortRunTask*>, runs being sorted in the background, in the order of input
+  int64_t runTaskSize;  // size of the runs being sorted, they take part of the sort buffer
 };
 
+typedef struct SSortRunTask {
+  SSDataBlock* pBlock;
+  SArray*      pOrderInfo;  // private copy, since the sort fills the column and compare function of each order
+  uint64_t     pqMaxRows;
+  int64_t      size;
+  int64_t      elapsed;
+  int32_t      code;
+  bool         queued;
+  tsem_t       ready;
+} SSortRunTask;
+
+// the runs of all the sorts are sorted by one pool, of querySortThreads threads when the first parallel sort starts
+static TdThreadOnce  sortRunWorkerOnce = PTHREAD_ONCE_INIT;
+static SSingleWorker sortRunWorker = {0};
+
 void tsortSetSingleTableMerge(SSortHandle* pHandle) {
   pHandle->singleTableMerge = true;
 }
@@ -87,13 +109,21 @@ void tsortSetAbortCheckFn(SSortHandle *pHandle, bool (*checkFn)(void *), void* p
 }
 
 static int32_t msortComparFn(const void* pLeft, const void* pRight, void* param);
+static int32_t sortWaitRunTasks(SSortHandle* pHandle, int32_t numOfRemain, bool flush);
 
 // | offset[0] | offset[1] |....| nullbitmap | data |...|
-static void* createTuple(uint32_t columnNum, uint32_t tupleLen) {
+// the tuples are allocated from the arena of the task if there is one, since they are created and dropped row by row
+static void* createTuple(SArena* pArena, uint32_t columnNum, uint32_t tupleLen) {
   uint32_t totalLen = sizeof(uint32_t) * columnNum + BitmapLen(columnNum) + tupleLen;
-  return taosMemoryCalloc(1, totalLen);
+  return (pArena != NULL) ? taosArenaCalloc(pArena, 1, totalLen) : taosMemoryCalloc(1, totalLen);
+}
+static void destoryAllocatedTuple(SArena* pArena, void* t) {
+  if (pArena != NULL) {
+    taosArenaFree(pArena, t);
+  } else {
+    taosMemoryFree(t);
+  }
 }
-static void destoryAllocatedTuple(void* t) { taosMemoryFree(t); }
 
 #define tupleOffset(tuple, colIdx) ((uint32_t*)(tuple + sizeof(uint32_t) * colIdx))
 #define tupleSetOffset(tuple, colIdx, offset) (*tupleOffset(tuple, colIdx) = offset)
@@ -108,14 +138,14 @@ static void destoryAllocatedTuple(void* t) { taosMemoryFree(t); }
  * @param colIndex the columnIndex, for setting null bitmap
  * @return the next offset to add field
  * */
-static inline size_t tupleAddField(char** t, uint32_t colNum, uint32_t offset, uint32_t colIdx, void* data, size_t length,
-                            bool isNull, uint32_t tupleLen) {
+static inline size_t tupleAddField(SArena* pArena, char** t, uint32_t colNum, uint32_t offset, uint32_t colIdx,
+                                   void* data, size_t length, bool isNull, uint32_t tupleLen) {
   tupleSetOffset(*t, colIdx, offset);
   if (isNull) {
     tupleSetNull(*t, colIdx, colNum);
   } else {
     if (offset + length > tupleLen + tupleGetDataStartOffset(colNum)) {
-      *t = taosMemoryRealloc(*t, offset + length);
+      *t = (pArena != NULL) ? taosArenaRealloc(pArena, *t, offset + length) : taosMemoryRealloc(*t, offset + length);
     }
     tupleSetData(*t, offset, data, length);
   }
@@ -136,6 +166,7 @@ SSDataBlock* tsortGetSortedDataBlock(const SSortHandle* pSortHandle) {
 typedef struct TupleDesc {
   uint8_t type;
   char*   data; // if type is AllocatedTuple, then points to the created tuple, otherwise points to the DataBlock
+  SArena* pArena;  // the allocated tuple and this desc are allocated from it if it is not NULL
 } TupleDesc;
 
 typedef struct ReferencedTuple {
@@ -143,11 +174,18 @@ typedef struct ReferencedTuple {
   size_t    rowIndex;
 } ReferencedTuple;
 
-static TupleDesc* createAllocatedTuple(SSDataBlock* pBlock, size_t colNum, uint32_t tupleLen, size_t rowIdx) {
-  TupleDesc* t = taosMemoryCalloc(1, sizeof(TupleDesc));
-  void*      pTuple = createTuple(colNum, tupleLen);
+static TupleDesc* createAllocatedTuple(SArena* pArena, SSDataBlock* pBlock, size_t colNum, uint32_t tupleLen,
+                                       size_t rowIdx) {
+  TupleDesc* t =
+      (pArena != NULL) ? taosArenaCalloc(pArena, 1, sizeof(TupleDesc)) : taosMemoryCalloc(1, sizeof(TupleDesc));
+  if (!t) {
+    if (pArena == NULL) terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  void* pTuple = createTuple(pArena, colNum, tupleLen);
   if (!pTuple) {
-    taosMemoryFree(t);
+    if (pArena == NULL) terrno = TSDB_CODE_OUT_OF_MEMORY;
+    destoryAllocatedTuple(pArena, t);
     return NULL;
   }
   size_t   colLen = 0;
@@ -155,15 +193,17 @@ static TupleDesc* createAllocatedTuple(SSDataBlock* pBlock, size_t colNum, uint3
   for (size_t colIdx = 0; colIdx < colNum; ++colIdx) {
     SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, colIdx);
     if (colDataIsNull_s(pCol, rowIdx)) {
-      offset = tupleAddField((char**)&pTuple, colNum, offset, colIdx, 0, 0, true, tupleLen);
+      offset = tupleAddField(pArena, (char**)&pTuple, colNum, offset, colIdx, 0, 0, true, tupleLen);
     } else {
       colLen = colDataGetRowLength(pCol, rowIdx);
       offset =
-          tupleAddField((char**)&pTuple, colNum, offset, colIdx, colDataGetData(pCol, rowIdx), colLen, false, tupleLen);
+          tupleAddField(pArena, (char**)&pTuple, colNum, offset, colIdx, colDataGetData(pCol, rowIdx), colLen, false,
+                        tupleLen);
     }
   }
   t->type = AllocatedTupleType;
   t->data = pTuple;
+  t->pArena = pArena;
   return t;
 }
 
@@ -181,8 +221,8 @@ void* tupleDescGetField(const TupleDesc* pDesc, int32_t colIdx, uint32_t colNum)
 void destroyTuple(void* t) {
   TupleDesc* pDesc = t;
   if (pDesc->type == AllocatedTupleType) {
-    destoryAllocatedTuple(pDesc->data);
-    taosMemoryFree(pDesc);
+    destoryAllocatedTuple(pDesc->pArena, pDesc->data);
+    destoryAllocatedTuple(pDesc->pArena, pDesc);
   }
 }
 
@@ -294,6 +334,12 @@ void tsortDestroySortHandle(SSortHandle* pSortHandle) {
 
   destroyDiskbasedBuf(pSortHandle->pBuf);
   taosMemoryFreeClear(pSortHandle->idStr);
+  taosMemoryFreeClear(pSortHandle->cmpParam.pKeyBuf);
+  taosMemoryFreeClear(pSortHandle->cmpParam.pKeyLen);
+  if (pSortHandle->pRunTasks != NULL) {
+    sortWaitRunTasks(pSortHandle, 0, false);
+    taosArrayDestroy(pSortHandle->pRunTasks);
+  }
   blockDataDestroy(pSortHandle->pDataBlock);
   if (pSortHandle->pBoundedQueue) destroyBoundedQueue(pSortHandle->pBoundedQueue);
 
@@ -350,6 +396,7 @@ static int32_t doAddToBuf(SSDataBlock* pDataBlock, SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+    (void)setBufPageCompressOnDisk(pHandle->pBuf, tsQuerySpillCompress);
   }
 
   SArray* pPageIdList = taosArrayInit(4, sizeof(int32_t));
@@ -395,6 +442,171 @@ static void setCurrentSourceDone(SSortSource* pSource, SSortHandle* pHandle) {
   ++pHandle->numOfCompletedSources;
 }
 
+#define SORT_NORM_KEY_MAX_LEN 512
+
+/*
+ * Normalized sort key of one row: for each order column, a null flag byte followed by the value bytes (absent if
+ * null). Integers are stored big-endian with the sign bit flipped, var chars as the bytes before the first '\0',
+ * a '\0' terminator and the big-endian length, which matches compareLenPrefixedStr. The value bytes are inverted
+ * for the descending order, so that memcmp over two keys gives the same result as msortComparFn.
+ */
+static int32_t sortGetNormKeyCap(SSortHandle* pHandle, SSDataBlock* pBlock) {
+  if (pHandle->type == SORT_BLOCK_TS_MERGE || pHandle->comparFn != msortComparFn) {
+    return 0;
+  }
+
+  int32_t cap = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pHandle->pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pHandle->pSortInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+
+    switch (pCol->info.type) {
+      case TSDB_DATA_TYPE_BOOL:
+      case TSDB_DATA_TYPE_TINYINT:
+      case TSDB_DATA_TYPE_SMALLINT:
+      case TSDB_DATA_TYPE_INT:
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_TIMESTAMP:
+      case TSDB_DATA_TYPE_UTINYINT:
+      case TSDB_DATA_TYPE_USMALLINT:
+      case TSDB_DATA_TYPE_UINT:
+      case TSDB_DATA_TYPE_UBIGINT:
+        cap += 1 + tDataTypes[pCol->info.type].bytes;
+        break;
+      case TSDB_DATA_TYPE_VARCHAR:
+        cap += 1 + (pCol->info.bytes - VARSTR_HEADER_SIZE) + 1 + sizeof(uint16_t);
+        break;
+      default:  // float/double are compared with a tolerance, nchar in wide chars, keep the comparator for them
+        return 0;
+    }
+  }
+
+  return (cap > SORT_NORM_KEY_MAX_LEN) ? 0 : cap;
+}
+
+static FORCE_INLINE char* sortPutNormKeyInt(char* p, uint64_t v, int32_t bytes) {
+  for (int32_t i = bytes - 1; i >= 0; --i) {
+    *p++ = (char)(v >> (i * 8));
+  }
+  return p;
+}
+
+static void sortBuildNormKey(SMsortComparParam* pParam, int32_t index) {
+  SSortSource* pSource = pParam->pSources[index];
+  SSDataBlock* pBlock = pSource->src.pBlock;
+  int32_t      row = pSource->src.rowIndex;
+  if (pBlock == NULL || row < 0 || row >= pBlock->info.rows) {
+    pParam->pKeyLen[index] = -1;
+    return;
+  }
+
+  char* pKey = pParam->pKeyBuf + (int64_t)index * pParam->keyCap;
+  char* p = pKey;
+  for (int32_t i = 0; i < taosArrayGetSize(pParam->orderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pParam->orderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (pCol->pData == NULL) {
+      pParam->pKeyLen[index] = -1;
+      return;
+    }
+
+    if (colDataIsNull_s(pCol, row)) {
+      *p++ = pOrder->nullFirst ? 0 : 1;
+      continue;
+    }
+    *p++ = pOrder->nullFirst ? 1 : 0;
+
+    char* pVal = p;
+    char* pData = colDataGetData(pCol, row);
+    switch (pCol->info.type) {
+      case TSDB_DATA_TYPE_BOOL:
+      case TSDB_DATA_TYPE_TINYINT:
+        p = sortPutNormKeyInt(p, (uint8_t)(*(int8_t*)pData) ^ 0x80u, sizeof(int8_t));
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        p = sortPutNormKeyInt(p, (uint16_t)(*(int16_t*)pData) ^ 0x8000u, sizeof(int16_t));
+        break;
+      case TSDB_DATA_TYPE_INT:
+        p = sortPutNormKeyInt(p, (uint32_t)(*(int32_t*)pData) ^ 0x80000000u, sizeof(int32_t));
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+      case TSDB_DATA_TYPE_TIMESTAMP:
+        p = sortPutNormKeyInt(p, (uint64_t)(*(int64_t*)pData) ^ 0x8000000000000000ull, sizeof(int64_t));
+        break;
+      case TSDB_DATA_TYPE_UTINYINT:
+        p = sortPutNormKeyInt(p, *(uint8_t*)pData, sizeof(uint8_t));
+        break;
+      case TSDB_DATA_TYPE_USMALLINT:
+        p = sortPutNormKeyInt(p, *(uint16_t*)pData, sizeof(uint16_t));
+        break;
+      case TSDB_DATA_TYPE_UINT:
+        p = sortPutNormKeyInt(p, *(uint32_t*)pData, sizeof(uint32_t));
+        break;
+      case TSDB_DATA_TYPE_UBIGINT:
+        p = sortPutNormKeyInt(p, *(uint64_t*)pData, sizeof(uint64_t));
+        break;
+      case TSDB_DATA_TYPE_VARCHAR: {
+        int32_t len = varDataLen(pData);
+        if (len > pCol->info.bytes - VARSTR_HEADER_SIZE) {
+          pParam->pKeyLen[index] = -1;
+          return;
+        }
+        char*   pEnd = memchr(varDataVal(pData), 0, len);
+        int32_t n = (pEnd == NULL) ? len : (int32_t)(pEnd - varDataVal(pData));
+        memcpy(p, varDataVal(pData), n);
+        p += n;
+        *p++ = 0;
+        p = sortPutNormKeyInt(p, (uint16_t)len, sizeof(uint16_t));
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (pOrder->order == TSDB_ORDER_DESC) {
+      for (char* q = pVal; q < p; ++q) {
+        *q = ~(*q);
+      }
+    }
+  }
+
+  pParam->pKeyLen[index] = (int32_t)(p - pKey);
+}
+
+static void sortInitNormKeys(SMsortComparParam* pParam, SSortHandle* pHandle) {
+  pParam->keyCap = 0;
+
+  SSDataBlock* pBlock = NULL;
+  for (int32_t i = 0; i < pParam->numOfSources && pBlock == NULL; ++i) {
+    SSortSource* pSource = pParam->pSources[i];
+    if (pSource->src.rowIndex != -1) {
+      pBlock = pSource->src.pBlock;
+    }
+  }
+
+  int32_t cap = (pBlock == NULL) ? 0 : sortGetNormKeyCap(pHandle, pBlock);
+  if (cap == 0) {
+    return;
+  }
+
+  // the key capacity is fixed for a sort handle, so the buffers only grow with the number of sources
+  if (pParam->numOfKeys < pParam->numOfSources) {
+    char*    pBuf = taosMemoryRealloc(pParam->pKeyBuf, (int64_t)cap * pParam->numOfSources);
+    int32_t* pLen = (pBuf == NULL) ? NULL : taosMemoryRealloc(pParam->pKeyLen, sizeof(int32_t) * pParam->numOfSources);
+    if (pBuf != NULL) pParam->pKeyBuf = pBuf;
+    if (pLen != NULL) pParam->pKeyLen = pLen;
+    if (pBuf == NULL || pLen == NULL) {
+      return;  // fall back to the column comparator
+    }
+    pParam->numOfKeys = pParam->numOfSources;
+  }
+
+  pParam->keyCap = cap;
+  for (int32_t i = 0; i < pParam->numOfSources; ++i) {
+    sortBuildNormKey(pParam, i);
+  }
+}
+
 static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32_t startIndex, int32_t endIndex,
                               SSortHandle* pHandle) {
   pParam->pSources = taosArrayGet(pSources, startIndex);
@@ -417,6 +629,7 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
       terrno = code;
       return code;
     }
+    (void)setBufPageCompressOnDisk(pHandle->pBuf, tsQuerySpillCompress);
   }
 
   if (pHandle->type == SORT_SINGLESOURCE_SORT) {
@@ -462,6 +675,7 @@ static int32_t sortComparInit(SMsortComparParam* pParam, SArray* pSources, int32
     qDebug("init for merge sort completed, elapsed time:%.2f ms, %s", (et - st) / 1000.0, pHandle->idStr);
   }
 
+  sortInitNormKeys(pParam, pHandle);
   return code;
 }
 
@@ -536,6 +750,10 @@ static int32_t adjustMergeTreeForNextTuple(SSortSource* pSource, SMultiwayMergeT
    * Adjust loser tree otherwise, according to new candidate data
    * if the loser tree is rebuild completed, we do not need to adjust
    */
+  if (pHandle->cmpParam.keyCap > 0) {
+    sortBuildNormKey(&pHandle->cmpParam, tMergeTreeGetChosenIndex(pTree));
+  }
+
   int32_t leafNodeIndex = tMergeTreeGetAdjustIndex(pTree);
 
 #ifdef _DEBUG_VIEW
@@ -608,6 +826,19 @@ int32_t msortComparFn(const void* pLeft, const void* pRight, void* param) {
     }
   }
 
+  if (pParam->keyCap > 0) {
+    int32_t leftLen = pParam->pKeyLen[pLeftIdx];
+    int32_t rightLen = pParam->pKeyLen[pRightIdx];
+    if (leftLen >= 0 && rightLen >= 0) {
+      int32_t ret = memcmp(pParam->pKeyBuf + (int64_t)pLeftIdx * pParam->keyCap,
+                           pParam->pKeyBuf + (int64_t)pRightIdx * pParam->keyCap, TMIN(leftLen, rightLen));
+      if (ret != 0) {
+        return ret < 0 ? -1 : 1;
+      }
+      return (leftLen == rightLen) ? 0 : (leftLen < rightLen ? -1 : 1);
+    }
+  }
+
   if (pParam->sortType == SORT_BLOCK_TS_MERGE) {
     SColumnInfoData* pLeftColInfoData = TARRAY_GET_ELEM(pLeftBlock->pDataBlock, pParam->tsSlotId);
     SColumnInfoData* pRightColInfoData = TARRAY_GET_ELEM(pRightBlock->pDataBlock, pParam->tsSlotId);
@@ -844,6 +1075,7 @@ static int32_t createPageBuf(SSortHandle* pHandle) {
     if (code != TSDB_CODE_SUCCESS) {
       return code;
     }
+    (void)setBufPageCompressOnDisk(pHandle->pBuf, tsQuerySpillCompress);
   }
   return 0;
 }
@@ -1120,6 +1352,129 @@ static int32_t createBlocksMergeSortInitialSources(SSortHandle* pHandle) {
   return TSDB_CODE_SUCCESS;
 }
 
+static void sortRunTask(SSortRunTask* pTask) {
+  int64_t st = taosGetTimestampUs();
+  pTask->code = blockDataSort(pTask->pBlock, pTask->pOrderInfo);
+  if (pTask->code == TSDB_CODE_SUCCESS && pTask->pqMaxRows > 0) {
+    blockDataKeepFirstNRows(pTask->pBlock, pTask->pqMaxRows);
+  }
+  pTask->elapsed = taosGetTimestampUs() - st;
+}
+
+static void sortRunWorkerFp(SQueueInfo* pInfo, void* pItem) {
+  SSortRunTask* pTask = *(SSortRunTask**)pItem;
+  taosFreeQitem(pItem);
+
+  sortRunTask(pTask);
+  tsem_post(&pTask->ready);
+}
+
+static void sortRunWorkerCleanup() { tSingleWorkerCleanup(&sortRunWorker); }
+
+static void sortRunWorkerInit() {
+  SSingleWorkerCfg cfg = {
+      .name = "sort-run", .min = tsQuerySortThreads, .max = tsQuerySortThreads, .fp = sortRunWorkerFp};
+  if (tSingleWorkerInit(&sortRunWorker, &cfg) != 0) {
+    qError("failed to init sort run worker since %s, the runs are sorted in place", terrstr());
+    sortRunWorker.queue = NULL;
+    return;
+  }
+  atexit(sortRunWorkerCleanup);
+}
+
+static void sortDestroyRunTask(SSortRunTask* pTask) {
+  if (pTask->queued) {
+    tsem_destroy(&pTask->ready);
+  }
+  blockDataDestroy(pTask->pBlock);
+  taosArrayDestroy(pTask->pOrderInfo);
+  taosMemoryFree(pTask);
+}
+
+/*
+ * Wait for the oldest runs until at most numOfRemain of them are still being sorted, and flush the sorted ones
+ * into the buffer in the order they are generated. Runs are only dropped if flush is false or an error occurs.
+ */
+static int32_t sortWaitRunTasks(SSortHandle* pHandle, int32_t numOfRemain, bool flush) {
+  int32_t code = TSDB_CODE_SUCCESS;
+
+  while ((int32_t)taosArrayGetSize(pHandle->pRunTasks) > numOfRemain) {
+    SSortRunTask* pTask = *(SSortRunTask**)taosArrayGet(pHandle->pRunTasks, 0);
+    taosArrayRemove(pHandle->pRunTasks, 0);
+
+    if (pTask->queued) {
+      tsem_wait(&pTask->ready);
+    }
+
+    pHandle->runTaskSize -= pTask->size;
+    pHandle->sortElapsed += pTask->elapsed;
+    if (code == TSDB_CODE_SUCCESS) {
+      code = pTask->code;
+    }
+    if (code == TSDB_CODE_SUCCESS && flush) {
+      code = doAddToBuf(pTask->pBlock, pHandle);
+    }
+    sortDestroyRunTask(pTask);
+  }
+
+  return code;
+}
+
+/*
+ * Hand the full in-memory batch to the sort pool, and continue to fetch into a new batch. The runs being sorted, the
+ * new one and the next batch share the sort buffer, so the oldest runs are flushed first if it is full.
+ */
+static int32_t sortStartRunTask(SSortHandle* pHandle, int64_t sortBufSize, int64_t batchSize) {
+  int64_t size = blockDataGetSize(pHandle->pDataBlock);
+  while (taosArrayGetSize(pHandle->pRunTasks) > 0 && pHandle->runTaskSize + size + batchSize > sortBufSize) {
+    int32_t code = sortWaitRunTasks(pHandle, taosArrayGetSize(pHandle->pRunTasks) - 1, true);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  SSortRunTask* pTask = taosMemoryCalloc(1, sizeof(SSortRunTask));
+  if (pTask == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SSDataBlock* pNewBlock = createOneDataBlock(pHandle->pDataBlock, false);
+  pTask->pOrderInfo = taosArrayDup(pHandle->pSortInfo, NULL);
+  if (pNewBlock == NULL || pTask->pOrderInfo == NULL || taosArrayPush(pHandle->pRunTasks, &pTask) == NULL) {
+    blockDataDestroy(pNewBlock);
+    taosArrayDestroy(pTask->pOrderInfo);
+    taosMemoryFree(pTask);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pTask->pBlock = pHandle->pDataBlock;
+  pTask->pqMaxRows = pHandle->pqMaxRows;
+  pTask->size = size;
+  pHandle->pDataBlock = pNewBlock;
+  pHandle->runTaskSize += size;
+
+  SSortRunTask** pItem = NULL;
+  if (sortRunWorker.queue != NULL) {
+    pItem = taosAllocateQitem(sizeof(SSortRunTask*), DEF_QITEM, 0);
+  }
+  if (pItem != NULL) {
+    *pItem = pTask;
+    tsem_init(&pTask->ready, 0, 0);
+    pTask->queued = true;
+    if (taosWriteQitem(sortRunWorker.queue, pItem) != 0) {
+      taosFreeQitem(pItem);
+      tsem_destroy(&pTask->ready);
+      pTask->queued = false;
+    }
+  }
+  if (!pTask->queued) {
+    qWarn("%s failed to queue the sort run, sort it in place", pHandle->idStr);
+    sortRunTask(pTask);
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
 static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
   int32_t code = 0;
   size_t  sortBufSize = pHandle->numOfPages * pHandle->pageSize;
@@ -1130,6 +1485,19 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
 
   tsortClearOrderdSource(pHandle->pOrderedSource, NULL, NULL);
 
+  // sort the full batches on the sort pool while the next batch is fetched, the batches are then smaller than the sort
+  // buffer, since the ones being sorted take part of it
+  pHandle->numOfSortThreads = tsQuerySortThreads;
+  bool parallel = (pHandle->numOfSortThreads > 1);
+  if (parallel) {
+    taosThreadOnce(&sortRunWorkerOnce, sortRunWorkerInit);
+    parallel = (sortRunWorker.queue != NULL);
+  }
+  if (parallel && pHandle->pRunTasks == NULL) {
+    pHandle->pRunTasks = taosArrayInit(pHandle->numOfSortThreads, POINTER_BYTES);
+    parallel = (pHandle->pRunTasks != NULL);
+  }
+
   while (1) {
     SSDataBlock* pBlock = pHandle->fetchfp(source->param);
     if (pBlock == NULL) {
@@ -1152,6 +1520,7 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
 
     code = blockDataMerge(pHandle->pDataBlock, pBlock);
     if (code != TSDB_CODE_SUCCESS) {
+      sortWaitRunTasks(pHandle, 0, false);
       if (source->param && !source->onlyRef) {
         taosMemoryFree(source->param);
       }
@@ -1164,7 +1533,13 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
     }
 
     size_t size = blockDataGetSize(pHandle->pDataBlock);
-    if (size > sortBufSize) {
+    if (parallel && size > sortBufSize / (pHandle->numOfSortThreads + 1)) {
+      code = sortStartRunTask(pHandle, sortBufSize, sortBufSize / (pHandle->numOfSortThreads + 1));
+      if (code != TSDB_CODE_SUCCESS) {
+        sortWaitRunTasks(pHandle, 0, false);
+        return code;
+      }
+    } else if (size > sortBufSize) {
       // Perform the in-memory sort and then flush data in the buffer into disk.
       int64_t p = taosGetTimestampUs();
       code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
@@ -1197,6 +1572,13 @@ static int32_t createBlocksQuickSortInitialSources(SSortHandle* pHandle) {
 
   taosMemoryFree(source);
 
+  if (pHandle->pRunTasks != NULL) {
+    code = sortWaitRunTasks(pHandle, 0, true);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
   if (pHandle->pDataBlock != NULL && pHandle->pDataBlock->info.rows > 0) {
     size_t size = blockDataGetSize(pHandle->pDataBlock);
 
@@ -1363,6 +1745,14 @@ void tsortSetForceUsePQSort(SSortHandle* pHandle) {
   pHandle->forceUsePQSort = true;
 }
 
+void tsortSetTopNThreshold(SSortHandle* pHandle, STopNThreshold* pThreshold) {
+  pHandle->pThreshold = pThreshold;
+}
+
+void tsortSetArena(SSortHandle* pHandle, SArena* pArena) {
+  pHandle->pArena = pArena;
+}
+
 static bool tsortIsPQSortApplicable(SSortHandle* pHandle) {
   if (pHandle->type != SORT_SINGLESOURCE_SORT) return false;
   if (tsortIsForceUsePQSort(pHandle)) return true;
@@ -1412,6 +1802,25 @@ static int32_t tupleComparFn(const void* pLeft, const void* pRight, void* param)
   return 0;
 }
 
+// the top of the bounded queue is the worst one of the kept rows, once the queue is full
+static void tsortUpdateTopNThreshold(SSortHandle* pHandle, uint32_t colNum) {
+  STopNThreshold* pThreshold = pHandle->pThreshold;
+  if (taosBQSize(pHandle->pBoundedQueue) < taosBQMaxSize(pHandle->pBoundedQueue) + 1) {
+    return;
+  }
+
+  PriorityQueueNode* pNode = taosBQTop(pHandle->pBoundedQueue);
+  void*              pData = tupleDescGetField(pNode->data, pThreshold->slotId, colNum);
+  if (pData == NULL) {
+    pThreshold->valid = false;
+    return;
+  }
+
+  int32_t type = ((SColumnInfoData*)taosArrayGet(pHandle->pDataBlock->pDataBlock, pThreshold->slotId))->info.type;
+  GET_TYPED_DATA(pThreshold->key, double, type, pData);
+  pThreshold->valid = true;
+}
+
 static int32_t tsortOpenForPQSort(SSortHandle* pHandle) {
   pHandle->pBoundedQueue = createBoundedQueue(pHandle->pqMaxRows, tsortPQCompFn, destroyTuple, pHandle);
   if (NULL == pHandle->pBoundedQueue) return TSDB_CODE_OUT_OF_MEMORY;
@@ -1455,10 +1864,14 @@ static int32_t tsortOpenForPQSort(SSortHandle* pHandle) {
       if (!pPushedNode) {
         // do nothing if push failed
       } else {
-        pPushedNode->data = createAllocatedTuple(pBlock, colNum, tupleLen, rowIdx);
-        if (pPushedNode->data == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+        pPushedNode->data = createAllocatedTuple(pHandle->pArena, pBlock, colNum, tupleLen, rowIdx);
+        if (pPushedNode->data == NULL) return terrno;
       }
     }
+
+    if (pHandle->pThreshold != NULL) {
+      tsortUpdateTopNThreshold(pHandle, colNum);
+    }
   }
   return TSDB_CODE_SUCCESS;
 }
@@ -1577,6 +1990,9 @@ SSortExecInfo tsortGetSortExecInfo(SSortHandle* pHandle) {
       SDiskbasedBufStatis st = getDBufStatis(pHandle->pBuf);
       info.writeBytes = st.flushBytes;
       info.readBytes = st.loadBytes;
+      info.compSrcBytes = st.compSrcBytes;
+      info.compBytes = st.compBytes;
+      info.compUs = st.compUs;
     }
   }
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "tgrouphash.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+TEST(groupHashTest, put_get) {
+  SGroupHash* pHash = tGroupHashInit(16);
+  ASSERT_NE(pHash, nullptr);
+
+  const int64_t num = 200000;
+  for (int64_t i = 0; i < num; ++i) {
+    bool             newGroup = false;
+    SGroupHashEntry* pEntry = tGroupHashPut(pHash, (const char*)&i, sizeof(i), &newGroup);
+    ASSERT_NE(pEntry, nullptr);
+    ASSERT_TRUE(newGroup);
+    ASSERT_EQ(pEntry->pos.pageId, -1);
+    pEntry->pos.pageId = (int32_t)i;
+  }
+  ASSERT_EQ(tGroupHashGetSize(pHash), num);
+
+  for (int64_t i = 0; i < num; ++i) {
+    bool             newGroup = true;
+    SGroupHashEntry* pEntry = tGroupHashPut(pHash, (const char*)&i, sizeof(i), &newGroup);
+    ASSERT_FALSE(newGroup);
+    ASSERT_EQ(pEntry->pos.pageId, i);
+    ASSERT_EQ(tGroupHashGet(pHash, (const char*)&i, sizeof(i)), pEntry);
+  }
+
+  int64_t missing = num;
+  ASSERT_EQ(tGroupHashGet(pHash, (const char*)&missing, sizeof(missing)), nullptr);
+
+  // every entry is iterated once, in the partition of its hash value
+  int64_t total = 0;
+  for (int32_t p = 0; p < GROUP_HASH_PARTITIONS; ++p) {
+    for (int32_t i = 0; i < tGroupHashGetPartitionSize(pHash, p); ++i) {
+      SGroupHashEntry* pEntry = tGroupHashGetEntry(pHash, p, i);
+      ASSERT_EQ(tGroupHashGetPartition(pEntry->hashVal), p);
+      ASSERT_EQ(pEntry->pos.pageId, *(int64_t*)pEntry->pKey);
+      total += 1;
+    }
+  }
+  ASSERT_EQ(total, num);
+
+  tGroupHashCleanup(pHash);
+}
+
+TEST(groupHashTest, var_keys_and_clear) {
+  SGroupHash* pHash = tGroupHashInit(64);
+  ASSERT_NE(pHash, nullptr);
+
+  char key[1024] = {0};
+  for (int32_t round = 0; round < 3; ++round) {
+    for (int32_t i = 0; i < 10000; ++i) {
+      int32_t len = snprintf(key, sizeof(key), "device_%d", i);
+      bool    newGroup = false;
+      ASSERT_NE(tGroupHashPut(pHash, key, len, &newGroup), nullptr);
+      ASSERT_TRUE(newGroup);
+    }
+
+    // a prefix of a key is a different key
+    bool newGroup = false;
+    ASSERT_NE(tGroupHashPut(pHash, "device_1", 7, &newGroup), nullptr);
+    ASSERT_TRUE(newGroup);
+
+    // a long key
+    memset(key, 'x', sizeof(key));
+    ASSERT_NE(tGroupHashPut(pHash, key, sizeof(key), &newGroup), nullptr);
+    ASSERT_TRUE(newGroup);
+    ASSERT_NE(tGroupHashGet(pHash, key, sizeof(key)), nullptr);
+
+    ASSERT_EQ(tGroupHashGetSize(pHash), 10002);
+    ASSERT_NE(tGroupHashGet(pHash, "device_9999", 11), nullptr);
+
+    tGroupHashClear(pHash);
+    ASSERT_EQ(tGroupHashGetSize(pHash), 0);
+    ASSERT_EQ(tGroupHashGet(pHash, "device_9999", 11), nullptr);
+  }
+
+  tGroupHashCleanup(pHash);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+#include "os.h"
+
+#include "executorInt.h"
+#include "hashjoin.h"
+#include "operator.h"
+#include "querynodes.h"
+#include "querytask.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+
+namespace {
+
+// the build side is the left table, block 1, and the probe side the right table, block 2
+const int32_t kBuildBlkId = 1;
+const int32_t kProbeBlkId = 2;
+const int32_t kResBlkId = 3;
+const int32_t kBlockRows = 4096;
+
+typedef std::tuple<int64_t, int32_t, int32_t> SJoinRow;  // key, build value, probe value
+
+typedef struct SHJoinTestInput {
+  int32_t      numOfRows;
+  int32_t      keyMod;
+  int32_t      current;
+  SSDataBlock* pBlock;
+} SHJoinTestInput;
+
+// rows of (key, value), the key of the row i is i % keyMod and the value is i
+SSDataBlock* getHJoinTestBlock(SOperatorInfo* pOperator) {
+  SHJoinTestInput* pInput = (SHJoinTestInput*)pOperator->info;
+  if (pInput->current >= pInput->numOfRows) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pInput->pBlock;
+  blockDataCleanup(pBlock);
+
+  int32_t rows = TMIN(kBlockRows, pInput->numOfRows - pInput->current);
+  for (int32_t i = 0; i < rows; ++i) {
+    int64_t key = (pInput->current + i) % pInput->keyMod;
+    int32_t val = pInput->current + i;
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&key, false);
+    colDataSetVal((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&val, false);
+  }
+
+  pBlock->info.rows = rows;
+  pInput->current += rows;
+  return pBlock;
+}
+
+void destroyHJoinTestInput(void* param) {
+  SHJoinTestInput* pInput = (SHJoinTestInput*)param;
+  blockDataDestroy(pInput->pBlock);
+  taosMemoryFree(pInput);
+}
+
+SOperatorInfo* createHJoinTestInput(int32_t blkId, int32_t numOfRows, int32_t keyMod) {
+  SHJoinTestInput* pInput = (SHJoinTestInput*)taosMemoryCalloc(1, sizeof(SHJoinTestInput));
+  pInput->numOfRows = numOfRows;
+  pInput->keyMod = keyMod;
+  pInput->pBlock = createDataBlock();
+
+  SColumnInfoData keyCol = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+  SColumnInfoData valCol = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 2);
+  blockDataAppendColInfo(pInput->pBlock, &keyCol);
+  blockDataAppendColInfo(pInput->pBlock, &valCol);
+  blockDataEnsureCapacity(pInput->pBlock, kBlockRows);
+
+  SOperatorInfo* pOperator = (SOperatorInfo*)taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  pOperator->info = pInput;
+  pOperator->resultDataBlockId = blkId;
+  pOperator->fpSet = createOperatorFpSet(optrDummyOpenFn, getHJoinTestBlock, NULL, destroyHJoinTestInput,
+                                         optrDefaultBufFn, NULL, optrDefaultGetNextExtFn, NULL);
+  return pOperator;
+}
+
+SNode* createHJoinTestCol(int32_t blkId, int32_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->dataBlockId = blkId;
+  pCol->slotId = slotId;
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  return (SNode*)pCol;
+}
+
+void addHJoinTestTarget(SHashJoinPhysiNode* pNode, int32_t blkId, int32_t srcSlot, int32_t dstSlot, int8_t type,
+                        int32_t bytes) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = kResBlkId;
+  pTarget->slotId = dstSlot;
+  pTarget->pExpr = createHJoinTestCol(blkId, srcSlot, type, bytes);
+  nodesListMakeAppend(&pNode->pTargets, (SNode*)pTarget);
+
+  SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+  pSlot->slotId = dstSlot;
+  pSlot->dataType.type = type;
+  pSlot->dataType.bytes = bytes;
+  pSlot->output = true;
+  nodesListMakeAppend(&pNode->node.pOutputDataBlockDesc->pSlots, (SNode*)pSlot);
+}
+
+// inner join on the key, select the key and the value of the build side and the value of the probe side
+SHashJoinPhysiNode* createHJoinTestNode(int32_t buildRows, int32_t probeRows) {
+  SHashJoinPhysiNode* pNode = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pNode->joinType = JOIN_TYPE_INNER;
+  pNode->inputStat[0].inputRowNum = buildRows;
+  pNode->inputStat[1].inputRowNum = buildRows + probeRows;  // the smaller input is the build side
+  nodesListMakeAppend(&pNode->pOnLeft, createHJoinTestCol(kBuildBlkId, 0, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t)));
+  nodesListMakeAppend(&pNode->pOnRight, createHJoinTestCol(kProbeBlkId, 0, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t)));
+
+  pNode->node.pOutputDataBlockDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pNode->node.pOutputDataBlockDesc->dataBlockId = kResBlkId;
+  addHJoinTestTarget(pNode, kBuildBlkId, 0, 0, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t));
+  addHJoinTestTarget(pNode, kBuildBlkId, 1, 1, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  addHJoinTestTarget(pNode, kProbeBlkId, 1, 2, TSDB_DATA_TYPE_INT, sizeof(int32_t));
+  return pNode;
+}
+
+// run the join with the given buffer size in MB, return the result rows sorted and the number of spilled partitions
+int32_t runHashJoin(int32_t bufSize, int32_t buildRows, int32_t buildKeyMod, int32_t probeRows, int32_t probeKeyMod,
+                    std::vector<SJoinRow>* pRows, int64_t* pSpillParts) {
+  int32_t bufSizeBak = tsQueryHashJoinBufSize;
+  tsQueryHashJoinBufSize = bufSize;
+
+  SExecTaskInfo*      pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  SHashJoinPhysiNode* pNode = createHJoinTestNode(buildRows, probeRows);
+  SOperatorInfo*      pDownstream[2] = {createHJoinTestInput(kBuildBlkId, buildRows, buildKeyMod),
+                                        createHJoinTestInput(kProbeBlkId, probeRows, probeKeyMod)};
+  SOperatorInfo*      pJoin = createHashJoinOperatorInfo(pDownstream, 2, pNode, pTaskInfo);
+  tsQueryHashJoinBufSize = bufSizeBak;
+  if (NULL == pJoin) {
+    return pTaskInfo->code;
+  }
+
+  int32_t code = setjmp(pTaskInfo->env);
+  if (TSDB_CODE_SUCCESS == code) {
+    while (true) {
+      SSDataBlock* pRes = pJoin->fpSet.getNextFn(pJoin);
+      if (NULL == pRes) {
+        break;
+      }
+
+      SColumnInfoData* pKey = (SColumnInfoData*)taosArrayGet(pRes->pDataBlock, 0);
+      SColumnInfoData* pBuildVal = (SColumnInfoData*)taosArrayGet(pRes->pDataBlock, 1);
+      SColumnInfoData* pProbeVal = (SColumnInfoData*)taosArrayGet(pRes->pDataBlock, 2);
+      for (int32_t i = 0; i < pRes->info.rows; ++i) {
+        pRows->push_back(SJoinRow(*(int64_t*)colDataGetData(pKey, i), *(int32_t*)colDataGetData(pBuildVal, i),
+                                  *(int32_t*)colDataGetData(pProbeVal, i)));
+      }
+    }
+
+    *pSpillParts = ((SHJoinOperatorInfo*)pJoin->info)->execInfo.spillParts;
+  }
+
+  destroyOperator(pJoin);
+  nodesDestroyNode((SNode*)pNode);
+  taosMemoryFree(pTaskInfo);
+
+  std::sort(pRows->begin(), pRows->end());
+  return code;
+}
+
+class HashJoinTest : public ::testing::Test {
+ protected:
+  // the spilled partitions are written to the temp dir, which must have free space
+  static void SetUpTestSuite() {
+    osDefaultInit();
+    osUpdate();
+  }
+};
+
+}  // namespace
+
+TEST_F(HashJoinTest, spill_same_as_in_memory) {
+  // the build rows take some MB, so they do not fit in a 1MB buffer
+  const int32_t buildRows = 200000, buildKeyMod = 50000;
+  const int32_t probeRows = 120000, probeKeyMod = 60000;
+
+  std::vector<SJoinRow> memRows, spillRows;
+  int64_t               memSpillParts = -1, spillParts = -1;
+  ASSERT_EQ(runHashJoin(512, buildRows, buildKeyMod, probeRows, probeKeyMod, &memRows, &memSpillParts), 0);
+  ASSERT_EQ(runHashJoin(1, buildRows, buildKeyMod, probeRows, probeKeyMod, &spillRows, &spillParts), 0);
+
+  ASSERT_EQ(memSpillParts, 0);
+  ASSERT_GT(spillParts, 0);
+
+  // every key below buildKeyMod has 4 build rows and 2 probe rows, the keys above it have no build row
+  ASSERT_EQ(memRows.size(), (size_t)buildKeyMod * 4 * 2);
+  ASSERT_TRUE(memRows == spillRows);
+
+  for (const auto& row : memRows) {
+    ASSERT_EQ(std::get<0>(row), std::get<1>(row) % buildKeyMod);
+    ASSERT_EQ(std::get<0>(row), std::get<2>(row) % probeKeyMod);
+  }
+}
+
+TEST_F(HashJoinTest, spill_small_probe) {
+  // without probe rows, the spilled partitions are never loaded
+  std::vector<SJoinRow> rows;
+  int64_t               spillParts = -1;
+  ASSERT_EQ(runHashJoin(1, 200000, 50000, 0, 1, &rows, &spillParts), 0);
+  ASSERT_TRUE(rows.empty());
+  ASSERT_GT(spillParts, 0);
+
+  // the probe rows of a few keys only
+  rows.clear();
+  ASSERT_EQ(runHashJoin(1, 200000, 50000, 1000, 1000, &rows, &spillParts), 0);
+  ASSERT_EQ(rows.size(), (size_t)1000 * 4);
+}
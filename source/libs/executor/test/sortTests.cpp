@@ -14,6 +14,8 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 #include <tglobal.h>
 #include <tsort.h>
 #include <iostream>
@@ -393,4 +395,239 @@ TEST(testCase, ordered_merge_sort_Test) {
 
 #endif
 
+namespace {
+typedef struct {
+  int32_t      numOfBlocks;
+  int32_t      rows;
+  int64_t      nextId;
+  SSDataBlock* pBlock;  // reused by each fetch
+} SMultiColSource;
+
+typedef struct {
+  bool        intNull;
+  int32_t     intVal;
+  bool        strNull;
+  std::string strVal;
+} SMultiColRow;
+
+SSDataBlock* createMultiColBlock() {
+  SSDataBlock* pBlock = createDataBlock();
+
+  SColumnInfoData c0 = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  SColumnInfoData c1 = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, VARCOUNT + VARSTR_HEADER_SIZE, 2);
+  SColumnInfoData c2 = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 3);
+  blockDataAppendColInfo(pBlock, &c0);
+  blockDataAppendColInfo(pBlock, &c1);
+  blockDataAppendColInfo(pBlock, &c2);
+  return pBlock;
+}
+
+// int with nulls, short strings over a small alphabet so that ties and common prefixes are frequent, row id
+SSDataBlock* getMultiColBlock(void* param) {
+  SMultiColSource* pSrc = (SMultiColSource*)param;
+  if (--pSrc->numOfBlocks < 0) {
+    return NULL;
+  }
+
+  SSDataBlock* pBlock = pSrc->pBlock;
+  blockDataCleanup(pBlock);
+  blockDataEnsureCapacity(pBlock, pSrc->rows);
+  pBlock->info.hasVarCol = true;
+
+  SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+  SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1);
+  SColumnInfoData* p2 = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2);
+  for (int32_t i = 0; i < pSrc->rows; ++i) {
+    int32_t v = (int32_t)(taosRand() % 2000) - 1000;
+    colDataSetVal(p0, i, (const char*)&v, (taosRand() % 20) == 0);
+
+    char    str[64] = {0};
+    int32_t len = taosRand() % 6;
+    for (int32_t j = 0; j < len; ++j) {
+      varDataVal(str)[j] = "ab"[taosRand() % 2];
+    }
+    varDataSetLen(str, len);
+    colDataSetVal(p1, i, str, (taosRand() % 50) == 0);
+
+    int64_t id = pSrc->nextId++;
+    colDataSetVal(p2, i, (const char*)&id, false);
+  }
+
+  pBlock->info.rows = pSrc->rows;
+  return pBlock;
+}
+
+// int desc with nulls first, then string asc with nulls last
+int32_t multiColCompare(const SMultiColRow& l, const SMultiColRow& r) {
+  if (l.intNull != r.intNull) return l.intNull ? -1 : 1;
+  if (!l.intNull && l.intVal != r.intVal) return l.intVal > r.intVal ? -1 : 1;
+  if (l.strNull != r.strNull) return l.strNull ? 1 : -1;
+  if (l.strNull) return 0;
+  return l.strVal.compare(r.strVal);
+}
+
+SArray* createMultiColOrder() {
+  SArray*         pOrderInfo = taosArrayInit(2, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_DESC;
+  oi.slotId = 0;
+  oi.nullFirst = true;
+  taosArrayPush(pOrderInfo, &oi);
+  oi.order = TSDB_ORDER_ASC;
+  oi.slotId = 1;
+  oi.nullFirst = false;
+  taosArrayPush(pOrderInfo, &oi);
+  return pOrderInfo;
+}
+
+// sort numOfBlocks * rows rows through a sort buffer of numOfPages pages, return the elapsed time in us
+int64_t runMultiColSort(int32_t numOfBlocks, int32_t rows, int32_t numOfPages, bool check) {
+  SMultiColSource src = {0};
+  src.numOfBlocks = numOfBlocks;
+  src.rows = rows;
+  src.pBlock = createMultiColBlock();
+
+  SArray*      pOrderInfo = createMultiColOrder();
+  SSortHandle* pHandle =
+      tsortCreateSortHandle(pOrderInfo, SORT_SINGLESOURCE_SORT, 4096, numOfPages, src.pBlock, "sort_test", 0, 0, 0);
+  tsortSetFetchRawDataFp(pHandle, getMultiColBlock, NULL, NULL);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &src;
+  ps->onlyRef = true;
+  tsortAddSource(pHandle, ps);
+
+  int64_t st = taosGetTimestampUs();
+  EXPECT_EQ(tsortOpen(pHandle), 0);
+
+  int64_t       numOfRows = 0, idSum = 0, numOfDisorder = 0;
+  SMultiColRow  prev, cur;
+  STupleHandle* pTuple = NULL;
+  while ((pTuple = tsortNextTuple(pHandle)) != NULL) {
+    numOfRows += 1;
+    if (!check) continue;
+
+    cur.intNull = tsortIsNullVal(pTuple, 0);
+    cur.intVal = cur.intNull ? 0 : *(int32_t*)tsortGetValue(pTuple, 0);
+    cur.strNull = tsortIsNullVal(pTuple, 1);
+    if (!cur.strNull) {
+      char* p = (char*)tsortGetValue(pTuple, 1);
+      cur.strVal.assign(varDataVal(p), varDataLen(p));
+    }
+    idSum += *(int64_t*)tsortGetValue(pTuple, 2);
+
+    if (numOfRows > 1 && multiColCompare(prev, cur) > 0) {
+      numOfDisorder += 1;
+    }
+    prev = cur;
+  }
+  int64_t elapsed = taosGetTimestampUs() - st;
+
+  int64_t total = (int64_t)numOfBlocks * rows;
+  EXPECT_EQ(numOfRows, total);
+  if (check) {
+    EXPECT_EQ(numOfDisorder, 0);
+    EXPECT_EQ(idSum, total * (total - 1) / 2);
+  }
+
+  tsortDestroySortHandle(pHandle);
+  taosArrayDestroy(pOrderInfo);
+  blockDataDestroy(src.pBlock);
+  return elapsed;
+}
+}  // namespace
+
+TEST(sortTest, external_sort_multi_col) {
+  int32_t threads = tsQuerySortThreads;
+
+  // serial run generation, then sorted runs generated in parallel, both with multi-pass merge
+  tsQuerySortThreads = 0;
+  runMultiColSort(200, 1000, 16, true);
+  tsQuerySortThreads = 4;
+  runMultiColSort(200, 1000, 16, true);
+
+  // all rows fit in memory
+  runMultiColSort(2, 100, 16, true);
+
+  tsQuerySortThreads = threads;
+}
+
+// the sorts share the sort pool, which has fewer threads than the runs in flight
+TEST(sortTest, external_sort_shared_pool) {
+  int32_t threads = tsQuerySortThreads;
+  tsQuerySortThreads = 2;
+
+  std::vector<std::thread> sorts;
+  for (int32_t i = 0; i < 4; ++i) {
+    sorts.emplace_back([]() { runMultiColSort(100, 1000, 16, true); });
+  }
+  for (auto& sort : sorts) {
+    sort.join();
+  }
+
+  tsQuerySortThreads = threads;
+}
+
+TEST(sortTest, pq_sort_topn_threshold) {
+  SMultiColSource src = {0};
+  src.numOfBlocks = 20;
+  src.rows = 1000;
+  src.pBlock = createMultiColBlock();
+
+  SArray*         pOrderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_DESC;
+  oi.slotId = 0;
+  oi.nullFirst = false;
+  taosArrayPush(pOrderInfo, &oi);
+
+  SSortHandle* pHandle = tsortCreateSortHandle(pOrderInfo, SORT_SINGLESOURCE_SORT, 4096, 16, src.pBlock, "sort_test",
+                                               10, 64, 1024 * 1024);
+  tsortSetFetchRawDataFp(pHandle, getMultiColBlock, NULL, NULL);
+  tsortSetForceUsePQSort(pHandle);
+
+  STopNThreshold threshold = {0};
+  threshold.order = oi.order;
+  threshold.nullFirst = oi.nullFirst;
+  threshold.slotId = oi.slotId;
+  tsortSetTopNThreshold(pHandle, &threshold);
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &src;
+  ps->onlyRef = true;
+  tsortAddSource(pHandle, ps);
+  ASSERT_EQ(tsortOpen(pHandle), 0);
+  ASSERT_TRUE(threshold.valid);
+
+  // every row of the result beats the threshold, so that a block whose max value is below it can be skipped
+  int32_t       numOfRows = 0;
+  STupleHandle* pTuple = NULL;
+  while ((pTuple = tsortNextTuple(pHandle)) != NULL) {
+    ASSERT_FALSE(tsortIsNullVal(pTuple, 0));
+    EXPECT_GE(*(int32_t*)tsortGetValue(pTuple, 0), threshold.key);
+    numOfRows += 1;
+  }
+  EXPECT_EQ(numOfRows, 10);
+
+  tsortDestroySortHandle(pHandle);
+  taosArrayDestroy(pOrderInfo);
+  blockDataDestroy(src.pBlock);
+}
+
+// rows/sec of the external sort with serial and parallel run generation, run with --gtest_also_run_disabled_tests
+TEST(sortTest, DISABLED_benchmark) {
+  int32_t threads = tsQuerySortThreads;
+  int32_t numOfThreads[] = {0, 2, 4, 8};
+  int64_t total = 4000 * 1000;
+
+  for (int32_t i = 0; i < sizeof(numOfThreads) / sizeof(numOfThreads[0]); ++i) {
+    tsQuerySortThreads = numOfThreads[i];
+    int64_t elapsed = runMultiColSort(4000, 1000, 1024, false);
+    printf("sort threads:%d rows:%" PRId64 " elapsed:%.2f ms rows/sec:%.0f\n", numOfThreads[i], total,
+           elapsed / 1000.0, total * 1000000.0 / TMAX(elapsed, 1));
+  }
+
+  tsQuerySortThreads = threads;
+}
+
 #pragma GCC diagnostic pop
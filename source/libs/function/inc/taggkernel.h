@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TD_AGG_KERNEL_H_
+#define _TD_AGG_KERNEL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tcommon.h"
+
+/*
+
+Aggregation kernels over the rows [start, start + numOfRows) of a numeric column. The null bitmap is checked eight
+rows at a time to split the range into runs of non-null rows, each run is handed to the AVX512 or AVX2 kernel when it
+is enabled, and the scalar loop takes the rest. All of them return the number of non-null rows.
+
+Integers of any width and sign are summed up in int64_t, which has the same bits as the uint64_t sum of unsigned
+types. The squares of 64 bits integers wrap around as the row by row loop does.
+
+*/
+
+int32_t tAggCountNotNull(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows);
+int32_t tAggSumInt(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum);
+int32_t tAggSumDouble(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum);
+int32_t tAggSumSquareInt(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum,
+                         int64_t* pSquareSum);
+int32_t tAggSumSquareDouble(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum,
+                            double* pSquareSum);
+
+// *pMin and *pMax are the initial values and are updated in place
+int32_t tAggMinMaxDouble(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pMin, double* pMax);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_TD_AGG_KERNEL_H_*/
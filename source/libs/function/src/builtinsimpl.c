@@ -20,10 +20,12 @@
 #include "querynodes.h"
 #include "tcompare.h"
 #include "tdatablock.h"
+#include "taggkernel.h"
 #include "tdigest.h"
 #include "tfunctionInt.h"
 #include "tglobal.h"
 #include "thistogram.h"
+#include "tkll.h"
 #include "tpercentile.h"
 
 #define HISTOGRAM_MAX_BINS_NUM 1000
@@ -36,6 +38,8 @@
 #define HLL_BUCKETS     (1 << HLL_BUCKET_BITS)
 #define HLL_BUCKET_MASK (HLL_BUCKETS - 1)
 #define HLL_ALPHA_INF   0.721347520444481703680  // constant for 0.5/ln(2)
+#define HLL_BATCH_ROWS  256
+#define HLL_SPARSE_MAX  (HLL_BUCKETS >> 3)  // keep the sparse form well below the dense one
 
 // typedef struct SMinmaxResInfo {
 //   bool      assign;  // assign the first value or not
@@ -101,12 +105,14 @@ typedef struct SAPercentileInfo {
   int8_t          algo;
   SHistogramInfo* pHisto;
   TDigest*        pTDigest;
+  SKll*           pKll;
 } SAPercentileInfo;
 
 typedef enum {
   APERCT_ALGO_UNKNOWN = 0,
   APERCT_ALGO_DEFAULT,
   APERCT_ALGO_TDIGEST,
+  APERCT_ALGO_KLL,
 } EAPerctAlgoType;
 
 typedef struct SDiffInfo {
@@ -165,6 +171,14 @@ typedef struct SHLLFuncInfo {
   uint8_t  buckets[HLL_BUCKETS];
 } SHLLInfo;
 
+// the partial result of hyperloglog with few buckets set, told apart from SHLLInfo by the length
+typedef struct SHLLSparseInfo {
+  uint64_t totalCount;
+  int32_t  numOfBuckets;
+  int32_t  reserved;
+  uint32_t buckets[];  // bucket index << 8 | count
+} SHLLSparseInfo;
+
 typedef struct SStateInfo {
   union {
     int64_t count;
@@ -321,18 +335,6 @@ typedef struct SGroupKeyInfo {
     }                                                                    \
   } while (0)
 
-#define LIST_ADD_N(_res, _col, _start, _rows, _t, numOfElem)             \
-  do {                                                                   \
-    _t* d = (_t*)(_col->pData);                                          \
-    for (int32_t i = (_start); i < (_rows) + (_start); ++i) {            \
-      if (((_col)->hasNull) && colDataIsNull_f((_col)->nullbitmap, i)) { \
-        continue;                                                        \
-      };                                                                 \
-      (_res) += (d)[i];                                                  \
-      (numOfElem)++;                                                     \
-    }                                                                    \
-  } while (0)
-
 #define LIST_SUB_N(_res, _col, _start, _rows, _t, numOfElem)             \
   do {                                                                   \
     _t* d = (_t*)(_col->pData);                                          \
@@ -502,7 +504,9 @@ static int64_t getNumOfElems(SqlFunctionCtx* pCtx) {
   if (pInput->colDataSMAIsSet && pInput->totalRows == pInput->numOfRows) {
     numOfElem = pInput->numOfRows - pInput->pColumnDataAgg[0]->numOfNull;
   } else {
-    if (pInputCol->hasNull) {
+    if (pInputCol->hasNull && !IS_VAR_DATA_TYPE(pInputCol->info.type)) {
+      numOfElem = tAggCountNotNull(pInputCol, pInput->startRowIndex, pInput->numOfRows);
+    } else if (pInputCol->hasNull) {
       for (int32_t i = pInput->startRowIndex; i < pInput->startRowIndex + pInput->numOfRows; ++i) {
         if (colDataIsNull(pInputCol, pInput->totalRows, i, NULL)) {
           continue;
@@ -605,29 +609,17 @@ int32_t sumFunction(SqlFunctionCtx* pCtx) {
     int32_t numOfRows = pInput->numOfRows;
 
     if (IS_SIGNED_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL) {
-      if (type == TSDB_DATA_TYPE_TINYINT || type == TSDB_DATA_TYPE_BOOL) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int8_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_SMALLINT) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int16_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_INT) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int32_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_BIGINT) {
-        LIST_ADD_N(pSumRes->isum, pCol, start, numOfRows, int64_t, numOfElem);
-      }
+      int64_t sum = 0;
+      numOfElem = tAggSumInt(pCol, start, numOfRows, &sum);
+      pSumRes->isum += sum;
     } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
-      if (type == TSDB_DATA_TYPE_UTINYINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint8_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_USMALLINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint16_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_UINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint32_t, numOfElem);
-      } else if (type == TSDB_DATA_TYPE_UBIGINT) {
-        LIST_ADD_N(pSumRes->usum, pCol, start, numOfRows, uint64_t, numOfElem);
-      }
-    } else if (type == TSDB_DATA_TYPE_DOUBLE) {
-      LIST_ADD_N(pSumRes->dsum, pCol, start, numOfRows, double, numOfElem);
-    } else if (type == TSDB_DATA_TYPE_FLOAT) {
-      LIST_ADD_N(pSumRes->dsum, pCol, start, numOfRows, float, numOfElem);
+      int64_t sum = 0;
+      numOfElem = tAggSumInt(pCol, start, numOfRows, &sum);
+      pSumRes->usum += (uint64_t)sum;
+    } else if (IS_FLOAT_TYPE(type)) {
+      double sum = 0;
+      numOfElem = tAggSumDouble(pCol, start, numOfRows, &sum);
+      pSumRes->dsum += sum;
     }
   }
 
@@ -1030,165 +1022,25 @@ int32_t stddevFunction(SqlFunctionCtx* pCtx) {
     goto _stddev_over;
   }
 
-  switch (type) {
-    case TSDB_DATA_TYPE_TINYINT: {
-      int8_t* plist = (int8_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + start; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->isum += plist[i];
-        pStddevRes->quadraticISum += plist[i] * plist[i];
-      }
-
-      break;
-    }
-
-    case TSDB_DATA_TYPE_SMALLINT: {
-      int16_t* plist = (int16_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->isum += plist[i];
-        pStddevRes->quadraticISum += plist[i] * plist[i];
-      }
-      break;
-    }
-
-    case TSDB_DATA_TYPE_INT: {
-      int32_t* plist = (int32_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->isum += plist[i];
-        pStddevRes->quadraticISum += plist[i] * plist[i];
-      }
-
-      break;
-    }
-
-    case TSDB_DATA_TYPE_BIGINT: {
-      int64_t* plist = (int64_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->isum += plist[i];
-        pStddevRes->quadraticISum += plist[i] * plist[i];
-      }
-      break;
-    }
-
-    case TSDB_DATA_TYPE_UTINYINT: {
-      uint8_t* plist = (uint8_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + start; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->usum += plist[i];
-        pStddevRes->quadraticUSum += plist[i] * plist[i];
-      }
-
-      break;
-    }
-
-    case TSDB_DATA_TYPE_USMALLINT: {
-      uint16_t* plist = (uint16_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->usum += plist[i];
-        pStddevRes->quadraticUSum += plist[i] * plist[i];
-      }
-      break;
-    }
-
-    case TSDB_DATA_TYPE_UINT: {
-      uint32_t* plist = (uint32_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->usum += plist[i];
-        pStddevRes->quadraticUSum += plist[i] * plist[i];
-      }
-
-      break;
-    }
-
-    case TSDB_DATA_TYPE_UBIGINT: {
-      uint64_t* plist = (uint64_t*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->usum += plist[i];
-        pStddevRes->quadraticUSum += plist[i] * plist[i];
-      }
-      break;
-    }
-
-    case TSDB_DATA_TYPE_FLOAT: {
-      float* plist = (float*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->dsum += plist[i];
-        pStddevRes->quadraticDSum += plist[i] * plist[i];
-      }
-      break;
-    }
-
-    case TSDB_DATA_TYPE_DOUBLE: {
-      double* plist = (double*)pCol->pData;
-      for (int32_t i = start; i < numOfRows + pInput->startRowIndex; ++i) {
-        if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, i)) {
-          continue;
-        }
-
-        numOfElem += 1;
-        pStddevRes->count += 1;
-        pStddevRes->dsum += plist[i];
-        pStddevRes->quadraticDSum += plist[i] * plist[i];
-      }
-      break;
-    }
-
-    default:
-      break;
+  if (IS_SIGNED_NUMERIC_TYPE(type)) {
+    int64_t sum = 0, squareSum = 0;
+    numOfElem = tAggSumSquareInt(pCol, start, numOfRows, &sum, &squareSum);
+    pStddevRes->isum += sum;
+    pStddevRes->quadraticISum += squareSum;
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(type)) {
+    int64_t sum = 0, squareSum = 0;
+    numOfElem = tAggSumSquareInt(pCol, start, numOfRows, &sum, &squareSum);
+    pStddevRes->usum += (uint64_t)sum;
+    pStddevRes->quadraticUSum += (uint64_t)squareSum;
+  } else if (IS_FLOAT_TYPE(type)) {
+    double sum = 0, squareSum = 0;
+    numOfElem = tAggSumSquareDouble(pCol, start, numOfRows, &sum, &squareSum);
+    pStddevRes->dsum += sum;
+    pStddevRes->quadraticDSum += squareSum;
   }
 
+  pStddevRes->count += numOfElem;
+
 _stddev_over:
   // data in the check operation are all null, not output
   SET_VAL(GET_RES_INFO(pCtx), numOfElem, 1);
@@ -1781,7 +1633,8 @@ bool getApercentileFuncEnv(SFunctionNode* pFunc, SFuncExecEnv* pEnv) {
   int32_t bytesHist =
       (int32_t)(sizeof(SAPercentileInfo) + sizeof(SHistogramInfo) + sizeof(SHistBin) * (MAX_HISTOGRAM_BIN + 1));
   int32_t bytesDigest = (int32_t)(sizeof(SAPercentileInfo) + TDIGEST_SIZE(COMPRESSION));
-  pEnv->calcMemSize = TMAX(bytesHist, bytesDigest);
+  int32_t bytesKll = (int32_t)(sizeof(SAPercentileInfo) + KLL_SIZE);
+  pEnv->calcMemSize = TMAX(TMAX(bytesHist, bytesDigest), bytesKll);
   return true;
 }
 
@@ -1789,7 +1642,8 @@ int32_t getApercentileMaxSize() {
   int32_t bytesHist =
       (int32_t)(sizeof(SAPercentileInfo) + sizeof(SHistogramInfo) + sizeof(SHistBin) * (MAX_HISTOGRAM_BIN + 1));
   int32_t bytesDigest = (int32_t)(sizeof(SAPercentileInfo) + TDIGEST_SIZE(COMPRESSION));
-  return TMAX(bytesHist, bytesDigest);
+  int32_t bytesKll = (int32_t)(sizeof(SAPercentileInfo) + KLL_SIZE);
+  return TMAX(TMAX(bytesHist, bytesDigest), bytesKll);
 }
 
 static int8_t getApercentileAlgo(char* algoStr) {
@@ -1798,6 +1652,8 @@ static int8_t getApercentileAlgo(char* algoStr) {
     algoType = APERCT_ALGO_DEFAULT;
   } else if (strcasecmp(algoStr, "t-digest") == 0) {
     algoType = APERCT_ALGO_TDIGEST;
+  } else if (strcasecmp(algoStr, "kll") == 0) {
+    algoType = APERCT_ALGO_KLL;
   } else {
     algoType = APERCT_ALGO_UNKNOWN;
   }
@@ -1814,6 +1670,10 @@ static void buildTDigestInfo(SAPercentileInfo* pInfo) {
   pInfo->pTDigest = (TDigest*)((char*)pInfo + sizeof(SAPercentileInfo));
 }
 
+static void buildKllInfo(SAPercentileInfo* pInfo) {
+  pInfo->pKll = (SKll*)((char*)pInfo + sizeof(SAPercentileInfo));
+}
+
 bool apercentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResultInfo) {
   if (!functionSetup(pCtx, pResultInfo)) {
     return false;
@@ -1837,6 +1697,8 @@ bool apercentileFunctionSetup(SqlFunctionCtx* pCtx, SResultRowEntryInfo* pResult
   char* tmp = (char*)pInfo + sizeof(SAPercentileInfo);
   if (pInfo->algo == APERCT_ALGO_TDIGEST) {
     pInfo->pTDigest = tdigestNewFrom(tmp, COMPRESSION);
+  } else if (pInfo->algo == APERCT_ALGO_KLL) {
+    pInfo->pKll = tKllNewFrom(tmp);
   } else {
     buildHistogramInfo(pInfo);
     pInfo->pHisto = tHistogramCreateFrom(tmp, MAX_HISTOGRAM_BIN);
@@ -1873,6 +1735,19 @@ int32_t apercentileFunction(SqlFunctionCtx* pCtx) {
       GET_TYPED_DATA(v, double, type, data);
       tdigestAdd(pInfo->pTDigest, v, w);
     }
+  } else if (pInfo->algo == APERCT_ALGO_KLL) {
+    buildKllInfo(pInfo);
+    for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
+      if (colDataIsNull_f(pCol->nullbitmap, i)) {
+        continue;
+      }
+      numOfElems += 1;
+      char* data = colDataGetData(pCol, i);
+
+      double v = 0;
+      GET_TYPED_DATA(v, double, type, data);
+      tKllAdd(pInfo->pKll, v);
+    }
   } else {
     // might be a race condition here that pHisto can be overwritten or setup function
     // has not been called, need to relink the buffer pHisto points to.
@@ -1929,6 +1804,22 @@ static void apercentileTransferInfo(SAPercentileInfo* pInput, SAPercentileInfo*
     } else {
       tdigestMerge(pTDigest, pInput->pTDigest);
     }
+  } else if (pOutput->algo == APERCT_ALGO_KLL) {
+    buildKllInfo(pInput);
+    if (pInput->pKll->n == 0) {
+      return;
+    }
+
+    if (hasRes) {
+      *hasRes = true;
+    }
+
+    buildKllInfo(pOutput);
+    if (pOutput->pKll->n == 0) {
+      memcpy(pOutput->pKll, pInput->pKll, KLL_SIZE);
+    } else {
+      tKllMerge(pOutput->pKll, pInput->pKll);
+    }
   } else {
     buildHistogramInfo(pInput);
     if (pInput->pHisto->numOfElems <= 0) {
@@ -1987,7 +1878,7 @@ int32_t apercentileFunctionMerge(SqlFunctionCtx* pCtx) {
     apercentileTransferInfo(pInputInfo, pInfo, &hasRes);
   }
 
-  if (pInfo->algo != APERCT_ALGO_TDIGEST) {
+  if (pInfo->algo != APERCT_ALGO_TDIGEST && pInfo->algo != APERCT_ALGO_KLL) {
     buildHistogramInfo(pInfo);
     qDebug("%s after merge, total:%" PRId64 ", numOfEntry:%d, %p", __FUNCTION__, pInfo->pHisto->numOfElems,
            pInfo->pHisto->numOfEntries, pInfo->pHisto);
@@ -2010,6 +1901,13 @@ int32_t apercentileFinalize(SqlFunctionCtx* pCtx, SSDataBlock* pBlock) {
       // setNull(pCtx->pOutput, pCtx->outputType, pCtx->outputBytes);
       return TSDB_CODE_SUCCESS;
     }
+  } else if (pInfo->algo == APERCT_ALGO_KLL) {
+    buildKllInfo(pInfo);
+    if (pInfo->pKll->n > 0) {
+      pInfo->result = tKllQuantile(pInfo->pKll, pInfo->percent / 100);
+    } else {
+      return TSDB_CODE_SUCCESS;
+    }
   } else {
     buildHistogramInfo(pInfo);
     if (pInfo->pHisto->numOfElems > 0) {
@@ -3390,27 +3288,11 @@ int32_t spreadFunction(SqlFunctionCtx* pCtx) {
   } else {  // computing based on the true data block
     SColumnInfoData* pCol = pInput->pData[0];
 
-    int32_t start = pInput->startRowIndex;
-    // check the valid data one by one
-    for (int32_t i = start; i < pInput->numOfRows + start; ++i) {
-      if (colDataIsNull_f(pCol->nullbitmap, i)) {
-        continue;
-      }
-
-      char* data = colDataGetData(pCol, i);
-
-      double v = 0;
-      GET_TYPED_DATA(v, double, type, data);
-      if (v < GET_DOUBLE_VAL(&pInfo->min)) {
-        SET_DOUBLE_VAL(&pInfo->min, v);
-      }
-
-      if (v > GET_DOUBLE_VAL(&pInfo->max)) {
-        SET_DOUBLE_VAL(&pInfo->max, v);
-      }
-
-      numOfElems += 1;
-    }
+    double tmin = GET_DOUBLE_VAL(&pInfo->min);
+    double tmax = GET_DOUBLE_VAL(&pInfo->max);
+    numOfElems = tAggMinMaxDouble(pCol, pInput->startRowIndex, pInput->numOfRows, &tmin, &tmax);
+    SET_DOUBLE_VAL(&pInfo->min, tmin);
+    SET_DOUBLE_VAL(&pInfo->max, tmax);
   }
 
 _spread_over:
@@ -4027,19 +3909,55 @@ bool getHLLFuncEnv(SFunctionNode* UNUSED_PARAM(pFunc), SFuncExecEnv* pEnv) {
   return true;
 }
 
-static uint8_t hllCountNum(void* data, int32_t bytes, int32_t* buk) {
-  uint64_t hash = MurmurHash3_64(data, bytes);
-  int32_t  index = hash & HLL_BUCKET_MASK;
+static FORCE_INLINE void hllUpdateBucket(uint8_t* buckets, uint64_t hash) {
+  int32_t index = hash & HLL_BUCKET_MASK;
   hash >>= HLL_BUCKET_BITS;
   hash |= ((uint64_t)1 << HLL_DATA_BITS);
-  uint64_t bit = 1;
-  uint8_t  count = 1;
-  while ((hash & bit) == 0) {
-    count++;
-    bit <<= 1;
+
+  uint8_t count = (uint8_t)(BUILDIN_CTZL(hash) + 1);
+  if (count > buckets[index]) {
+    buckets[index] = count;
+  }
+}
+
+// hash a batch of values first and then update the buckets, so the hash loop does not stall on the bucket writes
+static int32_t hllAddFixedData(SHLLInfo* pInfo, SColumnInfoData* pCol, int32_t start, int32_t numOfRows) {
+  int32_t  bytes = pCol->info.bytes;
+  int32_t  numOfElems = 0;
+  uint64_t hash[HLL_BATCH_ROWS];
+
+  for (int32_t i = start; i < start + numOfRows; i += HLL_BATCH_ROWS) {
+    int32_t end = TMIN(i + HLL_BATCH_ROWS, start + numOfRows);
+    int32_t num = 0;
+    for (int32_t j = i; j < end; ++j) {
+      if (pCol->hasNull && colDataIsNull_f(pCol->nullbitmap, j)) {
+        continue;
+      }
+      hash[num++] = MurmurHash3_64(pCol->pData + (int64_t)j * bytes, bytes);
+    }
+
+    for (int32_t j = 0; j < num; ++j) {
+      hllUpdateBucket(pInfo->buckets, hash[j]);
+    }
+    numOfElems += num;
+  }
+
+  return numOfElems;
+}
+
+static int32_t hllAddVarData(SHLLInfo* pInfo, SColumnInfoData* pCol, int32_t start, int32_t numOfRows) {
+  int32_t numOfElems = 0;
+  for (int32_t i = start; i < start + numOfRows; ++i) {
+    if (colDataIsNull_var(pCol, i)) {
+      continue;
+    }
+
+    char* data = colDataGetVarData(pCol, i);
+    hllUpdateBucket(pInfo->buckets, MurmurHash3_64(varDataVal(data), varDataLen(data)));
+    numOfElems++;
   }
-  *buk = index;
-  return count;
+
+  return numOfElems;
 }
 
 static void hllBucketHisto(uint8_t* buckets, int32_t* bucketHisto) {
@@ -4117,7 +4035,6 @@ int32_t hllFunction(SqlFunctionCtx* pCtx) {
   SColumnInfoData*      pCol = pInput->pData[0];
 
   int32_t type = pCol->info.type;
-  int32_t bytes = pCol->info.bytes;
 
   int32_t start = pInput->startRowIndex;
   int32_t numOfRows = pInput->numOfRows;
@@ -4127,25 +4044,10 @@ int32_t hllFunction(SqlFunctionCtx* pCtx) {
     goto _hll_over;
   }
 
-  for (int32_t i = start; i < numOfRows + start; ++i) {
-    if (pCol->hasNull && colDataIsNull_s(pCol, i)) {
-      continue;
-    }
-
-    numOfElems++;
-
-    char* data = colDataGetData(pCol, i);
-    if (IS_VAR_DATA_TYPE(type)) {
-      bytes = varDataLen(data);
-      data = varDataVal(data);
-    }
-
-    int32_t index = 0;
-    uint8_t count = hllCountNum(data, bytes, &index);
-    uint8_t oldcount = pInfo->buckets[index];
-    if (count > oldcount) {
-      pInfo->buckets[index] = count;
-    }
+  if (IS_VAR_DATA_TYPE(type)) {
+    numOfElems = hllAddVarData(pInfo, pCol, start, numOfRows);
+  } else {
+    numOfElems = hllAddFixedData(pInfo, pCol, start, numOfRows);
   }
 
 _hll_over:
@@ -4169,6 +4071,66 @@ static void hllTransferInfo(SHLLInfo* pInput, SHLLInfo* pOutput) {
   pOutput->totalCount += pInput->totalCount;
 }
 
+static bool hllIsSparseInfo(const char* pData, int32_t len) {
+  if (len < (int32_t)sizeof(SHLLSparseInfo)) {
+    return false;
+  }
+
+  int32_t numOfBuckets = ((const SHLLSparseInfo*)pData)->numOfBuckets;
+  return numOfBuckets >= 0 && numOfBuckets <= HLL_SPARSE_MAX &&
+         len == (int32_t)(sizeof(SHLLSparseInfo) + numOfBuckets * sizeof(uint32_t));
+}
+
+static void hllTransferSparseInfo(SHLLSparseInfo* pInput, SHLLInfo* pOutput) {
+  for (int32_t k = 0; k < pInput->numOfBuckets; ++k) {
+    int32_t index = (pInput->buckets[k] >> 8) & HLL_BUCKET_MASK;
+    uint8_t count = pInput->buckets[k] & 0xFF;
+    if (pOutput->buckets[index] < count) {
+      pOutput->buckets[index] = count;
+    }
+  }
+  pOutput->totalCount += pInput->totalCount;
+}
+
+static int32_t hllNumOfSetBuckets(SHLLInfo* pInfo) {
+  uint64_t* word = (uint64_t*)pInfo->buckets;
+  int32_t   num = 0;
+  for (int32_t j = 0; j < HLL_BUCKETS >> 3; j++) {
+    if (word[j] != 0) {
+      uint8_t* bytes = (uint8_t*)&word[j];
+      for (int32_t k = 0; k < 8; ++k) {
+        num += (bytes[k] != 0);
+      }
+    }
+  }
+
+  return num;
+}
+
+// encode the buckets as a list of (index, count) when it is shorter than the dense buckets, return the length. Nodes
+// before the sparse form take every partial result as a SHLLInfo, so it is only used when queryHllSparse is set.
+static int32_t hllEncodeInfo(SHLLInfo* pInfo, char* pBuf) {
+  int32_t num = tsQueryHllSparse ? hllNumOfSetBuckets(pInfo) : HLL_BUCKETS;
+  if (num > HLL_SPARSE_MAX) {
+    memcpy(pBuf, pInfo, sizeof(SHLLInfo));
+    return (int32_t)sizeof(SHLLInfo);
+  }
+
+  SHLLSparseInfo* pSparse = (SHLLSparseInfo*)pBuf;
+  pSparse->totalCount = pInfo->totalCount;
+  pSparse->numOfBuckets = num;
+  pSparse->reserved = 0;
+
+  int32_t n = 0;
+  for (int32_t k = 0; k < HLL_BUCKETS && n < num; ++k) {
+    if (pInfo->buckets[k] != 0) {
+      pSparse->buckets[n++] = ((uint32_t)k << 8) | pInfo->buckets[k];
+    }
+  }
+
+  return (int32_t)(sizeof(SHLLSparseInfo) + num * sizeof(uint32_t));
+}
+
 int32_t hllFunctionMerge(SqlFunctionCtx* pCtx) {
   SInputColumnInfoData* pInput = &pCtx->input;
   SColumnInfoData*      pCol = pInput->pData[0];
@@ -4182,9 +4144,15 @@ int32_t hllFunctionMerge(SqlFunctionCtx* pCtx) {
   int32_t start = pInput->startRowIndex;
 
   for (int32_t i = start; i < start + pInput->numOfRows; ++i) {
-    char*     data = colDataGetData(pCol, i);
-    SHLLInfo* pInputInfo = (SHLLInfo*)varDataVal(data);
-    hllTransferInfo(pInputInfo, pInfo);
+    char* data = colDataGetData(pCol, i);
+    if (varDataLen(data) == sizeof(SHLLInfo)) {
+      hllTransferInfo((SHLLInfo*)varDataVal(data), pInfo);
+    } else if (hllIsSparseInfo(varDataVal(data), varDataLen(data))) {
+      hllTransferSparseInfo((SHLLSparseInfo*)varDataVal(data), pInfo);
+    } else {
+      qError("invalid hyperloglog partial result, len:%d", varDataLen(data));
+      return TSDB_CODE_INVALID_DATA_FMT;
+    }
   }
 
   if (pInfo->totalCount == 0 && !tsCountAlwaysReturnValue) {
@@ -4214,8 +4182,7 @@ int32_t hllPartialFinalize(SqlFunctionCtx* pCtx, SSDataBlock* pBlock) {
   int32_t              resultBytes = getHLLInfoSize();
   char*                res = taosMemoryCalloc(resultBytes + VARSTR_HEADER_SIZE, sizeof(char));
 
-  memcpy(varDataVal(res), pInfo, resultBytes);
-  varDataSetLen(res, resultBytes);
+  varDataSetLen(res, hllEncodeInfo(pInfo, varDataVal(res)));
 
   int32_t          slotId = pCtx->pExpr->base.resSchema.slotId;
   SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, slotId);
@@ -0,0 +1,564 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taggkernel.h"
+#include "tdatablock.h"
+
+// the squares of integers are computed in uint64_t to wrap around without overflow
+#define AGG_SUM_SCALAR(_t, _sqt, _p, _i, _n, _sum, _square) \
+  do {                                                      \
+    const _t* _d = (const _t*)(_p);                         \
+    if ((_square) != NULL) {                                \
+      for (; (_i) < (_n); ++(_i)) {                         \
+        *(_sum) += _d[_i];                                  \
+        *(_square) += (_sqt)_d[_i] * (_sqt)_d[_i];          \
+      }                                                     \
+    } else {                                                \
+      for (; (_i) < (_n); ++(_i)) {                         \
+        *(_sum) += _d[_i];                                  \
+      }                                                     \
+    }                                                       \
+  } while (0)
+
+#define AGG_MINMAX_SCALAR(_t, _p, _i, _n, _min, _max) \
+  do {                                                \
+    const _t* _d = (const _t*)(_p);                   \
+    _t        _tmin = _d[_i], _tmax = _d[_i];         \
+    for (; (_i) < (_n); ++(_i)) {                     \
+      if (_d[_i] < _tmin) _tmin = _d[_i];             \
+      if (_d[_i] > _tmax) _tmax = _d[_i];             \
+    }                                                 \
+    if ((double)_tmin < *(_min)) *(_min) = _tmin;     \
+    if ((double)_tmax > *(_max)) *(_max) = _tmax;     \
+  } while (0)
+
+// find the next run of non-null rows from *pStart on, eight rows are checked at a time with the null bitmap
+static bool aggNextRun(const SColumnInfoData* pCol, int32_t* pStart, int32_t end, int32_t* pRunEnd) {
+  int32_t i = *pStart;
+  if (!pCol->hasNull || pCol->nullbitmap == NULL) {
+    *pRunEnd = end;
+    return i < end;
+  }
+
+  const uint8_t* bm = (const uint8_t*)pCol->nullbitmap;
+  while (i < end) {
+    if ((i & 0x7) == 0 && i + 8 <= end && bm[i >> 3] == 0xFF) {
+      i += 8;
+    } else if (colDataIsNull_f(pCol->nullbitmap, i)) {
+      i += 1;
+    } else {
+      break;
+    }
+  }
+
+  if (i >= end) {
+    return false;
+  }
+
+  int32_t j = i + 1;
+  while (j < end) {
+    if ((j & 0x7) == 0 && j + 8 <= end && bm[j >> 3] == 0) {
+      j += 8;
+    } else if (!colDataIsNull_f(pCol->nullbitmap, j)) {
+      j += 1;
+    } else {
+      break;
+    }
+  }
+
+  *pStart = i;
+  *pRunEnd = j;
+  return true;
+}
+
+static FORCE_INLINE int32_t aggPopcount64(uint64_t v) {
+  v = v - ((v >> 1) & 0x5555555555555555ULL);
+  v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (int32_t)((v * 0x0101010101010101ULL) >> 56);
+}
+
+int32_t tAggCountNotNull(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows) {
+  if (!pCol->hasNull || pCol->nullbitmap == NULL) {
+    return numOfRows;
+  }
+
+  int32_t i = start;
+  int32_t end = start + numOfRows;
+  int32_t numOfNull = 0;
+  for (; i < end && (i & 0x7) != 0; ++i) {
+    numOfNull += colDataIsNull_f(pCol->nullbitmap, i);
+  }
+
+  for (; i + 64 <= end; i += 64) {
+    uint64_t w = 0;
+    memcpy(&w, pCol->nullbitmap + (i >> 3), sizeof(uint64_t));
+    numOfNull += aggPopcount64(w);
+  }
+
+  for (; i + 8 <= end; i += 8) {
+    numOfNull += aggPopcount64((uint8_t)pCol->nullbitmap[i >> 3]);
+  }
+
+  for (; i < end; ++i) {
+    numOfNull += colDataIsNull_f(pCol->nullbitmap, i);
+  }
+
+  return numOfRows - numOfNull;
+}
+
+#if __AVX2__
+static FORCE_INLINE int64_t aggReduceI64AVX2(__m256i v) {
+  int64_t t[4];
+  _mm256_storeu_si256((__m256i*)t, v);
+  return t[0] + t[1] + t[2] + t[3];
+}
+
+// four values are widened to 64 bits in each step, squares of values within 32 bits are exact in 64 bits lanes
+static int32_t aggSumI8AVX2(const int8_t* p, int32_t numOfRows, bool sign, int64_t* pSum, int64_t* pSquareSum) {
+  int32_t i = 0;
+  __m256i sum = _mm256_setzero_si256();
+  __m256i square = _mm256_setzero_si256();
+
+  for (; i + 4 <= numOfRows; i += 4) {
+    int32_t v = 0;
+    memcpy(&v, p + i, sizeof(int32_t));
+    __m256i x = sign ? _mm256_cvtepi8_epi64(_mm_cvtsi32_si128(v)) : _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(v));
+    sum = _mm256_add_epi64(sum, x);
+    if (pSquareSum != NULL) {
+      square = _mm256_add_epi64(square, _mm256_mul_epi32(x, x));
+    }
+  }
+
+  *pSum += aggReduceI64AVX2(sum);
+  if (pSquareSum != NULL) {
+    *pSquareSum += aggReduceI64AVX2(square);
+  }
+  return i;
+}
+
+static int32_t aggSumI16AVX2(const int16_t* p, int32_t numOfRows, bool sign, int64_t* pSum, int64_t* pSquareSum) {
+  int32_t i = 0;
+  __m256i sum = _mm256_setzero_si256();
+  __m256i square = _mm256_setzero_si256();
+
+  for (; i + 4 <= numOfRows; i += 4) {
+    __m128i v = _mm_loadl_epi64((const __m128i*)(p + i));
+    __m256i x = sign ? _mm256_cvtepi16_epi64(v) : _mm256_cvtepu16_epi64(v);
+    sum = _mm256_add_epi64(sum, x);
+    if (pSquareSum != NULL) {
+      square = _mm256_add_epi64(square, _mm256_mul_epi32(x, x));
+    }
+  }
+
+  *pSum += aggReduceI64AVX2(sum);
+  if (pSquareSum != NULL) {
+    *pSquareSum += aggReduceI64AVX2(square);
+  }
+  return i;
+}
+
+static int32_t aggSumI32AVX2(const int32_t* p, int32_t numOfRows, bool sign, int64_t* pSum, int64_t* pSquareSum) {
+  int32_t i = 0;
+  __m256i sum = _mm256_setzero_si256();
+  __m256i square = _mm256_setzero_si256();
+
+  for (; i + 4 <= numOfRows; i += 4) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+    __m256i x = sign ? _mm256_cvtepi32_epi64(v) : _mm256_cvtepu32_epi64(v);
+    sum = _mm256_add_epi64(sum, x);
+    if (pSquareSum != NULL) {
+      square = _mm256_add_epi64(square, sign ? _mm256_mul_epi32(x, x) : _mm256_mul_epu32(x, x));
+    }
+  }
+
+  *pSum += aggReduceI64AVX2(sum);
+  if (pSquareSum != NULL) {
+    *pSquareSum += aggReduceI64AVX2(square);
+  }
+  return i;
+}
+
+// there is no 64 bits multiplication in AVX2, the squares are left to the scalar loop
+static int32_t aggSumI64AVX2(const int64_t* p, int32_t numOfRows, int64_t* pSum, int64_t* pSquareSum) {
+  if (pSquareSum != NULL) {
+    return 0;
+  }
+
+  int32_t i = 0;
+  __m256i sum0 = _mm256_setzero_si256();
+  __m256i sum1 = _mm256_setzero_si256();
+  for (; i + 8 <= numOfRows; i += 8) {
+    sum0 = _mm256_add_epi64(sum0, _mm256_loadu_si256((const __m256i*)(p + i)));
+    sum1 = _mm256_add_epi64(sum1, _mm256_loadu_si256((const __m256i*)(p + i + 4)));
+  }
+
+  *pSum += aggReduceI64AVX2(_mm256_add_epi64(sum0, sum1));
+  return i;
+}
+
+#endif
+
+#if __AVX__
+static FORCE_INLINE double aggReduceDoubleAVX(__m256d v) {
+  double t[4];
+  _mm256_storeu_pd(t, v);
+  return t[0] + t[1] + t[2] + t[3];
+}
+
+static int32_t aggSumFloatAVX(const float* p, int32_t numOfRows, double* pSum, double* pSquareSum) {
+  int32_t i = 0;
+  __m256d sum = _mm256_setzero_pd();
+  __m256d square = _mm256_setzero_pd();
+
+  // float values are accumulated in double as the scalar loop does
+  for (; i + 4 <= numOfRows; i += 4) {
+    __m256d x = _mm256_cvtps_pd(_mm_loadu_ps(p + i));
+    sum = _mm256_add_pd(sum, x);
+    if (pSquareSum != NULL) {
+      square = _mm256_add_pd(square, _mm256_mul_pd(x, x));
+    }
+  }
+
+  *pSum += aggReduceDoubleAVX(sum);
+  if (pSquareSum != NULL) {
+    *pSquareSum += aggReduceDoubleAVX(square);
+  }
+  return i;
+}
+
+static int32_t aggSumDoubleAVX(const double* p, int32_t numOfRows, double* pSum, double* pSquareSum) {
+  int32_t i = 0;
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  __m256d square = _mm256_setzero_pd();
+
+  for (; i + 8 <= numOfRows; i += 8) {
+    __m256d x0 = _mm256_loadu_pd(p + i);
+    __m256d x1 = _mm256_loadu_pd(p + i + 4);
+    sum0 = _mm256_add_pd(sum0, x0);
+    sum1 = _mm256_add_pd(sum1, x1);
+    if (pSquareSum != NULL) {
+      square = _mm256_add_pd(square, _mm256_add_pd(_mm256_mul_pd(x0, x0), _mm256_mul_pd(x1, x1)));
+    }
+  }
+
+  *pSum += aggReduceDoubleAVX(_mm256_add_pd(sum0, sum1));
+  if (pSquareSum != NULL) {
+    *pSquareSum += aggReduceDoubleAVX(square);
+  }
+  return i;
+}
+
+// NaN is skipped as the scalar comparison does, since min/max return the second operand if either one is NaN
+static int32_t aggMinMaxDoubleAVX(const double* p, int32_t numOfRows, double* pMin, double* pMax) {
+  if (numOfRows < 4) {
+    return 0;
+  }
+
+  int32_t i = 0;
+  __m256d vmin = _mm256_set1_pd(*pMin);
+  __m256d vmax = _mm256_set1_pd(*pMax);
+  for (; i + 4 <= numOfRows; i += 4) {
+    __m256d x = _mm256_loadu_pd(p + i);
+    vmin = _mm256_min_pd(x, vmin);
+    vmax = _mm256_max_pd(x, vmax);
+  }
+
+  double t[4];
+  _mm256_storeu_pd(t, vmin);
+  for (int32_t k = 0; k < 4; ++k) *pMin = TMIN(*pMin, t[k]);
+  _mm256_storeu_pd(t, vmax);
+  for (int32_t k = 0; k < 4; ++k) *pMax = TMAX(*pMax, t[k]);
+  return i;
+}
+#endif
+
+#if __AVX512F__
+static int32_t aggSumI32AVX512(const int32_t* p, int32_t numOfRows, bool sign, int64_t* pSum, int64_t* pSquareSum) {
+  int32_t i = 0;
+  __m512i sum = _mm512_setzero_si512();
+  __m512i square = _mm512_setzero_si512();
+
+  for (; i + 8 <= numOfRows; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+    __m512i x = sign ? _mm512_cvtepi32_epi64(v) : _mm512_cvtepu32_epi64(v);
+    sum = _mm512_add_epi64(sum, x);
+    if (pSquareSum != NULL) {
+      square = _mm512_add_epi64(square, sign ? _mm512_mul_epi32(x, x) : _mm512_mul_epu32(x, x));
+    }
+  }
+
+  *pSum += _mm512_reduce_add_epi64(sum);
+  if (pSquareSum != NULL) {
+    *pSquareSum += _mm512_reduce_add_epi64(square);
+  }
+  return i;
+}
+
+static int32_t aggSumI64AVX512(const int64_t* p, int32_t numOfRows, int64_t* pSum, int64_t* pSquareSum) {
+  if (pSquareSum != NULL) {
+    return 0;
+  }
+
+  int32_t i = 0;
+  __m512i sum = _mm512_setzero_si512();
+  for (; i + 8 <= numOfRows; i += 8) {
+    sum = _mm512_add_epi64(sum, _mm512_loadu_si512((const void*)(p + i)));
+  }
+
+  *pSum += _mm512_reduce_add_epi64(sum);
+  return i;
+}
+
+static int32_t aggSumDoubleAVX512(const double* p, int32_t numOfRows, double* pSum, double* pSquareSum) {
+  int32_t i = 0;
+  __m512d sum = _mm512_setzero_pd();
+  __m512d square = _mm512_setzero_pd();
+
+  for (; i + 8 <= numOfRows; i += 8) {
+    __m512d x = _mm512_loadu_pd(p + i);
+    sum = _mm512_add_pd(sum, x);
+    if (pSquareSum != NULL) {
+      square = _mm512_add_pd(square, _mm512_mul_pd(x, x));
+    }
+  }
+
+  *pSum += _mm512_reduce_add_pd(sum);
+  if (pSquareSum != NULL) {
+    *pSquareSum += _mm512_reduce_add_pd(square);
+  }
+  return i;
+}
+#endif
+
+static void aggSumIntRun(int32_t type, const char* pData, int32_t numOfRows, int64_t* pSum, int64_t* pSquareSum) {
+  int32_t i = 0;
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT: {
+      bool sign = (type != TSDB_DATA_TYPE_UTINYINT);
+#if __AVX2__
+      if (tsSIMDEnable && tsAVX2Enable) {
+        i = aggSumI8AVX2((const int8_t*)pData, numOfRows, sign, pSum, pSquareSum);
+      }
+#endif
+      if (sign) {
+        AGG_SUM_SCALAR(int8_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      } else {
+        AGG_SUM_SCALAR(uint8_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      }
+      break;
+    }
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT: {
+      bool sign = (type == TSDB_DATA_TYPE_SMALLINT);
+#if __AVX2__
+      if (tsSIMDEnable && tsAVX2Enable) {
+        i = aggSumI16AVX2((const int16_t*)pData, numOfRows, sign, pSum, pSquareSum);
+      }
+#endif
+      if (sign) {
+        AGG_SUM_SCALAR(int16_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      } else {
+        AGG_SUM_SCALAR(uint16_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      }
+      break;
+    }
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT: {
+      bool sign = (type == TSDB_DATA_TYPE_INT);
+#if __AVX512F__
+      if (tsSIMDEnable && tsAVX512Enable) {
+        i = aggSumI32AVX512((const int32_t*)pData, numOfRows, sign, pSum, pSquareSum);
+      }
+#endif
+#if __AVX2__
+      if (i == 0 && tsSIMDEnable && tsAVX2Enable) {
+        i = aggSumI32AVX2((const int32_t*)pData, numOfRows, sign, pSum, pSquareSum);
+      }
+#endif
+      if (sign) {
+        AGG_SUM_SCALAR(int32_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      } else {
+        AGG_SUM_SCALAR(uint32_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      }
+      break;
+    }
+    default: {  // bigint, ubigint and timestamp
+#if __AVX512F__
+      if (tsSIMDEnable && tsAVX512Enable) {
+        i = aggSumI64AVX512((const int64_t*)pData, numOfRows, pSum, pSquareSum);
+      }
+#endif
+#if __AVX2__
+      if (i == 0 && tsSIMDEnable && tsAVX2Enable) {
+        i = aggSumI64AVX2((const int64_t*)pData, numOfRows, pSum, pSquareSum);
+      }
+#endif
+      AGG_SUM_SCALAR(uint64_t, uint64_t, pData, i, numOfRows, pSum, pSquareSum);
+      break;
+    }
+  }
+}
+
+static void aggSumDoubleRun(int32_t type, const char* pData, int32_t numOfRows, double* pSum, double* pSquareSum) {
+  int32_t i = 0;
+
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+#if __AVX__
+    if (tsSIMDEnable && tsAVXEnable) {
+      i = aggSumFloatAVX((const float*)pData, numOfRows, pSum, pSquareSum);
+    }
+#endif
+    const float* d = (const float*)pData;
+    for (; i < numOfRows; ++i) {
+      *pSum += d[i];
+      if (pSquareSum != NULL) *pSquareSum += (double)d[i] * d[i];
+    }
+  } else {
+#if __AVX512F__
+    if (tsSIMDEnable && tsAVX512Enable) {
+      i = aggSumDoubleAVX512((const double*)pData, numOfRows, pSum, pSquareSum);
+    }
+#endif
+#if __AVX__
+    if (i == 0 && tsSIMDEnable && tsAVXEnable) {
+      i = aggSumDoubleAVX((const double*)pData, numOfRows, pSum, pSquareSum);
+    }
+#endif
+    AGG_SUM_SCALAR(double, double, pData, i, numOfRows, pSum, pSquareSum);
+  }
+}
+
+static int32_t aggSumIntImpl(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum,
+                             int64_t* pSquareSum) {
+  int32_t type = pCol->info.type;
+  int32_t bytes = pCol->info.bytes;
+  int32_t end = start + numOfRows;
+  int32_t numOfElems = 0;
+
+  int32_t runEnd = 0;
+  for (int32_t i = start; aggNextRun(pCol, &i, end, &runEnd); i = runEnd) {
+    aggSumIntRun(type, pCol->pData + (int64_t)i * bytes, runEnd - i, pSum, pSquareSum);
+    numOfElems += runEnd - i;
+  }
+
+  return numOfElems;
+}
+
+static int32_t aggSumDoubleImpl(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum,
+                                double* pSquareSum) {
+  int32_t type = pCol->info.type;
+  int32_t bytes = pCol->info.bytes;
+  int32_t end = start + numOfRows;
+  int32_t numOfElems = 0;
+
+  int32_t runEnd = 0;
+  for (int32_t i = start; aggNextRun(pCol, &i, end, &runEnd); i = runEnd) {
+    aggSumDoubleRun(type, pCol->pData + (int64_t)i * bytes, runEnd - i, pSum, pSquareSum);
+    numOfElems += runEnd - i;
+  }
+
+  return numOfElems;
+}
+
+int32_t tAggSumInt(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum) {
+  return aggSumIntImpl(pCol, start, numOfRows, pSum, NULL);
+}
+
+int32_t tAggSumDouble(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum) {
+  return aggSumDoubleImpl(pCol, start, numOfRows, pSum, NULL);
+}
+
+int32_t tAggSumSquareInt(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, int64_t* pSum,
+                         int64_t* pSquareSum) {
+  return aggSumIntImpl(pCol, start, numOfRows, pSum, pSquareSum);
+}
+
+int32_t tAggSumSquareDouble(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pSum,
+                            double* pSquareSum) {
+  return aggSumDoubleImpl(pCol, start, numOfRows, pSum, pSquareSum);
+}
+
+static void aggMinMaxRun(int32_t type, const char* pData, int32_t numOfRows, double* pMin, double* pMax) {
+  int32_t i = 0;
+
+  switch (type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      AGG_MINMAX_SCALAR(int8_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      AGG_MINMAX_SCALAR(uint8_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      AGG_MINMAX_SCALAR(int16_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      AGG_MINMAX_SCALAR(uint16_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      AGG_MINMAX_SCALAR(int32_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      AGG_MINMAX_SCALAR(uint32_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      AGG_MINMAX_SCALAR(uint64_t, pData, i, numOfRows, pMin, pMax);
+      break;
+    case TSDB_DATA_TYPE_FLOAT: {
+      const float* d = (const float*)pData;
+      for (; i < numOfRows; ++i) {
+        if (d[i] < *pMin) *pMin = d[i];
+        if (d[i] > *pMax) *pMax = d[i];
+      }
+      break;
+    }
+    case TSDB_DATA_TYPE_DOUBLE: {
+#if __AVX__
+      if (tsSIMDEnable && tsAVXEnable) {
+        i = aggMinMaxDoubleAVX((const double*)pData, numOfRows, pMin, pMax);
+      }
+#endif
+      const double* d = (const double*)pData;
+      for (; i < numOfRows; ++i) {
+        if (d[i] < *pMin) *pMin = d[i];
+        if (d[i] > *pMax) *pMax = d[i];
+      }
+      break;
+    }
+    default:  // bigint and timestamp
+      AGG_MINMAX_SCALAR(int64_t, pData, i, numOfRows, pMin, pMax);
+      break;
+  }
+}
+
+int32_t tAggMinMaxDouble(const SColumnInfoData* pCol, int32_t start, int32_t numOfRows, double* pMin, double* pMax) {
+  int32_t type = pCol->info.type;
+  int32_t bytes = pCol->info.bytes;
+  int32_t end = start + numOfRows;
+  int32_t numOfElems = 0;
+
+  int32_t runEnd = 0;
+  for (int32_t i = start; aggNextRun(pCol, &i, end, &runEnd); i = runEnd) {
+    aggMinMaxRun(type, pCol->pData + (int64_t)i * bytes, runEnd - i, pMin, pMax);
+    numOfElems += runEnd - i;
+  }
+
+  return numOfElems;
+}
@@ -574,7 +574,7 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
 
         // 1. If the CPU supports AVX, let's employ AVX instructions to speedup this loop
         if (simdAvailable) {
-          i8VectorSumAVX2(plist, numOfRows, type, pAvgRes);
+          i8VectorSumAVX2(plist + start, numOfRows, type, pAvgRes);
         } else {
           for (int32_t i = pInput->startRowIndex; i < pInput->numOfRows + pInput->startRowIndex; ++i) {
             if (type == TSDB_DATA_TYPE_TINYINT) {
@@ -593,7 +593,7 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
 
         // 1. If the CPU supports AVX, let's employ AVX instructions to speedup this loop
         if (simdAvailable) {
-          i16VectorSumAVX2(plist, numOfRows, type, pAvgRes);
+          i16VectorSumAVX2(plist + start, numOfRows, type, pAvgRes);
         } else {
           for (int32_t i = pInput->startRowIndex; i < pInput->numOfRows + pInput->startRowIndex; ++i) {
             if (type == TSDB_DATA_TYPE_SMALLINT) {
@@ -612,7 +612,7 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
 
         // 1. If the CPU supports AVX, let's employ AVX instructions to speedup this loop
         if (simdAvailable) {
-          i32VectorSumAVX2(plist, numOfRows, type, pAvgRes);
+          i32VectorSumAVX2(plist + start, numOfRows, type, pAvgRes);
         } else {
           for (int32_t i = pInput->startRowIndex; i < pInput->numOfRows + pInput->startRowIndex; ++i) {
             if (type == TSDB_DATA_TYPE_INT) {
@@ -631,7 +631,7 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
 
         // 1. If the CPU supports AVX, let's employ AVX instructions to speedup this loop
         if (simdAvailable && type == TSDB_DATA_TYPE_BIGINT) {
-          i64VectorSumAVX2(plist, numOfRows, pAvgRes);
+          i64VectorSumAVX2(plist + start, numOfRows, pAvgRes);
         } else {
           for (int32_t i = pInput->startRowIndex; i < pInput->numOfRows + pInput->startRowIndex; ++i) {
             if (type == TSDB_DATA_TYPE_BIGINT) {
@@ -649,7 +649,7 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
 
         // 1. If the CPU supports AVX, let's employ AVX instructions to speedup this loop
         if (simdAvailable) {
-          floatVectorSumAVX(plist, numOfRows, pAvgRes);
+          floatVectorSumAVX(plist + start, numOfRows, pAvgRes);
         } else {
           for (int32_t i = pInput->startRowIndex; i < pInput->numOfRows + pInput->startRowIndex; ++i) {
             pAvgRes->sum.dsum += plist[i];
@@ -662,7 +662,7 @@ int32_t avgFunction(SqlFunctionCtx* pCtx) {
 
         // 1. If the CPU supports AVX, let's employ AVX instructions to speedup this loop
         if (simdAvailable) {
-          doubleVectorSumAVX(plist, numOfRows, pAvgRes);
+          doubleVectorSumAVX(plist + start, numOfRows, pAvgRes);
         } else {
           for (int32_t i = pInput->startRowIndex; i < pInput->numOfRows + pInput->startRowIndex; ++i) {
             pAvgRes->sum.dsum += plist[i];
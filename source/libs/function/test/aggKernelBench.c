@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// micro-benchmark of the aggregation kernels, scalar vs. simd, usage: aggKernelBench [rows] [loops]
+
+#include "os.h"
+#include "taggkernel.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+
+typedef struct {
+  int32_t     type;
+  int32_t     bytes;
+  const char* name;
+} SBenchType;
+
+static SBenchType benchTypes[] = {
+    {TSDB_DATA_TYPE_TINYINT, 1, "tinyint"},  {TSDB_DATA_TYPE_SMALLINT, 2, "smallint"},
+    {TSDB_DATA_TYPE_INT, 4, "int"},          {TSDB_DATA_TYPE_BIGINT, 8, "bigint"},
+    {TSDB_DATA_TYPE_FLOAT, 4, "float"},      {TSDB_DATA_TYPE_DOUBLE, 8, "double"},
+};
+
+static void initColumn(SColumnInfoData* pCol, SBenchType* pType, int32_t numOfRows, int32_t nullRatio) {
+  memset(pCol, 0, sizeof(SColumnInfoData));
+  pCol->info.type = pType->type;
+  pCol->info.bytes = pType->bytes;
+  pCol->pData = taosMemoryCalloc(numOfRows, pType->bytes);
+  pCol->nullbitmap = taosMemoryCalloc(BitmapLen(numOfRows), 1);
+  pCol->hasNull = (nullRatio > 0);
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int32_t v = taosRand() % 100 - 50;
+    switch (pType->type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        ((int8_t*)pCol->pData)[i] = v;
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        ((int16_t*)pCol->pData)[i] = v;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        ((int32_t*)pCol->pData)[i] = v;
+        break;
+      case TSDB_DATA_TYPE_BIGINT:
+        ((int64_t*)pCol->pData)[i] = v;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        ((float*)pCol->pData)[i] = v * 0.5f;
+        break;
+      default:
+        ((double*)pCol->pData)[i] = v * 0.5;
+        break;
+    }
+
+    if (nullRatio > 0 && taosRand() % 100 < nullRatio) {
+      colDataSetNull_f(pCol->nullbitmap, i);
+    }
+  }
+}
+
+typedef struct {
+  int64_t isum;
+  int64_t isquare;
+  double  dsum;
+  double  dsquare;
+  double  dmin;
+  double  dmax;
+} SBenchResult;
+
+static double runKernel(const char* func, SColumnInfoData* pCol, int32_t numOfRows, int32_t loops,
+                        SBenchResult* pRes) {
+  bool isFloat = IS_FLOAT_TYPE(pCol->info.type);
+
+  memset(pRes, 0, sizeof(SBenchResult));
+  pRes->dmin = DBL_MAX;
+  pRes->dmax = -DBL_MAX;
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t l = 0; l < loops; ++l) {
+    if (strcmp(func, "count") == 0) {
+      pRes->isum += tAggCountNotNull(pCol, 0, numOfRows);
+    } else if (strcmp(func, "sum") == 0 && isFloat) {
+      (void)tAggSumDouble(pCol, 0, numOfRows, &pRes->dsum);
+    } else if (strcmp(func, "sum") == 0) {
+      (void)tAggSumInt(pCol, 0, numOfRows, &pRes->isum);
+    } else if (strcmp(func, "stddev") == 0 && isFloat) {
+      (void)tAggSumSquareDouble(pCol, 0, numOfRows, &pRes->dsum, &pRes->dsquare);
+    } else if (strcmp(func, "stddev") == 0) {
+      (void)tAggSumSquareInt(pCol, 0, numOfRows, &pRes->isum, &pRes->isquare);
+    } else {
+      (void)tAggMinMaxDouble(pCol, 0, numOfRows, &pRes->dmin, &pRes->dmax);
+    }
+  }
+  int64_t elapsed = TMAX(taosGetTimestampUs() - st, 1);
+
+  return (double)numOfRows * pCol->info.bytes * loops / elapsed / 1000.0;
+}
+
+// float sums are accumulated in another order by the simd kernels, so they are only close
+static bool sameResult(const SBenchResult* r1, const SBenchResult* r2) {
+  double eps = 1e-9 * TMAX(fabs(r1->dsum), 1);
+  double eps2 = 1e-9 * TMAX(fabs(r1->dsquare), 1);
+  return r1->isum == r2->isum && r1->isquare == r2->isquare && fabs(r1->dsum - r2->dsum) <= eps &&
+         fabs(r1->dsquare - r2->dsquare) <= eps2 && r1->dmin == r2->dmin && r1->dmax == r2->dmax;
+}
+
+int main(int argc, char* argv[]) {
+  int32_t numOfRows = (argc > 1) ? atoi(argv[1]) : 1000000;
+  int32_t loops = (argc > 2) ? atoi(argv[2]) : 100;
+
+  (void)taosGetCpuInstructions(&tsSSE42Enable, &tsAVXEnable, &tsAVX2Enable, &tsFMAEnable, &tsAVX512Enable);
+  printf("rows:%d loops:%d avx:%d avx2:%d avx512:%d\n", numOfRows, loops, tsAVXEnable, tsAVX2Enable, tsAVX512Enable);
+  printf("%-8s %-10s %-6s %12s %12s %8s\n", "func", "type", "null%", "scalar GB/s", "simd GB/s", "result");
+
+  const char* funcs[] = {"count", "sum", "stddev", "spread"};
+  int32_t     nullRatios[] = {0, 10};
+  int32_t     numOfMismatch = 0;
+
+  for (int32_t t = 0; t < tListLen(benchTypes); ++t) {
+    for (int32_t n = 0; n < tListLen(nullRatios); ++n) {
+      SColumnInfoData col = {0};
+      initColumn(&col, &benchTypes[t], numOfRows, nullRatios[n]);
+
+      for (int32_t f = 0; f < tListLen(funcs); ++f) {
+        SBenchResult scalarRes, simdRes;
+        tsSIMDEnable = 0;
+        double scalar = runKernel(funcs[f], &col, numOfRows, loops, &scalarRes);
+        tsSIMDEnable = 1;
+        double simd = runKernel(funcs[f], &col, numOfRows, loops, &simdRes);
+        bool   same = sameResult(&scalarRes, &simdRes);
+        numOfMismatch += !same;
+        printf("%-8s %-10s %-6d %12.2f %12.2f %8s\n", funcs[f], benchTypes[t].name, nullRatios[n], scalar, simd,
+               same ? "ok" : "MISMATCH");
+      }
+
+      taosMemoryFree(col.pData);
+      taosMemoryFree(col.nullbitmap);
+    }
+  }
+
+  return numOfMismatch > 0 ? 1 : 0;
+}
@@ -0,0 +1,290 @@
+#include <gtest/gtest.h>
+#include <float.h>
+#include <vector>
+
+#include "os.h"
+#include "taggkernel.h"
+#include "tdatablock.h"
+
+namespace {
+
+enum { NULL_NONE, NULL_SOME, NULL_ALL, NULL_RUNS };
+enum { VAL_SMALL, VAL_EXTREME };
+
+typedef struct {
+  int32_t type;
+  int32_t bytes;
+  bool    sign;
+} STestType;
+
+const STestType kIntTypes[] = {
+    {TSDB_DATA_TYPE_TINYINT, 1, true},  {TSDB_DATA_TYPE_UTINYINT, 1, false}, {TSDB_DATA_TYPE_SMALLINT, 2, true},
+    {TSDB_DATA_TYPE_USMALLINT, 2, false}, {TSDB_DATA_TYPE_INT, 4, true},    {TSDB_DATA_TYPE_UINT, 4, false},
+    {TSDB_DATA_TYPE_BIGINT, 8, true},   {TSDB_DATA_TYPE_UBIGINT, 8, false},  {TSDB_DATA_TYPE_TIMESTAMP, 8, true},
+};
+
+const STestType kFloatTypes[] = {{TSDB_DATA_TYPE_FLOAT, 4, true}, {TSDB_DATA_TYPE_DOUBLE, 8, true}};
+
+// odd lengths and starts off the bitmap byte, so that both the vector loops and their tails are hit
+const int32_t kRanges[][2] = {{0, 1}, {0, 7}, {0, 64}, {3, 61}, {5, 1}, {7, 17}, {1, 255}, {13, 987}, {0, 1000}};
+
+class AggColumn {
+ public:
+  AggColumn(const STestType *pType, int32_t numOfRows, int32_t nullMode, int32_t valMode, uint32_t seed) {
+    memset(&col, 0, sizeof(col));
+    col.info.type = pType->type;
+    col.info.bytes = pType->bytes;
+    col.pData = (char *)taosMemoryCalloc(numOfRows, pType->bytes);
+    col.nullbitmap = (char *)taosMemoryCalloc(BitmapLen(numOfRows), 1);
+    col.hasNull = (nullMode != NULL_NONE);
+
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      seed = seed * 1103515245 + 12345;
+      setValue(i, pType->sign, valMode, seed >> 8);
+
+      bool isNull = false;
+      if (nullMode == NULL_SOME) {
+        isNull = ((seed >> 16) % 10 == 0);
+      } else if (nullMode == NULL_ALL) {
+        isNull = true;
+      } else if (nullMode == NULL_RUNS) {
+        isNull = (i / 11) % 3 == 0;
+      }
+      if (isNull) {
+        colDataSetNull_f(col.nullbitmap, i);
+      }
+    }
+  }
+
+  ~AggColumn() {
+    taosMemoryFree(col.pData);
+    taosMemoryFree(col.nullbitmap);
+  }
+
+  bool isNull(int32_t i) const { return col.hasNull && colDataIsNull_f(col.nullbitmap, i); }
+
+  // the value as the scalar loop sees it, integers are sign or zero extended to 64 bits
+  uint64_t intAt(int32_t i) const {
+    const char *p = col.pData + (int64_t)i * col.info.bytes;
+    switch (col.info.type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        return (uint64_t)(int64_t)(*(int8_t *)p);
+      case TSDB_DATA_TYPE_UTINYINT:
+        return *(uint8_t *)p;
+      case TSDB_DATA_TYPE_SMALLINT:
+        return (uint64_t)(int64_t)(*(int16_t *)p);
+      case TSDB_DATA_TYPE_USMALLINT:
+        return *(uint16_t *)p;
+      case TSDB_DATA_TYPE_INT:
+        return (uint64_t)(int64_t)(*(int32_t *)p);
+      case TSDB_DATA_TYPE_UINT:
+        return *(uint32_t *)p;
+      default:
+        return *(uint64_t *)p;
+    }
+  }
+
+  double doubleAt(int32_t i) const {
+    const char *p = col.pData + (int64_t)i * col.info.bytes;
+    switch (col.info.type) {
+      case TSDB_DATA_TYPE_FLOAT:
+        return *(float *)p;
+      case TSDB_DATA_TYPE_DOUBLE:
+        return *(double *)p;
+      case TSDB_DATA_TYPE_UBIGINT:
+      case TSDB_DATA_TYPE_UTINYINT:
+      case TSDB_DATA_TYPE_USMALLINT:
+      case TSDB_DATA_TYPE_UINT:
+        return (double)intAt(i);
+      default:
+        return (double)(int64_t)intAt(i);
+    }
+  }
+
+  SColumnInfoData col;
+
+ private:
+  // small values are within [-100, 100), or [0, 200) for unsigned types, and the extreme ones are close to the min
+  // or max of the type
+  void setValue(int32_t i, bool sign, int32_t valMode, uint32_t r) {
+    char   *p = col.pData + (int64_t)i * col.info.bytes;
+    int32_t nbits = col.info.bytes * 8;
+    int64_t delta = r % 100;
+
+    if (IS_FLOAT_TYPE(col.info.type)) {
+      double v = (double)delta - 50;
+      if (valMode == VAL_EXTREME) {
+        v = ((r >> 8) & 1 ? 1 : -1) * (col.info.type == TSDB_DATA_TYPE_FLOAT ? FLT_MAX : 1e150) / (delta + 1);
+      }
+      if (col.info.type == TSDB_DATA_TYPE_FLOAT) {
+        *(float *)p = (float)v;
+      } else {
+        *(double *)p = v;
+      }
+      return;
+    }
+
+    uint64_t v = 0;
+    if (valMode == VAL_SMALL) {
+      v = sign ? (uint64_t)(delta * 2 - 100) : (uint64_t)(delta * 2);
+    } else if (!sign) {
+      v = (nbits == 64 ? UINT64_MAX : (1ULL << nbits) - 1) - delta;
+    } else if ((r >> 8) & 1) {
+      v = (uint64_t)(((nbits == 64) ? INT64_MAX : (int64_t)((1ULL << (nbits - 1)) - 1)) - delta);
+    } else {
+      v = (uint64_t)(((nbits == 64) ? INT64_MIN : -(int64_t)(1ULL << (nbits - 1))) + delta);
+    }
+    memcpy(p, &v, col.info.bytes);  // the low bytes on little endian
+  }
+};
+
+typedef struct {
+  int32_t count;
+  int64_t sum;
+  int64_t square;
+  double  dsum;
+  double  dsquare;
+  double  dabs;
+  double  min;
+  double  max;
+  int32_t numOfMinMax;
+} SAggResult;
+
+// the row by row reference, integer sums wrap around in 64 bits as the kernels do
+SAggResult aggReference(const AggColumn &c, int32_t start, int32_t numOfRows) {
+  SAggResult r = {0};
+  uint64_t   sum = 0, square = 0;
+  r.min = DBL_MAX;
+  r.max = -DBL_MAX;
+  for (int32_t i = start; i < start + numOfRows; ++i) {
+    if (c.isNull(i)) continue;
+    r.count++;
+    sum += c.intAt(i);
+    square += c.intAt(i) * c.intAt(i);
+    double d = c.doubleAt(i);
+    r.dsum += d;
+    r.dsquare += d * d;
+    r.dabs += fabs(d);
+    r.min = TMIN(r.min, d);
+    r.max = TMAX(r.max, d);
+  }
+  r.sum = (int64_t)sum;
+  r.square = (int64_t)square;
+  r.numOfMinMax = r.count;
+  return r;
+}
+
+SAggResult aggKernels(const AggColumn &c, int32_t start, int32_t numOfRows, bool simd) {
+  char       simdEnable = tsSIMDEnable;
+  SAggResult r = {0};
+  r.min = DBL_MAX;
+  r.max = -DBL_MAX;
+
+  tsSIMDEnable = simd;
+  r.count = tAggCountNotNull(&c.col, start, numOfRows);
+  if (IS_FLOAT_TYPE(c.col.info.type)) {
+    double dsum = 0;
+    EXPECT_EQ(tAggSumDouble(&c.col, start, numOfRows, &dsum), r.count);
+    EXPECT_EQ(tAggSumSquareDouble(&c.col, start, numOfRows, &r.dsum, &r.dsquare), r.count);
+    EXPECT_DOUBLE_EQ(dsum, r.dsum);
+  } else {
+    int64_t sum = 0;
+    EXPECT_EQ(tAggSumInt(&c.col, start, numOfRows, &sum), r.count);
+    EXPECT_EQ(tAggSumSquareInt(&c.col, start, numOfRows, &r.sum, &r.square), r.count);
+    EXPECT_EQ(sum, r.sum);
+  }
+  r.numOfMinMax = tAggMinMaxDouble(&c.col, start, numOfRows, &r.min, &r.max);
+  tsSIMDEnable = simdEnable;
+  return r;
+}
+
+// the error of a sum in another order is bounded by the sum of the magnitudes
+void expectNear(double expect, double actual, double magnitude) {
+  EXPECT_NEAR(expect, actual, magnitude * 1e-12);
+}
+
+void checkColumn(const STestType *pType, int32_t nullMode, int32_t valMode) {
+  AggColumn c(pType, 1000, nullMode, valMode, (uint32_t)(pType->type * 31 + nullMode * 7 + valMode));
+
+  for (int32_t k = 0; k < (int32_t)tListLen(kRanges); ++k) {
+    int32_t start = kRanges[k][0], numOfRows = kRanges[k][1];
+    SCOPED_TRACE(testing::Message() << "type:" << pType->type << " null:" << nullMode << " val:" << valMode
+                                    << " start:" << start << " rows:" << numOfRows);
+
+    SAggResult ref = aggReference(c, start, numOfRows);
+    SAggResult scalar = aggKernels(c, start, numOfRows, false);
+    SAggResult simd = aggKernels(c, start, numOfRows, true);
+
+    EXPECT_EQ(ref.count, scalar.count);
+    EXPECT_EQ(ref.count, simd.count);
+    EXPECT_EQ(ref.numOfMinMax, scalar.numOfMinMax);
+    EXPECT_EQ(ref.numOfMinMax, simd.numOfMinMax);
+    EXPECT_EQ(ref.min, scalar.min);
+    EXPECT_EQ(ref.min, simd.min);
+    EXPECT_EQ(ref.max, scalar.max);
+    EXPECT_EQ(ref.max, simd.max);
+
+    if (IS_FLOAT_TYPE(pType->type)) {
+      // float sums are accumulated in another order by the vector kernels
+      expectNear(ref.dsum, scalar.dsum, ref.dabs);
+      expectNear(ref.dsum, simd.dsum, ref.dabs);
+      expectNear(ref.dsquare, scalar.dsquare, ref.dsquare);
+      expectNear(ref.dsquare, simd.dsquare, ref.dsquare);
+    } else {
+      EXPECT_EQ(ref.sum, scalar.sum);
+      EXPECT_EQ(ref.sum, simd.sum);
+      EXPECT_EQ(ref.square, scalar.square);
+      EXPECT_EQ(ref.square, simd.square);
+    }
+  }
+}
+
+class AggKernelTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    (void)taosGetCpuInstructions(&tsSSE42Enable, &tsAVXEnable, &tsAVX2Enable, &tsFMAEnable, &tsAVX512Enable);
+  }
+};
+
+}  // namespace
+
+TEST_F(AggKernelTest, int_types) {
+  for (int32_t t = 0; t < (int32_t)tListLen(kIntTypes); ++t) {
+    for (int32_t nullMode = NULL_NONE; nullMode <= NULL_RUNS; ++nullMode) {
+      checkColumn(&kIntTypes[t], nullMode, VAL_SMALL);
+    }
+  }
+}
+
+// sums and squares of values close to the min or max of each type overflow and wrap around
+TEST_F(AggKernelTest, int_overflow) {
+  for (int32_t t = 0; t < (int32_t)tListLen(kIntTypes); ++t) {
+    for (int32_t nullMode = NULL_NONE; nullMode <= NULL_RUNS; ++nullMode) {
+      checkColumn(&kIntTypes[t], nullMode, VAL_EXTREME);
+    }
+  }
+}
+
+TEST_F(AggKernelTest, float_types) {
+  for (int32_t t = 0; t < (int32_t)tListLen(kFloatTypes); ++t) {
+    for (int32_t nullMode = NULL_NONE; nullMode <= NULL_RUNS; ++nullMode) {
+      checkColumn(&kFloatTypes[t], nullMode, VAL_SMALL);
+      checkColumn(&kFloatTypes[t], nullMode, VAL_EXTREME);
+    }
+  }
+}
+
+TEST_F(AggKernelTest, all_null) {
+  STestType type = {TSDB_DATA_TYPE_INT, 4, true};
+  AggColumn c(&type, 100, NULL_ALL, VAL_SMALL, 1);
+
+  int64_t sum = 0, square = 0;
+  double  min = DBL_MAX, max = -DBL_MAX;
+  ASSERT_EQ(tAggCountNotNull(&c.col, 0, 100), 0);
+  ASSERT_EQ(tAggSumSquareInt(&c.col, 3, 97, &sum, &square), 0);
+  ASSERT_EQ(tAggMinMaxDouble(&c.col, 0, 100, &min, &max), 0);
+  ASSERT_EQ(sum, 0);
+  ASSERT_EQ(square, 0);
+  ASSERT_EQ(min, DBL_MAX);
+  ASSERT_EQ(max, -DBL_MAX);
+}
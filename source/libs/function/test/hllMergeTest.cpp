@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "builtinsimpl.h"
+#include "tdatablock.h"
+#include "tglobal.h"
+
+namespace {
+
+// the SHLLInfo of builtinsimpl.c
+typedef struct {
+  uint64_t result;
+  uint64_t totalCount;
+  uint8_t  buckets[];
+} SHLLTestInfo;
+
+class HllCtx {
+ public:
+  HllCtx() {
+    memset(&ctx, 0, sizeof(ctx));
+    memset(&expr, 0, sizeof(expr));
+    pResInfo = (SResultRowEntryInfo *)taosMemoryCalloc(1, sizeof(SResultRowEntryInfo) + getHLLInfoSize());
+    ctx.resultInfo = pResInfo;
+    ctx.pExpr = &expr;
+  }
+
+  ~HllCtx() { taosMemoryFree(pResInfo); }
+
+  void add(const std::vector<int64_t> &values) {
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), 1);
+    ASSERT_EQ(colInfoDataEnsureCapacity(&col, values.size(), true), 0);
+    for (int32_t i = 0; i < (int32_t)values.size(); ++i) {
+      colDataSetInt64(&col, i, (int64_t *)&values[i]);
+    }
+    ASSERT_EQ(process(&col, values.size(), hllFunction), 0);
+    colDataDestroy(&col);
+  }
+
+  // the partial result as it is sent to the merge node
+  std::string partial() {
+    SSDataBlock    *pBlock = createDataBlock();
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BINARY, getHLLInfoSize() + VARSTR_HEADER_SIZE, 1);
+    blockDataAppendColInfo(pBlock, &col);
+    blockDataEnsureCapacity(pBlock, 1);
+
+    hllPartialFinalize(&ctx, pBlock);
+    char       *data = colDataGetData((SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0), 0);
+    std::string res(data, varDataTLen(data));
+    blockDataDestroy(pBlock);
+    return res;
+  }
+
+  int32_t merge(const std::vector<std::string> &partials) {
+    SColumnInfoData col = createColumnInfoData(TSDB_DATA_TYPE_BINARY, getHLLInfoSize() + VARSTR_HEADER_SIZE, 1);
+    EXPECT_EQ(colInfoDataEnsureCapacity(&col, partials.size(), true), 0);
+    for (int32_t i = 0; i < (int32_t)partials.size(); ++i) {
+      colDataSetVal(&col, i, partials[i].data(), false);
+    }
+    int32_t code = process(&col, partials.size(), hllFunctionMerge);
+    colDataDestroy(&col);
+    return code;
+  }
+
+  SHLLTestInfo *info() { return (SHLLTestInfo *)GET_ROWCELL_INTERBUF(pResInfo); }
+
+  bool sameAs(HllCtx &other) {
+    return info()->totalCount == other.info()->totalCount &&
+           memcmp(info()->buckets, other.info()->buckets, getHLLInfoSize() - sizeof(SHLLTestInfo)) == 0;
+  }
+
+ private:
+  int32_t process(SColumnInfoData *pCol, int32_t numOfRows, int32_t (*fp)(SqlFunctionCtx *)) {
+    SColumnInfoData *pData[1] = {pCol};
+    ctx.input.pData = pData;
+    ctx.input.numOfInputCols = 1;
+    ctx.input.startRowIndex = 0;
+    ctx.input.numOfRows = numOfRows;
+    ctx.input.totalRows = numOfRows;
+    int32_t code = fp(&ctx);
+    ctx.input.pData = NULL;
+    return code;
+  }
+
+  SqlFunctionCtx       ctx;
+  SExprInfo            expr;
+  SResultRowEntryInfo *pResInfo;
+};
+
+std::vector<int64_t> makeValues(int64_t start, int32_t num) {
+  std::vector<int64_t> values;
+  for (int32_t i = 0; i < num; ++i) values.push_back(start + i * 7);
+  return values;
+}
+
+class HllMergeTest : public ::testing::Test {
+ protected:
+  void SetUp() override { sparse = tsQueryHllSparse; }
+  void TearDown() override { tsQueryHllSparse = sparse; }
+
+  bool sparse = false;
+};
+
+}  // namespace
+
+TEST_F(HllMergeTest, dense_on_wire_by_default) {
+  tsQueryHllSparse = false;
+
+  HllCtx few;
+  few.add(makeValues(0, 10));
+  std::string partial = few.partial();
+  ASSERT_EQ(varDataLen(partial.data()), getHLLInfoSize());
+
+  HllCtx merged;
+  ASSERT_EQ(merged.merge({partial}), 0);
+  ASSERT_TRUE(merged.sameAs(few));
+}
+
+TEST_F(HllMergeTest, sparse_and_dense) {
+  tsQueryHllSparse = true;
+
+  std::vector<int64_t> fewValues = makeValues(0, 100);
+  std::vector<int64_t> manyValues = makeValues(1000000, 100000);
+
+  HllCtx few, many;
+  few.add(fewValues);
+  many.add(manyValues);
+  std::string sparsePartial = few.partial();
+  std::string densePartial = many.partial();
+  ASSERT_LT(varDataLen(sparsePartial.data()), getHLLInfoSize());
+  ASSERT_EQ(varDataLen(densePartial.data()), getHLLInfoSize());
+
+  // the same as hashing all the values on one node, in either order
+  HllCtx all;
+  all.add(fewValues);
+  all.add(manyValues);
+
+  HllCtx merged1, merged2;
+  ASSERT_EQ(merged1.merge({sparsePartial, densePartial}), 0);
+  ASSERT_EQ(merged2.merge({densePartial, sparsePartial}), 0);
+  ASSERT_TRUE(merged1.sameAs(all));
+  ASSERT_TRUE(merged2.sameAs(all));
+}
+
+TEST_F(HllMergeTest, sparse_and_sparse) {
+  tsQueryHllSparse = true;
+
+  std::vector<int64_t> values1 = makeValues(0, 200);
+  std::vector<int64_t> values2 = makeValues(100, 300);  // overlaps values1
+
+  HllCtx ctx1, ctx2, empty;
+  ctx1.add(values1);
+  ctx2.add(values2);
+  std::vector<std::string> partials = {ctx1.partial(), ctx2.partial(), empty.partial()};
+  for (auto &partial : partials) {
+    ASSERT_LT(varDataLen(partial.data()), getHLLInfoSize());
+  }
+
+  HllCtx all;
+  all.add(values1);
+  all.add(values2);
+
+  HllCtx merged;
+  ASSERT_EQ(merged.merge(partials), 0);
+  ASSERT_TRUE(merged.sameAs(all));
+}
+
+TEST_F(HllMergeTest, invalid_partial) {
+  tsQueryHllSparse = true;
+
+  HllCtx few;
+  few.add(makeValues(0, 10));
+  std::string partial = few.partial();
+
+  // the length does not match the number of buckets
+  std::string truncated = partial.substr(0, partial.size() - 1);
+  varDataSetLen(&truncated[0], varDataLen(truncated.data()) - 1);
+
+  HllCtx merged;
+  ASSERT_NE(merged.merge({truncated}), 0);
+}
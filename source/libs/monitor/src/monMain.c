@@ -398,12 +398,32 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "req_insert_batch", pStat->numOfBatchInsertReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_success", pStat->numOfBatchInsertSuccessReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_rate", req_insert_batch_rate);
+  tjsonAddDoubleToObject(pJson, "wal_groups", pStat->numOfWalGroups);
+  tjsonAddDoubleToObject(pJson, "wal_group_entries", pStat->numOfWalGroupEntries);
+  tjsonAddDoubleToObject(pJson, "sync_repl_msgs", pStat->numOfSyncReplMsgs);
+  tjsonAddDoubleToObject(pJson, "sync_repl_entries", pStat->numOfSyncReplEntries);
+  tjsonAddDoubleToObject(pJson, "sync_repl_entries_per_msg",
+                         pStat->numOfSyncReplMsgs > 0 ? (double)pStat->numOfSyncReplEntries / pStat->numOfSyncReplMsgs : 0);
+  tjsonAddDoubleToObject(pJson, "sync_repl_lag", pStat->syncReplLag);
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
   tjsonAddDoubleToObject(pJson, "has_mnode", pInfo->has_mnode);
   tjsonAddDoubleToObject(pJson, "has_qnode", pInfo->has_qnode);
   tjsonAddDoubleToObject(pJson, "has_snode", pInfo->has_snode);
+
+  // bucket i counts the wal fsync groups of [2^i, 2^(i+1)) entries
+  SJson *pHistJson = tjsonAddArrayToObject(pJson, "wal_group_size_hist");
+  if (pHistJson == NULL) return;
+
+  for (int32_t i = 0; i < TSDB_WAL_GROUP_HIST_SIZE; ++i) {
+    SJson *pBucketJson = tjsonCreateObject();
+    if (pBucketJson == NULL) continue;
+
+    tjsonAddDoubleToObject(pBucketJson, "min_entries", (double)(1 << i));
+    tjsonAddDoubleToObject(pBucketJson, "groups", pStat->walGroupHist[i]);
+    if (tjsonAddItemToArray(pHistJson, pBucketJson) != 0) tjsonDelete(pBucketJson);
+  }
 }
 
 static void monGenDiskJson(SMonInfo *pMonitor) {
@@ -2170,6 +2170,9 @@ static int32_t physiTableScanNodeInlineToMsg(const void* pObj, STlvEncoder* pEnc
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeValueBool(pEncoder, pNode->filesetDelimited);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeValueBool(pEncoder, pNode->unorderedScan);
+  }
   return code;
 }
 
@@ -2251,6 +2254,9 @@ static int32_t msgToPhysiTableScanNodeInline(STlvDecoder* pDecoder, void* pObj)
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvDecodeValueBool(pDecoder, &pNode->filesetDelimited);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvDecodeValueBool(pDecoder, &pNode->unorderedScan);
+  }
 
   return code;
 }
@@ -2562,7 +2568,8 @@ enum {
   PHY_AGG_CODE_GROUP_KEYS,
   PHY_AGG_CODE_AGG_FUNCS,
   PHY_AGG_CODE_MERGE_DATA_BLOCK,
-  PHY_AGG_CODE_GROUP_KEY_OPTIMIZE
+  PHY_AGG_CODE_GROUP_KEY_OPTIMIZE,
+  PHY_AGG_CODE_PARTIAL_AGG
 };
 
 static int32_t physiAggNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
@@ -2584,6 +2591,9 @@ static int32_t physiAggNodeToMsg(const void* pObj, STlvEncoder* pEncoder) {
   if (TSDB_CODE_SUCCESS == code) {
     code = tlvEncodeBool(pEncoder, PHY_AGG_CODE_GROUP_KEY_OPTIMIZE, pNode->groupKeyOptimized);
   }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = tlvEncodeBool(pEncoder, PHY_AGG_CODE_PARTIAL_AGG, pNode->isPartialAgg);
+  }
 
   return code;
 }
@@ -2613,6 +2623,9 @@ static int32_t msgToPhysiAggNode(STlvDecoder* pDecoder, void* pObj) {
       case PHY_AGG_CODE_GROUP_KEY_OPTIMIZE:
         code = tlvDecodeBool(pTlv, &pNode->groupKeyOptimized);
         break;
+      case PHY_AGG_CODE_PARTIAL_AGG:
+        code = tlvDecodeBool(pTlv, &pNode->isPartialAgg);
+        break;
       default:
         break;
     }
@@ -997,10 +997,14 @@ static int32_t stbSplSplitAggNodeForCrossTable(SSplitContext* pCxt, SStableSplit
 
   if (TSDB_CODE_SUCCESS == code) {
     // if slimit was pushed down to agg, agg will be pipelined mode, add sort merge before parent agg
-    if (pInfo->pSplitNode->forceCreateNonBlockingOptr)
+    if (pInfo->pSplitNode->forceCreateNonBlockingOptr) {
       code = stbSplAggNodeCreateMerge(pCxt, pInfo, pPartAgg);
-    else
+    } else {
+      // the parent agg merges the results of the same group from all vnodes, so the part agg may output a group
+      // more than once
+      ((SAggLogicNode*)pPartAgg)->isPartialAgg = true;
       code = stbSplCreateExchangeNode(pCxt, pInfo->pSplitNode, pPartAgg);
+    }
   } else {
     nodesDestroyNode((SNode*)pPartAgg);
   }
@@ -342,10 +342,15 @@ int32_t qwGetQueryResFromSink(QW_FPARAMS_DEF, SQWTaskCtx *ctx, int32_t *dataLen,
 
     *dataLen += len;
 
-    QW_ERR_RET(qwMallocFetchRsp(!ctx->localExec, *dataLen, &rsp));
+    if (NULL == rsp && !ctx->localExec) {
+      // the first block is already encoded in a rpc message by the sink, take it over as the response
+      code = dsGetDataMsg(ctx->sinkHandle, len, &output, (void **)&rsp);
+    } else {
+      QW_ERR_RET(qwMallocFetchRsp(!ctx->localExec, *dataLen, &rsp));
 
-    output.pData = rsp->data + *dataLen - len;
-    code = dsGetDataBlock(ctx->sinkHandle, &output);
+      output.pData = rsp->data + *dataLen - len;
+      code = dsGetDataBlock(ctx->sinkHandle, &output);
+    }
     if (code) {
       QW_TASK_ELOG("dsGetDataBlock failed, code:%x - %s", code, tstrerror(code));
       QW_ERR_RET(code);
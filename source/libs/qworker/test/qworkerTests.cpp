@@ -400,6 +400,15 @@ int32_t qwtGetDataBlock(DataSinkHandle handle, SOutputData *pOutput) {
   return 0;
 }
 
+int32_t qwtGetDataMsg(DataSinkHandle handle, int64_t len, SOutputData *pOutput, void **ppMsg) {
+  SRetrieveTableRsp *pRsp = (SRetrieveTableRsp *)rpcMallocCont(sizeof(SRetrieveTableRsp) + len);
+  memset(pRsp, 0, sizeof(SRetrieveTableRsp));
+  pOutput->pData = pRsp->data;
+  *ppMsg = pRsp;
+
+  return qwtGetDataBlock(handle, pOutput);
+}
+
 void qwtDestroyDataSinker(DataSinkHandle handle) {}
 
 void stubSetStringToPlan() {
@@ -622,6 +631,26 @@ void stubSetGetDataBlock() {
   }
 }
 
+void stubSetGetDataMsg() {
+  static Stub stub;
+  stub.set(dsGetDataMsg, qwtGetDataMsg);
+  {
+#ifdef WINDOWS
+    AddrAny                       any;
+    std::map<std::string, void *> result;
+    any.get_func_addr("dsGetDataMsg", result);
+#endif
+#ifdef LINUX
+    AddrAny                       any("libtransport.so");
+    std::map<std::string, void *> result;
+    any.get_global_func_addr_dynsym("^dsGetDataMsg$", result);
+#endif
+    for (const auto &f : result) {
+      stub.set(f.second, qwtGetDataMsg);
+    }
+  }
+}
+
 void *queryThread(void *param) {
   SRpcMsg  queryRpc = {0};
   int32_t  code = 0;
@@ -866,6 +895,7 @@ TEST(seqTest, normalCase) {
   stubSetEndPut();
   stubSetPutDataBlock();
   stubSetGetDataBlock();
+  stubSetGetDataMsg();
 
   SMsgCb msgCb = {0};
   msgCb.mgmt = (void *)mockPointer;
@@ -1008,6 +1038,7 @@ TEST(seqTest, multithreadRand) {
   stubSetEndPut();
   stubSetPutDataBlock();
   stubSetGetDataBlock();
+  stubSetGetDataMsg();
 
   taosSeedRand(taosGetTimestampSec());
 
@@ -1069,6 +1100,7 @@ TEST(rcTest, shortExecshortDelay) {
   stubSetEndPut();
   stubSetPutDataBlock();
   stubSetGetDataBlock();
+  stubSetGetDataMsg();
 
   taosSeedRand(taosGetTimestampSec());
   qwtTestStop = false;
@@ -1152,6 +1184,7 @@ TEST(rcTest, longExecshortDelay) {
   stubSetEndPut();
   stubSetPutDataBlock();
   stubSetGetDataBlock();
+  stubSetGetDataMsg();
 
   taosSeedRand(taosGetTimestampSec());
   qwtTestStop = false;
@@ -1235,6 +1268,7 @@ TEST(rcTest, shortExeclongDelay) {
   stubSetEndPut();
   stubSetPutDataBlock();
   stubSetGetDataBlock();
+  stubSetGetDataMsg();
 
   taosSeedRand(taosGetTimestampSec());
   qwtTestStop = false;
@@ -1318,6 +1352,7 @@ TEST(rcTest, dropTest) {
   stubSetEndPut();
   stubSetPutDataBlock();
   stubSetGetDataBlock();
+  stubSetGetDataMsg();
 
   taosSeedRand(taosGetTimestampSec());
 
@@ -214,6 +214,14 @@ typedef struct SFilterComUnit {
   int8_t   rfunc;
 } SFilterComUnit;
 
+typedef struct SFltVecUnit {
+  uint8_t type;
+  uint8_t optr;
+  bool    empty;  // no value of the column type is in [lo, hi]
+  int64_t lo;     // inclusive bounds, reinterpreted as uint64_t for TSDB_DATA_TYPE_UBIGINT
+  int64_t hi;
+} SFltVecUnit;
+
 typedef struct SFilterPCtx {
   SHashObj *valHash;
   SHashObj *unitHash;
@@ -257,6 +265,9 @@ struct SFilterInfo {
   SFilterGroup     *groups;
   SFilterUnit      *units;
   SFilterComUnit   *cunits;
+  SFltVecUnit      *vunits;      // column-at-a-time units, NULL if any unit is not supported
+  int8_t           *vecBuf;      // group and unit result of vunits
+  int32_t           vecBufRows;
   uint8_t          *unitRes;    // result
   uint8_t          *unitFlags;  // got result
   SFilterRangeCtx **colRange;
@@ -322,6 +333,8 @@ struct SFilterInfo {
   } while (0)
 #define FILTER_GREATER(cr, sflag, eflag) \
   ((cr > 0) || ((cr == 0) && (FILTER_GET_FLAG(sflag, RANGE_FLG_EXCLUDE) || FILTER_GET_FLAG(eflag, RANGE_FLG_EXCLUDE))))
+// the and of two bounds of the same value is unlimited only if both are
+#define FILTER_AND_RANGE_FLAG(f1, f2) (((f1) | (f2)) & (((f1) & (f2)) | (~RANGE_FLG_NULL)))
 #define FILTER_COPY_RA(dst, src) \
   do {                           \
     (dst)->sflag = (src)->sflag; \
@@ -497,6 +510,14 @@ extern bool          filterDoCompare(__compar_fn_t func, uint8_t optr, void *lef
 extern __compar_fn_t filterGetCompFunc(int32_t type, int32_t optr);
 extern __compar_fn_t filterGetCompFuncEx(int32_t lType, int32_t rType, int32_t optr);
 
+int32_t filterExecuteBasedOnStatis(SFilterInfo *info, int32_t numOfRows, SColumnInfoData *p, SColumnDataAgg *statis,
+                                   int16_t numOfCols, bool *all);
+bool    filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                          int16_t numOfCols, int32_t *numOfQualified);
+int32_t filterCompileVectorUnits(SFilterInfo *info);
+bool    filterExecuteImplVector(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                                int16_t numOfCols, int32_t *numOfQualified);
+
 #ifdef __cplusplus
 }
 #endif
@@ -609,13 +609,13 @@ int32_t filterAddRangeImpl(void *h, SFilterRange *ra, int32_t optr) {
       cr = ctx->pCompareFunc(&ra->s, &r->ra.s);
       if (FILTER_GREATER(cr, ra->sflag, r->ra.sflag)) {
         SIMPLE_COPY_VALUES((char *)&r->ra.s, &ra->s);
-        cr == 0 ? (r->ra.sflag |= ra->sflag) : (r->ra.sflag = ra->sflag);
+        cr == 0 ? (r->ra.sflag = FILTER_AND_RANGE_FLAG(r->ra.sflag, ra->sflag)) : (r->ra.sflag = ra->sflag);
       }
 
       cr = ctx->pCompareFunc(&r->ra.e, &ra->e);
       if (FILTER_GREATER(cr, r->ra.eflag, ra->eflag)) {
         SIMPLE_COPY_VALUES((char *)&r->ra.e, &ra->e);
-        cr == 0 ? (r->ra.eflag |= ra->eflag) : (r->ra.eflag = ra->eflag);
+        cr == 0 ? (r->ra.eflag = FILTER_AND_RANGE_FLAG(r->ra.eflag, ra->eflag)) : (r->ra.eflag = ra->eflag);
         break;
       }
 
@@ -1889,6 +1889,8 @@ void filterFreeInfo(SFilterInfo *info) {
   taosArrayDestroy(info->sclCtx.fltSclRange);
 
   taosMemoryFreeClear(info->cunits);
+  taosMemoryFreeClear(info->vunits);
+  taosMemoryFreeClear(info->vecBuf);
   taosMemoryFreeClear(info->blkUnitRes);
   taosMemoryFreeClear(info->blkUnits);
 
@@ -3338,6 +3340,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (filterCompileVectorUnits(info) == TSDB_CODE_SUCCESS && info->vunits != NULL) {
+    info->func = filterExecuteImplVector;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->unitNum > 1) {
     info->func = filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
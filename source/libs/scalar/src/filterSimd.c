@@ -0,0 +1,513 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "os.h"
+#include "filter.h"
+#include "filterInt.h"
+#include "tdatablock.h"
+
+// 4 bits of compare mask to 4 bytes of selection result, bit i is stored in byte i
+static const uint32_t gMask4ToBytes[16] = {
+    0x00000000, 0x00000001, 0x00000100, 0x00000101, 0x00010000, 0x00010001, 0x00010100, 0x00010101,
+    0x01000000, 0x01000001, 0x01000100, 0x01000101, 0x01010000, 0x01010001, 0x01010100, 0x01010101,
+};
+
+static bool fltVecIsSupportedType(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+    case TSDB_DATA_TYPE_UTINYINT:
+    case TSDB_DATA_TYPE_USMALLINT:
+    case TSDB_DATA_TYPE_UINT:
+    case TSDB_DATA_TYPE_UBIGINT:
+      return true;
+    default:
+      // float/double are compared with tolerance and NaN ordering in compareFloatVal/compareDoubleVal
+      return false;
+  }
+}
+
+static void fltVecGetTypeRange(int32_t type, int64_t *min, int64_t *max) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      *min = INT8_MIN;
+      *max = INT8_MAX;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      *min = INT16_MIN;
+      *max = INT16_MAX;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      *min = INT32_MIN;
+      *max = INT32_MAX;
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      *min = 0;
+      *max = UINT8_MAX;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      *min = 0;
+      *max = UINT16_MAX;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      *min = 0;
+      *max = UINT32_MAX;
+      break;
+    default:
+      *min = INT64_MIN;
+      *max = INT64_MAX;
+      break;
+  }
+}
+
+static int64_t fltVecGetSignedVal(int32_t type, const void *p) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return *(int8_t *)p;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return *(int16_t *)p;
+    case TSDB_DATA_TYPE_INT:
+      return *(int32_t *)p;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return *(uint8_t *)p;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return *(uint16_t *)p;
+    case TSDB_DATA_TYPE_UINT:
+      return *(uint32_t *)p;
+    default:
+      return *(int64_t *)p;
+  }
+}
+
+// convert the range unit into the inclusive range [lo, hi] of the column type
+static void fltVecSetSignedRange(SFltVecUnit *pUnit, int8_t rfunc, int64_t minv, int64_t maxv) {
+  int64_t tmin = 0, tmax = 0;
+  fltVecGetTypeRange(pUnit->type, &tmin, &tmax);
+
+  // rfunc: 0:(a, b) 1:(a, b] 2:[a, b) 3:[a, b] 4:(a, +) 5:[a, +) 6:(-, b) 7:(-, b]
+  bool    loExclude = (rfunc == 0 || rfunc == 1 || rfunc == 4);
+  bool    hiExclude = (rfunc == 0 || rfunc == 2 || rfunc == 6);
+  int64_t lo = (rfunc == 6 || rfunc == 7) ? tmin : minv;
+  int64_t hi = (rfunc == 4 || rfunc == 5) ? tmax : maxv;
+
+  if (loExclude) {
+    if (lo >= tmax) {
+      pUnit->empty = true;
+      return;
+    }
+    lo += 1;
+  }
+
+  if (hiExclude) {
+    if (hi <= tmin) {
+      pUnit->empty = true;
+      return;
+    }
+    hi -= 1;
+  }
+
+  pUnit->lo = TMAX(lo, tmin);
+  pUnit->hi = TMIN(hi, tmax);
+  pUnit->empty = (pUnit->lo > pUnit->hi);
+}
+
+static void fltVecSetUnsignedRange(SFltVecUnit *pUnit, int8_t rfunc, uint64_t minv, uint64_t maxv) {
+  bool     loExclude = (rfunc == 0 || rfunc == 1 || rfunc == 4);
+  bool     hiExclude = (rfunc == 0 || rfunc == 2 || rfunc == 6);
+  uint64_t lo = (rfunc == 6 || rfunc == 7) ? 0 : minv;
+  uint64_t hi = (rfunc == 4 || rfunc == 5) ? UINT64_MAX : maxv;
+
+  if (loExclude) {
+    if (lo == UINT64_MAX) {
+      pUnit->empty = true;
+      return;
+    }
+    lo += 1;
+  }
+
+  if (hiExclude) {
+    if (hi == 0) {
+      pUnit->empty = true;
+      return;
+    }
+    hi -= 1;
+  }
+
+  pUnit->lo = (int64_t)lo;
+  pUnit->hi = (int64_t)hi;
+  pUnit->empty = (lo > hi);
+}
+
+static bool fltVecCompileUnit(SFilterComUnit *cunit, SFltVecUnit *pUnit) {
+  memset(pUnit, 0, sizeof(SFltVecUnit));
+  pUnit->type = cunit->dataType;
+  pUnit->optr = cunit->optr;
+
+  if (!fltVecIsSupportedType(cunit->dataType)) {
+    return false;
+  }
+
+  if (cunit->optr == OP_TYPE_IS_NULL || cunit->optr == OP_TYPE_IS_NOT_NULL) {
+    return true;
+  }
+
+  bool isEqual = (cunit->optr == OP_TYPE_EQUAL || cunit->optr == OP_TYPE_NOT_EQUAL);
+  if ((cunit->rfunc < 0 && !isEqual) || cunit->valData == NULL || cunit->valData2 == NULL) {
+    return false;
+  }
+
+  int8_t rfunc = isEqual ? 3 : cunit->rfunc;
+  if (cunit->dataType == TSDB_DATA_TYPE_UBIGINT) {
+    fltVecSetUnsignedRange(pUnit, rfunc, *(uint64_t *)cunit->valData,
+                           *(uint64_t *)(isEqual ? cunit->valData : cunit->valData2));
+  } else {
+    fltVecSetSignedRange(pUnit, rfunc, fltVecGetSignedVal(cunit->dataType, cunit->valData),
+                         fltVecGetSignedVal(cunit->dataType, isEqual ? cunit->valData : cunit->valData2));
+  }
+
+  return true;
+}
+
+// set p[i] to 1 if lo <= v[i] <= hi, the result of not equal is computed by the caller
+#define FLT_VEC_RANGE_SCALAR(_t, _v, _start, _num, _lo, _hi, _p) \
+  do {                                                          \
+    const _t *v_ = (const _t *)(_v);                            \
+    _t        lo_ = (_t)(_lo), hi_ = (_t)(_hi);                 \
+    for (int32_t k = (_start); k < (_num); ++k) {               \
+      (_p)[k] = (v_[k] >= lo_) & (v_[k] <= hi_);                \
+    }                                                           \
+  } while (0)
+
+#if __AVX2__
+// the compare result of each lane is "out of range", so the selection byte is set by and-not with 1
+static int32_t fltVecRangeI8AVX2(const int8_t *v, int32_t numOfRows, int8_t lo, int8_t hi, bool sign, int8_t *p) {
+  int32_t i = 0;
+  __m256i flip = _mm256_set1_epi8(sign ? 0 : (char)0x80);
+  __m256i vlo = _mm256_xor_si256(_mm256_set1_epi8(lo), flip);
+  __m256i vhi = _mm256_xor_si256(_mm256_set1_epi8(hi), flip);
+  __m256i one = _mm256_set1_epi8(1);
+
+  for (; i + 32 <= numOfRows; i += 32) {
+    __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(v + i)), flip);
+    __m256i out = _mm256_or_si256(_mm256_cmpgt_epi8(vlo, x), _mm256_cmpgt_epi8(x, vhi));
+    _mm256_storeu_si256((__m256i *)(p + i), _mm256_andnot_si256(out, one));
+  }
+
+  return i;
+}
+
+static int32_t fltVecRangeI16AVX2(const int16_t *v, int32_t numOfRows, int16_t lo, int16_t hi, bool sign, int8_t *p) {
+  int32_t i = 0;
+  __m256i flip = _mm256_set1_epi16(sign ? 0 : (short)0x8000);
+  __m256i vlo = _mm256_xor_si256(_mm256_set1_epi16(lo), flip);
+  __m256i vhi = _mm256_xor_si256(_mm256_set1_epi16(hi), flip);
+  __m128i one = _mm_set1_epi8(1);
+
+  for (; i + 16 <= numOfRows; i += 16) {
+    __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(v + i)), flip);
+    __m256i out = _mm256_or_si256(_mm256_cmpgt_epi16(vlo, x), _mm256_cmpgt_epi16(x, vhi));
+    __m128i b = _mm_packs_epi16(_mm256_castsi256_si128(out), _mm256_extracti128_si256(out, 1));
+    _mm_storeu_si128((__m128i *)(p + i), _mm_andnot_si128(b, one));
+  }
+
+  return i;
+}
+
+static int32_t fltVecRangeI32AVX2(const int32_t *v, int32_t numOfRows, int32_t lo, int32_t hi, bool sign, int8_t *p) {
+  int32_t i = 0;
+  __m256i flip = _mm256_set1_epi32(sign ? 0 : (int32_t)0x80000000);
+  __m256i vlo = _mm256_xor_si256(_mm256_set1_epi32(lo), flip);
+  __m256i vhi = _mm256_xor_si256(_mm256_set1_epi32(hi), flip);
+  __m128i one = _mm_set1_epi8(1);
+
+  for (; i + 8 <= numOfRows; i += 8) {
+    __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(v + i)), flip);
+    __m256i out = _mm256_or_si256(_mm256_cmpgt_epi32(vlo, x), _mm256_cmpgt_epi32(x, vhi));
+    __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(out), _mm256_extracti128_si256(out, 1));
+    __m128i b = _mm_packs_epi16(w, w);
+    _mm_storel_epi64((__m128i *)(p + i), _mm_andnot_si128(b, one));
+  }
+
+  return i;
+}
+
+static int32_t fltVecRangeI64AVX2(const int64_t *v, int32_t numOfRows, int64_t lo, int64_t hi, bool sign, int8_t *p) {
+  int32_t i = 0;
+  __m256i flip = _mm256_set1_epi64x(sign ? 0 : INT64_MIN);
+  __m256i vlo = _mm256_xor_si256(_mm256_set1_epi64x(lo), flip);
+  __m256i vhi = _mm256_xor_si256(_mm256_set1_epi64x(hi), flip);
+
+  for (; i + 4 <= numOfRows; i += 4) {
+    __m256i  x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(v + i)), flip);
+    __m256i  out = _mm256_or_si256(_mm256_cmpgt_epi64(vlo, x), _mm256_cmpgt_epi64(x, vhi));
+    uint32_t m = (~_mm256_movemask_pd(_mm256_castsi256_pd(out))) & 0xF;
+    memcpy(p + i, &gMask4ToBytes[m], sizeof(uint32_t));
+  }
+
+  return i;
+}
+#endif
+
+#if __AVX512F__
+static int32_t fltVecRangeI32AVX512(const int32_t *v, int32_t numOfRows, int32_t lo, int32_t hi, bool sign,
+                                    int8_t *p) {
+  int32_t i = 0;
+  __m512i vlo = _mm512_set1_epi32(lo);
+  __m512i vhi = _mm512_set1_epi32(hi);
+
+  for (; i + 16 <= numOfRows; i += 16) {
+    __m512i   x = _mm512_loadu_si512((const void *)(v + i));
+    __mmask16 m = sign ? (_mm512_cmpge_epi32_mask(x, vlo) & _mm512_cmple_epi32_mask(x, vhi))
+                       : (_mm512_cmpge_epu32_mask(x, vlo) & _mm512_cmple_epu32_mask(x, vhi));
+    for (int32_t k = 0; k < 4; ++k) {
+      memcpy(p + i + (k << 2), &gMask4ToBytes[(m >> (k << 2)) & 0xF], sizeof(uint32_t));
+    }
+  }
+
+  return i;
+}
+
+static int32_t fltVecRangeI64AVX512(const int64_t *v, int32_t numOfRows, int64_t lo, int64_t hi, bool sign,
+                                    int8_t *p) {
+  int32_t i = 0;
+  __m512i vlo = _mm512_set1_epi64(lo);
+  __m512i vhi = _mm512_set1_epi64(hi);
+
+  for (; i + 8 <= numOfRows; i += 8) {
+    __m512i  x = _mm512_loadu_si512((const void *)(v + i));
+    __mmask8 m = sign ? (_mm512_cmpge_epi64_mask(x, vlo) & _mm512_cmple_epi64_mask(x, vhi))
+                      : (_mm512_cmpge_epu64_mask(x, vlo) & _mm512_cmple_epu64_mask(x, vhi));
+    memcpy(p + i, &gMask4ToBytes[m & 0xF], sizeof(uint32_t));
+    memcpy(p + i + 4, &gMask4ToBytes[(m >> 4) & 0xF], sizeof(uint32_t));
+  }
+
+  return i;
+}
+#endif
+
+static void fltVecRange(const SFltVecUnit *pUnit, const char *pData, int32_t numOfRows, int8_t *p) {
+  int32_t i = 0;
+
+  switch (pUnit->type) {
+    case TSDB_DATA_TYPE_TINYINT:
+    case TSDB_DATA_TYPE_UTINYINT: {
+      bool sign = (pUnit->type == TSDB_DATA_TYPE_TINYINT);
+#if __AVX2__
+      if (tsSIMDEnable && tsAVX2Enable) {
+        i = fltVecRangeI8AVX2((const int8_t *)pData, numOfRows, (int8_t)pUnit->lo, (int8_t)pUnit->hi, sign, p);
+      }
+#endif
+      if (sign) {
+        FLT_VEC_RANGE_SCALAR(int8_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      } else {
+        FLT_VEC_RANGE_SCALAR(uint8_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      }
+      break;
+    }
+    case TSDB_DATA_TYPE_SMALLINT:
+    case TSDB_DATA_TYPE_USMALLINT: {
+      bool sign = (pUnit->type == TSDB_DATA_TYPE_SMALLINT);
+#if __AVX2__
+      if (tsSIMDEnable && tsAVX2Enable) {
+        i = fltVecRangeI16AVX2((const int16_t *)pData, numOfRows, (int16_t)pUnit->lo, (int16_t)pUnit->hi, sign, p);
+      }
+#endif
+      if (sign) {
+        FLT_VEC_RANGE_SCALAR(int16_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      } else {
+        FLT_VEC_RANGE_SCALAR(uint16_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      }
+      break;
+    }
+    case TSDB_DATA_TYPE_INT:
+    case TSDB_DATA_TYPE_UINT: {
+      bool sign = (pUnit->type == TSDB_DATA_TYPE_INT);
+#if __AVX512F__
+      if (tsSIMDEnable && tsAVX512Enable) {
+        i = fltVecRangeI32AVX512((const int32_t *)pData, numOfRows, (int32_t)pUnit->lo, (int32_t)pUnit->hi, sign, p);
+      }
+#endif
+#if __AVX2__
+      if (i == 0 && tsSIMDEnable && tsAVX2Enable) {
+        i = fltVecRangeI32AVX2((const int32_t *)pData, numOfRows, (int32_t)pUnit->lo, (int32_t)pUnit->hi, sign, p);
+      }
+#endif
+      if (sign) {
+        FLT_VEC_RANGE_SCALAR(int32_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      } else {
+        FLT_VEC_RANGE_SCALAR(uint32_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      }
+      break;
+    }
+    default: {
+      bool sign = (pUnit->type != TSDB_DATA_TYPE_UBIGINT);
+#if __AVX512F__
+      if (tsSIMDEnable && tsAVX512Enable) {
+        i = fltVecRangeI64AVX512((const int64_t *)pData, numOfRows, pUnit->lo, pUnit->hi, sign, p);
+      }
+#endif
+#if __AVX2__
+      if (i == 0 && tsSIMDEnable && tsAVX2Enable) {
+        i = fltVecRangeI64AVX2((const int64_t *)pData, numOfRows, pUnit->lo, pUnit->hi, sign, p);
+      }
+#endif
+      if (sign) {
+        FLT_VEC_RANGE_SCALAR(int64_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      } else {
+        FLT_VEC_RANGE_SCALAR(uint64_t, pData, i, numOfRows, pUnit->lo, pUnit->hi, p);
+      }
+      break;
+    }
+  }
+}
+
+// clear the selection of null rows, eight rows are checked at a time with the null bitmap
+static void fltVecApplyNull(const SColumnInfoData *pCol, int32_t numOfRows, int8_t *p, bool isNullOptr) {
+  if (!pCol->hasNull || pCol->nullbitmap == NULL) {
+    return;
+  }
+
+  for (int32_t i = 0; i < numOfRows; i += 8) {
+    uint8_t bm = (uint8_t)pCol->nullbitmap[i >> 3];
+    if (bm == 0) {
+      continue;
+    }
+
+    int32_t n = TMIN(8, numOfRows - i);
+    for (int32_t k = 0; k < n; ++k) {
+      if (bm & (1u << (7u - k))) {
+        p[i + k] = isNullOptr ? 1 : 0;
+      }
+    }
+  }
+}
+
+static void fltVecExecUnit(const SFltVecUnit *pUnit, const SColumnInfoData *pCol, int32_t numOfRows, int8_t *p) {
+  switch (pUnit->optr) {
+    case OP_TYPE_IS_NULL:
+      memset(p, 0, numOfRows);
+      fltVecApplyNull(pCol, numOfRows, p, true);
+      return;
+    case OP_TYPE_IS_NOT_NULL:
+      memset(p, 1, numOfRows);
+      break;
+    default:
+      if (pUnit->empty) {
+        memset(p, pUnit->optr == OP_TYPE_NOT_EQUAL ? 1 : 0, numOfRows);
+      } else {
+        fltVecRange(pUnit, pCol->pData, numOfRows, p);
+        if (pUnit->optr == OP_TYPE_NOT_EQUAL) {
+          for (int32_t i = 0; i < numOfRows; ++i) {
+            p[i] ^= 1;
+          }
+        }
+      }
+      break;
+  }
+
+  fltVecApplyNull(pCol, numOfRows, p, false);
+}
+
+int32_t filterCompileVectorUnits(SFilterInfo *info) {
+  taosMemoryFreeClear(info->vunits);
+  if (info->cunits == NULL || info->unitNum == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SFltVecUnit *vunits = taosMemoryCalloc(info->unitNum, sizeof(SFltVecUnit));
+  if (vunits == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    if (!fltVecCompileUnit(&info->cunits[i], &vunits[i])) {
+      taosMemoryFree(vunits);
+      return TSDB_CODE_SUCCESS;
+    }
+  }
+
+  info->vunits = vunits;
+  return TSDB_CODE_SUCCESS;
+}
+
+static int8_t *fltVecGetBuf(SFilterInfo *info, int32_t numOfRows) {
+  if (info->vecBufRows < numOfRows) {
+    int8_t *p = taosMemoryRealloc(info->vecBuf, numOfRows * 2);
+    if (p == NULL) {
+      return NULL;
+    }
+
+    info->vecBuf = p;
+    info->vecBufRows = numOfRows;
+  }
+
+  return info->vecBuf;
+}
+
+bool filterExecuteImplVector(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                             int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool         all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  int8_t *gRes = (info->unitNum > 1) ? fltVecGetBuf(info, numOfRows) : NULL;
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    SColumnInfoData *pCol = info->cunits[i].colData;
+    if (pCol == NULL || pCol->info.type != info->vunits[i].type || (info->unitNum > 1 && gRes == NULL)) {
+      return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+    }
+  }
+
+  int8_t *p = (int8_t *)pRes->pData;
+
+  if (info->unitNum == 1) {
+    fltVecExecUnit(&info->vunits[0], info->cunits[0].colData, numOfRows, p);
+  } else {
+    // groups are OR-ed, units in a group are AND-ed
+    int8_t *uRes = gRes + numOfRows;
+    memset(p, 0, numOfRows);
+
+    for (uint32_t g = 0; g < info->groupNum; ++g) {
+      SFilterGroup *group = &info->groups[g];
+      for (uint32_t u = 0; u < group->unitNum; ++u) {
+        uint32_t uidx = group->unitIdxs[u];
+        fltVecExecUnit(&info->vunits[uidx], info->cunits[uidx].colData, numOfRows, (u == 0) ? gRes : uRes);
+        if (u > 0) {
+          for (int32_t i = 0; i < numOfRows; ++i) {
+            gRes[i] &= uRes[i];
+          }
+        }
+      }
+
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        p[i] |= gRes[i];
+      }
+    }
+  }
+
+  int32_t num = 0;
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    num += p[i];
+  }
+
+  *numOfQualified += num;
+  return num == numOfRows;
+}
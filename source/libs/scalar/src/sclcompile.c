@@ -0,0 +1,546 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "querynodes.h"
+#include "scalar.h"
+#include "sclInt.h"
+#include "tcompare.h"
+#include "tdatablock.h"
+
+/*
+ * The compiled program of an arithmetic expression.
+ *
+ * Each column is loaded into a register of doubles by a single type switch, and each operator is a tight loop over
+ * the registers that writes its result in place into the register of one of its operands, so that evaluating a
+ * block neither allocates an intermediate column nor converts a value through a function pointer. The registers
+ * are kept by the program and reused by the following blocks. The null rows are kept as one byte for each row, so
+ * that they are merged by the same kind of loop.
+ *
+ * The results are the same as the ones of sclvector.c: any null operand gives null, so do the divisor of zero and
+ * the remainder of an infinite or nan value.
+ */
+
+typedef enum ESclOpCode {
+  SCL_OPCODE_LOAD = 1,  // load a numeric column into a register
+  SCL_OPCODE_ADD,
+  SCL_OPCODE_SUB,
+  SCL_OPCODE_MULTI,
+  SCL_OPCODE_DIV,
+  SCL_OPCODE_REM,
+  SCL_OPCODE_MINUS,
+} ESclOpCode;
+
+typedef struct SSclOperand {
+  int32_t reg;  // -1 if it is a constant
+  double  val;
+} SSclOperand;
+
+typedef struct SSclStep {
+  int8_t      opCode;
+  int16_t     dataBlockId;  // the column of SCL_OPCODE_LOAD
+  int16_t     slotId;
+  SSclOperand left;
+  SSclOperand right;
+  int32_t     out;
+} SSclStep;
+
+typedef struct SSclReg {
+  double  *pData;
+  uint8_t *pNull;  // 1 if the row is null, valid only if hasNull is true
+  bool     hasNull;
+} SSclReg;
+
+struct SScalarProgram {
+  SArray  *pSteps;  // SArray<SSclStep>
+  SSclReg *pRegs;
+  int32_t  numOfRegs;
+  int32_t  capacity;  // the rows of each register
+  int32_t  result;    // the register of the result
+};
+
+typedef struct SSclCompileCtx {
+  SScalarProgram *pProgram;
+  SArray         *pFreeRegs;  // SArray<int32_t>
+  int32_t         numOfCols;
+} SSclCompileCtx;
+
+static bool sclIsCompilableType(int32_t type) { return IS_NUMERIC_TYPE(type) || type == TSDB_DATA_TYPE_BOOL; }
+
+static int8_t sclGetOpCode(EOperatorType opType) {
+  switch (opType) {
+    case OP_TYPE_ADD:
+      return SCL_OPCODE_ADD;
+    case OP_TYPE_SUB:
+      return SCL_OPCODE_SUB;
+    case OP_TYPE_MULTI:
+      return SCL_OPCODE_MULTI;
+    case OP_TYPE_DIV:
+      return SCL_OPCODE_DIV;
+    case OP_TYPE_REM:
+      return SCL_OPCODE_REM;
+    case OP_TYPE_MINUS:
+      return SCL_OPCODE_MINUS;
+    default:
+      return 0;
+  }
+}
+
+static bool sclRemIsNull(double lx, double rx) {
+  return isnan(lx) || isinf(lx) || isnan(rx) || isinf(rx) || FLT_EQUAL(rx, 0);
+}
+
+// return false if the result is null, which can not be a constant of the program
+static bool sclFoldConstant(int8_t opCode, double lx, double rx, double *pRes) {
+  switch (opCode) {
+    case SCL_OPCODE_ADD:
+      *pRes = lx + rx;
+      return true;
+    case SCL_OPCODE_SUB:
+      *pRes = lx - rx;
+      return true;
+    case SCL_OPCODE_MULTI:
+      *pRes = lx * rx;
+      return true;
+    case SCL_OPCODE_DIV:
+      *pRes = lx / rx;
+      return rx != 0;
+    case SCL_OPCODE_REM:
+      if (sclRemIsNull(lx, rx)) {
+        return false;
+      }
+      *pRes = lx - ((int64_t)(lx / rx)) * rx;
+      return true;
+    case SCL_OPCODE_MINUS:
+      *pRes = (lx == 0) ? 0 : -lx;
+      return true;
+    default:
+      return false;
+  }
+}
+
+static int32_t sclAllocReg(SSclCompileCtx *pCtx) {
+  if (taosArrayGetSize(pCtx->pFreeRegs) > 0) {
+    return *(int32_t *)taosArrayPop(pCtx->pFreeRegs);
+  }
+
+  return pCtx->pProgram->numOfRegs++;
+}
+
+static int32_t sclAppendStep(SSclCompileCtx *pCtx, SSclStep *pStep) {
+  if (NULL == taosArrayPush(pCtx->pProgram->pSteps, pStep)) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t sclCompileNode(SSclCompileCtx *pCtx, SNode *pNode, SSclOperand *pRes);
+
+static int32_t sclCompileOperator(SSclCompileCtx *pCtx, SOperatorNode *pOp, SSclOperand *pRes) {
+  int8_t opCode = sclGetOpCode(pOp->opType);
+  if (0 == opCode || pOp->node.resType.type != TSDB_DATA_TYPE_DOUBLE || NULL == pOp->pLeft) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  SSclStep step = {.opCode = opCode, .right = {.reg = -1}};
+  SCL_ERR_RET(sclCompileNode(pCtx, pOp->pLeft, &step.left));
+
+  if (SCL_OPCODE_MINUS != opCode) {
+    if (NULL == pOp->pRight) {
+      return TSDB_CODE_OPS_NOT_SUPPORT;
+    }
+    SCL_ERR_RET(sclCompileNode(pCtx, pOp->pRight, &step.right));
+  }
+
+  if (step.left.reg < 0 && step.right.reg < 0) {
+    *pRes = (SSclOperand){.reg = -1};
+    return sclFoldConstant(opCode, step.left.val, step.right.val, &pRes->val) ? TSDB_CODE_SUCCESS
+                                                                              : TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  // a constant that makes all rows null is left to scalarCalculate
+  if ((SCL_OPCODE_DIV == opCode && step.right.reg < 0 && step.right.val == 0) ||
+      (SCL_OPCODE_REM == opCode && step.right.reg < 0 && sclRemIsNull(0, step.right.val)) ||
+      (SCL_OPCODE_REM == opCode && step.left.reg < 0 && sclRemIsNull(step.left.val, 1))) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  // the result is written into the register of the left operand if it has one, and the other one is released
+  if (step.left.reg >= 0) {
+    step.out = step.left.reg;
+    if (step.right.reg >= 0 && NULL == taosArrayPush(pCtx->pFreeRegs, &step.right.reg)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  } else {
+    step.out = step.right.reg;
+  }
+
+  *pRes = (SSclOperand){.reg = step.out};
+  return sclAppendStep(pCtx, &step);
+}
+
+static int32_t sclCompileNode(SSclCompileCtx *pCtx, SNode *pNode, SSclOperand *pRes) {
+  switch (nodeType(pNode)) {
+    case QUERY_NODE_OPERATOR:
+      return sclCompileOperator(pCtx, (SOperatorNode *)pNode, pRes);
+    case QUERY_NODE_VALUE: {
+      SValueNode *pVal = (SValueNode *)pNode;
+      if (pVal->isNull || !sclIsCompilableType(pVal->node.resType.type)) {
+        return TSDB_CODE_OPS_NOT_SUPPORT;
+      }
+
+      *pRes = (SSclOperand){.reg = -1};
+      GET_TYPED_DATA(pRes->val, double, pVal->node.resType.type, nodesGetValueFromNode(pVal));
+      return TSDB_CODE_SUCCESS;
+    }
+    case QUERY_NODE_COLUMN: {
+      SColumnNode *pCol = (SColumnNode *)pNode;
+      if (!sclIsCompilableType(pCol->node.resType.type)) {
+        return TSDB_CODE_OPS_NOT_SUPPORT;
+      }
+
+      SSclStep step = {.opCode = SCL_OPCODE_LOAD, .dataBlockId = pCol->dataBlockId, .slotId = pCol->slotId};
+      step.out = sclAllocReg(pCtx);
+      *pRes = (SSclOperand){.reg = step.out};
+      pCtx->numOfCols += 1;
+      return sclAppendStep(pCtx, &step);
+    }
+    default:
+      return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+}
+
+int32_t scalarCompile(SNode *pNode, SScalarProgram **pProgram) {
+  int32_t        code = TSDB_CODE_SUCCESS;
+  SSclCompileCtx ctx = {0};
+  SSclOperand    res = {0};
+
+  *pProgram = NULL;
+  if (NULL == pNode || QUERY_NODE_OPERATOR != nodeType(pNode)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  ctx.pProgram = taosMemoryCalloc(1, sizeof(SScalarProgram));
+  ctx.pFreeRegs = taosArrayInit(4, sizeof(int32_t));
+  if (NULL == ctx.pProgram || NULL == ctx.pFreeRegs) {
+    SCL_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  ctx.pProgram->pSteps = taosArrayInit(8, sizeof(SSclStep));
+  if (NULL == ctx.pProgram->pSteps) {
+    SCL_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  code = sclCompileNode(&ctx, pNode, &res);
+  if (TSDB_CODE_OPS_NOT_SUPPORT == code || (TSDB_CODE_SUCCESS == code && 0 == ctx.numOfCols)) {
+    // fall back to scalarCalculate
+    code = TSDB_CODE_SUCCESS;
+    goto _return;
+  }
+  SCL_ERR_JRET(code);
+
+  ctx.pProgram->pRegs = taosMemoryCalloc(ctx.pProgram->numOfRegs, sizeof(SSclReg));
+  if (NULL == ctx.pProgram->pRegs) {
+    SCL_ERR_JRET(TSDB_CODE_OUT_OF_MEMORY);
+  }
+
+  ctx.pProgram->result = res.reg;
+  *pProgram = ctx.pProgram;
+  ctx.pProgram = NULL;
+
+_return:
+  scalarFreeProgram(ctx.pProgram);
+  taosArrayDestroy(ctx.pFreeRegs);
+  return code;
+}
+
+void scalarFreeProgram(SScalarProgram *pProgram) {
+  if (NULL == pProgram) {
+    return;
+  }
+
+  if (pProgram->pRegs != NULL) {
+    for (int32_t i = 0; i < pProgram->numOfRegs; ++i) {
+      taosMemoryFree(pProgram->pRegs[i].pData);
+      taosMemoryFree(pProgram->pRegs[i].pNull);
+    }
+    taosMemoryFree(pProgram->pRegs);
+  }
+
+  taosArrayDestroy(pProgram->pSteps);
+  taosMemoryFree(pProgram);
+}
+
+static int32_t sclEnsureRegCapacity(SScalarProgram *pProgram, int32_t numOfRows) {
+  if (numOfRows <= pProgram->capacity) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  for (int32_t i = 0; i < pProgram->numOfRegs; ++i) {
+    SSclReg *pReg = &pProgram->pRegs[i];
+    double  *pData = taosMemoryRealloc(pReg->pData, numOfRows * sizeof(double));
+    if (NULL == pData) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pReg->pData = pData;
+
+    uint8_t *pNull = taosMemoryRealloc(pReg->pNull, numOfRows);
+    if (NULL == pNull) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pReg->pNull = pNull;
+  }
+
+  pProgram->capacity = numOfRows;
+  return TSDB_CODE_SUCCESS;
+}
+
+static SColumnInfoData *sclGetStepColumn(SArray *pBlockList, const SSclStep *pStep, int32_t *numOfRows) {
+  for (int32_t i = 0; i < taosArrayGetSize(pBlockList); ++i) {
+    SSDataBlock *pBlock = taosArrayGetP(pBlockList, i);
+    if (pBlock->info.id.blockId != pStep->dataBlockId) {
+      continue;
+    }
+
+    if (pStep->slotId >= taosArrayGetSize(pBlock->pDataBlock)) {
+      sclError("column slotId is too big, slodId:%d, dataBlockSize:%d", pStep->slotId,
+               (int32_t)taosArrayGetSize(pBlock->pDataBlock));
+      return NULL;
+    }
+
+    *numOfRows = pBlock->info.rows;
+    return taosArrayGet(pBlock->pDataBlock, pStep->slotId);
+  }
+
+  sclError("column tupleId is too big, tupleId:%d, dataBlockNum:%d", pStep->dataBlockId,
+           (int32_t)taosArrayGetSize(pBlockList));
+  return NULL;
+}
+
+#define SCL_LOAD_COLUMN(_out, _data, _type, _n) \
+  do {                                          \
+    const _type *p = (const _type *)(_data);     \
+    for (int32_t i = 0; i < (_n); ++i) {        \
+      (_out)[i] = (double)p[i];                 \
+    }                                           \
+  } while (0)
+
+static int32_t sclLoadColumn(SSclReg *pReg, const SColumnInfoData *pCol, int32_t numOfRows) {
+  double *out = pReg->pData;
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, int8_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, uint8_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, int16_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, uint16_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      SCL_LOAD_COLUMN(out, pCol->pData, int32_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, uint32_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, int64_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      SCL_LOAD_COLUMN(out, pCol->pData, uint64_t, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      SCL_LOAD_COLUMN(out, pCol->pData, float, numOfRows);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      memcpy(out, pCol->pData, numOfRows * sizeof(double));
+      break;
+    default:
+      sclError("invalid column type to load, type:%d", pCol->info.type);
+      return TSDB_CODE_QRY_INVALID_INPUT;
+  }
+
+  pReg->hasNull = pCol->hasNull;
+  if (pCol->hasNull) {
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      pReg->pNull[i] = colDataIsNull_f(pCol->nullbitmap, i) ? 1 : 0;
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// the right operand is null if the left one is a constant, or for the unary operator
+static void sclMergeNull(SSclReg *pOut, const SSclReg *pIn, int32_t numOfRows) {
+  if (NULL == pIn || pIn == pOut || !pIn->hasNull) {
+    return;
+  }
+
+  if (!pOut->hasNull) {
+    memcpy(pOut->pNull, pIn->pNull, numOfRows);
+    pOut->hasNull = true;
+    return;
+  }
+
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    pOut->pNull[i] |= pIn->pNull[i];
+  }
+}
+
+static void sclPrepareNull(SSclReg *pOut, int32_t numOfRows) {
+  if (!pOut->hasNull) {
+    memset(pOut->pNull, 0, numOfRows);
+    pOut->hasNull = true;
+  }
+}
+
+#define SCL_ARITH_KERNEL(_out, _pl, _pr, _lv, _rv, _n, _expr) \
+  do {                                                       \
+    if ((_pl) != NULL && (_pr) != NULL) {                    \
+      for (int32_t i = 0; i < (_n); ++i) {                   \
+        double l = (_pl)[i], r = (_pr)[i];                   \
+        (_out)[i] = (_expr);                                 \
+      }                                                      \
+    } else if ((_pl) != NULL) {                              \
+      double r = (_rv);                                      \
+      for (int32_t i = 0; i < (_n); ++i) {                   \
+        double l = (_pl)[i];                                 \
+        (_out)[i] = (_expr);                                 \
+      }                                                      \
+    } else {                                                 \
+      double l = (_lv);                                      \
+      for (int32_t i = 0; i < (_n); ++i) {                   \
+        double r = (_pr)[i];                                 \
+        (_out)[i] = (_expr);                                 \
+      }                                                      \
+    }                                                        \
+  } while (0)
+
+static void sclExecArith(SScalarProgram *pProgram, const SSclStep *pStep, int32_t numOfRows) {
+  SSclReg *pOut = &pProgram->pRegs[pStep->out];
+  SSclReg *pLeft = (pStep->left.reg >= 0) ? &pProgram->pRegs[pStep->left.reg] : NULL;
+  SSclReg *pRight = (pStep->right.reg >= 0) ? &pProgram->pRegs[pStep->right.reg] : NULL;
+  double  *pl = (pLeft != NULL) ? pLeft->pData : NULL;
+  double  *pr = (pRight != NULL) ? pRight->pData : NULL;
+  double  *out = pOut->pData;
+
+  sclMergeNull(pOut, pLeft, numOfRows);
+  sclMergeNull(pOut, pRight, numOfRows);
+
+  switch (pStep->opCode) {
+    case SCL_OPCODE_ADD:
+      SCL_ARITH_KERNEL(out, pl, pr, pStep->left.val, pStep->right.val, numOfRows, l + r);
+      break;
+    case SCL_OPCODE_SUB:
+      SCL_ARITH_KERNEL(out, pl, pr, pStep->left.val, pStep->right.val, numOfRows, l - r);
+      break;
+    case SCL_OPCODE_MULTI:
+      SCL_ARITH_KERNEL(out, pl, pr, pStep->left.val, pStep->right.val, numOfRows, l * r);
+      break;
+    case SCL_OPCODE_DIV:
+      if (pr != NULL) {
+        sclPrepareNull(pOut, numOfRows);
+        for (int32_t i = 0; i < numOfRows; ++i) {
+          pOut->pNull[i] |= (pr[i] == 0);
+        }
+      }
+      SCL_ARITH_KERNEL(out, pl, pr, pStep->left.val, pStep->right.val, numOfRows, (r == 0) ? 0 : l / r);
+      break;
+    case SCL_OPCODE_REM:
+      sclPrepareNull(pOut, numOfRows);
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        double lx = (pl != NULL) ? pl[i] : pStep->left.val;
+        double rx = (pr != NULL) ? pr[i] : pStep->right.val;
+        if (sclRemIsNull(lx, rx)) {
+          pOut->pNull[i] = 1;
+          out[i] = 0;
+        } else {
+          out[i] = lx - ((int64_t)(lx / rx)) * rx;
+        }
+      }
+      break;
+    case SCL_OPCODE_MINUS:
+      for (int32_t i = 0; i < numOfRows; ++i) {
+        out[i] = (pl[i] == 0) ? 0 : -pl[i];
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+int32_t scalarExecProgram(SScalarProgram *pProgram, SArray *pBlockList, SColumnInfoData *pDst, int32_t startIndex,
+                          int32_t *numOfRows) {
+  if (pDst->info.type != TSDB_DATA_TYPE_DOUBLE) {
+    sclError("invalid result type of the compiled expression, type:%d", pDst->info.type);
+    SCL_ERR_RET(TSDB_CODE_QRY_INVALID_INPUT);
+  }
+
+  int32_t   rows = -1;
+  int32_t   numOfSteps = taosArrayGetSize(pProgram->pSteps);
+  SSclStep *pSteps = (SSclStep *)TARRAY_DATA(pProgram->pSteps);
+
+  for (int32_t i = 0; i < numOfSteps; ++i) {
+    if (SCL_OPCODE_LOAD != pSteps[i].opCode) {
+      continue;
+    }
+
+    int32_t n = 0;
+    if (NULL == sclGetStepColumn(pBlockList, &pSteps[i], &n) || (rows >= 0 && n != rows)) {
+      SCL_ERR_RET(TSDB_CODE_QRY_INVALID_INPUT);
+    }
+    rows = n;
+  }
+
+  *numOfRows = TMAX(rows, 0);
+  if (rows <= 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SCL_ERR_RET(sclEnsureRegCapacity(pProgram, rows));
+
+  for (int32_t i = 0; i < numOfSteps; ++i) {
+    SSclStep *pStep = &pSteps[i];
+    if (SCL_OPCODE_LOAD == pStep->opCode) {
+      int32_t n = 0;
+      SCL_ERR_RET(sclLoadColumn(&pProgram->pRegs[pStep->out], sclGetStepColumn(pBlockList, pStep, &n), rows));
+    } else {
+      sclExecArith(pProgram, pStep, rows);
+    }
+  }
+
+  SSclReg *pRes = &pProgram->pRegs[pProgram->result];
+  memcpy(((double *)pDst->pData) + startIndex, pRes->pData, rows * sizeof(double));
+
+  if (pRes->hasNull) {
+    for (int32_t i = 0; i < rows; ++i) {
+      if (pRes->pNull[i]) {
+        colDataSetNull_f(pDst->nullbitmap, startIndex + i);
+        pDst->hasNull = true;
+      } else {
+        colDataClearNull_f(pDst->nullbitmap, startIndex + i);
+      }
+    }
+  } else if (pDst->hasNull) {
+    for (int32_t i = 0; i < rows; ++i) {
+      colDataClearNull_f(pDst->nullbitmap, startIndex + i);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
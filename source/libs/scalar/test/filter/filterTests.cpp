@@ -15,6 +15,8 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <random>
+#include <vector>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wwrite-strings"
@@ -1341,6 +1343,448 @@ TEST(scalarModelogicTest, diff_columns_or_and_or) {
 }
 #endif
 
+namespace {
+
+// a column of the filterSimd tests, the values are stored in the low bytes of int64_t
+struct SFltSimdCol {
+  int32_t              type;
+  std::vector<int64_t> values;
+  std::vector<bool>    nulls;
+};
+
+const int32_t flttSimdTypes[] = {TSDB_DATA_TYPE_TINYINT,   TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+                                 TSDB_DATA_TYPE_BIGINT,    TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT,
+                                 TSDB_DATA_TYPE_UINT,      TSDB_DATA_TYPE_UBIGINT,  TSDB_DATA_TYPE_TIMESTAMP};
+
+// none of them is a multiple of the vector width of any type
+const int32_t flttSimdRowNums[] = {1, 3, 7, 15, 33, 67, 1029};
+
+std::mt19937_64 flttSimdRand(20231016);
+
+bool flttSimdIsUnsigned(int32_t type) { return IS_UNSIGNED_NUMERIC_TYPE(type); }
+
+void flttSimdGetRange(int32_t type, int64_t *min, int64_t *max) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      *min = INT8_MIN, *max = INT8_MAX;
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      *min = INT16_MIN, *max = INT16_MAX;
+      break;
+    case TSDB_DATA_TYPE_INT:
+      *min = INT32_MIN, *max = INT32_MAX;
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      *min = 0, *max = UINT8_MAX;
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      *min = 0, *max = UINT16_MAX;
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      *min = 0, *max = UINT32_MAX;
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      *min = 0, *max = (int64_t)UINT64_MAX;
+      break;
+    default:
+      *min = INT64_MIN, *max = INT64_MAX;
+      break;
+  }
+}
+
+// a random value of the type, one value in eight is the min or the max of the type
+int64_t flttSimdRandVal(int32_t type) {
+  int64_t min = 0, max = 0;
+  flttSimdGetRange(type, &min, &max);
+
+  uint64_t r = flttSimdRand();
+  switch (r % 16) {
+    case 0:
+      return min;
+    case 1:
+      return max;
+    default:
+      break;
+  }
+
+  if (type == TSDB_DATA_TYPE_BIGINT || type == TSDB_DATA_TYPE_TIMESTAMP || type == TSDB_DATA_TYPE_UBIGINT) {
+    return (int64_t)flttSimdRand();
+  }
+  return min + (int64_t)(flttSimdRand() % (uint64_t)(max - min + 1));
+}
+
+SFltSimdCol flttSimdMakeCol(int32_t type, int32_t rowNum, bool hasNull) {
+  SFltSimdCol col;
+  col.type = type;
+  for (int32_t i = 0; i < rowNum; ++i) {
+    col.values.push_back(flttSimdRandVal(type));
+    col.nulls.push_back(hasNull && (flttSimdRand() % 5 == 0));
+  }
+  return col;
+}
+
+// the value of the row in the range of the column type
+int64_t flttSimdGetVal(const SFltSimdCol &col, int32_t row) {
+  int64_t v = col.values[row];
+  switch (col.type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return (int8_t)v;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return (int16_t)v;
+    case TSDB_DATA_TYPE_INT:
+      return (int32_t)v;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return (uint8_t)v;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return (uint16_t)v;
+    case TSDB_DATA_TYPE_UINT:
+      return (uint32_t)v;
+    default:
+      return v;
+  }
+}
+
+// the expected result of the unit on the row
+bool flttSimdCompare(const SFltSimdCol &col, int32_t row, EOperatorType optr, int64_t value) {
+  if (col.nulls[row]) {
+    return optr == OP_TYPE_IS_NULL;
+  }
+
+  int64_t v = flttSimdGetVal(col, row);
+  int32_t c = 0;
+  if (flttSimdIsUnsigned(col.type)) {
+    c = ((uint64_t)v < (uint64_t)value) ? -1 : ((uint64_t)v > (uint64_t)value);
+  } else {
+    c = (v < value) ? -1 : (v > value);
+  }
+
+  switch (optr) {
+    case OP_TYPE_GREATER_THAN:
+      return c > 0;
+    case OP_TYPE_GREATER_EQUAL:
+      return c >= 0;
+    case OP_TYPE_LOWER_THAN:
+      return c < 0;
+    case OP_TYPE_LOWER_EQUAL:
+      return c <= 0;
+    case OP_TYPE_EQUAL:
+      return c == 0;
+    case OP_TYPE_NOT_EQUAL:
+      return c != 0;
+    case OP_TYPE_IS_NULL:
+      return false;
+    case OP_TYPE_IS_NOT_NULL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void flttSimdAppendCol(SSDataBlock *pBlock, const SFltSimdCol &col) {
+  int32_t         rowNum = (int32_t)col.values.size();
+  SColumnInfoData idata =
+      createColumnInfoData(col.type, tDataTypes[col.type].bytes, 1 + (int32_t)taosArrayGetSize(pBlock->pDataBlock));
+  blockDataAppendColInfo(pBlock, &idata);
+
+  SColumnInfoData *pColumn = (SColumnInfoData *)taosArrayGetLast(pBlock->pDataBlock);
+  colInfoDataEnsureCapacity(pColumn, rowNum, true);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    if (col.nulls[i]) {
+      colDataSetNULL(pColumn, i);
+    } else {
+      colDataSetVal(pColumn, i, (const char *)&col.values[i], false);
+    }
+  }
+
+  pBlock->info.rows = rowNum;
+}
+
+SNode *flttSimdMakeUnit(int32_t slotId, int32_t type, EOperatorType optr, int64_t value) {
+  SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  pCol->dataBlockId = 0;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  // the filter tells the columns apart by the name
+  snprintf(pCol->colName, sizeof(pCol->colName), "c%d", slotId);
+
+  SNode *pRight = NULL;
+  if (optr != OP_TYPE_IS_NULL && optr != OP_TYPE_IS_NOT_NULL) {
+    flttMakeValueNode(&pRight, type, &value);
+  }
+
+  SNode *opNode = NULL;
+  flttMakeOpNode(&opNode, optr, TSDB_DATA_TYPE_BOOL, (SNode *)pCol, pRight);
+  return opNode;
+}
+
+SNode *flttSimdMakeLogic(ELogicConditionType opType, SNode *pNode1, SNode *pNode2) {
+  SNode *list[2] = {pNode1, pNode2};
+  SNode *logicNode = NULL;
+  flttMakeLogicNode(&logicNode, opType, list, 2);
+  return logicNode;
+}
+
+int32_t flttSimdExec(SFilterInfo *filter, SSDataBlock *pBlock, std::vector<int8_t> *pRes) {
+  SColumnInfoData *pRowRes = NULL;
+  int32_t          status = 0;
+  int32_t          code = filterExecute(filter, pBlock, &pRowRes, NULL, (int16_t)taosArrayGetSize(pBlock->pDataBlock),
+                                        &status);
+  EXPECT_EQ(code, 0);
+
+  if (pRowRes != NULL) {
+    pRes->assign((int8_t *)pRowRes->pData, (int8_t *)pRowRes->pData + pBlock->info.rows);
+    colDataDestroy(pRowRes);
+    taosMemoryFree(pRowRes);
+  }
+
+  return status;
+}
+
+SFilterInfo *flttSimdInit(SNode *pCond, SSDataBlock *pBlock) {
+  SFilterInfo *filter = NULL;
+  EXPECT_EQ(filterInitFromNode(pCond, &filter, 0), 0);
+  if (filter == NULL) {
+    return NULL;
+  }
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(pBlock->pDataBlock), pBlock->pDataBlock};
+  EXPECT_EQ(filterSetDataFromSlotId(filter, &param), 0);
+  return filter;
+}
+
+// run the filter with the SIMD kernels, with the scalar loop of filterSimd.c and with the row-wise filterExecuteImpl,
+// all of them must give the expected result
+void flttSimdCheckFilter(SFilterInfo *filter, SSDataBlock *pBlock, const std::vector<int8_t> &expected) {
+  if (filter->scalarMode || filter->func != filterExecuteImplVector) {
+    std::vector<int8_t> res;
+    flttSimdExec(filter, pBlock, &res);
+    EXPECT_EQ(res, expected);
+    return;
+  }
+
+  char simdEnable = tsSIMDEnable;
+
+  std::vector<int8_t> simdRes, vecRes, rowRes;
+  tsSIMDEnable = 1;
+  int32_t simdStatus = flttSimdExec(filter, pBlock, &simdRes);
+  tsSIMDEnable = 0;
+  int32_t vecStatus = flttSimdExec(filter, pBlock, &vecRes);
+  tsSIMDEnable = simdEnable;
+
+  filter->func = filterExecuteImpl;
+  int32_t rowStatus = flttSimdExec(filter, pBlock, &rowRes);
+
+  EXPECT_EQ(simdRes, expected);
+  EXPECT_EQ(vecRes, expected);
+  EXPECT_EQ(rowRes, expected);
+  EXPECT_EQ(simdStatus, rowStatus);
+  EXPECT_EQ(vecStatus, rowStatus);
+}
+
+// return if the filter is evaluated column at a time
+bool flttSimdCheck(SNode *pCond, SSDataBlock *pBlock, const std::vector<int8_t> &expected) {
+  SFilterInfo *filter = flttSimdInit(pCond, pBlock);
+  if (filter == NULL) {
+    return false;
+  }
+
+  bool vector = (filter->func == filterExecuteImplVector);
+  flttSimdCheckFilter(filter, pBlock, expected);
+  filterFreeInfo(filter);
+  return vector;
+}
+
+class filterSimdTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    char sse42 = 0, avx = 0, fma = 0;
+    taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma, &tsAVX512Enable);
+  }
+};
+
+}  // namespace
+
+TEST_F(filterSimdTest, compare_ops) {
+  const EOperatorType optrs[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_THAN, OP_TYPE_LOWER_EQUAL,
+                                 OP_TYPE_EQUAL,        OP_TYPE_NOT_EQUAL,     OP_TYPE_IS_NULL,    OP_TYPE_IS_NOT_NULL};
+
+  for (int32_t type : flttSimdTypes) {
+    for (int32_t rowNum : flttSimdRowNums) {
+      for (int32_t hasNull = 0; hasNull < 2; ++hasNull) {
+        SFltSimdCol  col = flttSimdMakeCol(type, rowNum, hasNull);
+        SSDataBlock *pBlock = createDataBlock();
+        flttSimdAppendCol(pBlock, col);
+
+        for (EOperatorType optr : optrs) {
+          // a value of the column, so that equal matches some rows
+          int64_t value = flttSimdGetVal(col, flttSimdRand() % rowNum);
+
+          std::vector<int8_t> expected;
+          for (int32_t i = 0; i < rowNum; ++i) {
+            expected.push_back(flttSimdCompare(col, i, optr, value));
+          }
+
+          // not equal is evaluated in scalar mode, see not_equal_unit
+          SNode *pCond = flttSimdMakeUnit(0, type, optr, value);
+          ASSERT_EQ(flttSimdCheck(pCond, pBlock, expected), optr != OP_TYPE_NOT_EQUAL)
+              << "type:" << type << " optr:" << optr;
+          nodesDestroyNode(pCond);
+        }
+
+        blockDataDestroy(pBlock);
+      }
+    }
+  }
+}
+
+TEST_F(filterSimdTest, not_equal_unit) {
+  // filterInitFromNode sends not equal to scalar mode, so the unit is compiled from an equal unit
+  for (int32_t type : flttSimdTypes) {
+    for (int32_t rowNum : flttSimdRowNums) {
+      SFltSimdCol  col = flttSimdMakeCol(type, rowNum, true);
+      SSDataBlock *pBlock = createDataBlock();
+      flttSimdAppendCol(pBlock, col);
+
+      int64_t             value = flttSimdGetVal(col, flttSimdRand() % rowNum);
+      std::vector<int8_t> expected;
+      for (int32_t i = 0; i < rowNum; ++i) {
+        expected.push_back(flttSimdCompare(col, i, OP_TYPE_NOT_EQUAL, value));
+      }
+
+      SNode       *pCond = flttSimdMakeUnit(0, type, OP_TYPE_EQUAL, value);
+      SFilterInfo *filter = flttSimdInit(pCond, pBlock);
+      ASSERT_NE(filter, nullptr);
+      ASSERT_EQ(filter->unitNum, 1);
+      ASSERT_EQ(filter->cunits[0].rfunc, -1);
+
+      filter->cunits[0].optr = OP_TYPE_NOT_EQUAL;
+      ASSERT_EQ(filterCompileVectorUnits(filter), 0);
+      ASSERT_NE(filter->vunits, nullptr);
+      filter->func = filterExecuteImplVector;
+      flttSimdCheckFilter(filter, pBlock, expected);
+
+      filterFreeInfo(filter);
+      nodesDestroyNode(pCond);
+      blockDataDestroy(pBlock);
+    }
+  }
+}
+
+TEST_F(filterSimdTest, type_bounds) {
+  // the exclusive bounds at the min or the max of the type leave an empty range
+  const EOperatorType optrs[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_THAN, OP_TYPE_LOWER_EQUAL,
+                                 OP_TYPE_EQUAL,        OP_TYPE_NOT_EQUAL};
+
+  for (int32_t type : flttSimdTypes) {
+    SFltSimdCol  col = flttSimdMakeCol(type, 67, true);
+    SSDataBlock *pBlock = createDataBlock();
+    flttSimdAppendCol(pBlock, col);
+
+    int64_t min = 0, max = 0;
+    flttSimdGetRange(type, &min, &max);
+    for (int64_t value : {min, max}) {
+      for (EOperatorType optr : optrs) {
+        std::vector<int8_t> expected;
+        for (int32_t i = 0; i < 67; ++i) {
+          expected.push_back(flttSimdCompare(col, i, optr, value));
+        }
+
+        SNode *pCond = flttSimdMakeUnit(0, type, optr, value);
+        flttSimdCheck(pCond, pBlock, expected);
+        nodesDestroyNode(pCond);
+      }
+    }
+
+    // the range merged from col > min and col <= max, or from col > min or col >= max, still excludes min
+    std::vector<int8_t> andExpected, orExpected;
+    for (int32_t i = 0; i < 67; ++i) {
+      bool gtMin = flttSimdCompare(col, i, OP_TYPE_GREATER_THAN, min);
+      andExpected.push_back(gtMin && flttSimdCompare(col, i, OP_TYPE_LOWER_EQUAL, max));
+      orExpected.push_back(gtMin || flttSimdCompare(col, i, OP_TYPE_GREATER_EQUAL, max));
+    }
+
+    SNode *pCond = flttSimdMakeLogic(LOGIC_COND_TYPE_AND, flttSimdMakeUnit(0, type, OP_TYPE_GREATER_THAN, min),
+                                     flttSimdMakeUnit(0, type, OP_TYPE_LOWER_EQUAL, max));
+    flttSimdCheck(pCond, pBlock, andExpected);
+    nodesDestroyNode(pCond);
+
+    pCond = flttSimdMakeLogic(LOGIC_COND_TYPE_OR, flttSimdMakeUnit(0, type, OP_TYPE_GREATER_THAN, min),
+                              flttSimdMakeUnit(0, type, OP_TYPE_GREATER_EQUAL, max));
+    flttSimdCheck(pCond, pBlock, orExpected);
+    nodesDestroyNode(pCond);
+
+    blockDataDestroy(pBlock);
+  }
+}
+
+TEST_F(filterSimdTest, range_and) {
+  for (int32_t type : flttSimdTypes) {
+    for (int32_t rowNum : flttSimdRowNums) {
+      SFltSimdCol  col = flttSimdMakeCol(type, rowNum, true);
+      SSDataBlock *pBlock = createDataBlock();
+      flttSimdAppendCol(pBlock, col);
+
+      int64_t v1 = flttSimdGetVal(col, flttSimdRand() % rowNum);
+      int64_t v2 = flttSimdGetVal(col, flttSimdRand() % rowNum);
+      bool    less = flttSimdIsUnsigned(type) ? ((uint64_t)v1 < (uint64_t)v2) : (v1 < v2);
+      int64_t lo = less ? v1 : v2, hi = less ? v2 : v1;
+
+      // col > lo and col <= hi, the units of a column are merged into a range
+      std::vector<int8_t> expected;
+      for (int32_t i = 0; i < rowNum; ++i) {
+        expected.push_back(flttSimdCompare(col, i, OP_TYPE_GREATER_THAN, lo) &&
+                           flttSimdCompare(col, i, OP_TYPE_LOWER_EQUAL, hi));
+      }
+
+      SNode *pCond = flttSimdMakeLogic(LOGIC_COND_TYPE_AND, flttSimdMakeUnit(0, type, OP_TYPE_GREATER_THAN, lo),
+                                       flttSimdMakeUnit(0, type, OP_TYPE_LOWER_EQUAL, hi));
+      flttSimdCheck(pCond, pBlock, expected);
+      nodesDestroyNode(pCond);
+
+      blockDataDestroy(pBlock);
+    }
+  }
+}
+
+TEST_F(filterSimdTest, or_tree) {
+  for (int32_t rowNum : flttSimdRowNums) {
+    SFltSimdCol  col0 = flttSimdMakeCol(TSDB_DATA_TYPE_SMALLINT, rowNum, true);
+    SFltSimdCol  col1 = flttSimdMakeCol(TSDB_DATA_TYPE_UINT, rowNum, true);
+    SFltSimdCol  col2 = flttSimdMakeCol(TSDB_DATA_TYPE_BIGINT, rowNum, true);
+    SSDataBlock *pBlock = createDataBlock();
+    flttSimdAppendCol(pBlock, col0);
+    flttSimdAppendCol(pBlock, col1);
+    flttSimdAppendCol(pBlock, col2);
+
+    int64_t v0 = flttSimdGetVal(col0, flttSimdRand() % rowNum);
+    int64_t v1 = flttSimdGetVal(col1, flttSimdRand() % rowNum);
+    int64_t v2 = flttSimdGetVal(col2, flttSimdRand() % rowNum);
+
+    // (col0 >= v0 and col1 < v1) or col2 is null or (col2 > v2 and col0 is not null)
+    std::vector<int8_t> expected;
+    for (int32_t i = 0; i < rowNum; ++i) {
+      expected.push_back(
+          (flttSimdCompare(col0, i, OP_TYPE_GREATER_EQUAL, v0) && flttSimdCompare(col1, i, OP_TYPE_LOWER_THAN, v1)) ||
+          flttSimdCompare(col2, i, OP_TYPE_IS_NULL, 0) ||
+          (flttSimdCompare(col2, i, OP_TYPE_GREATER_THAN, v2) && flttSimdCompare(col0, i, OP_TYPE_IS_NOT_NULL, 0)));
+    }
+
+    SNode *pGroup1 = flttSimdMakeLogic(LOGIC_COND_TYPE_AND, flttSimdMakeUnit(0, col0.type, OP_TYPE_GREATER_EQUAL, v0),
+                                       flttSimdMakeUnit(1, col1.type, OP_TYPE_LOWER_THAN, v1));
+    SNode *pGroup3 = flttSimdMakeLogic(LOGIC_COND_TYPE_AND, flttSimdMakeUnit(2, col2.type, OP_TYPE_GREATER_THAN, v2),
+                                       flttSimdMakeUnit(0, col0.type, OP_TYPE_IS_NOT_NULL, 0));
+    SNode *pCond = flttSimdMakeLogic(
+        LOGIC_COND_TYPE_OR, pGroup1,
+        flttSimdMakeLogic(LOGIC_COND_TYPE_OR, flttSimdMakeUnit(2, col2.type, OP_TYPE_IS_NULL, 0), pGroup3));
+    ASSERT_TRUE(flttSimdCheck(pCond, pBlock, expected));
+    nodesDestroyNode(pCond);
+
+    blockDataDestroy(pBlock);
+  }
+}
+
 template <class SignedT, class UnsignedT>
 int32_t compareSignedWithUnsigned(SignedT l, UnsignedT r) {
   if (l < 0) return -1;
@@ -1992,6 +1992,81 @@ TEST(columnTest, greater_and_lower) {
   nodesDestroyNode(logicNode);
 }
 
+TEST(columnTest, compiled_arith_same_as_calculate) {
+  // (a * 1.8 + 32) - b / 1000 % c, where a has a null row, b and c have zeros
+  SNode       *pa = NULL, *pb = NULL, *pc = NULL, *pv = NULL, *opNode = NULL, *tmpNode = NULL;
+  int32_t      a[6] = {0, 10, -40, 100, 37, 1};
+  int64_t      b[6] = {1000, 0, 2500, -4000, 7, 3};
+  float        c[6] = {3, 2, 0, 1.5f, -2, 7};
+  double       v1 = 1.8, v3 = 1000;
+  int32_t      v2 = 32;
+  SSDataBlock *src = NULL;
+  int32_t      rowNum = sizeof(a) / sizeof(a[0]);
+  scltMakeColumnNode(&pa, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, a);
+  scltMakeColumnNode(&pb, &src, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), rowNum, b);
+  scltMakeColumnNode(&pc, &src, TSDB_DATA_TYPE_FLOAT, sizeof(float), rowNum, c);
+  colDataSetNULL((SColumnInfoData *)taosArrayGet(src->pDataBlock, ((SColumnNode *)pa)->slotId), 3);
+
+  scltMakeValueNode(&pv, TSDB_DATA_TYPE_DOUBLE, &v1);
+  scltMakeOpNode(&tmpNode, OP_TYPE_MULTI, TSDB_DATA_TYPE_DOUBLE, pa, pv);
+  scltMakeValueNode(&pv, TSDB_DATA_TYPE_INT, &v2);
+  scltMakeOpNode(&opNode, OP_TYPE_ADD, TSDB_DATA_TYPE_DOUBLE, tmpNode, pv);
+  scltMakeValueNode(&pv, TSDB_DATA_TYPE_DOUBLE, &v3);
+  scltMakeOpNode(&tmpNode, OP_TYPE_DIV, TSDB_DATA_TYPE_DOUBLE, pb, pv);
+  scltMakeOpNode(&tmpNode, OP_TYPE_REM, TSDB_DATA_TYPE_DOUBLE, tmpNode, pc);
+  scltMakeOpNode(&opNode, OP_TYPE_SUB, TSDB_DATA_TYPE_DOUBLE, opNode, tmpNode);
+
+  SScalarProgram *pProgram = NULL;
+  ASSERT_EQ(scalarCompile(opNode, &pProgram), 0);
+  ASSERT_NE(pProgram, nullptr);
+
+  SArray *blockList = taosArrayInit(1, POINTER_BYTES);
+  taosArrayPush(blockList, &src);
+
+  SColumnInfoData expect = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 1);
+  SScalarParam    dest = {.columnData = &expect};
+  ASSERT_EQ(scalarCalculate(opNode, blockList, &dest), 0);
+  ASSERT_EQ(dest.numOfRows, rowNum);
+
+  // run twice to reuse the registers, and write behind the rows of the previous run
+  SColumnInfoData column = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, sizeof(double), 1);
+  colInfoDataEnsureCapacity(&column, rowNum * 2, true);
+  for (int32_t r = 0; r < 2; ++r) {
+    int32_t numOfRows = 0;
+    ASSERT_EQ(scalarExecProgram(pProgram, blockList, &column, r * rowNum, &numOfRows), 0);
+    ASSERT_EQ(numOfRows, rowNum);
+
+    for (int32_t i = 0; i < rowNum; ++i) {
+      ASSERT_EQ(colDataIsNull_f(column.nullbitmap, r * rowNum + i), colDataIsNull_f(expect.nullbitmap, i));
+      if (!colDataIsNull_f(expect.nullbitmap, i)) {
+        ASSERT_DOUBLE_EQ(*(double *)colDataGetData(&column, r * rowNum + i), *(double *)colDataGetData(&expect, i));
+      }
+    }
+  }
+
+  // the null row of a, and the zero divisor of the remainder
+  ASSERT_TRUE(colDataIsNull_f(column.nullbitmap, 3));
+  ASSERT_TRUE(colDataIsNull_f(column.nullbitmap, 2));
+  ASSERT_FALSE(colDataIsNull_f(column.nullbitmap, 1));
+
+  // the expressions of other types are not compiled
+  SNode *pTs = NULL;
+  int64_t ts[6] = {0};
+  scltMakeColumnNode(&pTs, &src, TSDB_DATA_TYPE_TIMESTAMP, sizeof(int64_t), rowNum, ts);
+  scltMakeValueNode(&pv, TSDB_DATA_TYPE_INT, &v2);
+  scltMakeOpNode(&tmpNode, OP_TYPE_ADD, TSDB_DATA_TYPE_TIMESTAMP, pTs, pv);
+  SScalarProgram *pTsProgram = NULL;
+  ASSERT_EQ(scalarCompile(tmpNode, &pTsProgram), 0);
+  ASSERT_EQ(pTsProgram, nullptr);
+
+  scalarFreeProgram(pProgram);
+  colDataDestroy(&column);
+  colDataDestroy(&expect);
+  taosArrayDestroyEx(blockList, scltFreeDataBlock);
+  nodesDestroyNode(opNode);
+  nodesDestroyNode(tmpNode);
+}
+
 void scltMakeDataBlock(SScalarParam **pInput, int32_t type, void *pVal, int32_t num, bool setVal) {
   SScalarParam *input = (SScalarParam *)taosMemoryCalloc(1, sizeof(SScalarParam));
   int32_t       bytes;
@@ -89,6 +89,7 @@ extern "C" {
 //
 
 int32_t syncNodeOnAppendEntries(SSyncNode* ths, const SRpcMsg* pMsg);
+int32_t syncNodeOnAppendEntriesBatch(SSyncNode* ths, const SRpcMsg* pMsg);
 
 #ifdef __cplusplus
 }
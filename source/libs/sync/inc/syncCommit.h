@@ -52,6 +52,7 @@ bool syncNodeAgreedUpon(SSyncNode* pNode, SyncIndex index);
 
 int64_t syncNodeUpdateCommitIndex(SSyncNode* ths, SyncIndex commitIndex);
 int64_t syncNodeCheckCommitIndex(SSyncNode* ths, SyncIndex indexLikely);
+int64_t syncNodeCheckAgreedCommitIndex(SSyncNode* ths, SyncIndex indexLikely);
 
 #ifdef __cplusplus
 }
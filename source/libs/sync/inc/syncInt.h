@@ -224,6 +224,10 @@ typedef struct SSyncNode {
   int32_t hbrSlowNum;
   int32_t tmrRoutineNum;
 
+  // append entries sent to peers, guarded by the mutex of the log buffer
+  SSyncReplStat replStat;
+  bool          replDeferred;  // replication held back by a group commit
+
   bool isStart;
 
 } SSyncNode;
@@ -236,6 +240,7 @@ void       syncNodeClose(SSyncNode* pSyncNode);
 void       syncNodePreClose(SSyncNode* pSyncNode);
 void       syncNodePostClose(SSyncNode* pSyncNode);
 int32_t    syncNodePropose(SSyncNode* pSyncNode, SRpcMsg* pMsg, bool isWeak, int64_t* seq);
+int32_t    syncNodeEndGroupCommit(SSyncNode* pSyncNode);
 int32_t    syncNodeRestore(SSyncNode* pSyncNode);
 void       syncHbTimerDataFree(SSyncHbTimerData* pData);
 
@@ -248,6 +253,7 @@ int32_t syncNodeOnClientRequest(SSyncNode* ths, SRpcMsg* pMsg, SyncIndex* pRetIn
 int32_t syncNodeOnRequestVote(SSyncNode* pNode, const SRpcMsg* pMsg);
 int32_t syncNodeOnRequestVoteReply(SSyncNode* pNode, const SRpcMsg* pMsg);
 int32_t syncNodeOnAppendEntries(SSyncNode* pNode, const SRpcMsg* pMsg);
+int32_t syncNodeOnAppendEntriesBatch(SSyncNode* pNode, const SRpcMsg* pMsg);
 int32_t syncNodeOnAppendEntriesReply(SSyncNode* ths, const SRpcMsg* pMsg);
 int32_t syncNodeOnSnapshot(SSyncNode* ths, SRpcMsg* pMsg);
 int32_t syncNodeOnSnapshotRsp(SSyncNode* ths, SRpcMsg* pMsg);
@@ -309,6 +315,7 @@ int32_t   syncNodeGetPreIndexTerm(SSyncNode* pSyncNode, SyncIndex index, SyncInd
 
 int32_t syncNodeDoCommit(SSyncNode* ths, SyncIndex beginIndex, SyncIndex endIndex, uint64_t flag);
 int32_t syncNodeFollowerCommit(SSyncNode* ths, SyncIndex newCommitIndex);
+int32_t syncNodeAppend(SSyncNode* ths, SSyncRaftEntry* pEntry);
 int32_t syncNodePreCommit(SSyncNode* ths, SSyncRaftEntry* pEntry, int32_t code);
 
 bool                 syncNodeInRaftGroup(SSyncNode* ths, SRaftId* pRaftId);
@@ -262,6 +262,12 @@ int32_t syncBuildAppendEntries(SRpcMsg* pMsg, int32_t dataLen, int32_t vgId);
 int32_t syncBuildAppendEntriesReply(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pEntry, SyncTerm prevLogTerm,
                                             SRpcMsg* pRpcMsg);
+int32_t syncBuildAppendEntriesBatch(SSyncNode* pNode, SSyncRaftEntry** ppEntries, int32_t numOfEntries,
+                                    SyncTerm prevLogTerm, SRpcMsg* pRpcMsg);
+// the entries of a batch must be complete, consecutive from prevLogIndex + 1, with terms not going down and not
+// beyond the term of the msg
+int32_t syncCheckAppendEntriesBatch(const SyncAppendEntries* pMsg, int32_t contLen, int32_t* pNumOfEntries,
+                                    SyncIndex* pLastIndex);
 int32_t syncBuildHeartbeat(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildHeartbeatReply(SRpcMsg* pMsg, int32_t vgId);
 int32_t syncBuildPreSnapshot(SRpcMsg* pMsg, int32_t vgId);
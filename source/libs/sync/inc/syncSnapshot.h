@@ -30,6 +30,30 @@ extern "C" {
 
 #define SYNC_SNAPSHOT_RETRY_MS 5000
 
+#define SYNC_SNAP_VERIFY_NONE    0
+#define SYNC_SNAP_VERIFY_RUNNING 1
+#define SYNC_SNAP_VERIFY_DONE    2
+
+#define SYNC_SNAP_CMPR_NONE 0
+#define SYNC_SNAP_CMPR_LZ4  1
+
+// the head of a data block of payload type TDMT_SYNC_SNAPSHOT_BLOCK, the block data follows it
+typedef struct SSyncSnapBlockHead {
+  int8_t   cmprAlg;
+  int8_t   reserved[3];
+  int32_t  rawLen;
+  uint32_t checksum;  // crc32c of the raw data of all the blocks up to this one
+} SSyncSnapBlockHead;
+
+// the last block a receiver has written, offered in the prep rsp and accepted in the begin msg of a resumed transfer
+typedef struct SSyncSnapCheckpoint {
+  int32_t   seq;
+  uint32_t  checksum;
+  SyncIndex beginIndex;
+  SyncIndex lastIndex;
+  SyncTerm  lastTerm;
+} SSyncSnapCheckpoint;
+
 typedef struct SSyncSnapBuffer {
   void         *entries[TSDB_SYNC_SNAP_BUFFER_SIZE];
   int64_t       start;
@@ -50,7 +74,10 @@ typedef struct SyncSnapBlock {
   int32_t blockLen;
 } SyncSnapBlock;
 
-void syncSnapBlockDestroy(void *ptr);
+void    syncSnapBlockDestroy(void *ptr);
+int32_t syncSnapBlockEncode(SyncSnapBlock *pBlk, uint32_t checksum);
+int32_t syncSnapBlockDecode(SyncSnapshotSend *pMsg, uint32_t *pChecksum, char **ppBuf, char **ppData,
+                            int32_t *pDataLen);
 
 typedef struct SSyncSnapshotSender {
   int8_t         start;
@@ -66,6 +93,23 @@ typedef struct SSyncSnapshotSender {
   int64_t        lastSendTime;
   bool           finish;
 
+  // stream of encoded blocks, if the receiver supports it
+  bool                encode;
+  uint32_t            checksum;
+  SSyncSnapCheckpoint resume;
+  int32_t             skipSeq;
+
+  // the checkpoint is verified by a thread of its own, the sync thread sends begin once it is done
+  TdThread verifyThread;
+  int8_t   verifyState;
+  int8_t   verifyStop;
+  int32_t  verifyCode;
+
+  // throughput cap
+  int64_t rateTokens;
+  int64_t rateRefillMs;
+  bool    throttled;
+
   // ring buffer for ack
   SSyncSnapBuffer *pSndBuf;
 
@@ -80,6 +124,7 @@ bool                 snapshotSenderIsStart(SSyncSnapshotSender *pSender);
 int32_t              snapshotSenderStart(SSyncSnapshotSender *pSender);
 void                 snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish);
 int32_t              snapshotReSend(SSyncSnapshotSender *pSender);
+int32_t              snapshotSenderContinue(SSyncSnapshotSender *pSender);
 
 typedef struct SSyncSnapshotReceiver {
   // update when prep snapshot
@@ -94,6 +139,11 @@ typedef struct SSyncSnapshotReceiver {
   SSnapshotParam snapshotParam;
   SSnapshot      snapshot;
 
+  // stream of encoded blocks, the writer is kept to resume from ckpt when a transfer restarts
+  bool                encode;
+  uint32_t            checksum;
+  SSyncSnapCheckpoint ckpt;
+
   // buffer
   SSyncSnapBuffer *pRcvBuf;
 
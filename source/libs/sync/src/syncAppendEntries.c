@@ -194,3 +194,124 @@ _IGNORE:
   syncEntryDestroy(pEntry);
   return 0;
 }
+
+// the entries of a batch are accepted one by one and persisted together by a single proceed, so that they share one
+// wal fsync. The reply is about the last entry, or about the first entry that is not accepted.
+int32_t syncNodeOnAppendEntriesBatch(SSyncNode* ths, const SRpcMsg* pRpcMsg) {
+  SyncAppendEntries* pMsg = pRpcMsg->pCont;
+  SRpcMsg            rpcRsp = {0};
+  bool               accepted = false;
+  SSyncRaftEntry*    pEntry = NULL;
+  bool               resetElect = false;
+
+  // if already drop replica, do not process
+  if (!syncNodeInRaftGroup(ths, &(pMsg->srcId))) {
+    syncLogRecvAppendEntries(ths, pMsg, "not in my config");
+    goto _IGNORE;
+  }
+
+  int32_t code = syncBuildAppendEntriesReply(&rpcRsp, ths->vgId);
+  if (code != 0) {
+    syncLogRecvAppendEntries(ths, pMsg, "build rsp error");
+    goto _IGNORE;
+  }
+
+  SyncAppendEntriesReply* pReply = rpcRsp.pCont;
+  // prepare response msg
+  pReply->srcId = ths->myRaftId;
+  pReply->destId = pMsg->srcId;
+  pReply->term = raftStoreGetTerm(ths);
+  pReply->success = false;
+  pReply->matchIndex = SYNC_INDEX_INVALID;
+  pReply->lastSendIndex = pMsg->prevLogIndex + 1;
+  pReply->startTime = ths->startTime;
+
+  if (pMsg->term < raftStoreGetTerm(ths)) {
+    goto _SEND_RESPONSE;
+  }
+
+  if (pMsg->term > raftStoreGetTerm(ths)) {
+    pReply->term = pMsg->term;
+  }
+
+  if (ths->raftCfg.cfg.nodeInfo[ths->raftCfg.cfg.myIndex].nodeRole != TAOS_SYNC_ROLE_LEARNER) {
+    syncNodeStepDown(ths, pMsg->term);
+    resetElect = true;
+  }
+
+  // validate the entries before accepting any of them
+  int32_t   numOfEntries = 0;
+  SyncIndex lastIndex = SYNC_INDEX_INVALID;
+  if (syncCheckAppendEntriesBatch(pMsg, pRpcMsg->contLen, &numOfEntries, &lastIndex) < 0) {
+    goto _IGNORE;
+  }
+
+  sTrace("vgId:%d, recv append entries batch msg. index:%" PRId64 "..%" PRId64 ", term:%" PRId64
+         ", preLogIndex:%" PRId64 ", prevLogTerm:%" PRId64 " commitIndex:%" PRId64,
+         pMsg->vgId, pMsg->prevLogIndex + 1, lastIndex, pMsg->term, pMsg->prevLogIndex, pMsg->prevLogTerm,
+         pMsg->commitIndex);
+
+  if (ths->fsmState == SYNC_FSM_STATE_INCOMPLETE) {
+    pReply->fsmState = ths->fsmState;
+    sWarn("vgId:%d, unable to accept, due to incomplete fsm state. index:%" PRId64, ths->vgId, pMsg->prevLogIndex + 1);
+    goto _SEND_RESPONSE;
+  }
+
+  // accept
+  SyncTerm prevTerm = pMsg->prevLogTerm;
+  SyncTerm matchTerm = pMsg->prevLogTerm;
+  char*    pData = pMsg->data;
+  accepted = true;
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    SSyncRaftEntry head;
+    (void)memcpy(&head, pData, sizeof(SSyncRaftEntry));
+    pReply->lastSendIndex = head.index;
+
+    // the match term only moves on proceed, catch up with it when the term changes within the batch
+    if (prevTerm != matchTerm) {
+      (void)syncLogBufferProceed(ths->pLogBuf, ths, NULL, "OnAppnBatch");
+      matchTerm = prevTerm;
+    }
+
+    pEntry = taosMemoryMalloc(head.bytes);
+    if (pEntry == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      accepted = false;
+      break;
+    }
+    (void)memcpy(pEntry, pData, head.bytes);
+    pData += head.bytes;
+
+    if (syncLogBufferAccept(ths->pLogBuf, ths, pEntry, prevTerm) < 0) {
+      accepted = false;
+      break;
+    }
+    prevTerm = head.term;
+  }
+
+_SEND_RESPONSE:
+  pEntry = NULL;
+  pReply->matchIndex = syncLogBufferProceed(ths->pLogBuf, ths, &pReply->lastMatchTerm, "OnAppnBatch");
+  bool matched = (pReply->matchIndex >= pReply->lastSendIndex);
+  if (accepted && matched) {
+    pReply->success = true;
+    // update commit index only after matching
+    (void)syncNodeUpdateCommitIndex(ths, TMIN(pMsg->commitIndex, pReply->lastSendIndex));
+  }
+
+  // ack, i.e. send response
+  (void)syncNodeSendMsgById(&pReply->destId, ths, &rpcRsp);
+
+  // commit index, i.e. leader notice me
+  if (ths->fsmState != SYNC_FSM_STATE_INCOMPLETE && syncLogBufferCommit(ths->pLogBuf, ths, ths->commitIndex) < 0) {
+    sError("vgId:%d, failed to commit raft fsm log since %s.", ths->vgId, terrstr());
+  }
+
+  if (resetElect) syncNodeResetElectTimer(ths);
+  return 0;
+
+_IGNORE:
+  rpcFreeCont(rpcRsp.pCont);
+  syncEntryDestroy(pEntry);
+  return 0;
+}
@@ -88,3 +88,16 @@ int64_t syncNodeCheckCommitIndex(SSyncNode* ths, SyncIndex indexLikely) {
   }
   return ths->commitIndex;
 }
+
+int64_t syncNodeCheckAgreedCommitIndex(SSyncNode* ths, SyncIndex indexLikely) {
+  // the highest index up to indexLikely that a quorum has persisted is one of the match indexes of the voters
+  SyncIndex agreedIndex = ths->commitIndex;
+  for (int i = 0; i < ths->totalReplicaNum; i++) {
+    if (ths->raftCfg.cfg.nodeInfo[i].nodeRole != TAOS_SYNC_ROLE_VOTER) continue;
+    SyncIndex index = TMIN(ths->pMatchIndex->index[i], indexLikely);
+    if (index > agreedIndex && syncNodeAgreedUpon(ths, index)) {
+      agreedIndex = index;
+    }
+  }
+  return syncNodeCheckCommitIndex(ths, agreedIndex);
+}
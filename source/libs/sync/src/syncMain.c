@@ -219,6 +219,9 @@ int32_t syncProcessMsg(int64_t rid, SRpcMsg* pMsg) {
     case TDMT_SYNC_APPEND_ENTRIES:
       code = syncNodeOnAppendEntries(pSyncNode, pMsg);
       break;
+    case TDMT_SYNC_APPEND_ENTRIES_BATCH:
+      code = syncNodeOnAppendEntriesBatch(pSyncNode, pMsg);
+      break;
     case TDMT_SYNC_APPEND_ENTRIES_REPLY:
       code = syncNodeOnAppendEntriesReply(pSyncNode, pMsg);
       break;
@@ -557,6 +560,43 @@ SSyncState syncGetState(int64_t rid) {
   return state;
 }
 
+void syncGetReplStat(int64_t rid, SSyncReplStat* pStat) {
+  memset(pStat, 0, sizeof(*pStat));
+
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return;
+
+  SSyncLogBuffer* pBuf = pSyncNode->pLogBuf;
+  taosThreadMutexLock(&pBuf->mutex);
+  *pStat = pSyncNode->replStat;
+  pStat->maxLag = 0;
+  if (pSyncNode->state == TAOS_SYNC_STATE_LEADER) {
+    for (int32_t i = 0; i < pSyncNode->totalReplicaNum; i++) {
+      SSyncLogReplMgr* pMgr = pSyncNode->logReplMgrs[i];
+      if (pMgr == NULL || syncUtilSameId(&pSyncNode->replicasId[i], &pSyncNode->myRaftId)) {
+        continue;
+      }
+      pStat->maxLag = TMAX(pStat->maxLag, pBuf->matchIndex - pMgr->matchIndex);
+    }
+  }
+  taosThreadMutexUnlock(&pBuf->mutex);
+
+  syncNodeRelease(pSyncNode);
+}
+
+void syncResetReplStat(int64_t rid, const SSyncReplStat* pStat) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return;
+
+  SSyncLogBuffer* pBuf = pSyncNode->pLogBuf;
+  taosThreadMutexLock(&pBuf->mutex);
+  pSyncNode->replStat.numOfMsgs -= pStat->numOfMsgs;
+  pSyncNode->replStat.numOfEntries -= pStat->numOfEntries;
+  taosThreadMutexUnlock(&pBuf->mutex);
+
+  syncNodeRelease(pSyncNode);
+}
+
 SyncIndex syncNodeGetSnapshotConfigIndex(SSyncNode* pSyncNode, SyncIndex snapshotLastApplyIndex) {
   ASSERT(pSyncNode->raftCfg.configIndexCount >= 1);
   SyncIndex lastIndex = (pSyncNode->raftCfg.configIndexArr)[0];
@@ -607,6 +647,82 @@ int32_t syncPropose(int64_t rid, SRpcMsg* pMsg, bool isWeak, int64_t* seq) {
   return ret;
 }
 
+bool syncBeginGroupCommit(int64_t rid) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) return false;
+
+  bool opened = walBeginGroup(pSyncNode->pWal);
+
+  // multi replicas, hold back the replication to send the entries of the group in batches
+  if (pSyncNode->replicaNum > 1 && pSyncNode->state == TAOS_SYNC_STATE_LEADER && tsSyncLogReplBatchBytes > 0) {
+    taosThreadMutexLock(&pSyncNode->pLogBuf->mutex);
+    pSyncNode->replDeferred = true;
+    taosThreadMutexUnlock(&pSyncNode->pLogBuf->mutex);
+    opened = true;
+  }
+
+  syncNodeRelease(pSyncNode);
+  return opened;
+}
+
+int32_t syncEndGroupCommit(int64_t rid) {
+  SSyncNode* pSyncNode = syncNodeAcquire(rid);
+  if (pSyncNode == NULL) {
+    sError("sync end group commit error");
+    return -1;
+  }
+
+  int32_t ret = syncNodeEndGroupCommit(pSyncNode);
+  syncNodeRelease(pSyncNode);
+  return ret;
+}
+
+int32_t syncNodeEndGroupCommit(SSyncNode* pSyncNode) {
+  // send the group to the peers before it is fsynced locally
+  taosThreadMutexLock(&pSyncNode->pLogBuf->mutex);
+  if (pSyncNode->replDeferred) {
+    pSyncNode->replDeferred = false;
+    (void)syncNodeReplicateWithoutLock(pSyncNode);
+  }
+  taosThreadMutexUnlock(&pSyncNode->pLogBuf->mutex);
+
+  // the entries of a failed fsync stay pending and are not acked, a later fsync releases them
+  int32_t code = walEndGroup(pSyncNode->pWal);
+  if (code != 0) {
+    sError("vgId:%d, failed to end group commit since %s", pSyncNode->vgId, terrstr());
+  }
+
+  // my copy of the group counts toward the quorum only once it is fsynced
+  taosThreadMutexLock(&pSyncNode->pLogBuf->mutex);
+  SyncIndex matchIndex = TMIN(pSyncNode->pLogBuf->matchIndex, walGetSyncedVer(pSyncNode->pWal));
+  syncIndexMgrSetIndex(pSyncNode->pMatchIndex, &pSyncNode->myRaftId, matchIndex);
+  taosThreadMutexUnlock(&pSyncNode->pLogBuf->mutex);
+
+  if (code != 0) {
+    return -1;
+  }
+
+  if (pSyncNode->state != TAOS_SYNC_STATE_LEADER) {
+    return 0;
+  }
+
+  // commit the entries held back while the group was pending, with multi replicas the ones acked by the peers before
+  // the fsync
+  if (pSyncNode->replicaNum == 1) {
+    (void)syncNodeUpdateCommitIndex(pSyncNode, matchIndex);
+  } else {
+    (void)syncNodeCheckAgreedCommitIndex(pSyncNode, matchIndex);
+  }
+
+  if (pSyncNode->fsmState != SYNC_FSM_STATE_INCOMPLETE &&
+      syncLogBufferCommit(pSyncNode->pLogBuf, pSyncNode, pSyncNode->commitIndex) < 0) {
+    sError("vgId:%d, failed to commit until commitIndex:%" PRId64 "", pSyncNode->vgId, pSyncNode->commitIndex);
+    return -1;
+  }
+
+  return 0;
+}
+
 int32_t syncCheckMember(int64_t rid) {
   SSyncNode* pSyncNode = syncNodeAcquire(rid);
   if (pSyncNode == NULL) {
@@ -2900,12 +3016,23 @@ _out:;
          ths->vgId, pEntry->index, pEntry->term, ths->pLogBuf->startIndex, ths->pLogBuf->commitIndex,
          ths->pLogBuf->matchIndex, ths->pLogBuf->endIndex);
 
-  // multi replica
+  // multi replica, commit the entries the peers acked while my copy was fsynced
   if (ths->replicaNum > 1) {
+    if (ths->state == TAOS_SYNC_STATE_LEADER && !walGroupPending(ths->pWal)) {
+      SyncIndex commitIndex = syncNodeCheckAgreedCommitIndex(ths, matchIndex);
+      if (ths->fsmState != SYNC_FSM_STATE_INCOMPLETE && syncLogBufferCommit(ths->pLogBuf, ths, commitIndex) < 0) {
+        sError("vgId:%d, failed to commit until commitIndex:%" PRId64 "", ths->vgId, commitIndex);
+        code = -1;
+      }
+    }
+    return code;
+  }
+
+  // single replica, the commit is released by syncEndGroupCommit once the group is durable
+  if (walGroupPending(ths->pWal)) {
     return code;
   }
 
-  // single replica
   (void)syncNodeUpdateCommitIndex(ths, matchIndex);
 
   if (ths->fsmState != SYNC_FSM_STATE_INCOMPLETE && syncLogBufferCommit(ths->pLogBuf, ths, ths->commitIndex) < 0) {
@@ -17,6 +17,7 @@
 #include "syncMessage.h"
 #include "syncRaftEntry.h"
 #include "syncRaftStore.h"
+#include "syncUtil.h"
 
 int32_t syncBuildTimeout(SRpcMsg* pMsg, ESyncTimeoutType timeoutType, uint64_t logicClock, int32_t timerMS,
                          SSyncNode* pNode) {
@@ -182,6 +183,101 @@ int32_t syncBuildAppendEntriesFromRaftEntry(SSyncNode* pNode, SSyncRaftEntry* pE
   return 0;
 }
 
+int32_t syncBuildAppendEntriesBatch(SSyncNode* pNode, SSyncRaftEntry** ppEntries, int32_t numOfEntries,
+                                    SyncTerm prevLogTerm, SRpcMsg* pRpcMsg) {
+  uint32_t dataLen = 0;
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    dataLen += ppEntries[i]->bytes;
+  }
+
+  uint32_t bytes = sizeof(SyncAppendEntries) + dataLen;
+  pRpcMsg->contLen = bytes;
+  pRpcMsg->pCont = rpcMallocCont(pRpcMsg->contLen);
+  if (pRpcMsg->pCont == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  SyncAppendEntries* pMsg = pRpcMsg->pCont;
+  pMsg->bytes = pRpcMsg->contLen;
+  pMsg->msgType = pRpcMsg->msgType = TDMT_SYNC_APPEND_ENTRIES_BATCH;
+  pMsg->dataLen = dataLen;
+
+  // consecutive raft entries, each one sized by its own bytes
+  char* pData = pMsg->data;
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    (void)memcpy(pData, ppEntries[i], ppEntries[i]->bytes);
+    pData += ppEntries[i]->bytes;
+  }
+
+  pMsg->prevLogIndex = ppEntries[0]->index - 1;
+  pMsg->prevLogTerm = prevLogTerm;
+  pMsg->vgId = pNode->vgId;
+  pMsg->srcId = pNode->myRaftId;
+  pMsg->term = raftStoreGetTerm(pNode);
+  pMsg->commitIndex = pNode->commitIndex;
+  pMsg->privateTerm = 0;
+  return 0;
+}
+
+int32_t syncCheckAppendEntriesBatch(const SyncAppendEntries* pMsg, int32_t contLen, int32_t* pNumOfEntries,
+                                    SyncIndex* pLastIndex) {
+  int32_t   numOfEntries = 0;
+  SyncIndex lastIndex = pMsg->prevLogIndex;
+  SyncTerm  lastTerm = pMsg->prevLogTerm;
+
+  if (contLen < sizeof(SyncAppendEntries) || pMsg->dataLen > contLen - sizeof(SyncAppendEntries)) {
+    sError("vgId:%d, truncated append entries batch received. contLen:%d, datalen:%u", pMsg->vgId, contLen,
+           pMsg->dataLen);
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  for (uint32_t offset = 0; offset < pMsg->dataLen; numOfEntries++) {
+    // the entries are packed one after another, so the header may be unaligned
+    SSyncRaftEntry entry;
+    if (pMsg->dataLen - offset < sizeof(SSyncRaftEntry)) {
+      sError("vgId:%d, incomplete entry in append entries batch. datalen:%u, offset:%u", pMsg->vgId, pMsg->dataLen,
+             offset);
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+    (void)memcpy(&entry, pMsg->data + offset, sizeof(SSyncRaftEntry));
+
+    if (entry.bytes > pMsg->dataLen - offset || entry.dataLen > entry.bytes - sizeof(SSyncRaftEntry) ||
+        entry.bytes != sizeof(SSyncRaftEntry) + entry.dataLen) {
+      sError("vgId:%d, invalid entry size in append entries batch. bytes:%u, entry datalen:%u, datalen:%u, offset:%u",
+             pMsg->vgId, entry.bytes, entry.dataLen, pMsg->dataLen, offset);
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+
+    // the terms of the log never go down, and no entry is newer than the leader sending it
+    if (entry.index != lastIndex + 1 || entry.term < lastTerm || entry.term > pMsg->term) {
+      sError("vgId:%d, invalid entry in append entries batch. index:%" PRId64 ", term:%" PRId64
+             ", expected index:%" PRId64 ", prev term:%" PRId64 ", msg term:%" PRId64,
+             pMsg->vgId, entry.index, entry.term, lastIndex + 1, lastTerm, pMsg->term);
+      terrno = TSDB_CODE_INVALID_MSG;
+      return -1;
+    }
+
+    lastIndex = entry.index;
+    lastTerm = entry.term;
+    offset += entry.bytes;
+  }
+
+  if (numOfEntries == 0) {
+    sError("vgId:%d, empty append entries batch received. prev index:%" PRId64 ", term:%" PRId64, pMsg->vgId,
+           pMsg->prevLogIndex, pMsg->prevLogTerm);
+    terrno = TSDB_CODE_INVALID_MSG;
+    return -1;
+  }
+
+  *pNumOfEntries = numOfEntries;
+  *pLastIndex = lastIndex;
+  return 0;
+}
+
 int32_t syncBuildHeartbeat(SRpcMsg* pMsg, int32_t vgId) {
   int32_t bytes = sizeof(SyncHeartbeat);
   pMsg->pCont = rpcMallocCont(bytes);
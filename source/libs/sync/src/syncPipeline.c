@@ -27,6 +27,8 @@
 #include "syncUtil.h"
 #include "syncRaftCfg.h"
 #include "syncVoteMgr.h"
+#include "tglobal.h"
+#include "wal.h"
 
 static bool syncIsMsgBlock(tmsg_t type) {
   return (type == TDMT_VND_CREATE_TABLE) || (type == TDMT_VND_ALTER_TABLE) || (type == TDMT_VND_DROP_TABLE) ||
@@ -434,8 +436,12 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
   taosThreadMutexLock(&pBuf->mutex);
   syncLogBufferValidate(pBuf);
 
+  // entries persisted in one round share a single fsync
+  bool grouped = walBeginGroup(pNode->pWal);
+
   SSyncLogStore* pLogStore = pNode->pLogStore;
   int64_t        matchIndex = pBuf->matchIndex;
+  int64_t        startMatchIndex = pBuf->matchIndex;
 
   while (pBuf->matchIndex + 1 < pBuf->endIndex) {
     int64_t index = pBuf->matchIndex + 1;
@@ -514,18 +520,42 @@ int64_t syncLogBufferProceed(SSyncLogBuffer* pBuf, SSyncNode* pNode, SyncTerm* p
       }
     }
 
-    // replicate on demand
-    (void)syncNodeReplicateWithoutLock(pNode);
-
     ASSERT(pEntry->index == pBuf->matchIndex);
 
     // update my match index
     matchIndex = pBuf->matchIndex;
-    syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, pBuf->matchIndex);
   }  // end of while
 
 _out:
   pBuf->matchIndex = matchIndex;
+
+  // replicate the entries persisted in this round on demand, in batches and before they are fsynced locally. A group
+  // commit in progress replicates and fsyncs them at its end.
+  bool deferred = pNode->replDeferred && pNode->state == TAOS_SYNC_STATE_LEADER;
+  if (matchIndex > startMatchIndex && !deferred) {
+    (void)syncNodeReplicateWithoutLock(pNode);
+  }
+
+  // the match index is reported to peers, make it durable first
+  int32_t code = 0;
+  if (grouped) {
+    code = walEndGroup(pNode->pWal);
+  } else if (pNode->replicaNum > 1 && !deferred) {
+    code = walSyncGroup(pNode->pWal);
+  }
+
+  // entries not synced are neither acked nor counted for the quorum unless committed already, the next round retries
+  // the fsync
+  SyncIndex syncedIndex = walGetSyncedVer(pNode->pWal);
+  if (code != 0) {
+    sError("vgId:%d, failed to sync log entries since %s, match index:%" PRId64 ", synced index:%" PRId64, pNode->vgId,
+           terrstr(), matchIndex, syncedIndex);
+    matchIndex = TMAX(TMIN(matchIndex, syncedIndex), pBuf->commitIndex);
+  }
+
+  // update my match index, the entries of a pending group are counted by syncEndGroupCommit once they are fsynced
+  syncIndexMgrSetIndex(pNode->pMatchIndex, &pNode->myRaftId, TMAX(TMIN(matchIndex, syncedIndex), pBuf->commitIndex));
+
   if (pMatchTerm) {
     *pMatchTerm = pBuf->entries[(matchIndex + pBuf->size) % pBuf->size].pItem->term;
   }
@@ -965,16 +995,104 @@ int32_t syncLogReplProbe(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex inde
   return 0;
 }
 
+// consecutive entries sent to a peer in one append entries msg
+typedef struct SSyncLogReplBatch {
+  SSyncRaftEntry* pEntries[SYNC_LOG_REPL_BATCH_MAX_ENTRIES];
+  bool            inBuf[SYNC_LOG_REPL_BATCH_MAX_ENTRIES];
+  int32_t         numOfEntries;
+  int64_t         bytes;
+  SyncTerm        prevLogTerm;
+} SSyncLogReplBatch;
+
+static void syncLogReplBatchClear(SSyncLogReplBatch* pBatch) {
+  for (int32_t i = 0; i < pBatch->numOfEntries; ++i) {
+    if (!pBatch->inBuf[i]) {
+      syncEntryDestroy(pBatch->pEntries[i]);
+    }
+    pBatch->pEntries[i] = NULL;
+  }
+  pBatch->numOfEntries = 0;
+  pBatch->bytes = 0;
+  pBatch->prevLogTerm = -1;
+}
+
+static int32_t syncLogReplBatchAdd(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SSyncLogReplBatch* pBatch,
+                                   SyncIndex index, SyncTerm* pTerm, SRaftId* pDestId, bool* pBarrier) {
+  SSyncLogBuffer* pBuf = pNode->pLogBuf;
+  bool            inBuf = false;
+
+  SSyncRaftEntry* pEntry = syncLogBufferGetOneEntry(pBuf, pNode, index, &inBuf);
+  if (pEntry == NULL) {
+    sError("vgId:%d, failed to get raft entry for index:%" PRId64 "", pNode->vgId, index);
+    if (terrno == TSDB_CODE_WAL_LOG_NOT_EXIST) {
+      sInfo("vgId:%d, reset sync log repl of peer:%" PRIx64 " since %s. index:%" PRId64, pNode->vgId, pDestId->addr,
+            terrstr(), index);
+      (void)syncLogReplReset(pMgr);
+    }
+    return -1;
+  }
+
+  if (pBatch->numOfEntries == 0) {
+    pBatch->prevLogTerm = syncLogReplGetPrevLogTerm(pMgr, pNode, index);
+    if (pBatch->prevLogTerm < 0) {
+      sError("vgId:%d, failed to get prev log term since %s. index:%" PRId64 "", pNode->vgId, terrstr(), index);
+      if (!inBuf) syncEntryDestroy(pEntry);
+      return -1;
+    }
+  }
+
+  *pBarrier = syncLogReplBarrier(pEntry);
+  *pTerm = pEntry->term;
+  pBatch->pEntries[pBatch->numOfEntries] = pEntry;
+  pBatch->inBuf[pBatch->numOfEntries] = inBuf;
+  pBatch->numOfEntries++;
+  pBatch->bytes += pEntry->bytes;
+  return 0;
+}
+
+static int32_t syncLogReplBatchFlush(SSyncNode* pNode, SSyncLogReplBatch* pBatch, SRaftId* pDestId) {
+  if (pBatch->numOfEntries == 0) {
+    return 0;
+  }
+
+  SRpcMsg msgOut = {0};
+  int32_t code = 0;
+  if (pBatch->numOfEntries == 1) {
+    code = syncBuildAppendEntriesFromRaftEntry(pNode, pBatch->pEntries[0], pBatch->prevLogTerm, &msgOut);
+  } else {
+    code = syncBuildAppendEntriesBatch(pNode, pBatch->pEntries, pBatch->numOfEntries, pBatch->prevLogTerm, &msgOut);
+  }
+  if (code < 0) {
+    sError("vgId:%d, failed to get append entries for index:%" PRId64 "", pNode->vgId, pBatch->pEntries[0]->index);
+    syncLogReplBatchClear(pBatch);
+    return -1;
+  }
+
+  (void)syncNodeSendAppendEntries(pNode, pDestId, &msgOut);
+  pNode->replStat.numOfMsgs++;
+  pNode->replStat.numOfEntries += pBatch->numOfEntries;
+
+  sTrace("vgId:%d, replicate %d msgs in one batch. index:%" PRId64 "..%" PRId64 " prevterm:%" PRId64
+         " bytes:%" PRId64 " to dest: 0x%016" PRIx64,
+         pNode->vgId, pBatch->numOfEntries, pBatch->pEntries[0]->index,
+         pBatch->pEntries[pBatch->numOfEntries - 1]->index, pBatch->prevLogTerm, pBatch->bytes, pDestId->addr);
+
+  syncLogReplBatchClear(pBatch);
+  return 0;
+}
+
 int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
   ASSERT(pMgr->restored);
 
-  SRaftId*  pDestId = &pNode->replicasId[pMgr->peerId];
-  int32_t   batchSize = TMAX(1, pMgr->size >> (4 + pMgr->retryBackoff));
-  int32_t   count = 0;
-  int64_t   nowMs = taosGetMonoTimestampMs();
-  int64_t   limit = pMgr->size >> 1;
-  SyncTerm  term = -1;
-  SyncIndex firstIndex = -1;
+  SRaftId*          pDestId = &pNode->replicasId[pMgr->peerId];
+  int32_t           batchSize = TMAX(1, pMgr->size >> (4 + pMgr->retryBackoff));
+  int32_t           count = 0;
+  int64_t           nowMs = taosGetMonoTimestampMs();
+  int64_t           limit = pMgr->size >> 1;
+  int64_t           batchBytes = tsSyncLogReplBatchBytes;
+  SyncTerm          term = -1;
+  SyncIndex         firstIndex = -1;
+  SSyncLogReplBatch batch = {.prevLogTerm = -1};
 
   for (SyncIndex index = pMgr->endIndex; index <= pNode->pLogBuf->matchIndex; index++) {
     if (batchSize < count || limit <= index - pMgr->startIndex) {
@@ -987,9 +1105,10 @@ int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
     SRaftId* pDestId = &pNode->replicasId[pMgr->peerId];
     bool     barrier = false;
     SyncTerm term = -1;
-    if (syncLogReplSendTo(pMgr, pNode, index, &term, pDestId, &barrier) < 0) {
+    if (syncLogReplBatchAdd(pMgr, pNode, &batch, index, &term, pDestId, &barrier) < 0) {
       sError("vgId:%d, failed to replicate log entry since %s. index:%" PRId64 ", dest: 0x%016" PRIx64 "", pNode->vgId,
              terrstr(), index, pDestId->addr);
+      (void)syncLogReplBatchFlush(pNode, &batch, pDestId);
       return -1;
     }
     pMgr->states[pos].barrier = barrier;
@@ -1007,6 +1126,16 @@ int32_t syncLogReplAttempt(SSyncLogReplMgr* pMgr, SSyncNode* pNode) {
             pNode->vgId, DID(pDestId), index, term, pMgr->startIndex, pMgr->matchIndex, pMgr->endIndex);
       break;
     }
+
+    if (batch.bytes >= batchBytes || batch.numOfEntries == SYNC_LOG_REPL_BATCH_MAX_ENTRIES) {
+      if (syncLogReplBatchFlush(pNode, &batch, pDestId) < 0) {
+        return -1;
+      }
+    }
+  }
+
+  if (syncLogReplBatchFlush(pNode, &batch, pDestId) < 0) {
+    return -1;
   }
 
   syncLogReplRetryOnNeed(pMgr, pNode);
@@ -1271,6 +1400,8 @@ int32_t syncLogReplSendTo(SSyncLogReplMgr* pMgr, SSyncNode* pNode, SyncIndex ind
   }
 
   (void)syncNodeSendAppendEntries(pNode, pDestId, &msgOut);
+  pNode->replStat.numOfMsgs++;
+  pNode->replStat.numOfEntries++;
 
   sTrace("vgId:%d, replicate one msg index:%" PRId64 " term:%" PRId64 " prevterm:%" PRId64 " to dest: 0x%016" PRIx64,
          pNode->vgId, pEntry->index, pEntry->term, prevLogTerm, pDestId->addr);
@@ -22,6 +22,9 @@
 #include "syncRaftStore.h"
 #include "syncReplication.h"
 #include "syncUtil.h"
+#include "lz4.h"
+#include "tchecksum.h"
+#include "tglobal.h"
 
 static SyncIndex syncNodeGetSnapBeginIndex(SSyncNode *ths);
 
@@ -120,9 +123,21 @@ static int32_t snapshotSenderClearInfoData(SSyncSnapshotSender *pSender) {
   return 0;
 }
 
+// wait for the verification of the checkpoint, it reads with the reader of the sender
+static void snapshotSenderStopVerify(SSyncSnapshotSender *pSender) {
+  if (atomic_load_8(&pSender->verifyState) == SYNC_SNAP_VERIFY_NONE) return;
+
+  atomic_store_8(&pSender->verifyStop, 1);
+  taosThreadJoin(pSender->verifyThread, NULL);
+  taosThreadClear(&pSender->verifyThread);
+  atomic_store_8(&pSender->verifyState, SYNC_SNAP_VERIFY_NONE);
+}
+
 void snapshotSenderDestroy(SSyncSnapshotSender *pSender) {
   if (pSender == NULL) return;
 
+  snapshotSenderStopVerify(pSender);
+
   // close reader
   if (pSender->pReader != NULL) {
     pSender->pSyncNode->pFsm->FpSnapshotStopRead(pSender->pSyncNode->pFsm, pSender->pReader);
@@ -165,6 +180,15 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender) {
   pSender->startTime = taosGetMonoTimestampMs();
   pSender->lastSendTime = taosGetTimestampMs();
   pSender->finish = false;
+  pSender->encode = false;
+  pSender->checksum = 0;
+  memset(&pSender->resume, 0, sizeof(pSender->resume));
+  pSender->skipSeq = 0;
+  pSender->verifyStop = 0;
+  pSender->verifyCode = 0;
+  pSender->rateTokens = 0;
+  pSender->rateRefillMs = pSender->lastSendTime;
+  pSender->throttled = false;
 
   // Get snapshot info
   SSyncNode *pSyncNode = pSender->pSyncNode;
@@ -212,6 +236,8 @@ void snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish) {
   {
     pSender->finish = finish;
 
+    snapshotSenderStopVerify(pSender);
+
     // close reader
     if (pSender->pReader != NULL) {
       pSender->pSyncNode->pFsm->FpSnapshotStopRead(pSender->pSyncNode->pFsm, pSender->pReader);
@@ -259,12 +285,64 @@ int32_t syncSnapSendMsg(SSyncSnapshotSender *pSender, int32_t seq, void *pBlock,
     sSError(pSender, "failed to send snap replication msg since %s. seq:%d", terrstr(), seq);
     goto _OUT;
   }
+  pSender->rateTokens -= blockLen;
 
   code = 0;
 _OUT:
   return code;
 }
 
+// replace the raw data of a block with the head and the data compressed if it gets smaller
+int32_t syncSnapBlockEncode(SyncSnapBlock *pBlk, uint32_t checksum) {
+  int32_t rawLen = pBlk->blockLen;
+  char   *pBuf = taosMemoryMalloc(sizeof(SSyncSnapBlockHead) + rawLen);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  SSyncSnapBlockHead *pHead = (SSyncSnapBlockHead *)pBuf;
+  char               *pData = pBuf + sizeof(SSyncSnapBlockHead);
+  memset(pHead, 0, sizeof(SSyncSnapBlockHead));
+  pHead->rawLen = rawLen;
+  pHead->checksum = checksum;
+
+  int32_t len = 0;
+  if (tsSyncSnapReplCompress) {
+    len = LZ4_compress_default(pBlk->pBlock, pData, rawLen, rawLen - 1);
+  }
+  if (len > 0) {
+    pHead->cmprAlg = SYNC_SNAP_CMPR_LZ4;
+  } else {
+    pHead->cmprAlg = SYNC_SNAP_CMPR_NONE;
+    memcpy(pData, pBlk->pBlock, rawLen);
+    len = rawLen;
+  }
+
+  taosMemoryFree(pBlk->pBlock);
+  pBlk->pBlock = pBuf;
+  pBlk->blockLen = sizeof(SSyncSnapBlockHead) + len;
+  pBlk->blockType = TDMT_SYNC_SNAPSHOT_BLOCK;
+  return 0;
+}
+
+// token bucket refilled at syncSnapReplMaxRate, holding up to a timer period of tokens since the timer routine
+// continues a throttled sender
+static bool snapshotSenderThrottled(SSyncSnapshotSender *pSender) {
+  int64_t rate = (int64_t)tsSyncSnapReplMaxRate * 1024 * 1024;
+  if (rate <= 0) {
+    pSender->throttled = false;
+    return false;
+  }
+
+  int64_t nowMs = taosGetTimestampMs();
+  int64_t burst = rate * TMAX(pSender->pSyncNode->pingTimerMS, 1000) / 1000;
+  pSender->rateTokens = TMIN(pSender->rateTokens + rate * (nowMs - pSender->rateRefillMs) / 1000, burst);
+  pSender->rateRefillMs = nowMs;
+  pSender->throttled = (pSender->rateTokens <= 0);
+  return pSender->throttled;
+}
+
 // when sender receive ack, call this function to send msg from seq
 // seq = ack + 1, already updated
 static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
@@ -294,6 +372,11 @@ static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
       if (pBlk->blockLen > 0) {
         // has read data
         sSDebug(pSender, "snapshot sender continue to read, blockLen:%d seq:%d", pBlk->blockLen, pBlk->seq);
+        pSender->checksum = taosCalcChecksum(pSender->checksum, pBlk->pBlock, pBlk->blockLen);
+        if (pSender->encode && syncSnapBlockEncode(pBlk, pSender->checksum) != 0) {
+          sSError(pSender, "snapshot sender encode block failed since %s", terrstr());
+          goto _OUT;
+        }
       } else {
         // read finish, update seq to end
         pSender->seq = SYNC_SNAPSHOT_SEQ_END;
@@ -309,10 +392,26 @@ static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
   // send msg
   int32_t blockLen = (pBlk) ? pBlk->blockLen : 0;
   void   *pBlock = (pBlk) ? pBlk->pBlock : NULL;
-  if (syncSnapSendMsg(pSender, pSender->seq, pBlock, blockLen, 0) != 0) {
+  int32_t type = (pBlk) ? pBlk->blockType : 0;
+  bool    resume = (pSender->seq == SYNC_SNAPSHOT_SEQ_BEGIN && pSender->resume.seq > 0);
+  if (resume) {
+    pBlock = &pSender->resume;
+    blockLen = sizeof(SSyncSnapCheckpoint);
+    type = TDMT_SYNC_SNAPSHOT_RESUME;
+  }
+  if (syncSnapSendMsg(pSender, pSender->seq, pBlock, blockLen, type) != 0) {
     goto _OUT;
   }
 
+  if (resume) {
+    // the blocks up to the checkpoint are written by the receiver already
+    pSender->seq = pSender->resume.seq;
+    pSender->pSndBuf->start = pSender->seq + 1;
+    pSender->pSndBuf->end = pSender->pSndBuf->start;
+    pSender->pSndBuf->cursor = pSender->seq;
+    sSInfo(pSender, "snapshot sender resume from seq:%d", pSender->seq);
+  }
+
   // put in buffer
   int64_t nowMs = taosGetTimestampMs();
   if (pBlk) {
@@ -333,6 +432,27 @@ _OUT:;
   return code;
 }
 
+// send the blocks within the window, the rest of a throttled window is sent by the timer routine
+static int32_t snapshotSendWindow(SSyncSnapshotSender *pSender) {
+  SSyncSnapBuffer *pSndBuf = pSender->pSndBuf;
+
+  while (pSender->seq != SYNC_SNAPSHOT_SEQ_END && pSender->seq - pSndBuf->start < (pSndBuf->size >> 2)) {
+    if (snapshotSenderThrottled(pSender)) {
+      return 0;
+    }
+    if (snapshotSend(pSender) != 0) {
+      return -1;
+    }
+  }
+
+  if (pSender->seq == SYNC_SNAPSHOT_SEQ_END && pSndBuf->end <= pSndBuf->start) {
+    if (snapshotSend(pSender) != 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
 // send snapshot data from cache
 int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
   SSyncSnapBuffer *pSndBuf = pSender->pSndBuf;
@@ -342,6 +462,11 @@ int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
     goto _out;
   }
 
+  if (atomic_load_8(&pSender->verifyState) != SYNC_SNAP_VERIFY_NONE) {
+    code = 0;
+    goto _out;
+  }
+
   for (int32_t seq = pSndBuf->cursor + 1; seq < pSndBuf->end; ++seq) {
     SyncSnapBlock *pBlk = pSndBuf->entries[seq % pSndBuf->size];
     ASSERT(pBlk && !pBlk->acked);
@@ -349,7 +474,7 @@ int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
     if (nowMs < pBlk->sendTimeMs + SYNC_SNAP_RESEND_MS) {
       continue;
     }
-    if (syncSnapSendMsg(pSender, pBlk->seq, pBlk->pBlock, pBlk->blockLen, 0) != 0) {
+    if (syncSnapSendMsg(pSender, pBlk->seq, pBlk->pBlock, pBlk->blockLen, pBlk->blockType) != 0) {
       goto _out;
     }
     pBlk->sendTimeMs = nowMs;
@@ -490,6 +615,9 @@ static int32_t snapshotReceiverStartWriter(SSyncSnapshotReceiver *pReceiver, Syn
 
   // update ack
   pReceiver->ack = SYNC_SNAPSHOT_SEQ_BEGIN;
+  pReceiver->encode = false;
+  pReceiver->checksum = 0;
+  memset(&pReceiver->ckpt, 0, sizeof(pReceiver->ckpt));
 
   // update snapshot
   pReceiver->snapshot.lastApplyIndex = pBeginMsg->lastIndex;
@@ -525,7 +653,11 @@ void snapshotReceiverStart(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *p
   pReceiver->fromId = pPreMsg->srcId;
   pReceiver->startTime = pPreMsg->startTime;
 
-  pReceiver->snapshotParam.start = syncNodeGetSnapBeginIndex(pReceiver->pSyncNode);
+  if (pReceiver->ckpt.seq > 0) {
+    pReceiver->snapshotParam.start = pReceiver->ckpt.beginIndex;
+  } else {
+    pReceiver->snapshotParam.start = syncNodeGetSnapBeginIndex(pReceiver->pSyncNode);
+  }
   pReceiver->snapshotParam.end = -1;
 
   sRInfo(pReceiver, "snapshot receiver start, from dnode:%d.", DID(&pReceiver->fromId));
@@ -552,10 +684,66 @@ void snapshotReceiverStop(SSyncSnapshotReceiver *pReceiver) {
     syncSnapBufferReset(pReceiver->pRcvBuf);
 
     snapshotReceiverClearInfoData(pReceiver);
+    pReceiver->encode = false;
+    memset(&pReceiver->ckpt, 0, sizeof(pReceiver->ckpt));
+  }
+  taosThreadMutexUnlock(&pReceiver->pRcvBuf->mutex);
+}
+
+static bool snapshotReceiverResumable(SSyncSnapshotReceiver *pReceiver) {
+  return pReceiver->pWriter != NULL && pReceiver->encode &&
+         (pReceiver->ack > SYNC_SNAPSHOT_SEQ_BEGIN || pReceiver->ckpt.seq > 0);
+}
+
+// stop the receiver but keep the writer, so that a restarted transfer can resume from the last written block
+static void snapshotReceiverSuspend(SSyncSnapshotReceiver *pReceiver) {
+  int8_t stopped = !atomic_val_compare_exchange_8(&pReceiver->start, true, false);
+  if (stopped) return;
+  taosThreadMutexLock(&pReceiver->pRcvBuf->mutex);
+  {
+    if (pReceiver->ack > SYNC_SNAPSHOT_SEQ_BEGIN) {
+      pReceiver->ckpt.seq = pReceiver->ack;
+      pReceiver->ckpt.checksum = pReceiver->checksum;
+      pReceiver->ckpt.beginIndex = pReceiver->snapshotParam.start;
+      pReceiver->ckpt.lastIndex = pReceiver->snapshot.lastApplyIndex;
+      pReceiver->ckpt.lastTerm = pReceiver->snapshot.lastApplyTerm;
+    }
+
+    syncSnapBufferReset(pReceiver->pRcvBuf);
+    sRInfo(pReceiver, "snapshot receiver suspend, checkpoint seq:%d", pReceiver->ckpt.seq);
   }
   taosThreadMutexUnlock(&pReceiver->pRcvBuf->mutex);
 }
 
+// continue with the kept writer if the begin msg resumes from the checkpoint
+static bool snapshotReceiverResume(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pBeginMsg) {
+  SSyncSnapCheckpoint *pCkpt = &pReceiver->ckpt;
+  if (pBeginMsg->payloadType != TDMT_SYNC_SNAPSHOT_RESUME || pBeginMsg->dataLen != sizeof(SSyncSnapCheckpoint)) {
+    return false;
+  }
+
+  SSyncSnapCheckpoint *pOffer = (SSyncSnapCheckpoint *)pBeginMsg->data;
+  if (pCkpt->seq <= SYNC_SNAPSHOT_SEQ_BEGIN || pOffer->seq != pCkpt->seq || pOffer->checksum != pCkpt->checksum ||
+      pBeginMsg->beginIndex != pCkpt->beginIndex || pBeginMsg->lastIndex != pCkpt->lastIndex ||
+      pBeginMsg->lastTerm != pCkpt->lastTerm) {
+    return false;
+  }
+
+  taosThreadMutexLock(&pReceiver->pRcvBuf->mutex);
+  {
+    pReceiver->ack = pCkpt->seq;
+    pReceiver->checksum = pCkpt->checksum;
+    pReceiver->pRcvBuf->start = pCkpt->seq + 1;
+    pReceiver->pRcvBuf->end = pReceiver->pRcvBuf->start;
+    pReceiver->pRcvBuf->cursor = pCkpt->seq;
+  }
+  taosThreadMutexUnlock(&pReceiver->pRcvBuf->mutex);
+
+  sRInfo(pReceiver, "snapshot receiver resume from seq:%d", pCkpt->seq);
+  memset(pCkpt, 0, sizeof(SSyncSnapCheckpoint));
+  return true;
+}
+
 static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg) {
   int32_t code = 0;
   if (pReceiver->pWriter != NULL) {
@@ -614,6 +802,52 @@ static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnap
   return 0;
 }
 
+// the raw data of an encoded block, decompressed into *ppBuf if needed. *pChecksum is the checksum of the blocks before
+// it, and is updated if the block matches the checksum in its head.
+int32_t syncSnapBlockDecode(SyncSnapshotSend *pMsg, uint32_t *pChecksum, char **ppBuf, char **ppData,
+                            int32_t *pDataLen) {
+  SSyncSnapBlockHead *pHead = (SSyncSnapBlockHead *)pMsg->data;
+  char               *pData = pMsg->data + sizeof(SSyncSnapBlockHead);
+  int32_t             len = (int32_t)pMsg->dataLen - (int32_t)sizeof(SSyncSnapBlockHead);
+  char               *pBuf = NULL;
+
+  if (len < 0 || pHead->rawLen <= 0) {
+    goto _err;
+  }
+
+  if (pHead->cmprAlg == SYNC_SNAP_CMPR_LZ4) {
+    pBuf = taosMemoryMalloc(pHead->rawLen);
+    if (pBuf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    if (LZ4_decompress_safe(pData, pBuf, len, pHead->rawLen) != pHead->rawLen) {
+      goto _err;
+    }
+    pData = pBuf;
+  } else if (pHead->cmprAlg != SYNC_SNAP_CMPR_NONE || len != pHead->rawLen) {
+    goto _err;
+  }
+
+  uint32_t checksum = taosCalcChecksum(*pChecksum, (uint8_t *)pData, pHead->rawLen);
+  if (checksum != pHead->checksum) {
+    taosMemoryFree(pBuf);
+    terrno = TSDB_CODE_CHECKSUM_ERROR;
+    return -1;
+  }
+
+  *pChecksum = checksum;
+  *ppBuf = pBuf;
+  *ppData = pData;
+  *pDataLen = pHead->rawLen;
+  return 0;
+
+_err:
+  taosMemoryFree(pBuf);
+  terrno = TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG;
+  return -1;
+}
+
 static int32_t snapshotReceiverGotData(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg) {
   if (pMsg->seq != pReceiver->ack + 1) {
     sRError(pReceiver, "snapshot receiver invalid seq, ack:%d seq:%d", pReceiver->ack, pMsg->seq);
@@ -630,13 +864,29 @@ static int32_t snapshotReceiverGotData(SSyncSnapshotReceiver *pReceiver, SyncSna
   sRDebug(pReceiver, "snapshot receiver continue to write, blockLen:%d seq:%d", pMsg->dataLen, pMsg->seq);
 
   if (pMsg->dataLen > 0) {
+    char    *pBuf = NULL;
+    char    *pData = pMsg->data;
+    int32_t  dataLen = pMsg->dataLen;
+    uint32_t checksum = pReceiver->checksum;
+    if (pMsg->payloadType == TDMT_SYNC_SNAPSHOT_BLOCK) {
+      if (syncSnapBlockDecode(pMsg, &checksum, &pBuf, &pData, &dataLen) != 0) {
+        sRError(pReceiver, "snapshot receiver failed to decode block since %s, seq:%d", terrstr(), pMsg->seq);
+        return -1;
+      }
+    }
+
     // apply data block
-    int32_t code = pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter,
-                                                                 pMsg->data, pMsg->dataLen);
+    int32_t code =
+        pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter, pData, dataLen);
+    taosMemoryFree(pBuf);
     if (code != 0) {
+      // the block may be written partly, not resumable any more
+      pReceiver->encode = false;
       sRError(pReceiver, "snapshot receiver continue write failed since %s", terrstr());
       return -1;
     }
+    pReceiver->encode = (pMsg->payloadType == TDMT_SYNC_SNAPSHOT_BLOCK);
+    pReceiver->checksum = checksum;
   }
 
   // update progress
@@ -751,8 +1001,13 @@ static int32_t syncNodeOnSnapshotPrep(SSyncNode *pSyncNode, SyncSnapshotSend *pM
 
 _START_RECEIVER:
   if (snapshotReceiverIsStart(pReceiver)) {
-    sRInfo(pReceiver, "snapshot receiver already start and force stop pre one");
-    snapshotReceiverStop(pReceiver);
+    if (snapshotReceiverResumable(pReceiver)) {
+      sRInfo(pReceiver, "snapshot receiver already start and suspend pre one");
+      snapshotReceiverSuspend(pReceiver);
+    } else {
+      sRInfo(pReceiver, "snapshot receiver already start and force stop pre one");
+      snapshotReceiverStop(pReceiver);
+    }
   }
 
   snapshotReceiverStart(pReceiver, pMsg);
@@ -768,9 +1023,27 @@ _SEND_REPLY:;
     SSyncTLV *datHead = snapInfo.data;
     dataLen = sizeof(SSyncTLV) + datHead->len;
   }
+  int32_t type = (snapInfo.data) ? snapInfo.type : 0;
+
+  // offer the checkpoint to resume from
+  if (code == 0 && pReceiver->ckpt.seq > 0) {
+    int32_t len = dataLen + sizeof(SSyncTLV) + sizeof(SSyncSnapCheckpoint);
+    void   *data = taosMemoryRealloc(snapInfo.data, len);
+    if (data == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      code = terrno;
+      goto _out;
+    }
+    snapInfo.data = data;
+
+    SSyncTLV *pTlv = (SSyncTLV *)((char *)data + dataLen);
+    pTlv->typ = TDMT_SYNC_SNAPSHOT_RESUME;
+    pTlv->len = sizeof(SSyncSnapCheckpoint);
+    memcpy(pTlv->val, &pReceiver->ckpt, sizeof(SSyncSnapCheckpoint));
+    dataLen = len;
+  }
 
   // send response
-  int32_t type = (snapInfo.data) ? snapInfo.type : 0;
   if (syncSnapSendRsp(pReceiver, pMsg, snapInfo.data, dataLen, type, code) != 0) {
     code = terrno;
     goto _out;
@@ -800,6 +1073,27 @@ static int32_t syncNodeOnSnapshotBegin(SSyncNode *pSyncNode, SyncSnapshotSend *p
     goto _SEND_REPLY;
   }
 
+  // the writer kept by a suspended transfer
+  if (pReceiver->pWriter != NULL) {
+    if (snapshotReceiverResume(pReceiver, pMsg)) {
+      code = 0;
+      goto _SEND_REPLY;
+    }
+
+    sRInfo(pReceiver, "snapshot receiver discard the writer of checkpoint seq:%d", pReceiver->ckpt.seq);
+    if (pSyncNode->pFsm->FpSnapshotStopWrite(pSyncNode->pFsm, pReceiver->pWriter, false, &pReceiver->snapshot) != 0) {
+      sRError(pReceiver, "snapshot receiver stop write failed since %s", terrstr());
+    }
+    pReceiver->pWriter = NULL;
+    memset(&pReceiver->ckpt, 0, sizeof(pReceiver->ckpt));
+  }
+
+  if (pMsg->payloadType == TDMT_SYNC_SNAPSHOT_RESUME) {
+    terrno = TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG;
+    sRError(pReceiver, "failed to resume snapshot receiver since no checkpoint");
+    goto _SEND_REPLY;
+  }
+
   // start writer
   if (snapshotReceiverStartWriter(pReceiver, pMsg) != 0) {
     sRError(pReceiver, "failed to start snapshot writer since %s", terrstr());
@@ -812,8 +1106,8 @@ _SEND_REPLY:
     code = terrno;
   }
 
-  // send response
-  if (syncSnapSendRsp(pReceiver, pMsg, NULL, 0, 0, code) != 0) {
+  // send response, the payload type tells the sender that encoded blocks are supported
+  if (syncSnapSendRsp(pReceiver, pMsg, NULL, 0, TDMT_SYNC_SNAPSHOT_BLOCK, code) != 0) {
     return -1;
   }
 
@@ -1085,8 +1379,143 @@ static int32_t syncSnapSenderExchgSnapInfo(SSyncNode *pSyncNode, SSyncSnapshotSe
   return 0;
 }
 
+// the checkpoint the receiver offers to resume from, appended to the prep rsp after the exchanged snap info
+static void syncSnapSenderGetResume(SSyncSnapshotSender *pSender, SyncSnapshotRsp *pMsg) {
+  int32_t dataLen = pMsg->bytes - sizeof(SyncSnapshotRsp);
+  int32_t offset = 0;
+  if (pMsg->payloadType == TDMT_SYNC_PREP_SNAPSHOT_REPLY) {
+    offset = sizeof(SSyncTLV) + ((SSyncTLV *)pMsg->data)->len;
+  }
+
+  memset(&pSender->resume, 0, sizeof(pSender->resume));
+  if (dataLen - offset < (int32_t)(sizeof(SSyncTLV) + sizeof(SSyncSnapCheckpoint))) {
+    return;
+  }
+
+  SSyncTLV *pTlv = (SSyncTLV *)(pMsg->data + offset);
+  if (pTlv->typ != TDMT_SYNC_SNAPSHOT_RESUME || pTlv->len != sizeof(SSyncSnapCheckpoint)) {
+    return;
+  }
+
+  SSyncSnapCheckpoint *pCkpt = (SSyncSnapCheckpoint *)pTlv->val;
+  if (pCkpt->seq <= SYNC_SNAPSHOT_SEQ_BEGIN || pCkpt->beginIndex != pSender->snapshotParam.start ||
+      pCkpt->lastIndex != pSender->snapshot.lastApplyIndex || pCkpt->lastTerm != pSender->snapshot.lastApplyTerm) {
+    sSInfo(pSender, "snapshot sender ignore the checkpoint of seq:%d, last:%" PRId64 ", term:%" PRId64, pCkpt->seq,
+           pCkpt->lastIndex, pCkpt->lastTerm);
+    return;
+  }
+  pSender->resume = *pCkpt;
+}
+
+// re-read the blocks the receiver has written to verify its checkpoint. It runs in a thread of its own since the
+// blocks may take long to read, and the sync thread must not wait for them.
+static void *snapshotSenderVerifyFunc(void *param) {
+  SSyncSnapshotSender *pSender = param;
+  SSyncFSM            *pFsm = pSender->pSyncNode->pFsm;
+  setThreadName("sync-snap-verify");
+
+  while (pSender->skipSeq < pSender->resume.seq && !atomic_load_8(&pSender->verifyStop)) {
+    void   *pBlock = NULL;
+    int32_t blockLen = 0;
+    if (pFsm->FpSnapshotDoRead(pFsm, pSender->pReader, &pBlock, &blockLen) != 0) {
+      pSender->verifyCode = terrno;
+      break;
+    }
+    if (blockLen <= 0) {
+      taosMemoryFree(pBlock);
+      break;
+    }
+    pSender->checksum = taosCalcChecksum(pSender->checksum, pBlock, blockLen);
+    pSender->skipSeq++;
+    taosMemoryFree(pBlock);
+  }
+
+  atomic_store_8(&pSender->verifyState, SYNC_SNAP_VERIFY_DONE);
+  return NULL;
+}
+
+static int32_t snapshotSenderStartVerify(SSyncSnapshotSender *pSender) {
+  pSender->skipSeq = 0;
+  pSender->checksum = 0;
+  pSender->verifyStop = 0;
+  pSender->verifyCode = 0;
+  pSender->lastSendTime = taosGetTimestampMs();
+  atomic_store_8(&pSender->verifyState, SYNC_SNAP_VERIFY_RUNNING);
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  int32_t code = taosThreadCreate(&pSender->verifyThread, &thAttr, snapshotSenderVerifyFunc, pSender);
+  taosThreadAttrDestroy(&thAttr);
+  if (code != 0) {
+    atomic_store_8(&pSender->verifyState, SYNC_SNAP_VERIFY_NONE);
+    terrno = TAOS_SYSTEM_ERROR(code);
+    sSError(pSender, "snapshot sender failed to verify the checkpoint since %s", terrstr());
+    return -1;
+  }
+
+  sSInfo(pSender, "snapshot sender verify the checkpoint of seq:%d", pSender->resume.seq);
+  return 0;
+}
+
+// send begin once the checkpoint is verified, resuming from it if the blocks read match it, or sending all otherwise
+static int32_t snapshotSenderFinishVerify(SSyncSnapshotSender *pSender) {
+  SSyncFSM *pFsm = pSender->pSyncNode->pFsm;
+
+  if (atomic_load_8(&pSender->verifyState) == SYNC_SNAP_VERIFY_RUNNING) {
+    pSender->lastSendTime = taosGetTimestampMs();
+    return 0;
+  }
+
+  snapshotSenderStopVerify(pSender);
+  if (pSender->verifyCode != 0) {
+    terrno = pSender->verifyCode;
+    sSError(pSender, "snapshot sender read failed since %s", terrstr());
+    return -1;
+  }
+
+  if (pSender->skipSeq != pSender->resume.seq || pSender->checksum != pSender->resume.checksum) {
+    sSWarn(pSender, "snapshot sender failed to resume from seq:%d since checksum mismatch, read:%d, send all",
+           pSender->resume.seq, pSender->skipSeq);
+    pFsm->FpSnapshotStopRead(pFsm, pSender->pReader);
+    pSender->pReader = NULL;
+    memset(&pSender->resume, 0, sizeof(pSender->resume));
+    pSender->skipSeq = 0;
+    pSender->checksum = 0;
+    if (pFsm->FpSnapshotStartRead(pFsm, &pSender->snapshotParam, &pSender->pReader) != 0) {
+      sSError(pSender, "prepare snapshot failed since %s", terrstr());
+      return -1;
+    }
+  }
+
+  return snapshotSend(pSender);
+}
+
+int32_t snapshotSenderContinue(SSyncSnapshotSender *pSender) {
+  SSyncSnapBuffer *pSndBuf = pSender->pSndBuf;
+  int32_t          code = 0;
+  taosThreadMutexLock(&pSndBuf->mutex);
+  if (pSender->pReader == NULL || pSender->finish || !snapshotSenderIsStart(pSender)) {
+    goto _out;
+  }
+
+  if (atomic_load_8(&pSender->verifyState) != SYNC_SNAP_VERIFY_NONE) {
+    code = snapshotSenderFinishVerify(pSender);
+  } else if (pSender->throttled) {
+    code = snapshotSendWindow(pSender);
+  }
+_out:
+  taosThreadMutexUnlock(&pSndBuf->mutex);
+  return code;
+}
+
 // sender
 static int32_t syncNodeOnSnapshotPrepRsp(SSyncNode *pSyncNode, SSyncSnapshotSender *pSender, SyncSnapshotRsp *pMsg) {
+  if (atomic_load_8(&pSender->verifyState) != SYNC_SNAP_VERIFY_NONE) {
+    sSInfo(pSender, "ignore the prepare rsp while verifying the checkpoint");
+    return 0;
+  }
+
   SSnapshot snapshot = {0};
   pSyncNode->pFsm->FpGetSnapshotInfo(pSyncNode->pFsm, &snapshot);
 
@@ -1116,6 +1545,11 @@ static int32_t syncNodeOnSnapshotPrepRsp(SSyncNode *pSyncNode, SSyncSnapshotSend
   // update next index
   syncIndexMgrSetIndex(pSyncNode->pNextIndex, &pMsg->srcId, snapshot.lastApplyIndex + 1);
 
+  syncSnapSenderGetResume(pSender, pMsg);
+  if (pSender->resume.seq > 0) {
+    return snapshotSenderStartVerify(pSender);
+  }
+
   return snapshotSend(pSender);
 }
 
@@ -1138,7 +1572,8 @@ static int32_t syncSnapBufferSend(SSyncSnapshotSender *pSender, SyncSnapshotRsp
     goto _out;
   }
 
-  if (pSender->pReader == NULL || pSender->finish || !snapshotSenderIsStart(pSender)) {
+  if (pSender->pReader == NULL || pSender->finish || !snapshotSenderIsStart(pSender) ||
+      atomic_load_8(&pSender->verifyState) != SYNC_SNAP_VERIFY_NONE) {
     code = terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
     goto _out;
   }
@@ -1171,18 +1606,13 @@ static int32_t syncSnapBufferSend(SSyncSnapshotSender *pSender, SyncSnapshotRsp
     pSndBuf->start = ack + 1;
   }
 
-  while (pSender->seq != SYNC_SNAPSHOT_SEQ_END && pSender->seq - pSndBuf->start < (pSndBuf->size >> 2)) {
-    if (snapshotSend(pSender) != 0) {
-      code = terrno;
-      goto _out;
-    }
+  if (pMsg->ack == SYNC_SNAPSHOT_SEQ_BEGIN) {
+    pSender->encode = (pMsg->payloadType == TDMT_SYNC_SNAPSHOT_BLOCK);
   }
 
-  if (pSender->seq == SYNC_SNAPSHOT_SEQ_END && pSndBuf->end <= pSndBuf->start) {
-    if (snapshotSend(pSender) != 0) {
-      code = terrno;
-      goto _out;
-    }
+  if (snapshotSendWindow(pSender) != 0) {
+    code = terrno;
+    goto _out;
   }
 _out:
   taosThreadMutexUnlock(&pSndBuf->mutex);
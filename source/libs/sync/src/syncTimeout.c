@@ -78,6 +78,12 @@ static int32_t syncNodeTimerRoutine(SSyncNode* ths) {
     SSyncSnapshotSender* pSender = syncNodeGetSnapshotSender(ths, &(ths->peersId[i]));
     if (pSender != NULL) {
       if (ths->isStart && ths->state == TAOS_SYNC_STATE_LEADER && pSender->start) {
+        if (snapshotSenderContinue(pSender) != 0) {
+          sSError(pSender, "snap replication failed to continue since %s, terminate.", terrstr());
+          snapshotSenderStop(pSender, false);
+          continue;
+        }
+
         int64_t elapsedMs = timeNow - pSender->lastSendTime;
         if (elapsedMs < SYNC_SNAP_RESEND_MS) {
           continue;
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "syncCommit.h"
+#include "syncIndexMgr.h"
+#include "syncPipeline.h"
+#include "syncRaftEntry.h"
+#include "syncRaftLog.h"
+#include "syncRespMgr.h"
+#include "tglobal.h"
+#include "wal.h"
+
+namespace {
+
+std::vector<SyncIndex> committed;
+
+int32_t getSnapshotInfo(const SSyncFSM *pFsm, SSnapshot *pSnapshot) {
+  pSnapshot->lastApplyIndex = SYNC_INDEX_INVALID;
+  pSnapshot->lastApplyTerm = 0;
+  return 0;
+}
+
+SyncIndex getAppliedIndex(const SSyncFSM *pFsm) { return SYNC_INDEX_INVALID; }
+
+int32_t commitCb(const SSyncFSM *pFsm, SRpcMsg *pMsg, SFsmCbMeta *pMeta) {
+  committed.push_back(pMeta->index);
+  rpcFreeCont(pMsg->pCont);
+  return 0;
+}
+
+class SyncGroupCommitTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() { ASSERT_EQ(walInit(), 0); }
+
+  static void TearDownTestCase() { walCleanUp(); }
+
+  void SetUp() override {
+    latency = tsWalGroupCommitLatency;
+    tsWalGroupCommitLatency = 10000;
+    committed.clear();
+
+    taosRemoveDir(pathName);
+    SWalCfg cfg = {0};
+    cfg.vgId = 2;
+    cfg.level = TAOS_WAL_FSYNC;
+    cfg.fsyncPeriod = 0;
+    cfg.rollPeriod = -1;
+    cfg.segSize = -1;
+    pWal = walOpen(pathName, &cfg);
+    ASSERT_NE(pWal, nullptr);
+
+    // a leader of three voters, without the peers to send the entries to
+    memset(&node, 0, sizeof(node));
+    node.vgId = 2;
+    node.state = TAOS_SYNC_STATE_LEADER;
+    node.replicaNum = 3;
+    node.totalReplicaNum = 3;
+    node.quorum = 2;
+    node.raftCfg.cfg.totalReplicaNum = 1;
+    node.raftCfg.configIndexCount = 1;
+    node.raftCfg.configIndexArr[0] = SYNC_INDEX_INVALID;
+    for (int32_t i = 0; i < node.totalReplicaNum; ++i) {
+      node.replicasId[i].addr = i + 1;
+      node.replicasId[i].vgId = 2;
+      node.raftCfg.cfg.nodeInfo[i].nodeRole = TAOS_SYNC_ROLE_VOTER;
+    }
+    node.myRaftId = node.replicasId[0];
+    node.commitIndex = SYNC_INDEX_INVALID;
+    node.restoreFinish = true;
+    node.raftStore.currentTerm = 1;
+    taosThreadMutexInit(&node.raftStore.mutex, NULL);
+
+    fsm.FpGetSnapshotInfo = getSnapshotInfo;
+    fsm.FpAppliedIndexCb = getAppliedIndex;
+    fsm.FpCommitCb = commitCb;
+    node.pFsm = &fsm;
+    node.pWal = pWal;
+    node.pLogStore = logStoreCreate(&node);
+    node.pMatchIndex = syncIndexMgrCreate(&node);
+    for (int32_t i = 0; i < node.totalReplicaNum; ++i) {
+      syncIndexMgrSetIndex(node.pMatchIndex, &node.replicasId[i], SYNC_INDEX_INVALID);
+    }
+    node.pSyncRespMgr = syncRespMgrCreate(&node, 0);
+    node.pLogBuf = syncLogBufferCreate();
+    ASSERT_EQ(syncLogBufferInit(node.pLogBuf, &node), 0);
+  }
+
+  void TearDown() override {
+    syncLogBufferDestroy(node.pLogBuf);
+    syncRespMgrDestroy(node.pSyncRespMgr);
+    syncIndexMgrDestroy(node.pMatchIndex);
+    logStoreDestory(node.pLogStore);
+    taosThreadMutexDestroy(&node.raftStore.mutex);
+    walClose(pWal);
+    pWal = NULL;
+    taosRemoveDir(pathName);
+    tsWalGroupCommitLatency = latency;
+  }
+
+  void append(SyncIndex index) {
+    SSyncRaftEntry *pEntry = syncEntryBuild(sizeof(SMsgHead) + 16);
+    ASSERT_NE(pEntry, nullptr);
+    pEntry->msgType = TDMT_SYNC_CLIENT_REQUEST;
+    pEntry->originalRpcType = TDMT_VND_SUBMIT;
+    pEntry->seqNum = index;
+    pEntry->term = 1;
+    pEntry->index = index;
+    ASSERT_EQ(syncNodeAppend(&node, pEntry), 0);
+  }
+
+  // a peer acks the entries up to the index, as syncNodeOnAppendEntriesReply does
+  void ack(int32_t peer, SyncIndex index) {
+    syncIndexMgrSetIndex(node.pMatchIndex, &node.replicasId[peer], index);
+    SyncIndex commitIndex = syncNodeCheckCommitIndex(&node, TMIN(index, node.pLogBuf->matchIndex));
+    (void)syncLogBufferCommit(node.pLogBuf, &node, commitIndex);
+  }
+
+  SyncIndex myMatchIndex() { return syncIndexMgrGetIndex(node.pMatchIndex, &node.myRaftId); }
+
+  SSyncNode   node;
+  SSyncFSM    fsm = {0};
+  SWal       *pWal = NULL;
+  int32_t     latency = 0;
+  const char *pathName = TD_TMP_DIR_PATH "sync_group_commit_test";
+};
+
+}  // namespace
+
+TEST_F(SyncGroupCommitTest, deferred_group) {
+  // the vnode opens the group and holds back the replication, as syncBeginGroupCommit does
+  ASSERT_TRUE(walBeginGroup(pWal));
+  node.replDeferred = true;
+  for (SyncIndex index = 0; index < 4; ++index) append(index);
+
+  ASSERT_EQ(node.pLogBuf->matchIndex, 3);
+  ASSERT_TRUE(walGroupPending(pWal));
+  ASSERT_EQ(walGetSyncedVer(pWal), SYNC_INDEX_INVALID);
+  ASSERT_EQ(myMatchIndex(), SYNC_INDEX_INVALID);
+
+  // a peer acks the group before the leader fsyncs it, a quorum of durable copies is not reached yet
+  ack(1, 3);
+  ASSERT_EQ(node.commitIndex, SYNC_INDEX_INVALID);
+  ASSERT_TRUE(committed.empty());
+
+  // the group is fsynced, the entries acked meanwhile are committed
+  ASSERT_EQ(syncNodeEndGroupCommit(&node), 0);
+  ASSERT_FALSE(node.replDeferred);
+  ASSERT_FALSE(walGroupPending(pWal));
+  ASSERT_EQ(myMatchIndex(), 3);
+  ASSERT_EQ(node.commitIndex, 3);
+  ASSERT_EQ(committed, std::vector<SyncIndex>({0, 1, 2, 3}));
+}
+
+TEST_F(SyncGroupCommitTest, partial_ack) {
+  ASSERT_TRUE(walBeginGroup(pWal));
+  node.replDeferred = true;
+  for (SyncIndex index = 0; index < 6; ++index) append(index);
+
+  ack(1, 2);
+  ack(2, 4);
+  ASSERT_EQ(node.commitIndex, SYNC_INDEX_INVALID);
+
+  // the highest index held by a quorum is the one of the peer ahead
+  ASSERT_EQ(syncNodeEndGroupCommit(&node), 0);
+  ASSERT_EQ(myMatchIndex(), 5);
+  ASSERT_EQ(node.commitIndex, 4);
+  ASSERT_EQ(committed, std::vector<SyncIndex>({0, 1, 2, 3, 4}));
+
+  ack(1, 5);
+  ASSERT_EQ(node.commitIndex, 5);
+  ASSERT_EQ(committed.size(), 6);
+}
+
+TEST_F(SyncGroupCommitTest, without_group) {
+  // each entry is fsynced as it is written and counted right away
+  for (SyncIndex index = 0; index < 3; ++index) append(index);
+  ASSERT_FALSE(walGroupPending(pWal));
+  ASSERT_EQ(myMatchIndex(), 2);
+  ASSERT_EQ(node.commitIndex, SYNC_INDEX_INVALID);
+
+  ack(1, 1);
+  ASSERT_EQ(node.commitIndex, 1);
+
+  // the ack of a peer arriving before the leader counts its own copy is committed by the next append
+  syncIndexMgrSetIndex(node.pMatchIndex, &node.replicasId[2], 3);
+  append(3);
+  ASSERT_EQ(node.commitIndex, 3);
+  ASSERT_EQ(committed, std::vector<SyncIndex>({0, 1, 2, 3}));
+}
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "syncMessage.h"
+#include "syncRaftEntry.h"
+
+namespace {
+
+class SyncReplBatchTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    memset(&node, 0, sizeof(node));
+    node.vgId = 2;
+    node.myRaftId.addr = 1;
+    node.myRaftId.vgId = 2;
+    node.commitIndex = 8;
+    node.raftStore.currentTerm = 4;
+    taosThreadMutexInit(&node.raftStore.mutex, NULL);
+  }
+
+  void TearDown() override {
+    for (auto pEntry : entries) syncEntryDestroy(pEntry);
+    entries.clear();
+    rpcFreeCont(rpcMsg.pCont);
+    rpcMsg.pCont = NULL;
+    taosThreadMutexDestroy(&node.raftStore.mutex);
+  }
+
+  // entries of odd sizes, so that the ones after the first are not aligned in the msg
+  void addEntry(SyncIndex index, SyncTerm term) {
+    int32_t         dataLen = 5 + (int32_t)entries.size() * 3;
+    SSyncRaftEntry *pEntry = syncEntryBuild(dataLen);
+    ASSERT_NE(pEntry, nullptr);
+    pEntry->msgType = TDMT_SYNC_CLIENT_REQUEST;
+    pEntry->originalRpcType = TDMT_VND_SUBMIT;
+    pEntry->seqNum = index;
+    pEntry->term = term;
+    pEntry->index = index;
+    memset(pEntry->data, 'a' + (int32_t)entries.size(), dataLen);
+    entries.push_back(pEntry);
+  }
+
+  SyncAppendEntries *build(SyncTerm prevLogTerm) {
+    EXPECT_EQ(syncBuildAppendEntriesBatch(&node, entries.data(), (int32_t)entries.size(), prevLogTerm, &rpcMsg), 0);
+    return (SyncAppendEntries *)rpcMsg.pCont;
+  }
+
+  // the raft entry at the given position of the batch
+  SSyncRaftEntry *entryAt(SyncAppendEntries *pMsg, int32_t pos) {
+    uint32_t offset = 0;
+    for (int32_t i = 0; i < pos; ++i) {
+      SSyncRaftEntry head;
+      memcpy(&head, pMsg->data + offset, sizeof(SSyncRaftEntry));
+      offset += head.bytes;
+    }
+    return (SSyncRaftEntry *)(pMsg->data + offset);
+  }
+
+  int32_t check(SyncAppendEntries *pMsg, int32_t contLen) {
+    numOfEntries = 0;
+    lastIndex = SYNC_INDEX_INVALID;
+    return syncCheckAppendEntriesBatch(pMsg, contLen, &numOfEntries, &lastIndex);
+  }
+
+  SSyncNode                     node;
+  std::vector<SSyncRaftEntry *> entries;
+  SRpcMsg                       rpcMsg = {0};
+  int32_t                       numOfEntries = 0;
+  SyncIndex                     lastIndex = SYNC_INDEX_INVALID;
+};
+
+}  // namespace
+
+TEST_F(SyncReplBatchTest, build_and_parse) {
+  for (SyncIndex index = 11; index <= 15; ++index) addEntry(index, 3);
+  SyncAppendEntries *pMsg = build(3);
+
+  ASSERT_EQ(rpcMsg.msgType, TDMT_SYNC_APPEND_ENTRIES_BATCH);
+  ASSERT_EQ(pMsg->msgType, TDMT_SYNC_APPEND_ENTRIES_BATCH);
+  ASSERT_EQ(pMsg->bytes, (uint32_t)rpcMsg.contLen);
+  ASSERT_EQ(pMsg->vgId, 2);
+  ASSERT_EQ(pMsg->term, 4);
+  ASSERT_EQ(pMsg->prevLogIndex, 10);
+  ASSERT_EQ(pMsg->prevLogTerm, 3);
+  ASSERT_EQ(pMsg->commitIndex, 8);
+
+  uint32_t dataLen = 0;
+  for (auto pEntry : entries) dataLen += pEntry->bytes;
+  ASSERT_EQ(pMsg->dataLen, dataLen);
+  ASSERT_EQ(rpcMsg.contLen, (int32_t)(sizeof(SyncAppendEntries) + dataLen));
+
+  ASSERT_EQ(check(pMsg, rpcMsg.contLen), 0);
+  ASSERT_EQ(numOfEntries, 5);
+  ASSERT_EQ(lastIndex, 15);
+
+  for (int32_t i = 0; i < numOfEntries; ++i) {
+    ASSERT_EQ(memcmp(entryAt(pMsg, i), entries[i], entries[i]->bytes), 0);
+  }
+}
+
+TEST_F(SyncReplBatchTest, truncated) {
+  for (SyncIndex index = 11; index <= 13; ++index) addEntry(index, 3);
+  SyncAppendEntries *pMsg = build(3);
+  uint32_t           dataLen = pMsg->dataLen;
+
+  // the msg is shorter than its header, or than the entries it claims
+  ASSERT_LT(check(pMsg, sizeof(SyncAppendEntries) - 1), 0);
+  ASSERT_LT(check(pMsg, rpcMsg.contLen - 1), 0);
+
+  // the last entry is cut in its data, or in its header
+  pMsg->dataLen = dataLen - 1;
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+  pMsg->dataLen = dataLen - entries[2]->bytes + sizeof(SSyncRaftEntry) - 1;
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  // without the last entry it is a valid batch of two
+  pMsg->dataLen = dataLen - entries[2]->bytes;
+  ASSERT_EQ(check(pMsg, rpcMsg.contLen), 0);
+  ASSERT_EQ(numOfEntries, 2);
+  ASSERT_EQ(lastIndex, 12);
+
+  pMsg->dataLen = 0;
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+}
+
+TEST_F(SyncReplBatchTest, oversize_entry) {
+  for (SyncIndex index = 11; index <= 13; ++index) addEntry(index, 3);
+  SyncAppendEntries *pMsg = build(3);
+  SSyncRaftEntry    *pEntry = entryAt(pMsg, 1);
+  SSyncRaftEntry     head;
+  memcpy(&head, pEntry, sizeof(SSyncRaftEntry));
+
+  // the entry claims more bytes than left in the msg
+  uint32_t bytes = pMsg->dataLen;
+  memcpy(&pEntry->bytes, &bytes, sizeof(bytes));
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  // the data of the entry does not match its size
+  memcpy(pEntry, &head, sizeof(SSyncRaftEntry));
+  uint32_t entryDataLen = head.dataLen + 1;
+  memcpy(&pEntry->dataLen, &entryDataLen, sizeof(entryDataLen));
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  entryDataLen = UINT32_MAX;
+  memcpy(&pEntry->dataLen, &entryDataLen, sizeof(entryDataLen));
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  bytes = sizeof(SSyncRaftEntry) - 1;
+  memcpy(pEntry, &head, sizeof(SSyncRaftEntry));
+  memcpy(&pEntry->bytes, &bytes, sizeof(bytes));
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  memcpy(pEntry, &head, sizeof(SSyncRaftEntry));
+  ASSERT_EQ(check(pMsg, rpcMsg.contLen), 0);
+  ASSERT_EQ(numOfEntries, 3);
+}
+
+TEST_F(SyncReplBatchTest, non_contiguous_index) {
+  addEntry(11, 3);
+  addEntry(12, 3);
+  addEntry(14, 3);
+  SyncAppendEntries *pMsg = build(3);
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  // the first entry does not follow prevLogIndex
+  pMsg->prevLogIndex = 9;
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  rpcFreeCont(rpcMsg.pCont);
+  rpcMsg.pCont = NULL;
+  entries[2]->index = 12;
+  pMsg = build(3);
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+}
+
+TEST_F(SyncReplBatchTest, term_change) {
+  // a new leader sends the entries of the old term followed by its own
+  addEntry(11, 2);
+  addEntry(12, 3);
+  addEntry(13, 4);
+  addEntry(14, 4);
+  SyncAppendEntries *pMsg = build(2);
+  ASSERT_EQ(check(pMsg, rpcMsg.contLen), 0);
+  ASSERT_EQ(numOfEntries, 4);
+  ASSERT_EQ(lastIndex, 14);
+  ASSERT_EQ(entryAt(pMsg, 1)->term, 3);
+  ASSERT_EQ(entryAt(pMsg, 3)->term, 4);
+
+  // an entry newer than the leader sending it
+  pMsg->term = 3;
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+  pMsg->term = 4;
+
+  // the first entry is older than the entry before it
+  pMsg->prevLogTerm = 3;
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+
+  // the term goes down within the batch
+  rpcFreeCont(rpcMsg.pCont);
+  rpcMsg.pCont = NULL;
+  entries[2]->term = 2;
+  pMsg = build(2);
+  ASSERT_LT(check(pMsg, rpcMsg.contLen), 0);
+}
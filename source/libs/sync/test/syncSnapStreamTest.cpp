@@ -0,0 +1,386 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "syncIndexMgr.h"
+#include "syncMessage.h"
+#include "syncSnapshot.h"
+#include "tchecksum.h"
+#include "tglobal.h"
+
+namespace {
+
+const int32_t   kNumOfBlocks = 8;
+const int32_t   kBlockSize = 64 * 1024;
+const SyncIndex kBeginIndex = 11;
+const SyncIndex kLastIndex = 100;
+const SyncTerm  kLastTerm = 3;
+
+// the blocks of odd i are not compressible
+std::string snapTestBlock(int32_t i) {
+  std::string block(kBlockSize, 'a' + i);
+  if (i % 2 == 1) {
+    uint32_t seed = i;
+    for (auto &c : block) {
+      seed = seed * 1103515245 + 12345;
+      c = (char)(seed >> 16);
+    }
+  }
+  return block;
+}
+
+uint32_t snapTestChecksum(int32_t numOfBlocks) {
+  uint32_t checksum = 0;
+  for (int32_t i = 0; i < numOfBlocks; ++i) {
+    std::string block = snapTestBlock(i);
+    checksum = taosCalcChecksum(checksum, (const uint8_t *)block.data(), block.size());
+  }
+  return checksum;
+}
+
+typedef struct SSnapTestReader {
+  int32_t next;
+} SSnapTestReader;
+
+int32_t snapTestNumOfReads = 0;
+
+int32_t snapTestGetSnapshotInfo(const SSyncFSM *pFsm, SSnapshot *pSnapshot) {
+  pSnapshot->lastApplyIndex = kLastIndex;
+  pSnapshot->lastApplyTerm = kLastTerm;
+  pSnapshot->lastConfigIndex = SYNC_INDEX_INVALID;
+  return 0;
+}
+
+int32_t snapTestStartRead(const SSyncFSM *pFsm, void *pParam, void **ppReader) {
+  *ppReader = taosMemoryCalloc(1, sizeof(SSnapTestReader));
+  ++snapTestNumOfReads;
+  return 0;
+}
+
+void snapTestStopRead(const SSyncFSM *pFsm, void *pReader) { taosMemoryFree(pReader); }
+
+int32_t snapTestDoRead(const SSyncFSM *pFsm, void *pReader, void **ppBuf, int32_t *len) {
+  SSnapTestReader *pTestReader = (SSnapTestReader *)pReader;
+  *ppBuf = NULL;
+  *len = 0;
+  if (pTestReader->next < kNumOfBlocks) {
+    std::string block = snapTestBlock(pTestReader->next++);
+    *ppBuf = taosMemoryMalloc(block.size());
+    memcpy(*ppBuf, block.data(), block.size());
+    *len = block.size();
+  }
+  return 0;
+}
+
+std::vector<std::string> snapTestSent;
+
+int32_t snapTestSendMsg(const SEpSet *pEpSet, SRpcMsg *pMsg) {
+  snapTestSent.push_back(std::string((char *)pMsg->pCont, pMsg->contLen));
+  rpcFreeCont(pMsg->pCont);
+  return 0;
+}
+
+class SyncSnapshotTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    compress = tsSyncSnapReplCompress;
+    maxRate = tsSyncSnapReplMaxRate;
+    snapTestNumOfReads = 0;
+    snapTestSent.clear();
+
+    memset(&fsm, 0, sizeof(fsm));
+    fsm.FpGetSnapshotInfo = snapTestGetSnapshotInfo;
+    fsm.FpSnapshotStartRead = snapTestStartRead;
+    fsm.FpSnapshotStopRead = snapTestStopRead;
+    fsm.FpSnapshotDoRead = snapTestDoRead;
+
+    memset(&node, 0, sizeof(node));
+    node.vgId = 2;
+    node.myRaftId.addr = 1;
+    node.myRaftId.vgId = 2;
+    peerId.addr = 2;
+    peerId.vgId = 2;
+    node.totalReplicaNum = 2;
+    node.replicaNum = 2;
+    node.replicasId[0] = node.myRaftId;
+    node.replicasId[1] = peerId;
+    node.peersNum = 1;
+    node.peersId[0] = peerId;
+    node.syncSendMSg = snapTestSendMsg;
+    node.state = TAOS_SYNC_STATE_LEADER;
+    node.pingTimerMS = 1000;
+    node.raftStore.currentTerm = 4;
+    taosThreadMutexInit(&node.raftStore.mutex, NULL);
+    node.pFsm = &fsm;
+    node.pNextIndex = syncIndexMgrCreate(&node);
+
+    pSender = snapshotSenderCreate(&node, 1);
+    ASSERT_NE(pSender, nullptr);
+    node.senders[1] = pSender;
+  }
+
+  void TearDown() override {
+    snapshotSenderStop(pSender, false);
+    snapshotSenderDestroy(pSender);
+    syncIndexMgrDestroy(node.pNextIndex);
+    taosThreadMutexDestroy(&node.raftStore.mutex);
+    snapTestSent.clear();
+    tsSyncSnapReplCompress = compress;
+    tsSyncSnapReplMaxRate = maxRate;
+  }
+
+  // a snapshot rsp of the peer, with the checkpoint to resume from if given
+  int32_t recvRsp(int32_t ack, int32_t payloadType, const SSyncSnapCheckpoint *pCkpt) {
+    int32_t dataLen = pCkpt ? sizeof(SSyncTLV) + sizeof(SSyncSnapCheckpoint) : 0;
+    SRpcMsg rpcMsg = {0};
+    EXPECT_EQ(syncBuildSnapshotSendRsp(&rpcMsg, dataLen, node.vgId), 0);
+
+    SyncSnapshotRsp *pMsg = (SyncSnapshotRsp *)rpcMsg.pCont;
+    pMsg->srcId = peerId;
+    pMsg->destId = node.myRaftId;
+    pMsg->term = pSender->term;
+    pMsg->startTime = pSender->startTime;
+    pMsg->lastIndex = kLastIndex;
+    pMsg->lastTerm = kLastTerm;
+    pMsg->ack = ack;
+    pMsg->snapBeginIndex = kBeginIndex;
+    pMsg->payloadType = payloadType;
+    if (pCkpt) {
+      SSyncTLV *pTlv = (SSyncTLV *)pMsg->data;
+      pTlv->typ = TDMT_SYNC_SNAPSHOT_RESUME;
+      pTlv->len = sizeof(SSyncSnapCheckpoint);
+      memcpy(pTlv->val, pCkpt, sizeof(SSyncSnapCheckpoint));
+    }
+
+    int32_t code = syncNodeOnSnapshotRsp(&node, &rpcMsg);
+    rpcFreeCont(rpcMsg.pCont);
+    return code;
+  }
+
+  // start the sender and answer its prep msg
+  void prepare(const SSyncSnapCheckpoint *pCkpt) {
+    ASSERT_EQ(snapshotSenderStart(pSender), 0);
+    ASSERT_EQ(snapTestSent.size(), 1);
+    ASSERT_EQ(sentMsg(0)->seq, SYNC_SNAPSHOT_SEQ_PREP);
+    snapTestSent.clear();
+    ASSERT_EQ(recvRsp(SYNC_SNAPSHOT_SEQ_PREP, 0, pCkpt), 0);
+  }
+
+  // the timer routine continues the sender until the checkpoint is verified
+  void waitVerified() {
+    for (int32_t i = 0; i < 10000 && atomic_load_8(&pSender->verifyState) != SYNC_SNAP_VERIFY_NONE; ++i) {
+      ASSERT_EQ(snapshotSenderContinue(pSender), 0);
+      taosMsleep(1);
+    }
+    ASSERT_EQ(atomic_load_8(&pSender->verifyState), SYNC_SNAP_VERIFY_NONE);
+  }
+
+  SSyncSnapCheckpoint checkpoint(int32_t seq, uint32_t checksum) {
+    SSyncSnapCheckpoint ckpt = {0};
+    ckpt.seq = seq;
+    ckpt.checksum = checksum;
+    ckpt.beginIndex = kBeginIndex;
+    ckpt.lastIndex = kLastIndex;
+    ckpt.lastTerm = kLastTerm;
+    return ckpt;
+  }
+
+  SyncSnapshotSend *sentMsg(int32_t i) { return (SyncSnapshotSend *)snapTestSent[i].data(); }
+
+  // the data msgs sent are the blocks from the given one on, with the checksums chained from the given one
+  void checkSentBlocks(int32_t firstBlock, uint32_t checksum) {
+    int32_t block = firstBlock;
+    for (int32_t i = 0; i < (int32_t)snapTestSent.size(); ++i) {
+      SyncSnapshotSend *pMsg = sentMsg(i);
+      if (pMsg->seq <= SYNC_SNAPSHOT_SEQ_BEGIN || pMsg->seq >= SYNC_SNAPSHOT_SEQ_END) continue;
+      ASSERT_EQ(pMsg->seq, block + 1);
+      ASSERT_EQ(pMsg->payloadType, TDMT_SYNC_SNAPSHOT_BLOCK);
+
+      char   *pBuf = NULL, *pData = NULL;
+      int32_t dataLen = 0;
+      ASSERT_EQ(syncSnapBlockDecode(pMsg, &checksum, &pBuf, &pData, &dataLen), 0);
+      ASSERT_EQ(std::string(pData, dataLen), snapTestBlock(block));
+      taosMemoryFree(pBuf);
+      ++block;
+    }
+    numOfBlocksSent = block - firstBlock;
+  }
+
+  SSyncFSM             fsm;
+  SSyncNode            node;
+  SRaftId              peerId = {0};
+  SSyncSnapshotSender *pSender = NULL;
+  int32_t              numOfBlocksSent = 0;
+  bool                 compress = true;
+  int32_t              maxRate = 0;
+};
+
+}  // namespace
+
+TEST_F(SyncSnapshotTest, encode_decode) {
+  for (bool cmpr : {false, true}) {
+    tsSyncSnapReplCompress = cmpr;
+    uint32_t checksum = 0, decodeChecksum = 0;
+    for (int32_t i = 0; i < 4; ++i) {
+      std::string    block = snapTestBlock(i);
+      SyncSnapBlock *pBlk = (SyncSnapBlock *)taosMemoryCalloc(1, sizeof(SyncSnapBlock));
+      pBlk->pBlock = taosMemoryMalloc(block.size());
+      memcpy(pBlk->pBlock, block.data(), block.size());
+      pBlk->blockLen = block.size();
+
+      checksum = taosCalcChecksum(checksum, (const uint8_t *)block.data(), block.size());
+      ASSERT_EQ(syncSnapBlockEncode(pBlk, checksum), 0);
+      ASSERT_EQ(pBlk->blockType, TDMT_SYNC_SNAPSHOT_BLOCK);
+      SSyncSnapBlockHead *pHead = (SSyncSnapBlockHead *)pBlk->pBlock;
+      ASSERT_EQ(pHead->cmprAlg, (cmpr && i % 2 == 0) ? SYNC_SNAP_CMPR_LZ4 : SYNC_SNAP_CMPR_NONE);
+      if (pHead->cmprAlg == SYNC_SNAP_CMPR_LZ4) {
+        ASSERT_LT(pBlk->blockLen, kBlockSize);
+      }
+
+      SRpcMsg rpcMsg = {0};
+      ASSERT_EQ(syncBuildSnapshotSend(&rpcMsg, pBlk->blockLen, node.vgId), 0);
+      SyncSnapshotSend *pMsg = (SyncSnapshotSend *)rpcMsg.pCont;
+      memcpy(pMsg->data, pBlk->pBlock, pBlk->blockLen);
+
+      char   *pBuf = NULL, *pData = NULL;
+      int32_t dataLen = 0;
+      ASSERT_EQ(syncSnapBlockDecode(pMsg, &decodeChecksum, &pBuf, &pData, &dataLen), 0);
+      ASSERT_EQ(std::string(pData, dataLen), block);
+      ASSERT_EQ(decodeChecksum, checksum);
+
+      taosMemoryFree(pBuf);
+      rpcFreeCont(rpcMsg.pCont);
+      syncSnapBlockDestroy(pBlk);
+    }
+  }
+}
+
+TEST_F(SyncSnapshotTest, checksum_mismatch) {
+  for (int32_t i = 0; i < 2; ++i) {
+    tsSyncSnapReplCompress = true;
+    std::string    block = snapTestBlock(i);
+    SyncSnapBlock *pBlk = (SyncSnapBlock *)taosMemoryCalloc(1, sizeof(SyncSnapBlock));
+    pBlk->pBlock = taosMemoryMalloc(block.size());
+    memcpy(pBlk->pBlock, block.data(), block.size());
+    pBlk->blockLen = block.size();
+    uint32_t checksum = taosCalcChecksum(0, (const uint8_t *)block.data(), block.size());
+    ASSERT_EQ(syncSnapBlockEncode(pBlk, checksum), 0);
+
+    SRpcMsg rpcMsg = {0};
+    ASSERT_EQ(syncBuildSnapshotSend(&rpcMsg, pBlk->blockLen, node.vgId), 0);
+    SyncSnapshotSend *pMsg = (SyncSnapshotSend *)rpcMsg.pCont;
+    memcpy(pMsg->data, pBlk->pBlock, pBlk->blockLen);
+
+    // the blocks before it differ
+    char    *pBuf = NULL, *pData = NULL;
+    int32_t  dataLen = 0;
+    uint32_t decodeChecksum = 1;
+    ASSERT_NE(syncSnapBlockDecode(pMsg, &decodeChecksum, &pBuf, &pData, &dataLen), 0);
+    ASSERT_EQ(terrno, TSDB_CODE_CHECKSUM_ERROR);
+    ASSERT_EQ(decodeChecksum, 1);
+
+    // the data is corrupted
+    decodeChecksum = 0;
+    if (i % 2 == 1) {
+      pMsg->data[pMsg->dataLen - 1] ^= 0x1;
+      ASSERT_NE(syncSnapBlockDecode(pMsg, &decodeChecksum, &pBuf, &pData, &dataLen), 0);
+      ASSERT_EQ(terrno, TSDB_CODE_CHECKSUM_ERROR);
+    } else {
+      pMsg->dataLen -= 1;
+      ASSERT_NE(syncSnapBlockDecode(pMsg, &decodeChecksum, &pBuf, &pData, &dataLen), 0);
+      ASSERT_EQ(terrno, TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG);
+    }
+    ASSERT_EQ(decodeChecksum, 0);
+
+    rpcFreeCont(rpcMsg.pCont);
+    syncSnapBlockDestroy(pBlk);
+  }
+}
+
+TEST_F(SyncSnapshotTest, resume_accepted) {
+  SSyncSnapCheckpoint ckpt = checkpoint(3, snapTestChecksum(3));
+  prepare(&ckpt);
+
+  // begin is sent once the checkpoint is verified
+  waitVerified();
+  ASSERT_EQ(snapTestSent.size(), 1);
+  SyncSnapshotSend *pBegin = sentMsg(0);
+  ASSERT_EQ(pBegin->seq, SYNC_SNAPSHOT_SEQ_BEGIN);
+  ASSERT_EQ(pBegin->payloadType, TDMT_SYNC_SNAPSHOT_RESUME);
+  ASSERT_EQ(pBegin->dataLen, sizeof(SSyncSnapCheckpoint));
+  ASSERT_EQ(memcmp(pBegin->data, &ckpt, sizeof(ckpt)), 0);
+  ASSERT_EQ(pSender->seq, ckpt.seq);
+  ASSERT_EQ(snapTestNumOfReads, 1);
+
+  // the blocks after the checkpoint follow the ack of begin
+  snapTestSent.clear();
+  ASSERT_EQ(recvRsp(SYNC_SNAPSHOT_SEQ_BEGIN, TDMT_SYNC_SNAPSHOT_BLOCK, NULL), 0);
+  checkSentBlocks(ckpt.seq, ckpt.checksum);
+  ASSERT_EQ(numOfBlocksSent, kNumOfBlocks - ckpt.seq);
+}
+
+TEST_F(SyncSnapshotTest, resume_rejected) {
+  // the checksum does not match, or the snapshot has fewer blocks than the checkpoint
+  SSyncSnapCheckpoint ckpts[] = {checkpoint(3, snapTestChecksum(3) + 1), checkpoint(kNumOfBlocks + 1, 0)};
+  for (auto &ckpt : ckpts) {
+    snapshotSenderStop(pSender, false);
+    snapTestSent.clear();
+    snapTestNumOfReads = 0;
+    prepare(&ckpt);
+
+    // all the blocks are sent with a new reader
+    waitVerified();
+    ASSERT_EQ(snapTestSent.size(), 1);
+    SyncSnapshotSend *pBegin = sentMsg(0);
+    ASSERT_EQ(pBegin->seq, SYNC_SNAPSHOT_SEQ_BEGIN);
+    ASSERT_EQ(pBegin->payloadType, 0);
+    ASSERT_EQ(pBegin->dataLen, 0);
+    ASSERT_EQ(pSender->seq, SYNC_SNAPSHOT_SEQ_BEGIN);
+    ASSERT_EQ(snapTestNumOfReads, 2);
+
+    snapTestSent.clear();
+    ASSERT_EQ(recvRsp(SYNC_SNAPSHOT_SEQ_BEGIN, TDMT_SYNC_SNAPSHOT_BLOCK, NULL), 0);
+    checkSentBlocks(0, 0);
+    ASSERT_EQ(numOfBlocksSent, kNumOfBlocks);
+  }
+}
+
+TEST_F(SyncSnapshotTest, stop_while_verifying) {
+  SSyncSnapCheckpoint ckpt = checkpoint(kNumOfBlocks, snapTestChecksum(kNumOfBlocks));
+  prepare(&ckpt);
+
+  // a duplicate prep rsp does not start another reader
+  ASSERT_EQ(recvRsp(SYNC_SNAPSHOT_SEQ_PREP, 0, &ckpt), 0);
+  ASSERT_EQ(snapTestNumOfReads, 1);
+
+  snapshotSenderStop(pSender, false);
+  ASSERT_EQ(atomic_load_8(&pSender->verifyState), SYNC_SNAP_VERIFY_NONE);
+  ASSERT_EQ(pSender->pReader, nullptr);
+  ASSERT_TRUE(snapTestSent.empty());
+}
+
+TEST_F(SyncSnapshotTest, throttled_window) {
+  tsSyncSnapReplCompress = false;
+  prepare(NULL);
+  ASSERT_EQ(snapTestSent.size(), 1);
+  ASSERT_EQ(sentMsg(0)->seq, SYNC_SNAPSHOT_SEQ_BEGIN);
+
+  // 1MB/s with the tokens of a byte left, the window stops after a block or so
+  tsSyncSnapReplMaxRate = 1;
+  pSender->rateTokens = 1;
+  pSender->rateRefillMs = taosGetTimestampMs();
+  snapTestSent.clear();
+  ASSERT_EQ(recvRsp(SYNC_SNAPSHOT_SEQ_BEGIN, TDMT_SYNC_SNAPSHOT_BLOCK, NULL), 0);
+  ASSERT_TRUE(pSender->throttled);
+  checkSentBlocks(0, 0);
+  ASSERT_GE(numOfBlocksSent, 1);
+  ASSERT_LT(numOfBlocksSent, kNumOfBlocks);
+
+  // the timer routine sends the rest of the window once the cap is lifted
+  tsSyncSnapReplMaxRate = 0;
+  ASSERT_EQ(snapshotSenderContinue(pSender), 0);
+  ASSERT_FALSE(pSender->throttled);
+  checkSentBlocks(0, 0);
+  ASSERT_EQ(numOfBlocksSent, kNumOfBlocks);
+  ASSERT_EQ(pSender->seq, SYNC_SNAPSHOT_SEQ_END);
+}
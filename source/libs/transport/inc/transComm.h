@@ -437,8 +437,18 @@ void transInit();
 void transCleanup();
 void transPrintEpSet(SEpSet* pEpSet);
 
+#define TRANS_COMP_SKIP_RATIO   900           // per mille, compression is paused on a conn compressing worse than it
+#define TRANS_COMP_PROBE_MSGS   32            // msgs sent raw before a paused conn tries compression again
+#define TRANS_COMP_BACKLOG_SIZE (256 * 1024)  // bytes queued on a conn, above which lz4hc is used for a better ratio
+
+// compression of the msgs sent on a conn, adapted to how well its data compresses and how fast its link drains
+typedef struct {
+  int32_t ratio;  // per mille, moving average of the compressed size to the raw size
+  int32_t skip;   // msgs left to send raw
+} STransCompStat;
+
 void    transFreeMsg(void* msg);
-int32_t transCompressMsg(char* msg, int32_t len);
+int32_t transCompressMsg(char* msg, int32_t len, STransCompStat* pStat, int64_t backlog);
 int32_t transDecompressMsg(char** msg, int32_t len);
 
 int32_t transOpenRefMgt(int size, void (*func)(void*));
@@ -18,6 +18,7 @@
 
 #include <uv.h>
 #include "lz4.h"
+#include "lz4hc.h"
 #include "os.h"
 #include "taoserror.h"
 #include "tglobal.h"
@@ -68,6 +69,7 @@ typedef struct {
   int8_t        connLimitLock;  // 0: no lock. 1. lock
   int8_t        supportBatch;   // 0: no batch, 1: support batch
   int32_t       batchSize;
+  int32_t       connMaxInflight;  // max reqs in flight on one conn, <= 1: no multiplexing
   int32_t       timeToGetConn;
   int           index;
   void*         parent;
@@ -26,6 +26,7 @@ typedef struct SConnList {
   queue     conns;
   int32_t   size;
   SMsgList* list;
+  queue     mconns;  // conns with reqs multiplexed on them
 } SConnList;
 
 typedef struct {
@@ -71,11 +72,16 @@ typedef struct SCliConn {
   STransCtx  ctx;
   bool       broken;  // link broken or not
   ConnStatus status;  //
+  bool       connected;
+  bool       mux;  // multiple reqs in flight, resp matched by the seq in ahandle of head
+  uint64_t   seq;
 
   SCliBatch* pBatch;
 
   SDelayTask* task;
 
+  STransCompStat compStat;
+
   char* dstAddr;
   char  src[32];
   char  dst[32];
@@ -93,6 +99,7 @@ typedef struct SCliMsg {
   uint64_t st;
   int      sent;  //(0: no send, 1: alread sent)
   queue    seqq;  //
+  uint64_t seq;   // seq on the multiplexed conn
 } SCliMsg;
 
 typedef struct SCliThrd {
@@ -294,6 +301,15 @@ static void cliWalkCb(uv_handle_t* handle, void* arg);
 #define REQUEST_PERSIS_HANDLE(msg)   ((msg)->info.persistHandle == 1)
 #define REQUEST_RELEASE_HANDLE(cmsg) ((cmsg)->type == Release)
 
+// only the reqs with resp and without handle or read timer can be multiplexed on one conn
+#define REQUEST_CAN_MUX(pInst, cmsg)                                                           \
+  ((pInst)->connMaxInflight > 1 && (cmsg)->type == Normal && !REQUEST_NO_RESP(&(cmsg)->msg) && \
+   !REQUEST_PERSIS_HANDLE(&(cmsg)->msg) && (cmsg)->msg.info.handle == 0 &&                     \
+   ((pInst)->startTimer == NULL || !(pInst)->startTimer(0, (cmsg)->msg.msgType)))
+
+// max msgs coalesced into one write on the multiplexed conn
+#define CONN_MUX_WRITE_LIMIT 64
+
 #define EPSET_IS_VALID(epSet)       ((epSet) != NULL && (epSet)->numOfEps >= 0 && (epSet)->inUse >= 0)
 #define EPSET_GET_SIZE(epSet)       (epSet)->numOfEps
 #define EPSET_GET_INUSE_IP(epSet)   ((epSet)->eps[(epSet)->inUse].fqdn)
@@ -365,6 +381,76 @@ bool cliConnSendSeqMsg(int64_t refId, SCliConn* conn) {
   return false;
 }
 
+static SCliConn* cliMuxGetConn(SCliThrd* pThrd, char* key) {
+  STrans*    pTransInst = pThrd->pTransInst;
+  SConnList* plist = taosHashGet((SHashObj*)pThrd->pool, key, strlen(key));
+  if (plist == NULL) {
+    return NULL;
+  }
+
+  queue* h = NULL;
+  QUEUE_FOREACH(h, &plist->mconns) {
+    SCliConn* conn = QUEUE_DATA(h, SCliConn, q);
+    if (conn->broken == false && transQueueSize(&conn->cliMsgs) < pTransInst->connMaxInflight) {
+      return conn;
+    }
+  }
+  return NULL;
+}
+static void cliMuxAttachConn(SCliThrd* pThrd, SCliConn* conn, char* key) {
+  SConnList* plist = taosHashGet((SHashObj*)pThrd->pool, key, strlen(key));
+  if (plist == NULL) {
+    return;
+  }
+  conn->mux = true;
+  QUEUE_PUSH(&plist->mconns, &conn->q);
+  tDebug("%s conn %p start to multiplex reqs, dst:%s", CONN_GET_INST_LABEL(conn), conn, key);
+}
+static void cliMuxDetachConn(SCliConn* conn) {
+  QUEUE_REMOVE(&conn->q);
+  QUEUE_INIT(&conn->q);
+}
+static SCliMsg* cliMuxGetMsg(SCliConn* conn, uint64_t seq) {
+  for (int i = 0; i < transQueueSize(&conn->cliMsgs); i++) {
+    SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, i);
+    if (pMsg->sent == 1 && pMsg->seq == seq) {
+      return transQueueRm(&conn->cliMsgs, i);
+    }
+  }
+  return NULL;
+}
+static void cliMuxSend(SCliConn* pConn);
+static void cliMuxReleaseConn(SCliConn* conn) {
+  SCliThrd* pThrd = conn->hostThrd;
+  STrans*   pTransInst = pThrd->pTransInst;
+
+  if (transQueueEmpty(&conn->cliMsgs)) {
+    // nothing in flight, back to pool as a normal conn
+    cliMuxDetachConn(conn);
+    conn->mux = false;
+    addConnToPool(pThrd->pool, conn);
+    return;
+  }
+
+  // reqs waiting for a conn can share this one
+  SConnList* plist = taosHashGet((SHashObj*)pThrd->pool, conn->dstAddr, strlen(conn->dstAddr));
+  if (plist != NULL) {
+    SMsgList* list = plist->list;
+    while (!QUEUE_IS_EMPTY(&list->msgQ) && transQueueSize(&conn->cliMsgs) < pTransInst->connMaxInflight) {
+      queue*   h = QUEUE_HEAD(&list->msgQ);
+      SCliMsg* pMsg = QUEUE_DATA(h, SCliMsg, q);
+      if (!REQUEST_CAN_MUX(pTransInst, pMsg)) {
+        break;
+      }
+      QUEUE_REMOVE(h);
+      transDQCancel(pThrd->waitConnQueue, pMsg->ctx->task);
+      pMsg->ctx->task = NULL;
+      transQueuePush(&conn->cliMsgs, pMsg);
+    }
+  }
+  cliMuxSend(conn);
+}
+
 void cliHandleResp(SCliConn* conn) {
   SCliThrd* pThrd = conn->hostThrd;
   STrans*   pTransInst = pThrd->pTransInst;
@@ -409,7 +495,13 @@ void cliHandleResp(SCliConn* conn) {
 
   SCliMsg*       pMsg = NULL;
   STransConnCtx* pCtx = NULL;
-  if (CONN_NO_PERSIST_BY_APP(conn)) {
+  if (conn->mux) {
+    pMsg = cliMuxGetMsg(conn, (uint64_t)pHead->ahandle);
+
+    pCtx = pMsg ? pMsg->ctx : NULL;
+    transMsg.info.ahandle = pCtx ? pCtx->ahandle : NULL;
+    tDebug("%s conn %p get ahandle %p, mux: 1", CONN_GET_INST_LABEL(conn), conn, transMsg.info.ahandle);
+  } else if (CONN_NO_PERSIST_BY_APP(conn)) {
     pMsg = transQueuePop(&conn->cliMsgs);
 
     pCtx = pMsg ? pMsg->ctx : NULL;
@@ -457,6 +549,7 @@ void cliHandleResp(SCliConn* conn) {
 
   if (pMsg == NULL || (pMsg && pMsg->type != Release)) {
     if (cliAppCb(conn, &transMsg, pMsg) != 0) {
+      if (conn->mux) cliMuxReleaseConn(conn);
       return;
     }
   }
@@ -464,6 +557,9 @@ void cliHandleResp(SCliConn* conn) {
   tDebug("conn %p msg refId: %" PRId64 "", conn, refId);
 
   destroyCmsg(pMsg);
+  if (conn->mux) {
+    return cliMuxReleaseConn(conn);
+  }
   if (cliConnSendSeqMsg(refId, conn)) {
     return;
   }
@@ -493,6 +589,10 @@ static void cliDestroyMsgInExhandle(int64_t refId) {
   }
 }
 void cliHandleExceptImpl(SCliConn* pConn, int32_t code) {
+  if (pConn->mux) {
+    // no more reqs on it, the ones in flight are failed below
+    cliMuxDetachConn(pConn);
+  }
   if (transQueueEmpty(&pConn->cliMsgs)) {
     if (pConn->broken == true && CONN_NO_PERSIST_BY_APP(pConn)) {
       tTrace("%s conn %p handle except, persist:0", CONN_GET_INST_LABEL(pConn), pConn);
@@ -553,6 +653,8 @@ void cliHandleExceptImpl(SCliConn* pConn, int32_t code) {
       int64_t refId = (pMsg == NULL ? 0 : (int64_t)(pMsg->msg.info.handle));
       cliDestroyMsgInExhandle(refId);
       if (cliAppCb(pConn, &transMsg, pMsg) != 0) {
+        // the multiplexed conn is released after all reqs in flight are failed
+        if (pConn->mux) continue;
         return;
       }
     }
@@ -602,6 +704,12 @@ void* destroyConnPool(SCliThrd* pThrd) {
       SCliConn* c = QUEUE_DATA(h, SCliConn, q);
       cliDestroyConn(c, true);
     }
+    // multiplexed conns are closed with the loop, only unlink them from the list to be freed
+    while (!QUEUE_IS_EMPTY(&connList->mconns)) {
+      queue* h = QUEUE_HEAD(&connList->mconns);
+      QUEUE_REMOVE(h);
+      QUEUE_INIT(h);
+    }
 
     SMsgList* msglist = connList->list;
     while (!QUEUE_IS_EMPTY(&msglist->msgQ)) {
@@ -638,6 +746,7 @@ static SCliConn* getConnFromPool(SCliThrd* pThrd, char* key, bool* exceed) {
     nList->numOfConn++;
 
     QUEUE_INIT(&plist->conns);
+    QUEUE_INIT(&plist->mconns);
     plist->list = nList;
   }
 
@@ -678,6 +787,7 @@ static SCliConn* getConnFromPool2(SCliThrd* pThrd, char* key, SCliMsg** pMsg) {
     nList->numOfConn++;
 
     QUEUE_INIT(&plist->conns);
+    QUEUE_INIT(&plist->mconns);
     plist->list = nList;
   }
 
@@ -1022,6 +1132,11 @@ static void cliSendCb(uv_write_t* req, int status) {
     }
     return;
   }
+  if (pConn->mux) {
+    uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
+    cliMuxSend(pConn);
+    return;
+  }
   if (cliHandleNoResp(pConn) == true) {
     tTrace("%s conn %p no resp required", CONN_GET_INST_LABEL(pConn), pConn);
     return;
@@ -1072,7 +1187,8 @@ void cliSendBatch(SCliConn* pConn) {
 
     if (pHead->comp == 0) {
       if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-        msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
+        msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen, &pConn->compStat, pConn->stream->write_queue_size) +
+                 sizeof(STransMsgHead);
         pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
       }
     } else {
@@ -1088,18 +1204,10 @@ void cliSendBatch(SCliConn* pConn) {
   uv_write(req, (uv_stream_t*)pConn->stream, wb, wLen, cliSendBatchCb);
   taosMemoryFree(wb);
 }
-void cliSend(SCliConn* pConn) {
+static int32_t cliBuildSendData(SCliConn* pConn, SCliMsg* pCliMsg, uv_buf_t* wb) {
   SCliThrd* pThrd = pConn->hostThrd;
   STrans*   pTransInst = pThrd->pTransInst;
 
-  if (transQueueEmpty(&pConn->cliMsgs)) {
-    tError("%s conn %p not msg to send", pTransInst->label, pConn);
-    cliHandleExcept(pConn);
-    return;
-  }
-
-  SCliMsg* pCliMsg = NULL;
-  CONN_GET_NEXT_SENDMSG(pConn);
   pCliMsg->sent = 1;
 
   STransConnCtx* pCtx = pCliMsg->ctx;
@@ -1127,6 +1235,11 @@ void cliSend(SCliConn* pConn) {
     pHead->version = TRANS_VER;
     pHead->compatibilityVer = htonl(pTransInst->compatibilityVer);
   }
+  if (pConn->mux) {
+    // echoed back by server, even if the msg is already compressed by a previous try
+    pCliMsg->seq = ++pConn->seq;
+    pHead->ahandle = pCliMsg->seq;
+  }
   pHead->timestamp = taosHton64(taosGetTimestampUs());
 
   if (pHead->persist == 1) {
@@ -1151,7 +1264,8 @@ void cliSend(SCliConn* pConn) {
 
   if (pHead->comp == 0) {
     if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-      msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
+      msgLen = transCompressMsg(pMsg->pCont, pMsg->contLen, &pConn->compStat, pConn->stream->write_queue_size) +
+               sizeof(STransMsgHead);
       pHead->msgLen = (int32_t)htonl((uint32_t)msgLen);
     }
   } else {
@@ -1161,13 +1275,63 @@ void cliSend(SCliConn* pConn) {
   tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
           TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
 
-  uv_buf_t    wb = uv_buf_init((char*)pHead, msgLen);
+  *wb = uv_buf_init((char*)pHead, msgLen);
+  return msgLen;
+}
+static void cliMuxSend(SCliConn* pConn) {
+  // reqs queued while connecting or while the previous write is in progress are coalesced into the next write
+  if (pConn->connected == false || !QUEUE_IS_EMPTY(&pConn->wreqQueue)) {
+    return;
+  }
+
+  uv_buf_t wb[CONN_MUX_WRITE_LIMIT];
+  int32_t  num = 0, size = transQueueSize(&pConn->cliMsgs);
+  for (int32_t i = 0; i < size && num < CONN_MUX_WRITE_LIMIT; i++) {
+    SCliMsg* pCliMsg = transQueueGet(&pConn->cliMsgs, i);
+    if (pCliMsg->sent == 0) {
+      cliBuildSendData(pConn, pCliMsg, &wb[num++]);
+    }
+  }
+  if (num == 0) {
+    return;
+  }
+
+  uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
+
+  int status = uv_write(req, (uv_stream_t*)pConn->stream, wb, num, cliSendCb);
+  if (status != 0) {
+    tError("%s conn %p failed to send %d msgs, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, num,
+           uv_err_name(status));
+    cliHandleExcept(pConn);
+  }
+}
+void cliSend(SCliConn* pConn) {
+  SCliThrd* pThrd = pConn->hostThrd;
+  STrans*   pTransInst = pThrd->pTransInst;
+
+  if (transQueueEmpty(&pConn->cliMsgs)) {
+    tError("%s conn %p not msg to send", pTransInst->label, pConn);
+    cliHandleExcept(pConn);
+    return;
+  }
+  if (pConn->mux) {
+    cliMuxSend(pConn);
+    return;
+  }
+
+  SCliMsg* pCliMsg = NULL;
+  CONN_GET_NEXT_SENDMSG(pConn);
+
+  uv_buf_t wb;
+  cliBuildSendData(pConn, pCliMsg, &wb);
+
+  STraceId*   trace = &pCliMsg->msg.info.traceId;
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
 
   int status = uv_write(req, (uv_stream_t*)pConn->stream, &wb, 1, cliSendCb);
   if (status != 0) {
-    tGError("%s conn %p failed to send msg:%s, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, TMSG_INFO(pMsg->msgType),
-            uv_err_name(status));
+    tGError("%s conn %p failed to send msg:%s, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn,
+            TMSG_INFO(pCliMsg->msg.msgType), uv_err_name(status));
     cliHandleExcept(pConn);
   }
   return;
@@ -1381,6 +1545,7 @@ void cliConnCb(uv_connect_t* req, int status) {
   transSockInfo2Str(&sockname, pConn->src);
 
   tTrace("%s conn %p connect to server successfully", CONN_GET_INST_LABEL(pConn), pConn);
+  pConn->connected = true;
   if (pConn->pBatch != NULL) {
     cliSendBatch(pConn);
   } else {
@@ -1482,6 +1647,14 @@ SCliConn* cliGetConn(SCliMsg** pMsg, SCliThrd* pThrd, bool* ignore, char* addr)
     return conn;
   };
 
+  if (REQUEST_CAN_MUX((STrans*)pThrd->pTransInst, *pMsg)) {
+    conn = cliMuxGetConn(pThrd, addr);
+    if (conn != NULL) {
+      tTrace("%s conn %p get from multiplexed conns", CONN_GET_INST_LABEL(conn), conn);
+      return conn;
+    }
+  }
+
   conn = getConnFromPool2(pThrd, addr, pMsg);
   if (conn != NULL) {
     tTrace("%s conn %p get from conn pool:%p", CONN_GET_INST_LABEL(conn), conn, pThrd->pool);
@@ -1611,6 +1784,9 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
   STraceId* trace = &pMsg->msg.info.traceId;
 
   if (conn != NULL) {
+    if (conn->mux == false && REQUEST_CAN_MUX(pTransInst, pMsg)) {
+      cliMuxAttachConn(pThrd, conn, addr);
+    }
     transCtxMerge(&conn->ctx, &pMsg->ctx->appCtx);
     transQueuePush(&conn->cliMsgs, pMsg);
     cliSend(conn);
@@ -1624,6 +1800,10 @@ void cliHandleReq(SCliMsg* pMsg, SCliThrd* pThrd) {
     transQueuePush(&conn->cliMsgs, pMsg);
 
     conn->dstAddr = taosStrdup(addr);
+    if (REQUEST_CAN_MUX(pTransInst, pMsg)) {
+      // later reqs to the same dst are queued on it while connecting
+      cliMuxAttachConn(pThrd, conn, addr);
+    }
 
     uint32_t ipaddr = cliGetIpFromFqdnCache(pThrd->fqdn2ipCache, fqdn);
     if (ipaddr == 0xffffffff) {
@@ -2323,12 +2503,13 @@ bool cliGenRetryRule(SCliConn* pConn, STransMsg* pResp, SCliMsg* pMsg) {
   // B:  epset,   not know leader
   // C:  no epset, leader but not serivce
 
+  // the multiplexed conn is released by caller, other reqs may be still in flight on it
   bool noDelay = false;
   if (code == TSDB_CODE_RPC_BROKEN_LINK || code == TSDB_CODE_RPC_NETWORK_UNAVAIL) {
     tTrace("code str %s, contlen:%d 0", tstrerror(code), pResp->contLen);
     noDelay = cliResetEpset(pCtx, pResp, false);
     transFreeMsg(pResp->pCont);
-    transUnrefCliHandle(pConn);
+    if (!pConn->mux) transUnrefCliHandle(pConn);
   } else if (code == TSDB_CODE_SYN_NOT_LEADER || code == TSDB_CODE_SYN_INTERNAL_ERROR ||
              code == TSDB_CODE_SYN_PROPOSE_NOT_READY || code == TSDB_CODE_VND_STOPPED ||
              code == TSDB_CODE_MNODE_NOT_FOUND || code == TSDB_CODE_APP_IS_STARTING ||
@@ -2336,16 +2517,16 @@ bool cliGenRetryRule(SCliConn* pConn, STransMsg* pResp, SCliMsg* pMsg) {
     tTrace("code str %s, contlen:%d 1", tstrerror(code), pResp->contLen);
     noDelay = cliResetEpset(pCtx, pResp, true);
     transFreeMsg(pResp->pCont);
-    addConnToPool(pThrd->pool, pConn);
+    if (!pConn->mux) addConnToPool(pThrd->pool, pConn);
   } else if (code == TSDB_CODE_SYN_RESTORING) {
     tTrace("code str %s, contlen:%d 0", tstrerror(code), pResp->contLen);
     noDelay = cliResetEpset(pCtx, pResp, true);
-    addConnToPool(pThrd->pool, pConn);
+    if (!pConn->mux) addConnToPool(pThrd->pool, pConn);
     transFreeMsg(pResp->pCont);
   } else {
     tTrace("code str %s, contlen:%d 0", tstrerror(code), pResp->contLen);
     noDelay = cliResetEpset(pCtx, pResp, false);
-    addConnToPool(pThrd->pool, pConn);
+    if (!pConn->mux) addConnToPool(pThrd->pool, pConn);
     transFreeMsg(pResp->pCont);
   }
   if (code != TSDB_CODE_RPC_BROKEN_LINK && code != TSDB_CODE_RPC_NETWORK_UNAVAIL && code != TSDB_CODE_SUCCESS) {
@@ -25,11 +25,22 @@ static int32_t transSyncMsgMgt;
 
 void transDestroySyncMsg(void* msg);
 
-int32_t transCompressMsg(char* msg, int32_t len) {
+/*
+ * pStat is the compression stat of the conn, NULL to always compress. backlog is the bytes queued on the conn and not
+ * written to the socket yet, the link is slower than the msgs are produced when it grows. lz4hc is used then to trade
+ * cpu for bytes on the link. Both produce the lz4 format, so the peer decompresses them the same way.
+ */
+int32_t transCompressMsg(char* msg, int32_t len, STransCompStat* pStat, int64_t backlog) {
   int32_t        ret = 0;
   int            compHdr = sizeof(STransCompMsg);
   STransMsgHead* pHead = transHeadFromCont(msg);
 
+  if (pStat != NULL && pStat->skip > 0) {
+    pStat->skip--;
+    pHead->comp = 0;
+    return len;
+  }
+
   char* buf = taosMemoryMalloc(len + compHdr + 8);  // 8 extra bytes
   if (buf == NULL) {
     tError("failed to allocate memory for rpc msg compression, contLen:%d", len);
@@ -37,7 +48,20 @@ int32_t transCompressMsg(char* msg, int32_t len) {
     return ret;
   }
 
-  int32_t clen = LZ4_compress_default(msg, buf, len, len + compHdr);
+  int32_t clen = 0;
+  if (backlog > TRANS_COMP_BACKLOG_SIZE) {
+    clen = LZ4_compress_HC(msg, buf, len, len + compHdr, LZ4HC_CLEVEL_DEFAULT);
+  } else {
+    clen = LZ4_compress_default(msg, buf, len, len + compHdr);
+  }
+
+  if (pStat != NULL) {
+    int32_t ratio = (clen > 0 && len > 0) ? (int32_t)((int64_t)clen * 1000 / len) : 1000;
+    pStat->ratio = (pStat->ratio * 3 + ratio) / 4;
+    if (pStat->ratio > TRANS_COMP_SKIP_RATIO) {
+      pStat->skip = TRANS_COMP_PROBE_MSGS;
+    }
+  }
   /*
    * only the compressed size is less than the value of contLen - overhead, the compression is applied
    * The first four bytes is set to 0, the second four bytes are utilized to keep the original length of message
@@ -48,7 +72,7 @@ int32_t transCompressMsg(char* msg, int32_t len) {
     pComp->contLen = htonl(len);
     memcpy(msg + compHdr, buf, clen);
 
-    tDebug("compress rpc msg, before:%d, after:%d", len, clen);
+    tDebug("compress rpc msg, before:%d, after:%d, backlog:%" PRId64, len, clen, backlog);
     ret = clen + compHdr;
     pHead->comp = 1;
   } else {
@@ -58,6 +58,8 @@ typedef struct SSvrConn {
   char    ckey[TSDB_PASSWORD_LEN];  // ciphering key
 
   int64_t whiteListVer;
+
+  STransCompStat compStat;
 } SSvrConn;
 
 typedef struct SSvrMsg {
@@ -422,6 +424,7 @@ static bool uvHandleReq(SSvrConn* pConn) {
   // 2. once send out data, cli conn released to conn pool immediately
   // 3. not mixed with persist
   transMsg.info.ahandle = (void*)pHead->ahandle;
+  transMsg.info.reqType = pHead->msgType;
   transMsg.info.handle = (void*)transAcquireExHandle(transGetRefMgt(), pConn->refId);
   transMsg.info.refId = pConn->refId;
   transMsg.info.traceId = pHead->traceId;
@@ -585,15 +588,18 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
   pHead->compatibilityVer = htonl(((STrans*)pConn->pTransInst)->compatibilityVer);
   pHead->version = TRANS_VER;
 
+  // reqs may be multiplexed on one conn by client, so prefer the type of the req this resp is for
+  int32_t inType = pMsg->info.reqType != 0 ? pMsg->info.reqType : pConn->inType;
+
   // handle invalid drop_task resp, TD-20098
-  if (pConn->inType == TDMT_SCH_DROP_TASK && pMsg->code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
+  if (inType == TDMT_SCH_DROP_TASK && pMsg->code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
     transQueuePop(&pConn->srvMsgs);
     destroySmsg(smsg);
     return -1;
   }
 
   if (pConn->status == ConnNormal) {
-    pHead->msgType = (0 == pMsg->msgType ? pConn->inType + 1 : pMsg->msgType);
+    pHead->msgType = (0 == pMsg->msgType ? inType + 1 : pMsg->msgType);
     if (smsg->type == Release) pHead->msgType = 0;
   } else {
     if (smsg->type == Release) {
@@ -603,7 +609,7 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
       transUnrefSrvHandle(pConn);
     } else {
       // set up resp msg type
-      pHead->msgType = (0 == pMsg->msgType ? pConn->inType + 1 : pMsg->msgType);
+      pHead->msgType = (0 == pMsg->msgType ? inType + 1 : pMsg->msgType);
     }
   }
 
@@ -616,7 +622,8 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
 
   STrans* pTransInst = pConn->pTransInst;
   if (pTransInst->compressSize != -1 && pTransInst->compressSize < pMsg->contLen) {
-    len = transCompressMsg(pMsg->pCont, pMsg->contLen) + sizeof(STransMsgHead);
+    len = transCompressMsg(pMsg->pCont, pMsg->contLen, &pConn->compStat, pConn->pTcp->write_queue_size) +
+          sizeof(STransMsgHead);
     pHead->msgLen = (int32_t)htonl((uint32_t)len);
   }
 
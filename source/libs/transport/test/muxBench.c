@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Starts servers on local ports and keeps a fixed number of reqs in flight to them, for each fan-out the msgs/s and
+// the latency percentiles are reported. Run it with -x 1 and -x N to compare one req per conn with N reqs multiplexed.
+
+#include "os.h"
+#include "taoserror.h"
+#include "tglobal.h"
+#include "transLog.h"
+#include "trpc.h"
+#include "tutil.h"
+#include "tversion.h"
+
+#define MAX_SERVERS 256
+#define MAX_FANOUTS 16
+
+typedef struct {
+  int64_t st;
+  int32_t ep;
+} SSlot;
+
+typedef struct {
+  void    *pRpc;
+  SEpSet   epSet[MAX_SERVERS];
+  int32_t  msgSize;
+  int32_t  total;
+  int32_t  sent;
+  int32_t  recv;
+  int32_t  errs;
+  int64_t *cost;
+  tsem_t   overSem;
+} SBench;
+
+static SBench bench = {0};
+
+static void initLogEnv() {
+  const char   *logDir = "/tmp/trans_mux";
+  const char   *defaultLogFileNamePrefix = "taoslog";
+  const int32_t maxLogFileNum = 10000;
+  tsAsyncLog = 0;
+  strcpy(tsLogDir, (char *)logDir);
+  taosRemoveDir(tsLogDir);
+  taosMkDir(tsLogDir);
+
+  if (taosInitLog(defaultLogFileNamePrefix, maxLogFileNum) < 0) {
+    printf("failed to open log file in directory:%s\n", tsLogDir);
+  }
+}
+
+static void processRequest(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  rpcFreeCont(pMsg->pCont);
+
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.pCont = rpcMallocCont(bench.msgSize);
+  rpcMsg.contLen = bench.msgSize;
+  rpcMsg.info = pMsg->info;
+  rpcMsg.code = 0;
+  rpcSendResponse(&rpcMsg);
+}
+
+static void sendRequest(SSlot *pSlot) {
+  if (atomic_fetch_add_32(&bench.sent, 1) >= bench.total) {
+    return;
+  }
+
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.pCont = rpcMallocCont(bench.msgSize);
+  rpcMsg.contLen = bench.msgSize;
+  rpcMsg.info.ahandle = pSlot;
+  rpcMsg.msgType = 1;
+
+  pSlot->st = taosGetTimestampUs();
+  rpcSendRequest(bench.pRpc, &bench.epSet[pSlot->ep], &rpcMsg, NULL);
+}
+
+static void processResponse(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  SSlot *pSlot = (SSlot *)pMsg->info.ahandle;
+  if (pMsg->code != 0) {
+    atomic_add_fetch_32(&bench.errs, 1);
+  }
+  rpcFreeCont(pMsg->pCont);
+
+  int32_t idx = atomic_fetch_add_32(&bench.recv, 1);
+  bench.cost[idx] = taosGetTimestampUs() - pSlot->st;
+  if (idx + 1 == bench.total) {
+    tsem_post(&bench.overSem);
+  } else {
+    sendRequest(pSlot);
+  }
+}
+
+static int costCompare(const void *a, const void *b) {
+  int64_t x = *(int64_t *)a, y = *(int64_t *)b;
+  return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+static void runFanout(int32_t fanout, int32_t numOfSvrs) {
+  SSlot *pSlots = taosMemoryCalloc(fanout, sizeof(SSlot));
+  bench.sent = 0;
+  bench.recv = 0;
+  bench.errs = 0;
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < fanout; i++) {
+    pSlots[i].ep = i % numOfSvrs;
+    sendRequest(&pSlots[i]);
+  }
+  tsem_wait(&bench.overSem);
+  int64_t used = taosGetTimestampUs() - st;
+
+  qsort(bench.cost, bench.total, sizeof(int64_t), costCompare);
+  printf("fanout:%-6d reqs:%-8d msgs/s:%-10.0f p50:%-8" PRId64 "us p99:%-8" PRId64 "us max:%-8" PRId64 "us errs:%d\n",
+         fanout, bench.total, 1000000.0 * bench.total / used, bench.cost[bench.total / 2],
+         bench.cost[(int64_t)bench.total * 99 / 100], bench.cost[bench.total - 1], bench.errs);
+
+  taosMemoryFree(pSlots);
+}
+
+int main(int argc, char *argv[]) {
+  SRpcInit rpcInit;
+  int32_t  port = 7100;
+  int32_t  numOfSvrs = 1;
+  int32_t  fanouts[MAX_FANOUTS] = {1, 16, 64, 256, 1024};
+  int32_t  numOfFanouts = 5;
+  int32_t  numOfThreads = 1;
+  int32_t  maxInflight = 1;
+  int32_t  connLimitNum = 20;
+
+  bench.msgSize = 128;
+  bench.total = 100000;
+
+  rpcDebugFlag = 131;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      port = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-e") == 0 && i < argc - 1) {
+      numOfSvrs = atoi(argv[++i]);
+      TRANGE(numOfSvrs, 1, MAX_SERVERS);
+    } else if (strcmp(argv[i], "-t") == 0 && i < argc - 1) {
+      numOfThreads = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-m") == 0 && i < argc - 1) {
+      bench.msgSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      bench.total = TMAX(atoi(argv[++i]), 1);
+    } else if (strcmp(argv[i], "-f") == 0 && i < argc - 1) {
+      numOfFanouts = 0;
+      char *p = argv[++i];
+      while (*p != 0 && numOfFanouts < MAX_FANOUTS) {
+        fanouts[numOfFanouts++] = TMAX(atoi(p), 1);
+        while (*p != 0 && *p != ',') p++;
+        if (*p == ',') p++;
+      }
+    } else if (strcmp(argv[i], "-x") == 0 && i < argc - 1) {
+      maxInflight = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-c") == 0 && i < argc - 1) {
+      connLimitNum = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-o") == 0 && i < argc - 1) {
+      tsCompressMsgSize = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-d") == 0 && i < argc - 1) {
+      rpcDebugFlag = atoi(argv[++i]);
+    } else {
+      printf("\nusage: %s [options] \n", argv[0]);
+      printf("  [-p port]: first server port, default is:%d\n", port);
+      printf("  [-e servers]: number of servers to fan out to, default is:%d\n", numOfSvrs);
+      printf("  [-t threads]: number of rpc threads of client and each server, default is:%d\n", numOfThreads);
+      printf("  [-m msgSize]: message body size, default is:%d\n", bench.msgSize);
+      printf("  [-n requests]: number of requests for each fan-out, default is:%d\n", bench.total);
+      printf("  [-f fanouts]: reqs kept in flight, separated by comma, default is:1,16,64,256,1024\n");
+      printf("  [-x inflight]: max reqs in flight on one conn, default is:%d\n", maxInflight);
+      printf("  [-c conns]: max conns to one server in each thread, default is:%d\n", connLimitNum);
+      printf("  [-o compSize]: compression message size, default is:%d\n", tsCompressMsgSize);
+      printf("  [-d debugFlag]: debug flag, default:%d\n", rpcDebugFlag);
+      printf("  [-h help]: print out this help\n\n");
+      exit(0);
+    }
+  }
+
+  taosBlockSIGPIPE();
+  initLogEnv();
+
+  void *pSvrs[MAX_SERVERS] = {0};
+  for (int32_t i = 0; i < numOfSvrs; i++) {
+    memset(&rpcInit, 0, sizeof(rpcInit));
+    tstrncpy(rpcInit.localFqdn, "localhost", sizeof(rpcInit.localFqdn));
+    rpcInit.localPort = port + i;
+    rpcInit.label = "SER";
+    rpcInit.numOfThreads = numOfThreads;
+    rpcInit.cfp = processRequest;
+    rpcInit.idleTime = tsShellActivityTimer * 1000;
+    rpcInit.connType = TAOS_CONN_SERVER;
+    rpcInit.compressSize = tsCompressMsgSize;
+    taosVersionStrToInt(version, &(rpcInit.compatibilityVer));
+    pSvrs[i] = rpcOpen(&rpcInit);
+    if (pSvrs[i] == NULL) {
+      printf("failed to start server at port:%d\n", port + i);
+      return -1;
+    }
+
+    SEpSet *pEpSet = &bench.epSet[i];
+    pEpSet->inUse = 0;
+    pEpSet->numOfEps = 1;
+    pEpSet->eps[0].port = port + i;
+    strcpy(pEpSet->eps[0].fqdn, "127.0.0.1");
+  }
+
+  memset(&rpcInit, 0, sizeof(rpcInit));
+  rpcInit.label = "APP";
+  rpcInit.numOfThreads = numOfThreads;
+  rpcInit.cfp = processResponse;
+  rpcInit.sessions = 100;
+  rpcInit.idleTime = tsShellActivityTimer * 1000;
+  rpcInit.user = "michael";
+  rpcInit.connType = TAOS_CONN_CLIENT;
+  rpcInit.compressSize = tsCompressMsgSize;
+  rpcInit.connLimitNum = connLimitNum;
+  rpcInit.connMaxInflight = maxInflight;
+  rpcInit.timeToGetConn = 100 * 1000;
+  taosVersionStrToInt(version, &(rpcInit.compatibilityVer));
+  bench.pRpc = rpcOpen(&rpcInit);
+  if (bench.pRpc == NULL) {
+    printf("failed to initialize RPC client\n");
+    return -1;
+  }
+
+  bench.cost = taosMemoryCalloc(bench.total, sizeof(int64_t));
+  tsem_init(&bench.overSem, 0, 0);
+  taosMsleep(500);
+
+  printf("servers:%d threads:%d msgSize:%d inflight per conn:%d conns limit:%d\n", numOfSvrs, numOfThreads,
+         bench.msgSize, maxInflight, connLimitNum);
+  for (int32_t i = 0; i < numOfFanouts; i++) {
+    runFanout(fanouts[i], numOfSvrs);
+  }
+
+  rpcClose(bench.pRpc);
+  for (int32_t i = 0; i < numOfSvrs; i++) {
+    rpcClose(pSvrs[i]);
+  }
+  tsem_destroy(&bench.overSem);
+  taosMemoryFree(bench.cost);
+  taosCloseLog();
+  return 0;
+}
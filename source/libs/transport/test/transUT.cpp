@@ -13,8 +13,11 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include <gtest/gtest.h>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
+#include <vector>
 #include "tdatablock.h"
 #include "tglobal.h"
 #include "tlog.h"
@@ -40,8 +43,10 @@ static void processContinueSend(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReleaseHandleCb(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processRegisterFailure(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processReqOutOfOrder(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 // client process;
 static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processMuxResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 class Client {
  public:
   void Init(int nThread) {
@@ -65,9 +70,10 @@ class Client {
   }
   SRpcMsg *Resp() { return &this->resp; }
 
-  void Restart(CB cb) {
+  void Restart(CB cb, int32_t maxInflight = 0) {
     rpcClose(this->transCli);
     rpcInit_.cfp = cb;
+    rpcInit_.connMaxInflight = maxInflight;
     taosVersionStrToInt(version, &(rpcInit_.compatibilityVer));
     this->transCli = rpcOpen(&rpcInit_);
   }
@@ -76,6 +82,13 @@ class Client {
     this->transCli = NULL;
   }
 
+  void Send(SRpcMsg *req) {
+    SEpSet epSet = {0};
+    epSet.inUse = 0;
+    addEpIntoEpSet(&epSet, "127.0.0.1", 7000);
+
+    rpcSendRequest(this->transCli, &epSet, req, NULL);
+  }
   void SendAndRecv(SRpcMsg *req, SRpcMsg *resp) {
     SEpSet epSet = {0};
     epSet.inUse = 0;
@@ -201,6 +214,28 @@ static void processRegisterFailure(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet)
   rpcMsg.code = 0;
   rpcSendResponse(&rpcMsg);
 }
+// resp every 8 reqs in reverse order, as reqs multiplexed on one conn are finished out of order
+static std::mutex           pendingMtx;
+static std::vector<SRpcMsg> pendingReqs;
+static void processReqOutOfOrder(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  std::vector<SRpcMsg> reqs;
+  {
+    std::lock_guard<std::mutex> lock(pendingMtx);
+    pendingReqs.push_back(*pMsg);
+    if (pendingReqs.size() < 8) return;
+    reqs.swap(pendingReqs);
+  }
+  for (auto it = reqs.rbegin(); it != reqs.rend(); ++it) {
+    SRpcMsg rpcMsg = {0};
+    rpcMsg.pCont = rpcMallocCont(it->contLen);
+    memcpy(rpcMsg.pCont, it->pCont, it->contLen);
+    rpcMsg.contLen = it->contLen;
+    rpcMsg.info = it->info;
+    rpcMsg.code = 0;
+    rpcFreeCont(it->pCont);
+    rpcSendResponse(&rpcMsg);
+  }
+}
 // client process;
 static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   Client *client = (Client *)parent;
@@ -209,6 +244,21 @@ static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   tDebug("received resp");
 }
 
+static const int32_t    muxReqs = 64;
+static std::atomic<int> muxRecv(0);
+static std::atomic<int> muxErrs(0);
+static void processMuxResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  Client *client = (Client *)parent;
+  int32_t id = (int32_t)(intptr_t)pMsg->info.ahandle;
+  // the resp echoes the id of req, and the resp type follows the type of req
+  if (pMsg->code != 0 || pMsg->contLen != sizeof(int32_t) || *(int32_t *)pMsg->pCont != id ||
+      pMsg->msgType != (id % 2 == 0 ? 2 : 4)) {
+    muxErrs++;
+  }
+  rpcFreeCont(pMsg->pCont);
+  if (++muxRecv == muxReqs) client->SemPost();
+}
+
 static void initEnv() {
   dDebugFlag = 143;
   vDebugFlag = 0;
@@ -245,9 +295,9 @@ class TransObj {
     srv->Start();
   }
 
-  void RestartCli(CB cb) {
+  void RestartCli(CB cb, int32_t maxInflight = 0) {
     //
-    cli->Restart(cb);
+    cli->Restart(cb, maxInflight);
   }
   void StopSrv() {
     //
@@ -263,6 +313,8 @@ class TransObj {
     ///////
     cli->Stop();
   }
+  void cliSend(SRpcMsg *req) { cli->Send(req); }
+  void cliSemWait() { cli->SemWait(); }
   void cliSendAndRecv(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecv(req, resp); }
   void cliSendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecvNoHandle(req, resp); }
 
@@ -504,3 +556,18 @@ TEST_F(TransEnv, noResp) {
 
   // no resp
 }
+TEST_F(TransEnv, cliMuxOutOfOrder) {
+  tr->SetSrvContinueSend(processReqOutOfOrder);
+  tr->RestartCli(processMuxResp, 8);
+  for (int32_t i = 1; i <= muxReqs; i++) {
+    SRpcMsg req = {0};
+    req.msgType = (i % 2 == 0) ? 1 : 3;
+    req.info.ahandle = (void *)(intptr_t)i;
+    req.pCont = rpcMallocCont(sizeof(int32_t));
+    req.contLen = sizeof(int32_t);
+    *(int32_t *)req.pCont = i;
+    tr->cliSend(&req);
+  }
+  tr->cliSemWait();
+  ASSERT_EQ(muxErrs.load(), 0);
+}
@@ -232,4 +232,50 @@ int32_t cloneVal(void *src, void **dst) {
 //  skey = (char *)transCtxDumpVal(ctx, 2);
 //  EXPECT_EQ(0, strcmp(skey, val.c_str()));
 //}
+static char *compressAndRestore(char *pCont, int32_t contLen, STransCompStat *pStat, int64_t backlog, int8_t *comp) {
+  STransMsgHead *pHead = transHeadFromCont(pCont);
+  int32_t        msgLen = transCompressMsg(pCont, contLen, pStat, backlog) + sizeof(STransMsgHead);
+  pHead->msgLen = htonl(msgLen);
+  *comp = pHead->comp;
+
+  char *msg = (char *)pHead;
+  EXPECT_EQ(0, transDecompressMsg(&msg, msgLen));
+  return msg;
+}
+
+TEST(TransCompTest, adaptive) {
+  const int32_t  contLen = 64 * 1024;
+  STransCompStat stat = {0};
+  int8_t         comp = 0;
+
+  // repetitive data is compressed, with lz4 or lz4hc depending on the backlog of the conn
+  for (int64_t backlog : {(int64_t)0, (int64_t)TRANS_COMP_BACKLOG_SIZE * 2}) {
+    char *pCont = (char *)rpcMallocCont(contLen);
+    for (int32_t i = 0; i < contLen; ++i) pCont[i] = i % 97;
+
+    char *msg = compressAndRestore(pCont, contLen, &stat, backlog, &comp);
+    ASSERT_EQ(comp, 1);
+    ASSERT_EQ((int32_t)ntohl(((STransMsgHead *)msg)->msgLen), contLen + (int32_t)sizeof(STransMsgHead));
+    char *pRestored = transContFromHead(msg);
+    for (int32_t i = 0; i < contLen; ++i) ASSERT_EQ(pRestored[i], i % 97);
+    rpcFreeCont(pRestored);
+  }
+  ASSERT_EQ(stat.skip, 0);
+
+  // random data pauses compression on the conn, and it is tried again after TRANS_COMP_PROBE_MSGS msgs
+  uint32_t seed = 1;
+  int32_t  numOfSkipped = 0;
+  for (int32_t n = 0; n < 64; ++n) {
+    char *pCont = (char *)rpcMallocCont(contLen);
+    for (int32_t i = 0; i < contLen; ++i) pCont[i] = taosRandR(&seed);
+
+    bool  skip = stat.skip > 0;
+    char *msg = compressAndRestore(pCont, contLen, &stat, 0, &comp);
+    ASSERT_EQ(comp, 0);
+    if (skip) numOfSkipped++;
+    rpcFreeCont(transContFromHead(msg));
+  }
+  ASSERT_GT(numOfSkipped, TRANS_COMP_PROBE_MSGS);
+  ASSERT_GT(stat.ratio, TRANS_COMP_SKIP_RATIO);
+}
 #endif
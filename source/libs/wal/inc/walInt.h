@@ -27,6 +27,8 @@
 extern "C" {
 #endif
 
+#define WAL_FSYNC_EVERY_WRITE(pWal) ((pWal)->cfg.level == TAOS_WAL_FSYNC && (pWal)->cfg.fsyncPeriod == 0)
+
 // meta section begin
 typedef struct {
   int64_t firstVer;
@@ -165,6 +167,7 @@ int     walInitWriteFile(SWal* pWal);
 int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
+int32_t walFsyncGroupImpl(SWal* pWal);
 
 #ifdef __cplusplus
 }
@@ -211,6 +211,7 @@ int32_t walPersist(SWal *pWal) {
 
 void walClose(SWal *pWal) {
   taosThreadMutexLock(&pWal->mutex);
+  if (pWal->groupEntries > 0) (void)walFsyncGroupImpl(pWal);
   (void)walSaveMeta(pWal);
   taosCloseFile(&pWal->pLogFile);
   pWal->pLogFile = NULL;
@@ -204,6 +204,10 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
   pWal->vers.lastVer = ver - 1;
+  if (pWal->groupEntries > 0) {
+    // the entries not synced yet may be gone with the rollback
+    pWal->groupEntries = TMAX(0, (int32_t)(ver - pWal->groupFirstVer));
+  }
   ((SWalFileInfo *)taosArrayGetLast(pWal->fileInfoSet))->lastVer = ver - 1;
   ((SWalFileInfo *)taosArrayGetLast(pWal->fileInfoSet))->fileSize = entry.offset;
 
@@ -408,9 +412,9 @@ int32_t walRollImpl(SWal *pWal) {
   }
 
   if (pWal->pLogFile != NULL) {
-    code = taosFsyncFile(pWal->pLogFile);
+    // the pending group is covered by the fsync of the old log file
+    code = walFsyncGroupImpl(pWal);
     if (code != 0) {
-      terrno = TAOS_SYSTEM_ERROR(errno);
       goto END;
     }
     code = taosCloseFile(&pWal->pLogFile);
@@ -513,15 +517,9 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
     goto END;
   }
 
-  if (taosWriteFile(pWal->pLogFile, &pWal->writeHead, sizeof(SWalCkHead)) != sizeof(SWalCkHead)) {
-    terrno = TAOS_SYSTEM_ERROR(errno);
-    wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
-           strerror(errno));
-    code = -1;
-    goto END;
-  }
-
-  if (taosWriteFile(pWal->pLogFile, (char *)body, bodyLen) != bodyLen) {
+  // head and body go in one system call
+  TdFileIoVec iov[2] = {{.buf = &pWal->writeHead, .len = sizeof(SWalCkHead)}, {.buf = (void *)body, .len = bodyLen}};
+  if (taosWritevFile(pWal->pLogFile, iov, 2) != sizeof(SWalCkHead) + bodyLen) {
     terrno = TAOS_SYSTEM_ERROR(errno);
     wError("vgId:%d, file:%" PRId64 ".log, failed to write since %s", pWal->cfg.vgId, walGetLastFileFirstVer(pWal),
            strerror(errno));
@@ -538,6 +536,15 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
 
+  if (WAL_FSYNC_EVERY_WRITE(pWal)) {
+    if (pWal->groupEntries == 0) {
+      pWal->groupStartUs = taosGetTimestampUs();
+      pWal->groupFirstVer = index;
+    }
+    pWal->groupEntries++;
+    pWal->groupBytes += sizeof(SWalCkHead) + bodyLen;
+  }
+
   return 0;
 
 END:
@@ -637,14 +644,115 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
   return walWriteWithSyncInfo(pWal, index, msgType, syncMeta, body, bodyLen);
 }
 
+static FORCE_INLINE int32_t walGroupHistBucket(int32_t entries) {
+  int32_t bucket = 0;
+  while (entries > 1 && bucket < TSDB_WAL_GROUP_HIST_SIZE - 1) {
+    entries >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+static FORCE_INLINE bool walGroupIsFull(SWal *pWal) {
+  return pWal->groupBytes >= tsWalGroupCommitBytes ||
+         taosGetTimestampUs() - pWal->groupStartUs >= (int64_t)tsWalGroupCommitLatency * 1000;
+}
+
+// fsync the log file and close the pending group, the caller holds the mutex. The group stays pending if the fsync
+// fails, so that its entries are neither acked nor counted as durable.
+int32_t walFsyncGroupImpl(SWal *pWal) {
+  wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync, group entries:%d bytes:%" PRId64, pWal->cfg.vgId,
+         walGetCurFileFirstVer(pWal), pWal->groupEntries, pWal->groupBytes);
+  if (taosFsyncFile(pWal->pLogFile) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s, group entries:%d from ver:%" PRId64, pWal->cfg.vgId,
+           walGetCurFileFirstVer(pWal), strerror(errno), pWal->groupEntries, pWal->groupFirstVer);
+    return -1;
+  }
+
+  if (pWal->groupEntries > 0) {
+    pWal->groupStat.numOfGroups++;
+    pWal->groupStat.numOfEntries += pWal->groupEntries;
+    pWal->groupStat.hist[walGroupHistBucket(pWal->groupEntries)]++;
+  }
+  pWal->groupEntries = 0;
+  pWal->groupBytes = 0;
+  pWal->groupStartUs = 0;
+  return 0;
+}
+
 void walFsync(SWal *pWal, bool forceFsync) {
   taosThreadMutexLock(&pWal->mutex);
-  if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
-    wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
-    if (taosFsyncFile(pWal->pLogFile) < 0) {
-      wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
-             strerror(errno));
+  if (forceFsync || WAL_FSYNC_EVERY_WRITE(pWal)) {
+    if (!forceFsync && pWal->groupOpen && !walGroupIsFull(pWal)) {
+      wTrace("vgId:%d, fsync deferred to group, entries:%d bytes:%" PRId64, pWal->cfg.vgId, pWal->groupEntries,
+             pWal->groupBytes);
+    } else {
+      (void)walFsyncGroupImpl(pWal);
     }
   }
   taosThreadMutexUnlock(&pWal->mutex);
 }
+
+bool walBeginGroup(SWal *pWal) {
+  bool opened = false;
+  taosThreadMutexLock(&pWal->mutex);
+  if (!pWal->groupOpen && tsWalGroupCommitLatency > 0 && WAL_FSYNC_EVERY_WRITE(pWal)) {
+    pWal->groupOpen = 1;
+    opened = true;
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+  return opened;
+}
+
+int32_t walEndGroup(SWal *pWal) {
+  int32_t code = 0;
+  taosThreadMutexLock(&pWal->mutex);
+  if (pWal->groupEntries > 0) {
+    code = walFsyncGroupImpl(pWal);
+  }
+  pWal->groupOpen = 0;
+  taosThreadMutexUnlock(&pWal->mutex);
+  return code;
+}
+
+// also retries the fsync of the entries left by a failed one
+int32_t walSyncGroup(SWal *pWal) {
+  int32_t code = 0;
+  taosThreadMutexLock(&pWal->mutex);
+  if (pWal->groupEntries > 0) {
+    code = walFsyncGroupImpl(pWal);
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+  return code;
+}
+
+bool walGroupPending(SWal *pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  bool pending = pWal->groupEntries > 0;
+  taosThreadMutexUnlock(&pWal->mutex);
+  return pending;
+}
+
+int64_t walGetSyncedVer(SWal *pWal) {
+  taosThreadMutexLock(&pWal->mutex);
+  int64_t ver = pWal->groupEntries > 0 ? TMIN(pWal->groupFirstVer - 1, pWal->vers.lastVer) : pWal->vers.lastVer;
+  taosThreadMutexUnlock(&pWal->mutex);
+  return ver;
+}
+
+void walGetGroupStat(SWal *pWal, SWalGroupStat *pStat) {
+  taosThreadMutexLock(&pWal->mutex);
+  *pStat = pWal->groupStat;
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
+void walResetGroupStat(SWal *pWal, const SWalGroupStat *pStat) {
+  taosThreadMutexLock(&pWal->mutex);
+  pWal->groupStat.numOfGroups -= pStat->numOfGroups;
+  pWal->groupStat.numOfEntries -= pStat->numOfEntries;
+  for (int32_t i = 0; i < TSDB_WAL_GROUP_HIST_SIZE; ++i) {
+    pWal->groupStat.hist[i] -= pStat->hist[i];
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+}
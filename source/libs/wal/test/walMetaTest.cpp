@@ -3,6 +3,7 @@
 #include <iostream>
 #include <queue>
 
+#include "tglobal.h"
 #include "walInt.h"
 
 const char* ranStr = "tvapq02tcp";
@@ -234,6 +235,88 @@ TEST_F(WalCleanEnv, write) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalCleanEnv, groupCommit) {
+  int32_t latency = tsWalGroupCommitLatency;
+  tsWalGroupCommitLatency = 0;
+  ASSERT_FALSE(walBeginGroup(pWal));
+
+  tsWalGroupCommitLatency = 100;
+  ASSERT_TRUE(walBeginGroup(pWal));
+  ASSERT_FALSE(walBeginGroup(pWal));
+  ASSERT_FALSE(walGroupPending(pWal));
+
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen), 0);
+    walFsync(pWal, false);
+    ASSERT_EQ(pWal->vers.lastVer, i);
+  }
+  ASSERT_TRUE(walGroupPending(pWal));
+  ASSERT_EQ(pWal->groupEntries, 5);
+  walEndGroup(pWal);
+  ASSERT_FALSE(walGroupPending(pWal));
+
+  // without a group every write is synced on its own
+  ASSERT_EQ(walWrite(pWal, 5, 6, (void*)ranStr, ranStrLen), 0);
+  walFsync(pWal, false);
+  ASSERT_EQ(pWal->groupEntries, 0);
+
+  SWalGroupStat stat = {0};
+  walGetGroupStat(pWal, &stat);
+  ASSERT_EQ(stat.numOfGroups, 2);
+  ASSERT_EQ(stat.numOfEntries, 6);
+  ASSERT_EQ(stat.hist[0], 1);
+  ASSERT_EQ(stat.hist[2], 1);
+
+  walResetGroupStat(pWal, &stat);
+  walGetGroupStat(pWal, &stat);
+  ASSERT_EQ(stat.numOfGroups, 0);
+  tsWalGroupCommitLatency = latency;
+}
+
+TEST_F(WalCleanEnv, groupCommitFsyncFail) {
+  int32_t latency = tsWalGroupCommitLatency;
+  tsWalGroupCommitLatency = 100;
+
+  ASSERT_TRUE(walBeginGroup(pWal));
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(walWrite(pWal, i, i + 1, (void*)ranStr, ranStrLen), 0);
+    walFsync(pWal, false);
+  }
+  ASSERT_EQ(walGetSyncedVer(pWal), -1);
+
+  // fsync of a char device fails with EINVAL
+  TdFilePtr pLogFile = pWal->pLogFile;
+  pWal->pLogFile = taosOpenFile("/dev/null", TD_FILE_WRITE);
+  ASSERT_NE(pWal->pLogFile, nullptr);
+
+  // the group is not durable, so it stays pending and is not counted
+  ASSERT_NE(walEndGroup(pWal), 0);
+  ASSERT_TRUE(walGroupPending(pWal));
+  ASSERT_EQ(pWal->groupEntries, 3);
+  ASSERT_EQ(walGetSyncedVer(pWal), -1);
+  ASSERT_NE(walSyncGroup(pWal), 0);
+  walFsync(pWal, false);
+  ASSERT_TRUE(walGroupPending(pWal));
+
+  SWalGroupStat stat = {0};
+  walGetGroupStat(pWal, &stat);
+  ASSERT_EQ(stat.numOfGroups, 0);
+
+  // a later fsync releases the pending entries
+  taosCloseFile(&pWal->pLogFile);
+  pWal->pLogFile = pLogFile;
+  ASSERT_EQ(walWrite(pWal, 3, 4, (void*)ranStr, ranStrLen), 0);
+  ASSERT_EQ(walGetSyncedVer(pWal), -1);
+  ASSERT_EQ(walSyncGroup(pWal), 0);
+  ASSERT_FALSE(walGroupPending(pWal));
+  ASSERT_EQ(walGetSyncedVer(pWal), 3);
+
+  walGetGroupStat(pWal, &stat);
+  ASSERT_EQ(stat.numOfGroups, 1);
+  ASSERT_EQ(stat.numOfEntries, 4);
+  tsWalGroupCommitLatency = latency;
+}
+
 TEST_F(WalCleanEnv, rollback) {
   int code;
   for (int i = 0; i < 10; i++) {
@@ -36,7 +36,11 @@
 #include <sys/sendfile.h>
 #endif
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <unistd.h>
+#ifdef USE_URING
+#include <liburing.h>
+#endif
 #define LINUX_FILE_NO_TEXT_OPTION 0
 #define O_TEXT                    LINUX_FILE_NO_TEXT_OPTION
 
@@ -400,6 +404,17 @@ int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   return bytesWritten;
 }
 
+int64_t taosWritevFile(TdFilePtr pFile, const TdFileIoVec *iov, int32_t iovcnt) {
+  int64_t total = 0;
+  for (int32_t i = 0; i < iovcnt; ++i) {
+    if (taosWriteFile(pFile, iov[i].buf, iov[i].len) != iov[i].len) {
+      return -1;
+    }
+    total += iov[i].len;
+  }
+  return total;
+}
+
 int64_t taosPWriteFile(TdFilePtr pFile, const void *buf, int64_t count, int64_t offset) {
   if (pFile == NULL) {
     return 0;
@@ -648,6 +663,9 @@ int taosOpenFileNotStream(const char *path, int32_t tdFileOptions) {
   access |= (tdFileOptions & TD_FILE_TEXT) ? O_TEXT : 0;
   access |= (tdFileOptions & TD_FILE_EXCL) ? O_EXCL : 0;
   access |= (tdFileOptions & TD_FILE_CLOEXEC) ? O_CLOEXEC : 0;
+#ifdef O_DIRECT
+  access |= (tdFileOptions & TD_FILE_DIRECT) ? O_DIRECT : 0;
+#endif
 
   int fd = open(path, access, S_IRWXU | S_IRWXG | S_IRWXO);
   return fd;
@@ -739,6 +757,61 @@ int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   return count;
 }
 
+int64_t taosWritevFile(TdFilePtr pFile, const TdFileIoVec *iov, int32_t iovcnt) {
+  if (pFile == NULL || iovcnt > TD_FILE_IOV_MAX) {
+    return 0;
+  }
+
+  struct iovec vec[TD_FILE_IOV_MAX];
+  int64_t      count = 0;
+  for (int32_t i = 0; i < iovcnt; ++i) {
+    vec[i].iov_base = iov[i].buf;
+    vec[i].iov_len = iov[i].len;
+    count += iov[i].len;
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockWrlock(&(pFile->rwlock));
+#endif
+  if (pFile->fd < 0) {
+#if FILE_WITH_LOCK
+    taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+    return 0;
+  }
+
+  struct iovec *pVec = vec;
+  int32_t       nvec = iovcnt;
+  while (nvec > 0) {
+    int64_t nwritten = writev(pFile->fd, pVec, nvec);
+    if (nwritten < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+#if FILE_WITH_LOCK
+      taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+      return -1;
+    }
+
+    // skip the fully written buffers and continue with the partial one
+    while (nvec > 0 && nwritten >= (int64_t)pVec->iov_len) {
+      nwritten -= pVec->iov_len;
+      pVec++;
+      nvec--;
+    }
+    if (nvec > 0) {
+      pVec->iov_base = (char *)pVec->iov_base + nwritten;
+      pVec->iov_len -= nwritten;
+    }
+  }
+
+#if FILE_WITH_LOCK
+  taosThreadRwlockUnlock(&(pFile->rwlock));
+#endif
+  return count;
+}
+
 int64_t taosPWriteFile(TdFilePtr pFile, const void *buf, int64_t count, int64_t offset) {
   if (pFile == NULL) {
     return 0;
@@ -1386,3 +1459,244 @@ int32_t taosSetFileHandlesLimit() {
 #endif
   return 0;
 }
+
+static int32_t taosFileIoSync(TdFileIoReq *req) {
+  req->res = 0;
+  while (req->res < req->len) {
+    char   *buf = (char *)req->buf + req->res;
+    int64_t n = req->write ? taosPWriteFile(req->pFile, buf, req->len - req->res, req->offset + req->res)
+                           : taosPReadFile(req->pFile, buf, req->len - req->res, req->offset + req->res);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    } else if (n == 0) {
+      if (req->write) {
+        errno = EIO;
+        return -1;
+      }
+      break;
+    }
+    req->res += n;
+  }
+  return 0;
+}
+
+#ifdef USE_URING
+struct TdFileRing {
+  struct io_uring ring;
+  int32_t         depth;
+  int32_t         inflight;  // prepared and not reaped, kept below depth so that the completions never overflow
+};
+
+static threadlocal TdFileRingPtr tlFileRing = NULL;
+static threadlocal bool          tlFileRingTried = false;
+
+static int32_t taosFileRingPrep(TdFileRingPtr pRing, TdFileIoReq *req) {
+  struct io_uring_sqe *sqe = io_uring_get_sqe(&pRing->ring);
+  if (sqe == NULL) {
+    errno = EBUSY;
+    return -1;
+  }
+
+  // a short transfer is continued from where it stopped
+  char   *buf = (char *)req->buf + req->res;
+  int64_t offset = req->offset + req->res;
+  if (req->write) {
+    io_uring_prep_write(sqe, req->pFile->fd, buf, req->len - req->res, offset);
+  } else {
+    io_uring_prep_read(sqe, req->pFile->fd, buf, req->len - req->res, offset);
+  }
+  io_uring_sqe_set_data(sqe, req);
+  pRing->inflight++;
+  return 0;
+}
+
+static void taosFileRingComplete(TdFileRingPtr pRing, TdFileIoReq *req, int32_t res) {
+  if (res > 0) {
+    req->res += res;
+    if (req->res == req->len) {
+      return;
+    }
+  } else if (res == 0) {
+    if (!req->write) {
+      return;  // end of file
+    }
+    res = -EIO;
+  }
+
+  if (res < 0 && res != -EINTR && res != -EAGAIN) {
+    req->err = -res;
+    return;
+  }
+
+  // submitted with the next reap
+  if (taosFileRingPrep(pRing, req) < 0) {
+    req->err = errno;
+  }
+}
+
+static int32_t taosFileRingReap(TdFileRingPtr pRing) {
+  // the prepared entries not submitted yet go with it
+  int32_t ret = io_uring_submit_and_wait(&pRing->ring, 1);
+  if (ret < 0 && ret != -EINTR) {
+    errno = -ret;
+    return -1;
+  }
+
+  struct io_uring_cqe *cqe = NULL;
+  while (io_uring_peek_cqe(&pRing->ring, &cqe) == 0) {
+    TdFileIoReq *req = io_uring_cqe_get_data(cqe);
+    int32_t      res = cqe->res;
+    io_uring_cqe_seen(&pRing->ring, cqe);
+    pRing->inflight--;
+    taosFileRingComplete(pRing, req, res);
+  }
+  return 0;
+}
+
+static int32_t taosFileRingQueue(TdFileRingPtr pRing, TdFileIoReq *req) {
+  while (pRing->inflight >= pRing->depth) {
+    if (taosFileRingReap(pRing) < 0) {
+      return -1;
+    }
+  }
+  return taosFileRingPrep(pRing, req);
+}
+#endif
+
+TdFileRingPtr taosCreateFileRing(int32_t depth) {
+#ifdef USE_URING
+  TdFileRingPtr pRing = taosMemoryCalloc(1, sizeof(*pRing));
+  if (pRing == NULL) {
+    errno = ENOMEM;
+    return NULL;
+  }
+
+  int32_t ret = io_uring_queue_init(depth, &pRing->ring, 0);
+  if (ret < 0) {
+    taosMemoryFree(pRing);
+    errno = -ret;
+    return NULL;
+  }
+  pRing->depth = depth;
+  return pRing;
+#else
+  errno = ENOSYS;
+  return NULL;
+#endif
+}
+
+void taosDestroyFileRing(TdFileRingPtr *ppRing) {
+  if (ppRing == NULL || *ppRing == NULL) {
+    return;
+  }
+#ifdef USE_URING
+  // the buffers in flight belong to the caller, they are released only after this
+  taosWaitFileRing(*ppRing);
+  io_uring_queue_exit(&(*ppRing)->ring);
+  taosMemoryFree(*ppRing);
+#endif
+  *ppRing = NULL;
+}
+
+TdFileRingPtr taosGetThreadFileRing(int32_t depth) {
+#ifdef USE_URING
+  // not retried, the kernel refuses it again
+  if (!tlFileRingTried) {
+    tlFileRingTried = true;
+    tlFileRing = taosCreateFileRing(depth);
+  }
+  return tlFileRing;
+#else
+  errno = ENOSYS;
+  return NULL;
+#endif
+}
+
+void taosDestroyThreadFileRing() {
+#ifdef USE_URING
+  taosDestroyFileRing(&tlFileRing);
+  tlFileRingTried = false;
+#endif
+}
+
+int32_t taosPReadFileBatch(TdFileRingPtr pRing, TdFileIoReq *reqs, int32_t num) {
+  for (int32_t i = 0; i < num; ++i) {
+    reqs[i].res = 0;
+    reqs[i].err = 0;
+    reqs[i].write = 0;
+  }
+
+#ifdef USE_URING
+  if (pRing != NULL) {
+    for (int32_t i = 0; i < num; ++i) {
+      if (reqs[i].len == 0) {
+        continue;
+      }
+      if (taosFileRingQueue(pRing, &reqs[i]) < 0) {
+        int32_t err = errno;
+        (void)taosWaitFileRing(pRing);
+        errno = err;
+        return -1;
+      }
+    }
+    if (taosWaitFileRing(pRing) < 0) {
+      return -1;
+    }
+    for (int32_t i = 0; i < num; ++i) {
+      if (reqs[i].err != 0) {
+        errno = reqs[i].err;
+        return -1;
+      }
+    }
+    return 0;
+  }
+#endif
+
+  for (int32_t i = 0; i < num; ++i) {
+    if (taosFileIoSync(&reqs[i]) < 0) {
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int32_t taosPWriteFileAsync(TdFileRingPtr pRing, TdFileIoReq *req) {
+  req->res = 0;
+  req->err = 0;
+  req->write = 1;
+
+#ifdef USE_URING
+  if (pRing != NULL) {
+    if (taosFileRingQueue(pRing, req) < 0) {
+      return -1;
+    }
+    // on failure it stays in the queue and is submitted by the next reap
+    (void)io_uring_submit(&pRing->ring);
+    return 0;
+  }
+#endif
+
+  if (taosFileIoSync(req) < 0) {
+    req->err = errno;
+    return -1;
+  }
+  return 0;
+}
+
+int32_t taosWaitFileRing(TdFileRingPtr pRing) {
+#ifdef USE_URING
+  if (pRing == NULL) {
+    return 0;
+  }
+
+  while (pRing->inflight > 0) {
+    if (taosFileRingReap(pRing) < 0) {
+      return -1;
+    }
+  }
+#endif
+  return 0;
+}
@@ -168,6 +168,108 @@ TEST(osTest, osFile) {
   //printf("remove file success");
 }
 
+TEST(osTest, osFileRing) {
+  const char   *fname = "./osfiletest2.txt";
+  const int32_t num = 16;
+  const int32_t szPage = 4096;
+
+  TdFilePtr pFile = taosOpenFile(fname, TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+
+  // NULL without io_uring, the reqs are done synchronously then
+  TdFileRingPtr pRing = taosCreateFileRing(8);
+
+  char       *pOut = (char *)taosMemoryMalloc(num * szPage);
+  char       *pIn = (char *)taosMemoryCalloc(num, szPage);
+  TdFileIoReq reqs[num];
+  for (int32_t i = 0; i < num; ++i) {
+    memset(pOut + i * szPage, 'a' + i, szPage);
+    reqs[i] = {0};
+    reqs[i].pFile = pFile;
+    reqs[i].buf = pOut + i * szPage;
+    reqs[i].len = szPage;
+    reqs[i].offset = (int64_t)i * szPage;
+    ASSERT_EQ(taosPWriteFileAsync(pRing, &reqs[i]), 0);
+  }
+  ASSERT_EQ(taosWaitFileRing(pRing), 0);
+  for (int32_t i = 0; i < num; ++i) {
+    ASSERT_EQ(reqs[i].res, szPage);
+  }
+
+  // read back in reverse order
+  for (int32_t i = 0; i < num; ++i) {
+    reqs[i].buf = pIn + (num - 1 - i) * szPage;
+    reqs[i].offset = (int64_t)(num - 1 - i) * szPage;
+  }
+  ASSERT_EQ(taosPReadFileBatch(pRing, reqs, num), 0);
+  for (int32_t i = 0; i < num; ++i) {
+    ASSERT_EQ(reqs[i].res, szPage);
+  }
+  ASSERT_EQ(memcmp(pIn, pOut, num * szPage), 0);
+
+  // a read over the end of file is short
+  reqs[0].offset = (int64_t)num * szPage - 100;
+  ASSERT_EQ(taosPReadFileBatch(pRing, reqs, 1), 0);
+  ASSERT_EQ(reqs[0].res, 100);
+
+  taosDestroyFileRing(&pRing);
+  ASSERT_EQ(pRing, nullptr);
+  taosMemoryFree(pOut);
+  taosMemoryFree(pIn);
+  taosCloseFile(&pFile);
+  taosRemoveFile(fname);
+}
+
+TEST(osTest, osFileThreadRing) {
+  const char   *fname1 = "./osfiletest3.txt";
+  const char   *fname2 = "./osfiletest4.txt";
+  const int32_t szPage = 4096;
+
+  // the thread ring is created once and shared by the files
+  TdFileRingPtr pRing = taosGetThreadFileRing(8);
+  ASSERT_EQ(taosGetThreadFileRing(8), pRing);
+
+  char pOut[szPage], pIn[szPage];
+  memset(pOut, 'x', szPage);
+  TdFilePtr pFile = taosOpenFile(fname2, TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosWriteFile(pFile, pOut, szPage), szPage);
+  taosCloseFile(&pFile);
+
+  // a write to a file opened for read fails, it does not fail the read of the other file in between
+  TdFilePtr pRFile = taosOpenFile(fname1, TD_FILE_READ | TD_FILE_WRITE | TD_FILE_CREATE | TD_FILE_TRUNC);
+  ASSERT_NE(pRFile, nullptr);
+  taosCloseFile(&pRFile);
+  pRFile = taosOpenFile(fname1, TD_FILE_READ);
+  ASSERT_NE(pRFile, nullptr);
+  pFile = taosOpenFile(fname2, TD_FILE_READ);
+  ASSERT_NE(pFile, nullptr);
+
+  TdFileIoReq wreq = {0};
+  wreq.pFile = pRFile;
+  wreq.buf = pOut;
+  wreq.len = szPage;
+  int32_t ret = taosPWriteFileAsync(pRing, &wreq);
+  ASSERT_EQ(ret, pRing == NULL ? -1 : 0);
+
+  TdFileIoReq rreq = {0};
+  rreq.pFile = pFile;
+  rreq.buf = pIn;
+  rreq.len = szPage;
+  ASSERT_EQ(taosPReadFileBatch(pRing, &rreq, 1), 0);
+  ASSERT_EQ(rreq.res, szPage);
+  ASSERT_EQ(memcmp(pIn, pOut, szPage), 0);
+
+  ASSERT_EQ(taosWaitFileRing(pRing), 0);
+  ASSERT_NE(wreq.err, 0);
+
+  taosDestroyThreadFileRing();
+  taosCloseFile(&pRFile);
+  taosCloseFile(&pFile);
+  taosRemoveFile(fname1);
+  taosRemoveFile(fname2);
+}
+
 #ifndef OSFILE_PERFORMANCE_TEST
 
 #define MAX_WORDS          100
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tarena.h"
+#include "taoserror.h"
+
+#define ARENA_MIN_CLASS_SHIFT 4
+#define ARENA_MAX_CLASS_SHIFT 12
+#define ARENA_NUM_CLASSES     (ARENA_MAX_CLASS_SHIFT - ARENA_MIN_CLASS_SHIFT + 1)
+#define ARENA_LARGE_CLASS     ARENA_NUM_CLASSES
+#define ARENA_HEAD_SIZE       16  // keeps the returned memory 16 bytes aligned
+
+// the class is right before the returned memory, for both small and large allocations
+#define ARENA_CLASS(p) (*(int64_t *)((char *)(p) - sizeof(int64_t)))
+
+typedef struct SArenaChunk {
+  struct SArenaChunk *next;
+  int64_t             size;
+  char                data[];
+} SArenaChunk;
+
+typedef struct SArenaLarge {
+  struct SArenaLarge *prev;
+  struct SArenaLarge *next;
+  int64_t             size;
+  int64_t             cls;
+} SArenaLarge;
+
+struct SArena {
+  FArenaCharge chargeFn;
+  void        *param;
+  SArenaChunk *pChunks;
+  char        *pCur;
+  char        *pEnd;
+  SArenaLarge *pLarge;
+  void        *freeList[ARENA_NUM_CLASSES];
+  int64_t      chunkSize;
+};
+
+static int32_t arenaSizeClass(int64_t size) {
+  int32_t cls = 0;
+  while ((1LL << (cls + ARENA_MIN_CLASS_SHIFT)) < size) {
+    cls++;
+  }
+  return cls;
+}
+
+static int32_t arenaCharge(SArena *pArena, int64_t size) {
+  if (pArena->chargeFn == NULL) {
+    return TSDB_CODE_SUCCESS;
+  }
+  return pArena->chargeFn(pArena->param, size);
+}
+
+static void *arenaMallocLarge(SArena *pArena, int64_t size) {
+  int64_t total = sizeof(SArenaLarge) + size;
+  if (arenaCharge(pArena, total) != TSDB_CODE_SUCCESS) {
+    return NULL;
+  }
+
+  SArenaLarge *pLarge = taosMemoryMalloc(total);
+  if (pLarge == NULL) {
+    arenaCharge(pArena, -total);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pLarge->prev = NULL;
+  pLarge->next = pArena->pLarge;
+  pLarge->size = total;
+  pLarge->cls = ARENA_LARGE_CLASS;
+  if (pArena->pLarge != NULL) {
+    pArena->pLarge->prev = pLarge;
+  }
+  pArena->pLarge = pLarge;
+  pArena->chunkSize += total;
+  return pLarge + 1;
+}
+
+static void arenaFreeLarge(SArena *pArena, void *p) {
+  SArenaLarge *pLarge = (SArenaLarge *)p - 1;
+  if (pLarge->prev != NULL) {
+    pLarge->prev->next = pLarge->next;
+  } else {
+    pArena->pLarge = pLarge->next;
+  }
+  if (pLarge->next != NULL) {
+    pLarge->next->prev = pLarge->prev;
+  }
+
+  pArena->chunkSize -= pLarge->size;
+  arenaCharge(pArena, -pLarge->size);
+  taosMemoryFree(pLarge);
+}
+
+static int32_t arenaAddChunk(SArena *pArena) {
+  int64_t total = sizeof(SArenaChunk) + ARENA_CHUNK_SIZE;
+  if (arenaCharge(pArena, total) != TSDB_CODE_SUCCESS) {
+    return terrno;
+  }
+
+  SArenaChunk *pChunk = taosMemoryMalloc(total);
+  if (pChunk == NULL) {
+    arenaCharge(pArena, -total);
+    return terrno = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pChunk->size = total;
+  pChunk->next = pArena->pChunks;
+  pArena->pChunks = pChunk;
+  pArena->pCur = pChunk->data;
+  pArena->pEnd = pChunk->data + ARENA_CHUNK_SIZE;
+  pArena->chunkSize += total;
+  return TSDB_CODE_SUCCESS;
+}
+
+SArena *taosArenaCreate(FArenaCharge chargeFn, void *param) {
+  SArena *pArena = taosMemoryCalloc(1, sizeof(SArena));
+  if (pArena == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  pArena->chargeFn = chargeFn;
+  pArena->param = param;
+  return pArena;
+}
+
+void taosArenaDestroy(SArena *pArena) {
+  if (pArena == NULL) {
+    return;
+  }
+
+  while (pArena->pLarge != NULL) {
+    arenaFreeLarge(pArena, pArena->pLarge + 1);
+  }
+
+  SArenaChunk *pChunk = pArena->pChunks;
+  while (pChunk != NULL) {
+    SArenaChunk *pNext = pChunk->next;
+    arenaCharge(pArena, -pChunk->size);
+    taosMemoryFree(pChunk);
+    pChunk = pNext;
+  }
+
+  taosMemoryFree(pArena);
+}
+
+void *taosArenaMalloc(SArena *pArena, int64_t size) {
+  if (size > ARENA_MAX_CLASS_SIZE) {
+    return arenaMallocLarge(pArena, size);
+  }
+
+  int32_t cls = arenaSizeClass(size);
+  void   *p = pArena->freeList[cls];
+  if (p != NULL) {
+    pArena->freeList[cls] = *(void **)p;
+    return p;
+  }
+
+  int64_t blockSize = ARENA_HEAD_SIZE + (1LL << (cls + ARENA_MIN_CLASS_SHIFT));
+  if (pArena->pEnd - pArena->pCur < blockSize && arenaAddChunk(pArena) != TSDB_CODE_SUCCESS) {
+    return NULL;
+  }
+
+  p = pArena->pCur + ARENA_HEAD_SIZE;
+  pArena->pCur += blockSize;
+  ARENA_CLASS(p) = cls;
+  return p;
+}
+
+void *taosArenaCalloc(SArena *pArena, int64_t num, int64_t size) {
+  void *p = taosArenaMalloc(pArena, num * size);
+  if (p != NULL) {
+    memset(p, 0, num * size);
+  }
+  return p;
+}
+
+void *taosArenaRealloc(SArena *pArena, void *p, int64_t size) {
+  if (p == NULL) {
+    return taosArenaMalloc(pArena, size);
+  }
+
+  int64_t cls = ARENA_CLASS(p);
+  int64_t cap = (cls == ARENA_LARGE_CLASS) ? (((SArenaLarge *)p - 1)->size - (int64_t)sizeof(SArenaLarge))
+                                           : (1LL << (cls + ARENA_MIN_CLASS_SHIFT));
+  if (size <= cap) {
+    return p;
+  }
+
+  void *pNew = taosArenaMalloc(pArena, size);
+  if (pNew == NULL) {
+    return NULL;
+  }
+
+  memcpy(pNew, p, cap);
+  taosArenaFree(pArena, p);
+  return pNew;
+}
+
+void taosArenaFree(SArena *pArena, void *p) {
+  if (p == NULL) {
+    return;
+  }
+
+  int64_t cls = ARENA_CLASS(p);
+  if (cls == ARENA_LARGE_CLASS) {
+    arenaFreeLarge(pArena, p);
+    return;
+  }
+
+  *(void **)p = pArena->freeList[cls];
+  pArena->freeList[cls] = p;
+}
+
+int64_t taosArenaChunkSize(const SArena *pArena) { return pArena->chunkSize; }
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tkll.h"
+
+#define KLL_LEVEL_SIZE(s, h) ((s)->levels[(h) + 1] - (s)->levels[h])
+
+typedef struct {
+  double  value;
+  int64_t weight;
+} SKllItem;
+
+static int32_t kllCmpDouble(const void *p1, const void *p2) {
+  double v1 = *(const double *)p1;
+  double v2 = *(const double *)p2;
+  return (v1 < v2) ? -1 : ((v1 > v2) ? 1 : 0);
+}
+
+static int32_t kllCmpItem(const void *p1, const void *p2) {
+  return kllCmpDouble(&((const SKllItem *)p1)->value, &((const SKllItem *)p2)->value);
+}
+
+// the sum of the capacities never exceeds KLL_CAPACITY
+static int32_t kllLevelCap(int32_t numLevels, int32_t h) {
+  double cap = KLL_K;
+  for (int32_t depth = numLevels - 1 - h; depth > 0 && cap > 2; --depth) {
+    cap = cap * 2 / 3;
+  }
+
+  return TMAX((int32_t)ceil(cap), 2);
+}
+
+static int32_t kllMergeSorted(const double *p1, int32_t n1, const double *p2, int32_t n2, double *pDst) {
+  int32_t i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    pDst[k++] = (p1[i] <= p2[j]) ? p1[i++] : p2[j++];
+  }
+  while (i < n1) pDst[k++] = p1[i++];
+  while (j < n2) pDst[k++] = p2[j++];
+  return k;
+}
+
+static bool kllAddLevel(SKll *pKll) {
+  if (pKll->numLevels >= KLL_MAX_LEVELS) {
+    return false;
+  }
+
+  pKll->levels[pKll->numLevels + 1] = pKll->levels[pKll->numLevels];
+  pKll->numLevels++;
+  return true;
+}
+
+// sort level h, keep one item of it if the number is odd, and promote every other item of the rest to level h + 1
+static void kllCompactLevel(SKll *pKll, int32_t h) {
+  if (h == pKll->numLevels - 1 && !kllAddLevel(pKll)) {
+    h--;
+  }
+
+  int32_t start = pKll->levels[h];
+  int32_t size = KLL_LEVEL_SIZE(pKll, h);
+  double *p = pKll->items + start;
+  if (h == 0) {
+    taosSort(p, size, sizeof(double), kllCmpDouble);
+  }
+
+  int32_t odd = size & 1;
+  int32_t half = size / 2;
+  int32_t offset = taosRandR(&pKll->seed) & 1;
+  double  kept = p[0];
+
+  double promoted[KLL_CAPACITY / 2 + 1];
+  for (int32_t i = 0; i < half; ++i) {
+    promoted[i] = p[odd + 2 * i + offset];
+  }
+
+  double  merged[KLL_CAPACITY];
+  int32_t end = pKll->levels[h + 2];
+  int32_t len = kllMergeSorted(promoted, half, pKll->items + pKll->levels[h + 1], KLL_LEVEL_SIZE(pKll, h + 1), merged);
+  memcpy(pKll->items + end - len, merged, len * sizeof(double));
+  pKll->levels[h + 1] = end - len;
+  if (odd) {
+    pKll->items[pKll->levels[h + 1] - 1] = kept;
+  }
+
+  // the lower levels move up to fill the space of the dropped half
+  int32_t shift = half;
+  memmove(pKll->items + pKll->levels[0] + shift, pKll->items + pKll->levels[0],
+          (start - pKll->levels[0]) * sizeof(double));
+  for (int32_t i = 0; i < h; ++i) {
+    pKll->levels[i] += shift;
+  }
+  pKll->levels[h] = pKll->levels[h + 1] - odd;
+}
+
+static void kllCompress(SKll *pKll) {
+  for (int32_t h = 0; h < pKll->numLevels; ++h) {
+    if (KLL_LEVEL_SIZE(pKll, h) >= kllLevelCap(pKll->numLevels, h)) {
+      kllCompactLevel(pKll, h);
+      return;
+    }
+  }
+
+  // a merge may need more room than the levels over capacity can free
+  for (int32_t h = 0; h < pKll->numLevels; ++h) {
+    if (KLL_LEVEL_SIZE(pKll, h) >= 2) {
+      kllCompactLevel(pKll, h);
+      return;
+    }
+  }
+}
+
+// the caller makes sure there are at least num free slots
+static void kllInsertLevel(SKll *pKll, int32_t h, const double *pSrc, int32_t num) {
+  int32_t start = pKll->levels[h];
+  int32_t size = KLL_LEVEL_SIZE(pKll, h);
+  double  merged[KLL_CAPACITY];
+
+  if (h == 0) {
+    memcpy(merged, pSrc, num * sizeof(double));
+    memcpy(merged + num, pKll->items + start, size * sizeof(double));
+  } else {
+    (void)kllMergeSorted(pSrc, num, pKll->items + start, size, merged);
+  }
+
+  memmove(pKll->items + pKll->levels[0] - num, pKll->items + pKll->levels[0],
+          (start - pKll->levels[0]) * sizeof(double));
+  for (int32_t i = 0; i <= h; ++i) {
+    pKll->levels[i] -= num;
+  }
+  memcpy(pKll->items + pKll->levels[h], merged, (size + num) * sizeof(double));
+}
+
+SKll *tKllNewFrom(void *pBuf) {
+  SKll *pKll = (SKll *)pBuf;
+  memset(pKll, 0, sizeof(SKll));
+
+  pKll->min = DBL_MAX;
+  pKll->max = -DBL_MAX;
+  pKll->seed = 0x9e3779b9;
+  pKll->numLevels = 1;
+  pKll->levels[0] = KLL_CAPACITY;
+  pKll->levels[1] = KLL_CAPACITY;
+  return pKll;
+}
+
+void tKllAdd(SKll *pKll, double v) {
+  if (pKll->levels[0] == 0) {
+    kllCompress(pKll);
+  }
+
+  pKll->items[--pKll->levels[0]] = v;
+  pKll->n++;
+  pKll->min = TMIN(pKll->min, v);
+  pKll->max = TMAX(pKll->max, v);
+}
+
+void tKllMerge(SKll *pKll, const SKll *pSrc) {
+  if (pSrc->n == 0) {
+    return;
+  }
+
+  while (pKll->numLevels < pSrc->numLevels && kllAddLevel(pKll)) {
+  }
+
+  for (int32_t h = 0; h < pSrc->numLevels; ++h) {
+    const double *p = pSrc->items + pSrc->levels[h];
+    int32_t       m = KLL_LEVEL_SIZE(pSrc, h);
+
+    for (int32_t done = 0; done < m;) {
+      if (pKll->levels[0] == 0) {
+        kllCompress(pKll);
+      }
+
+      int32_t num = TMIN(m - done, pKll->levels[0]);
+      kllInsertLevel(pKll, h, p + done, num);
+      done += num;
+    }
+  }
+
+  pKll->n += pSrc->n;
+  pKll->min = TMIN(pKll->min, pSrc->min);
+  pKll->max = TMAX(pKll->max, pSrc->max);
+}
+
+double tKllQuantile(const SKll *pKll, double q) {
+  if (pKll->n == 0) {
+    return NAN;
+  }
+  if (q <= 0) {
+    return pKll->min;
+  }
+  if (q >= 1) {
+    return pKll->max;
+  }
+
+  SKllItem items[KLL_CAPACITY];
+  int32_t  num = 0;
+  int64_t  total = 0;
+  for (int32_t h = 0; h < pKll->numLevels; ++h) {
+    for (int32_t i = pKll->levels[h]; i < pKll->levels[h + 1]; ++i) {
+      items[num].value = pKll->items[i];
+      items[num].weight = 1LL << h;
+      total += items[num].weight;
+      num++;
+    }
+  }
+
+  taosSort(items, num, sizeof(SKllItem), kllCmpItem);
+
+  double  rank = q * total;
+  int64_t weight = 0;
+  for (int32_t i = 0; i < num; ++i) {
+    weight += items[i].weight;
+    if (weight >= rank) {
+      return items[i].value;
+    }
+  }
+
+  return pKll->max;
+}
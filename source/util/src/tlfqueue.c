@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define _DEFAULT_SOURCE
+#include "tlfqueue.h"
+#include "taoserror.h"
+#include "tlog.h"
+
+#define LF_QUEUE_CACHE_LINE 64
+
+typedef struct {
+  int64_t seq;
+  void   *data;
+} SLfCell;
+
+struct STaosLfQueue {
+  SLfCell *cells;
+  int64_t  mask;
+  char     pad0[LF_QUEUE_CACHE_LINE - sizeof(SLfCell *) - sizeof(int64_t)];
+  int64_t  enqPos;  // producers only touch this cache line
+  char     pad1[LF_QUEUE_CACHE_LINE - sizeof(int64_t)];
+  int64_t  deqPos;  // consumers only touch this cache line
+  char     pad2[LF_QUEUE_CACHE_LINE - sizeof(int64_t)];
+};
+
+STaosLfQueue *taosLfQueueOpen(int32_t capacity) {
+  int64_t cap = 2;
+  while (cap < capacity) cap <<= 1;
+
+  STaosLfQueue *queue = taosMemoryCalloc(1, sizeof(STaosLfQueue));
+  if (queue == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  queue->cells = taosMemoryCalloc(cap, sizeof(SLfCell));
+  if (queue->cells == NULL) {
+    taosMemoryFree(queue);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  for (int64_t i = 0; i < cap; ++i) {
+    queue->cells[i].seq = i;
+  }
+  queue->mask = cap - 1;
+
+  uDebug("lfqueue:%p is opened, capacity:%" PRId64, queue, cap);
+  return queue;
+}
+
+void taosLfQueueClose(STaosLfQueue *queue) {
+  if (queue == NULL) return;
+  taosMemoryFree(queue->cells);
+  taosMemoryFree(queue);
+  uDebug("lfqueue:%p is closed", queue);
+}
+
+bool taosLfQueuePush(STaosLfQueue *queue, void *data) {
+  int64_t  pos = atomic_load_64(&queue->enqPos);
+  SLfCell *cell = NULL;
+
+  while (1) {
+    cell = &queue->cells[pos & queue->mask];
+    int64_t seq = atomic_load_64(&cell->seq);
+    int64_t dif = seq - pos;
+    if (dif == 0) {
+      int64_t old = atomic_val_compare_exchange_64(&queue->enqPos, pos, pos + 1);
+      if (old == pos) break;
+      pos = old;
+    } else if (dif < 0) {
+      return false;  // the cell is not consumed yet since the last round, full
+    } else {
+      pos = atomic_load_64(&queue->enqPos);
+    }
+  }
+
+  cell->data = data;
+  atomic_store_64(&cell->seq, pos + 1);
+  return true;
+}
+
+bool taosLfQueuePop(STaosLfQueue *queue, void **ppData) {
+  int64_t  pos = atomic_load_64(&queue->deqPos);
+  SLfCell *cell = NULL;
+
+  while (1) {
+    cell = &queue->cells[pos & queue->mask];
+    int64_t seq = atomic_load_64(&cell->seq);
+    int64_t dif = seq - (pos + 1);
+    if (dif == 0) {
+      int64_t old = atomic_val_compare_exchange_64(&queue->deqPos, pos, pos + 1);
+      if (old == pos) break;
+      pos = old;
+    } else if (dif < 0) {
+      return false;  // the cell is not published yet, empty
+    } else {
+      pos = atomic_load_64(&queue->deqPos);
+    }
+  }
+
+  *ppData = cell->data;
+  atomic_store_64(&cell->seq, pos + queue->mask + 1);
+  return true;
+}
+
+int32_t taosLfQueueCapacity(STaosLfQueue *queue) { return (int32_t)(queue->mask + 1); }
+
+// not linearizable, only used for statistics
+int32_t taosLfQueueSize(STaosLfQueue *queue) {
+  int64_t size = atomic_load_64(&queue->enqPos) - atomic_load_64(&queue->deqPos);
+  return (int32_t)TMIN(TMAX(size, 0), queue->mask + 1);
+}
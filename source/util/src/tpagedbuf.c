@@ -1,5 +1,7 @@
 #define _DEFAULT_SOURCE
 #include "tpagedbuf.h"
+#include "lz4.h"
+#include "lz4hc.h"
 #include "taoserror.h"
 #include "tcompression.h"
 #include "tsimplehash.h"
@@ -22,8 +24,9 @@ struct SPageInfo {
   int64_t    offset;
   int32_t    pageId;
   int32_t    length : 29;
-  bool       used : 1;   // set current page is in used
-  bool       dirty : 1;  // set current buffer page is dirty or not
+  bool       used : 1;        // set current page is in used
+  bool       dirty : 1;       // set current buffer page is dirty or not
+  bool       compressed : 1;  // the on disk data is compressed
 };
 
 struct SDiskbasedBuf {
@@ -42,8 +45,8 @@ struct SDiskbasedBuf {
   SList*    lruList;
   void*     emptyDummyIdList;  // dummy id list
   void*     assistBuf;         // assistant buffer for compress/decompress data
-  SArray*   pFree;             // free area in file
-  bool      comp;              // compressed before flushed to disk
+  SArray*   pFree;             // free area in file, ordered by offset and coalesced
+  int8_t    comp;              // compress algorithm before flushed to disk, BUF_PAGE_COMP_*
   uint64_t  nextPos;           // next page flush position
 
   char*               id;           // for debug purpose
@@ -70,52 +73,123 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
+static FORCE_INLINE int32_t getPagePayloadSize(int32_t pageSize) { return pageSize + (int32_t)sizeof(SFilePage); }
+
+// return the compressed page in the assistant buffer, or the page itself if it is not compressible
+static const char* doCompressData(const char* data, int32_t srcSize, int32_t* dst, bool* compressed,
+                                  SDiskbasedBuf* pBuf) {
+  *compressed = false;
+  *dst = srcSize;
+  if (pBuf->comp == BUF_PAGE_COMP_NONE) {
     return data;
   }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
+  int64_t st = taosGetTimestampUs();
+  int32_t cap = LZ4_compressBound(srcSize);
+  int32_t len = 0;
+  if (pBuf->comp == BUF_PAGE_COMP_LZ4HC) {
+    len = LZ4_compress_HC(data, pBuf->assistBuf, srcSize, cap, LZ4HC_CLEVEL_DEFAULT);
+  } else {
+    len = LZ4_compress_default(data, pBuf->assistBuf, srcSize, cap);
+  }
 
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
-}
+  pBuf->statis.compUs += taosGetTimestampUs() - st;
+  pBuf->statis.compSrcBytes += srcSize;
+  pBuf->statis.compPages += 1;
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
+  if (len <= 0 || len >= srcSize) {
+    pBuf->statis.compBytes += srcSize;
     return data;
   }
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  pBuf->statis.compBytes += len;
+  *compressed = true;
+  *dst = len;
+  return pBuf->assistBuf;
+}
+
+static int32_t doDecompressData(const char* data, int32_t srcSize, char* dst, int32_t dstSize, SDiskbasedBuf* pBuf) {
+  int64_t st = taosGetTimestampUs();
+  int32_t len = LZ4_decompress_safe(data, dst, srcSize, dstSize);
+  pBuf->statis.decompUs += taosGetTimestampUs() - st;
+
+  if (len != dstSize) {
+    uError("failed to decompress buf page, compressed size:%d, decompressed size:%d, expected:%d, %s", srcSize, len,
+           dstSize, pBuf->id);
+    return TSDB_CODE_FILE_CORRUPTED;
   }
-  return data;
+  return TSDB_CODE_SUCCESS;
 }
 
-static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, size_t size) {
-  if (pBuf->pFree == NULL) {
-    return pBuf->nextPos;
-  } else {
-    int32_t offset = -1;
+// best fit in the free area list, or append to the end of file
+static uint64_t allocateNewPositionInFile(SDiskbasedBuf* pBuf, int32_t size) {
+  int32_t index = -1;
+  int32_t minLen = INT32_MAX;
+  size_t  num = taosArrayGetSize(pBuf->pFree);
+  for (int32_t i = 0; i < num; ++i) {
+    SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
+    if (pi->length >= size && pi->length < minLen) {
+      index = i;
+      minLen = pi->length;
+      if (minLen == size) break;
+    }
+  }
 
-    size_t num = taosArrayGetSize(pBuf->pFree);
-    for (int32_t i = 0; i < num; ++i) {
-      SFreeListItem* pi = taosArrayGet(pBuf->pFree, i);
-      if (pi->length >= size) {
-        offset = pi->offset;
-        pi->offset += (int32_t)size;
-        pi->length -= (int32_t)size;
+  if (index == -1) {
+    uint64_t offset = pBuf->nextPos;
+    pBuf->nextPos += size;
+    return offset;
+  }
 
-        return offset;
-      }
+  SFreeListItem* pi = taosArrayGet(pBuf->pFree, index);
+  uint64_t       offset = pi->offset;
+  pi->offset += size;
+  pi->length -= size;
+  if (pi->length == 0) {
+    taosArrayRemove(pBuf->pFree, index);
+  }
+
+  return offset;
+}
+
+static void releasePositionInFile(SDiskbasedBuf* pBuf, int64_t offset, int32_t size) {
+  if (size <= 0) {
+    return;
+  }
+
+  // the first free area after the released one
+  int32_t num = (int32_t)taosArrayGetSize(pBuf->pFree);
+  int32_t pos = 0;
+  while (pos < num && ((SFreeListItem*)taosArrayGet(pBuf->pFree, pos))->offset < offset) {
+    pos += 1;
+  }
+
+  SFreeListItem item = {.offset = offset, .length = size};
+  if (pos < num) {
+    SFreeListItem* pNext = taosArrayGet(pBuf->pFree, pos);
+    if (item.offset + item.length == pNext->offset && (int64_t)item.length + pNext->length <= INT32_MAX) {
+      item.length += pNext->length;
+      taosArrayRemove(pBuf->pFree, pos);
+    }
+  }
+
+  if (pos > 0) {
+    SFreeListItem* pPrev = taosArrayGet(pBuf->pFree, pos - 1);
+    if (pPrev->offset + pPrev->length == item.offset && (int64_t)item.length + pPrev->length <= INT32_MAX) {
+      item.offset = pPrev->offset;
+      item.length += pPrev->length;
+      pos -= 1;
+      taosArrayRemove(pBuf->pFree, pos);
     }
+  }
 
-    // no available recycle space, allocate new area in file
-    return pBuf->nextPos;
+  // the tail of file is free, let the next page take it over
+  if (item.offset + item.length == pBuf->nextPos) {
+    pBuf->nextPos = item.offset;
+    return;
   }
+
+  taosArrayInsert(pBuf->pFree, pos, &item);
 }
 
 /**
@@ -163,44 +237,26 @@ static char* doFlushBufPage(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   int32_t size = pBuf->pageSize;
   int64_t offset = pg->offset;
 
-  char* t = NULL;
-  if ((!HAS_DATA_IN_DISK(pg)) || pg->dirty) {
-    void* payload = GET_PAYLOAD_DATA(pg);
-    t = doCompressData(payload, pBuf->pageSize + sizeof(SFilePage), &size, pBuf);
-    if (size < 0) {
-      uError("failed to compress data when flushing data to disk, %s", pBuf->id);
-      terrno = TSDB_CODE_INVALID_PARA;
-      return NULL;
-    }
-  }
-
-  // this page is flushed to disk for the first time
   if (pg->dirty) {
-    if (!HAS_DATA_IN_DISK(pg)) {
-      offset = allocateNewPositionInFile(pBuf, size);
-      pBuf->nextPos += size;
+    bool        compressed = false;
+    const char* t = doCompressData(GET_PAYLOAD_DATA(pg), getPagePayloadSize(pBuf->pageSize), &size, &compressed, pBuf);
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
-    } else {
-      // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        offset = allocateNewPositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
+    if (!HAS_DATA_IN_DISK(pg)) {  // this page is flushed to disk for the first time
+      offset = allocateNewPositionInFile(pBuf, size);
+    } else if (pg->length < size) {
+      // length becomes greater, current space is not enough, allocate new place
+      releasePositionInFile(pBuf, offset, pg->length);
+      offset = allocateNewPositionInFile(pBuf, size);
+    } else if (pg->length > size) {
+      // length becomes smaller, give back the tail
+      releasePositionInFile(pBuf, offset + size, pg->length - size);
+    }
 
-      int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
-      if (code != TSDB_CODE_SUCCESS) {
-        return NULL;
-      }
+    int32_t code = doFlushBufPageImpl(pBuf, offset, t, size);
+    if (code != TSDB_CODE_SUCCESS) {
+      return NULL;
     }
+    pg->compressed = compressed;
   } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
     size = pg->length;
   }
@@ -247,8 +303,9 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
     return ret;
   }
 
-  void* pPage = (void*)GET_PAYLOAD_DATA(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
+  char* pPage = GET_PAYLOAD_DATA(pg);
+  char* pRead = pg->compressed ? pBuf->assistBuf : pPage;
+  ret = (int32_t)taosReadFile(pBuf->pFile, pRead, pg->length);
   if (ret != pg->length) {
     ret = TAOS_SYSTEM_ERROR(errno);
     return ret;
@@ -257,8 +314,9 @@ static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   pBuf->statis.loadBytes += pg->length;
   pBuf->statis.loadPages += 1;
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
+  if (pg->compressed) {
+    return doDecompressData(pRead, pg->length, pPage, getPagePayloadSize(pBuf->pageSize), pBuf);
+  }
   return 0;
 }
 
@@ -278,6 +336,7 @@ static SPageInfo* registerNewPageInfo(SDiskbasedBuf* pBuf, int32_t pageId) {
   ppi->used = true;
   ppi->pn = NULL;
   ppi->dirty = false;
+  ppi->compressed = false;
 
   return *(SPageInfo**)taosArrayPush(pBuf->pIdList, &ppi);
 }
@@ -595,6 +654,13 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
           ps->getPages, ps->releasePages, ps->flushBytes / 1024.0f, ps->flushPages, ps->loadBytes / 1024.0f,
           ps->loadPages, ps->loadBytes / (1024.0 * ps->loadPages));
     }
+
+    if (ps->compPages > 0) {
+      uDebug("Compressed pages:%d, %.2f Kb -> %.2f Kb, ratio:%.2f, compress:%" PRId64 " us, decompress:%" PRId64
+             " us, %s",
+             ps->compPages, ps->compSrcBytes / 1024.0, ps->compBytes / 1024.0,
+             ps->compSrcBytes / (double)TMAX(ps->compBytes, 1), ps->compUs, ps->decompUs, pBuf->id);
+    }
   }
 
   if (needRemoveFile) {
@@ -647,11 +713,17 @@ void setBufPageDirty(void* pPage, bool dirty) {
   ppi->dirty = dirty;
 }
 
-void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp) {
-  pBuf->comp = comp;
-  if (comp  && (pBuf->assistBuf == NULL)) {
-    pBuf->assistBuf = taosMemoryMalloc(pBuf->pageSize + 2);  // EXTRA BYTES
+int32_t setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, int8_t comp) {
+  if (comp != BUF_PAGE_COMP_NONE && pBuf->assistBuf == NULL) {
+    pBuf->assistBuf = taosMemoryMalloc(LZ4_compressBound(getPagePayloadSize(pBuf->pageSize)));
+    if (pBuf->assistBuf == NULL) {
+      pBuf->comp = BUF_PAGE_COMP_NONE;
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
   }
+
+  pBuf->comp = comp;
+  return TSDB_CODE_SUCCESS;
 }
 
 void dBufSetBufPageRecycled(SDiskbasedBuf* pBuf, void* pPage) {
@@ -697,6 +769,12 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
   } else {
     // printf("no page loaded\n");
   }
+
+  if (ps->compPages > 0) {
+    printf("Compressed pages:%d, %.2f Kb -> %.2f Kb, ratio:%.2f, compress:%.2f ms, decompress:%.2f ms\n",
+           ps->compPages, ps->compSrcBytes / 1024.0, ps->compBytes / 1024.0,
+           ps->compSrcBytes / (double)TMAX(ps->compBytes, 1), ps->compUs / 1000.0, ps->decompUs / 1000.0);
+  }
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
@@ -721,4 +799,5 @@ void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
   pBuf->totalBufSize = 0;
   pBuf->allocateId = -1;
   pBuf->fileSize = 0;
+  pBuf->nextPos = 0;
 }
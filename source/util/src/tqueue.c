@@ -89,6 +89,11 @@ bool taosQueueEmpty(STaosQueue *queue) {
 void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   if (queue == NULL) return;
 
+  if (queue->stealing) {
+    atomic_sub_fetch_32(&queue->numOfItems, items);
+    return;
+  }
+
   taosThreadMutexLock(&queue->mutex);
   queue->numOfItems -= items;
   taosThreadMutexUnlock(&queue->mutex);
@@ -156,11 +161,51 @@ void taosFreeQitem(void *pItem) {
   taosMemoryFree(pNode);
 }
 
+static int32_t taosWriteQitemIntoRings(STaosQueue *queue, STaosQnode *pNode) {
+  STaosQset *qset = queue->qset;
+  int64_t    size = pNode->size + pNode->dataSize;
+
+  if (queue->memLimit > 0 && (atomic_load_64(&queue->memOfItems) + size) > queue->memLimit) {
+    uError("item:%p failed to put into queue:%p, queue mem limit: %" PRId64, pNode->item, queue, queue->memLimit);
+    return TSDB_CODE_UTIL_QUEUE_OUT_OF_MEMORY;
+  } else if (queue->itemLimit > 0 && atomic_load_32(&queue->numOfItems) + 1 > queue->itemLimit) {
+    uError("item:%p failed to put into queue:%p, queue size limit: %" PRId64, pNode->item, queue, queue->itemLimit);
+    return TSDB_CODE_UTIL_QUEUE_OUT_OF_MEMORY;
+  }
+
+  pNode->queue = queue;
+  atomic_add_fetch_32(&queue->numOfItems, 1);
+  atomic_add_fetch_64(&queue->memOfItems, size);
+
+  // rings are picked in turn, if all of them are full the writer backs off until a reader makes room
+  int64_t start = atomic_fetch_add_64(&qset->nextRing, 1);
+  for (int32_t retry = 0;; ++retry) {
+    bool pushed = false;
+    for (int32_t i = 0; i < qset->numOfRings && !pushed; ++i) {
+      pushed = taosLfQueuePush(qset->rings[(start + i) % qset->numOfRings], pNode);
+    }
+    if (pushed) break;
+    if (retry == 0) uWarn("qset:%p, all rings are full, queue:%p waits", qset, queue);
+    taosUsleep(1);
+  }
+
+  // pairs with the reader which registers as a sleeper before checking numOfItems
+  atomic_add_fetch_32(&qset->numOfItems, 1);
+  if (atomic_load_32(&qset->numOfSleepers) > 0) tsem_post(&qset->sem);
+
+  uTrace("item:%p is put into queue:%p, items:%d", pNode->item, queue, queue->numOfItems);
+  return 0;
+}
+
 int32_t taosWriteQitem(STaosQueue *queue, void *pItem) {
   int32_t     code = 0;
   STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
   pNode->next = NULL;
 
+  if (queue->stealing) {
+    return taosWriteQitemIntoRings(queue, pNode);
+  }
+
   taosThreadMutexLock(&queue->mutex);
   if (queue->memLimit > 0 && (queue->memOfItems + pNode->size + pNode->dataSize) > queue->memLimit) {
     code = TSDB_CODE_UTIL_QUEUE_OUT_OF_MEMORY;
@@ -305,6 +350,31 @@ STaosQset *taosOpenQset() {
   return qset;
 }
 
+STaosQset *taosOpenStealQset(int32_t numOfRings, int32_t capacity) {
+  STaosQset *qset = taosOpenQset();
+  if (qset == NULL) return NULL;
+
+  qset->type = QSET_TYPE_STEAL;
+  qset->rings = taosMemoryCalloc(numOfRings, sizeof(STaosLfQueue *));
+  if (qset->rings == NULL) {
+    taosCloseQset(qset);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < numOfRings; ++i) {
+    qset->rings[i] = taosLfQueueOpen(capacity);
+    if (qset->rings[i] == NULL) {
+      taosCloseQset(qset);
+      return NULL;
+    }
+    qset->numOfRings++;
+  }
+
+  uDebug("qset:%p is opened with %d rings, capacity:%d", qset, numOfRings, capacity);
+  return qset;
+}
+
 void taosCloseQset(STaosQset *qset) {
   if (qset == NULL) return;
 
@@ -319,6 +389,15 @@ void taosCloseQset(STaosQset *qset) {
   }
   taosThreadMutexUnlock(&qset->mutex);
 
+  for (int32_t i = 0; i < qset->numOfRings; ++i) {
+    STaosQnode *pNode = NULL;
+    while (taosLfQueuePop(qset->rings[i], (void **)&pNode)) {
+      taosFreeQitem(pNode->item);
+    }
+    taosLfQueueClose(qset->rings[i]);
+  }
+  taosMemoryFree(qset->rings);
+
   taosThreadMutexDestroy(&qset->mutex);
   tsem_destroy(&qset->sem);
   taosMemoryFree(qset);
@@ -330,6 +409,7 @@ void taosCloseQset(STaosQset *qset) {
 // thread to exit.
 void taosQsetThreadResume(STaosQset *qset) {
   uDebug("qset:%p, it will exit", qset);
+  if (qset->type == QSET_TYPE_STEAL) atomic_store_8(&qset->quit, 1);
   tsem_post(&qset->sem);
 }
 
@@ -344,7 +424,11 @@ int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
   qset->numOfQueues++;
 
   taosThreadMutexLock(&queue->mutex);
-  atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
+  if (qset->type == QSET_TYPE_STEAL) {
+    queue->stealing = 1;
+  } else {
+    atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
+  }
   queue->qset = qset;
   taosThreadMutexUnlock(&queue->mutex);
 
@@ -382,7 +466,7 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
       qset->numOfQueues--;
 
       taosThreadMutexLock(&queue->mutex);
-      atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
+      if (!queue->stealing) atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
       queue->qset = NULL;
       queue->next = NULL;
       taosThreadMutexUnlock(&queue->mutex);
@@ -394,10 +478,47 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
   uDebug("queue:%p is removed from qset:%p", queue, qset);
 }
 
+static int32_t taosReadQitemFromRings(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
+  int32_t     home = TABS(qinfo->workerId) % qset->numOfRings;
+  STaosQnode *pNode = NULL;
+
+  while (1) {
+    // own ring first, then steal from the others
+    for (int32_t i = 0; i < qset->numOfRings; ++i) {
+      if (taosLfQueuePop(qset->rings[(home + i) % qset->numOfRings], (void **)&pNode)) break;
+      pNode = NULL;
+    }
+    if (pNode != NULL) break;
+    if (atomic_load_8(&qset->quit)) return 0;
+
+    atomic_add_fetch_32(&qset->numOfSleepers, 1);
+    if (atomic_load_32(&qset->numOfItems) <= 0 && !atomic_load_8(&qset->quit)) {
+      tsem_wait(&qset->sem);
+    }
+    atomic_sub_fetch_32(&qset->numOfSleepers, 1);
+  }
+
+  STaosQueue *queue = pNode->queue;
+  atomic_sub_fetch_32(&qset->numOfItems, 1);
+  atomic_sub_fetch_64(&queue->memOfItems, pNode->size + pNode->dataSize);
+
+  *ppItem = pNode->item;
+  qinfo->ahandle = queue->ahandle;
+  qinfo->fp = queue->itemFp;
+  qinfo->queue = queue;
+  qinfo->timestamp = pNode->timestamp;
+  uTrace("item:%p is read out from queue:%p by worker:%d", *ppItem, queue, qinfo->workerId);
+  return 1;
+}
+
 int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
   STaosQnode *pNode = NULL;
   int32_t     code = 0;
 
+  if (qset->type == QSET_TYPE_STEAL) {
+    return taosReadQitemFromRings(qset, ppItem, qinfo);
+  }
+
   tsem_wait(&qset->sem);
 
   taosThreadMutexLock(&qset->mutex);
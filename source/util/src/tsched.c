@@ -166,6 +166,7 @@ void *taosProcessSchedQueue(void *scheduler) {
   }
 
   destroyThreadLocalGeosCtx();
+  taosDestroyThreadFileRing();
 
   return NULL;
 }
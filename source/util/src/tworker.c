@@ -19,10 +19,14 @@
 #include "taoserror.h"
 #include "tlog.h"
 
+#define QWORKER_RING_CAPACITY 4096
+
 typedef void *(*ThreadFp)(void *param);
 
 int32_t tQWorkerInit(SQWorkerPool *pool) {
-  pool->qset = taosOpenQset();
+  pool->qset = pool->stealing ? taosOpenStealQset(pool->max, QWORKER_RING_CAPACITY) : taosOpenQset();
+  if (pool->qset == NULL) return -1;
+
   pool->workers = taosMemoryCalloc(pool->max, sizeof(SQueueWorker));
   if (pool->workers == NULL) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
@@ -37,7 +41,7 @@ int32_t tQWorkerInit(SQWorkerPool *pool) {
     worker->pool = pool;
   }
 
-  uInfo("worker:%s is initialized, min:%d max:%d", pool->name, pool->min, pool->max);
+  uInfo("worker:%s is initialized, min:%d max:%d stealing:%d", pool->name, pool->min, pool->max, pool->stealing);
   return 0;
 }
 
@@ -77,6 +81,9 @@ static void *tQWorkerThreadFp(SQueueWorker *worker) {
   worker->pid = taosGetSelfPthreadId();
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
 
+  // the worker id selects the home ring of a stealing qset
+  qinfo.workerId = worker->id;
+
   while (1) {
     if (taosReadQitemFromQset(pool->qset, (void **)&msg, &qinfo) == 0) {
       uInfo("worker:%s:%d qset:%p, got no message and exiting, thread:%08" PRId64, pool->name, worker->id, pool->qset,
@@ -94,6 +101,7 @@ static void *tQWorkerThreadFp(SQueueWorker *worker) {
   }
 
   destroyThreadLocalGeosCtx();
+  taosDestroyThreadFileRing();
 
   return NULL;
 }
@@ -207,6 +215,8 @@ static void *tAutoQWorkerThreadFp(SQueueWorker *worker) {
     taosUpdateItemSize(qinfo.queue, 1);
   }
 
+  taosDestroyThreadFileRing();
+
   return NULL;
 }
 
@@ -346,6 +356,8 @@ static void *tWWorkerThreadFp(SWWorker *worker) {
     taosUpdateItemSize(qinfo.queue, numOfMsgs);
   }
 
+  taosDestroyThreadFileRing();
+
   return NULL;
 }
 
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "taoserror.h"
+#include "tarena.h"
+
+namespace {
+
+typedef struct {
+  int64_t charged;
+  int64_t limit;
+} SArenaQuota;
+
+int32_t chargeQuota(void *param, int64_t size) {
+  SArenaQuota *pQuota = (SArenaQuota *)param;
+  if (size > 0 && pQuota->limit > 0 && pQuota->charged + size > pQuota->limit) {
+    return terrno = TSDB_CODE_QRY_NOT_ENOUGH_BUFFER;
+  }
+  pQuota->charged += size;
+  return 0;
+}
+
+}  // namespace
+
+TEST(arenaTest, reuse_freed) {
+  SArenaQuota quota = {0};
+  SArena     *pArena = taosArenaCreate(chargeQuota, &quota);
+
+  std::vector<char *> ps;
+  for (int32_t i = 0; i < 10000; ++i) {
+    int64_t size = i % 300 + 1;
+    char   *p = (char *)taosArenaMalloc(pArena, size);
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ((uintptr_t)p % 16, 0);
+    memset(p, i & 0xff, size);
+    ps.push_back(p);
+  }
+  for (int32_t i = 0; i < 10000; ++i) {
+    ASSERT_EQ((uint8_t)ps[i][i % 300], (uint8_t)(i & 0xff));
+  }
+
+  // freed memory is reused, no more chunk is required
+  int64_t size = taosArenaChunkSize(pArena);
+  for (int32_t round = 0; round < 10; ++round) {
+    for (int32_t i = 0; i < 10000; ++i) {
+      taosArenaFree(pArena, ps[i]);
+    }
+    for (int32_t i = 0; i < 10000; ++i) {
+      ps[i] = (char *)taosArenaMalloc(pArena, i % 300 + 1);
+    }
+  }
+  EXPECT_EQ(taosArenaChunkSize(pArena), size);
+  EXPECT_EQ(quota.charged, size);
+
+  taosArenaDestroy(pArena);
+  EXPECT_EQ(quota.charged, 0);
+}
+
+TEST(arenaTest, large_and_realloc) {
+  SArenaQuota quota = {0};
+  SArena     *pArena = taosArenaCreate(chargeQuota, &quota);
+
+  char *p = (char *)taosArenaCalloc(pArena, 1, 10);
+  strcpy(p, "arena");
+  p = (char *)taosArenaRealloc(pArena, p, 100 * 1024);
+  ASSERT_NE(p, nullptr);
+  EXPECT_STREQ(p, "arena");
+  int64_t withLarge = taosArenaChunkSize(pArena);
+
+  // a large allocation is released on free
+  taosArenaFree(pArena, p);
+  EXPECT_LT(taosArenaChunkSize(pArena), withLarge - 100 * 1024);
+  EXPECT_EQ(quota.charged, taosArenaChunkSize(pArena));
+
+  taosArenaDestroy(pArena);
+  EXPECT_EQ(quota.charged, 0);
+}
+
+TEST(arenaTest, quota) {
+  SArenaQuota quota = {0, 256 * 1024};
+  SArena     *pArena = taosArenaCreate(chargeQuota, &quota);
+
+  int32_t num = 0;
+  while (taosArenaMalloc(pArena, 1000) != NULL) {
+    num++;
+  }
+  EXPECT_EQ(terrno, TSDB_CODE_QRY_NOT_ENOUGH_BUFFER);
+  EXPECT_GT(num, 0);
+  EXPECT_LE(quota.charged, quota.limit);
+  EXPECT_EQ(taosArenaMalloc(pArena, 1024 * 1024), nullptr);
+
+  taosArenaDestroy(pArena);
+  EXPECT_EQ(quota.charged, 0);
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+#include "tkll.h"
+
+namespace {
+
+// the rank error of the estimated quantile against the exact one
+double rankError(std::vector<double> &sorted, double estimate, double q) {
+  auto   pos = std::lower_bound(sorted.begin(), sorted.end(), estimate);
+  double rank = (double)(pos - sorted.begin()) / sorted.size();
+  return fabs(rank - q);
+}
+
+}  // namespace
+
+TEST(kllTest, small_exact) {
+  char  buf[KLL_SIZE];
+  SKll *pKll = tKllNewFrom(buf);
+  ASSERT_TRUE(isnan(tKllQuantile(pKll, 0.5)));
+
+  for (int32_t i = 100; i >= 1; --i) {
+    tKllAdd(pKll, i);
+  }
+
+  ASSERT_EQ(pKll->n, 100);
+  ASSERT_EQ(tKllQuantile(pKll, 0), 1);
+  ASSERT_EQ(tKllQuantile(pKll, 1), 100);
+  ASSERT_EQ(tKllQuantile(pKll, 0.5), 50);
+  ASSERT_EQ(tKllQuantile(pKll, 0.9), 90);
+}
+
+TEST(kllTest, large_stream) {
+  const int32_t       num = 1000000;
+  std::vector<double> values;
+  uint32_t            seed = 1;
+  char                buf[KLL_SIZE];
+  SKll               *pKll = tKllNewFrom(buf);
+
+  for (int32_t i = 0; i < num; ++i) {
+    double v = taosRandR(&seed) % 100000 + (i % 7) * 0.1;
+    values.push_back(v);
+    tKllAdd(pKll, v);
+  }
+  std::sort(values.begin(), values.end());
+
+  ASSERT_EQ(pKll->n, num);
+  ASSERT_EQ(tKllQuantile(pKll, 0), values.front());
+  ASSERT_EQ(tKllQuantile(pKll, 1), values.back());
+  for (double q : {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99}) {
+    ASSERT_LT(rankError(values, tKllQuantile(pKll, q), q), 0.02) << "q:" << q;
+  }
+}
+
+TEST(kllTest, merge) {
+  const int32_t       numOfSketches = 50;
+  const int32_t       num = 20000;
+  std::vector<double> values;
+  std::vector<char>   bufs(KLL_SIZE * numOfSketches);
+  char                buf[KLL_SIZE];
+  SKll               *pRes = tKllNewFrom(buf);
+
+  // skewed parts, as partial results of different vnodes
+  for (int32_t s = 0; s < numOfSketches; ++s) {
+    SKll *pKll = tKllNewFrom(&bufs[s * KLL_SIZE]);
+    for (int32_t i = 0; i < num; ++i) {
+      double v = s * 1000 + (i * 7919) % (s + 1) * 10;
+      values.push_back(v);
+      tKllAdd(pKll, v);
+    }
+  }
+
+  // merge into an empty one and then into each other
+  for (int32_t s = 0; s < numOfSketches; ++s) {
+    tKllMerge(pRes, (SKll *)&bufs[s * KLL_SIZE]);
+  }
+  std::sort(values.begin(), values.end());
+
+  ASSERT_EQ(pRes->n, (int64_t)numOfSketches * num);
+  ASSERT_EQ(tKllQuantile(pRes, 0), values.front());
+  ASSERT_EQ(tKllQuantile(pRes, 1), values.back());
+  for (double q : {0.05, 0.25, 0.5, 0.75, 0.95}) {
+    ASSERT_LT(rankError(values, tKllQuantile(pRes, q), q), 0.02) << "q:" << q;
+  }
+
+  // the total weight is kept after merging
+  int64_t total = 0;
+  for (int32_t h = 0; h < pRes->numLevels; ++h) {
+    total += (int64_t)(pRes->levels[h + 1] - pRes->levels[h]) << h;
+  }
+  ASSERT_EQ(total, pRes->n);
+}
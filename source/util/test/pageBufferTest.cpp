@@ -220,6 +220,60 @@ void testFlushAndReadBackBuffer() {
   taosMemoryFree(rowData);
 }
 
+// evict pages through a two-page window, so that every page is compressed, written and read back several times
+void compressedFlushTest(int8_t comp) {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        pageSize = 4096;
+  int32_t        numOfPages = 16;
+  ASSERT_EQ(createDiskbasedBuf(&pBuf, pageSize, pageSize * 2, "comp", TD_TMP_DIR_PATH), 0);
+  ASSERT_EQ(setBufPageCompressOnDisk(pBuf, comp), 0);
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t    pageId = -1;
+    SFilePage* pPg = (SFilePage*)getNewBufPage(pBuf, &pageId);
+    ASSERT_TRUE(pPg != nullptr);
+    ASSERT_EQ(pageId, i);
+    pPg->num = pageSize;
+    for (int32_t j = 0; j < pageSize / sizeof(int32_t); ++j) {
+      ((int32_t*)pPg->data)[j] = i * 10 + j % 7;
+    }
+    setBufPageDirty(pPg, true);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  SDiskbasedBufStatis st = getDBufStatis(pBuf);
+  ASSERT_GT(st.compPages, 0);
+  ASSERT_LT(st.compBytes * 3, st.compSrcBytes);
+
+  // overwrite the even pages with incompressible data, they grow on disk and have to move
+  for (int32_t i = 0; i < numOfPages; i += 2) {
+    SFilePage* pPg = (SFilePage*)getBufPage(pBuf, i);
+    ASSERT_TRUE(pPg != nullptr);
+    for (int32_t j = 0; j < pageSize / sizeof(int32_t); ++j) {
+      ((int32_t*)pPg->data)[j] = taosRand();
+    }
+    ((int32_t*)pPg->data)[0] = i;
+    setBufPageDirty(pPg, true);
+    releaseBufPage(pBuf, pPg);
+  }
+
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SFilePage* pPg = (SFilePage*)getBufPage(pBuf, i);
+    ASSERT_TRUE(pPg != nullptr);
+    ASSERT_EQ(pPg->num, pageSize);
+    if (i % 2 == 0) {
+      ASSERT_EQ(((int32_t*)pPg->data)[0], i);
+    } else {
+      for (int32_t j = 0; j < pageSize / sizeof(int32_t); ++j) {
+        ASSERT_EQ(((int32_t*)pPg->data)[j], i * 10 + j % 7);
+      }
+    }
+    releaseBufPage(pBuf, pPg);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
+
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -230,4 +284,10 @@ TEST(testCase, resultBufferTest) {
   testFlushAndReadBackBuffer();
 }
 
+TEST(testCase, compressedBufferTest) {
+  taosSeedRand(taosGetTimestampSec());
+  compressedFlushTest(BUF_PAGE_COMP_LZ4);
+  compressedFlushTest(BUF_PAGE_COMP_LZ4HC);
+}
+
 #pragma GCC diagnostic pop
@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tlfqueue.h"
+#include "tworker.h"
+
+namespace {
+
+// a full queue or a stalled pool fails the test instead of spinning forever
+const int64_t kWaitTimeoutUs = 30 * 1000000;
+
+typedef struct {
+  std::atomic<int64_t> processed;
+  std::atomic<int64_t> sum;
+  int64_t             *latency;  // us, from allocation to processing
+  int64_t              capacity;
+  std::atomic<bool>    timedOut;
+} SQueueTestCtx;
+
+void queueTestFp(SQueueInfo *pInfo, void *pItem) {
+  SQueueTestCtx *pCtx = (SQueueTestCtx *)pInfo->ahandle;
+  int64_t        lat = taosGetTimestampUs() - pInfo->timestamp;
+
+  pCtx->sum += *(int64_t *)pItem;
+  int64_t idx = pCtx->processed++;
+  if (pCtx->latency != NULL && idx < pCtx->capacity) {
+    pCtx->latency[idx] = lat;
+  }
+  taosFreeQitem(pItem);
+}
+
+void writeItems(SQueueTestCtx *pCtx, STaosQueue *queue, int64_t start, int64_t num) {
+  for (int64_t i = start; i < start + num && !pCtx->timedOut; ++i) {
+    int64_t *pItem = (int64_t *)taosAllocateQitem(sizeof(int64_t), DEF_QITEM, 0);
+    *pItem = i;
+
+    // all the rings are full, wait for the workers to drain them, but not forever
+    int64_t deadline = taosGetTimestampUs() + kWaitTimeoutUs;
+    while (taosWriteQitem(queue, pItem) != 0) {
+      if (pCtx->timedOut || taosGetTimestampUs() > deadline) {
+        pCtx->timedOut = true;
+        taosFreeQitem(pItem);
+        return;
+      }
+      taosUsleep(1);
+    }
+  }
+}
+
+bool waitProcessed(SQueueTestCtx *pCtx, int64_t num) {
+  int64_t deadline = taosGetTimestampUs() + kWaitTimeoutUs;
+  while (pCtx->processed.load() < num) {
+    if (pCtx->timedOut || taosGetTimestampUs() > deadline) {
+      pCtx->timedOut = true;
+      return false;
+    }
+    taosUsleep(10);
+  }
+  return true;
+}
+
+// run numOfThreads writers against a pool of numOfThreads workers, and report throughput and tail latency
+void runWorkerBench(int32_t numOfThreads, bool stealing, int64_t numOfItems) {
+  SQueueTestCtx ctx;
+  ctx.processed = 0;
+  ctx.sum = 0;
+  ctx.capacity = numOfItems;
+  ctx.latency = (int64_t *)taosMemoryCalloc(numOfItems, sizeof(int64_t));
+  ctx.timedOut = false;
+
+  SQWorkerPool pool = {0};
+  pool.name = "bench";
+  pool.min = numOfThreads;
+  pool.max = numOfThreads;
+  pool.stealing = stealing;
+  ASSERT_EQ(tQWorkerInit(&pool), 0);
+
+  STaosQueue *queue = tQWorkerAllocQueue(&pool, &ctx, queueTestFp);
+  ASSERT_NE(queue, nullptr);
+
+  int64_t                  perThread = numOfItems / numOfThreads;
+  int64_t                  start = taosGetTimestampUs();
+  std::vector<std::thread> writers;
+  for (int32_t t = 0; t < numOfThreads; ++t) {
+    writers.emplace_back(writeItems, &ctx, queue, t * perThread, perThread);
+  }
+  for (auto &w : writers) w.join();
+  bool done = waitProcessed(&ctx, perThread * numOfThreads);
+  int64_t elapsed = taosGetTimestampUs() - start;
+
+  tQWorkerCleanup(&pool);
+  tQWorkerFreeQueue(&pool, queue);
+  if (!done) {
+    taosMemoryFree(ctx.latency);
+    FAIL() << "timed out with " << ctx.processed.load() << " items processed";
+  }
+
+  int64_t total = perThread * numOfThreads;
+  std::sort(ctx.latency, ctx.latency + total);
+  printf("%-8s threads:%2d items:%" PRId64 " throughput:%.0f/s p50:%" PRId64 "us p99:%" PRId64 "us p999:%" PRId64
+         "us\n",
+         stealing ? "stealing" : "qset", numOfThreads, total, total * 1000000.0 / TMAX(elapsed, 1),
+         ctx.latency[total / 2], ctx.latency[total * 99 / 100], ctx.latency[total * 999 / 1000]);
+
+  taosMemoryFree(ctx.latency);
+}
+
+}  // namespace
+
+TEST(lfqueueTest, push_pop) {
+  STaosLfQueue *queue = taosLfQueueOpen(5);
+  ASSERT_NE(queue, nullptr);
+  ASSERT_EQ(taosLfQueueCapacity(queue), 8);
+
+  void *p = NULL;
+  ASSERT_FALSE(taosLfQueuePop(queue, &p));
+
+  for (int64_t i = 1; i <= 8; ++i) {
+    ASSERT_TRUE(taosLfQueuePush(queue, (void *)i));
+  }
+  ASSERT_FALSE(taosLfQueuePush(queue, (void *)9));
+  ASSERT_EQ(taosLfQueueSize(queue), 8);
+
+  // wrap around several rounds and keep FIFO order
+  for (int64_t i = 1; i <= 100; ++i) {
+    ASSERT_TRUE(taosLfQueuePop(queue, &p));
+    ASSERT_EQ((int64_t)p, i);
+    ASSERT_TRUE(taosLfQueuePush(queue, (void *)(i + 8)));
+  }
+
+  for (int64_t i = 101; i <= 108; ++i) {
+    ASSERT_TRUE(taosLfQueuePop(queue, &p));
+    ASSERT_EQ((int64_t)p, i);
+  }
+  ASSERT_FALSE(taosLfQueuePop(queue, &p));
+  ASSERT_EQ(taosLfQueueSize(queue), 0);
+
+  taosLfQueueClose(queue);
+}
+
+TEST(lfqueueTest, multi_producer_multi_consumer) {
+  const int32_t numOfThreads = 4;
+  const int64_t perThread = 100000;
+
+  STaosLfQueue        *queue = taosLfQueueOpen(64);
+  std::atomic<int64_t> sum(0);
+  std::atomic<int64_t> count(0);
+  std::atomic<bool>    timedOut(false);
+  int64_t              deadline = taosGetTimestampUs() + kWaitTimeoutUs;
+
+  std::vector<std::thread> threads;
+  for (int32_t t = 0; t < numOfThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int64_t i = 1; i <= perThread && !timedOut; ++i) {
+        while (!taosLfQueuePush(queue, (void *)(t * perThread + i))) {
+          if (timedOut || taosGetTimestampUs() > deadline) {
+            timedOut = true;
+            return;
+          }
+          std::this_thread::yield();
+        }
+      }
+    });
+    threads.emplace_back([&]() {
+      void *p = NULL;
+      while (count.load() < numOfThreads * perThread && !timedOut) {
+        if (taosGetTimestampUs() > deadline) {
+          timedOut = true;
+          break;
+        }
+        if (taosLfQueuePop(queue, &p)) {
+          sum += (int64_t)p;
+          count++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &t : threads) t.join();
+
+  int64_t n = numOfThreads * perThread;
+  ASSERT_FALSE(timedOut.load());
+  ASSERT_EQ(count.load(), n);
+  ASSERT_EQ(sum.load(), n * (n + 1) / 2);
+  taosLfQueueClose(queue);
+}
+
+TEST(queueWorkerTest, stealing_pool) {
+  const int64_t numOfItems = 20000;
+
+  SQueueTestCtx ctx;
+  ctx.processed = 0;
+  ctx.sum = 0;
+  ctx.latency = NULL;
+  ctx.capacity = 0;
+  ctx.timedOut = false;
+
+  SQWorkerPool pool = {0};
+  pool.name = "steal";
+  pool.min = 4;
+  pool.max = 4;
+  pool.stealing = true;
+  ASSERT_EQ(tQWorkerInit(&pool), 0);
+
+  STaosQueue *queue1 = tQWorkerAllocQueue(&pool, &ctx, queueTestFp);
+  STaosQueue *queue2 = tQWorkerAllocQueue(&pool, &ctx, queueTestFp);
+  ASSERT_NE(queue1, nullptr);
+  ASSERT_NE(queue2, nullptr);
+
+  std::thread w1(writeItems, &ctx, queue1, 0, numOfItems / 2);
+  std::thread w2(writeItems, &ctx, queue2, numOfItems / 2, numOfItems / 2);
+  w1.join();
+  w2.join();
+
+  bool done = waitProcessed(&ctx, numOfItems);
+  while (done && (!taosQueueEmpty(queue1) || !taosQueueEmpty(queue2))) taosMsleep(1);
+
+  // the workers are stopped before checking, so that a failure does not leave them on ctx
+  tQWorkerCleanup(&pool);
+
+  EXPECT_TRUE(done) << "timed out with " << ctx.processed.load() << " items processed";
+  EXPECT_EQ(ctx.sum.load(), numOfItems * (numOfItems - 1) / 2);
+  EXPECT_EQ(taosQueueItemSize(queue1), 0);
+  EXPECT_EQ(taosQueueMemorySize(queue2), 0);
+
+  tQWorkerFreeQueue(&pool, queue1);
+  tQWorkerFreeQueue(&pool, queue2);
+}
+
+// micro-benchmark of the qset and the stealing backend, run with --gtest_also_run_disabled_tests
+TEST(queueWorkerTest, DISABLED_benchmark) {
+  int32_t threads[] = {1, 2, 4, 8, 16, 32, 64};
+  for (int32_t i = 0; i < (int32_t)(sizeof(threads) / sizeof(threads[0])); ++i) {
+    runWorkerBench(threads[i], false, 640000);
+    runWorkerBench(threads[i], true, 640000);
+  }
+}
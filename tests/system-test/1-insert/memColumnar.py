@@ -0,0 +1,101 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "db"
+        self.columnarRows = 100
+        self.ts = 1640966400000  # 2022-01-01 00:00:00 +08:00
+
+    def value(self, v):
+        return "NULL" if v is None else (f"'{v}'" if isinstance(v, str) else f"{v}")
+
+    def rows(self, start, num, step, seed):
+        rows = []
+        for i in range(num):
+            k = start + i * step
+            c1 = None if (k + seed) % 7 == 0 else (k * 31 + seed) % 1000
+            c2 = None if (k + seed) % 11 == 0 else k * 0.5 + seed
+            c3 = None if (k + seed) % 5 == 0 else f"s{seed}_{k}"
+            rows.append((self.ts + k, c1, c2, c3))
+        return rows
+
+    def insert(self, rows, cols=None):
+        # the table in row format gets the rows in submits below the threshold, the other one in a single submit
+        colList = f" ({', '.join(cols)})" if cols else ""
+        values = [" ".join(["(" + ", ".join([self.value(v) for v in r]) + ")" for r in part])
+                  for part in [rows[i:i + self.columnarRows // 2] for i in range(0, len(rows), self.columnarRows // 2)]]
+        for part in values:
+            tdSql.execute(f"insert into {self.dbname}.t_row{colList} values {part}")
+        tdSql.execute(f"insert into {self.dbname}.t_col{colList} values {' '.join(values)}")
+        self.keys |= set([r[0] for r in rows])
+
+    def prepareData(self):
+        dbname = self.dbname
+        self.keys = set()
+        tdSql.execute(f"drop database if exists {dbname}")
+        tdSql.execute(f"create database {dbname} vgroups 1 replica {self.replicaVar}")
+        for tb in ["t_row", "t_col"]:
+            tdSql.execute(f"create table {dbname}.{tb} (ts timestamp, c1 int, c2 double, c3 binary(16))")
+
+        # rows in order, with null values
+        self.insert(self.rows(0, 300, 2, 0))
+        # rows between and before the rows in memory table
+        self.insert(self.rows(1, 300, 2, 1))
+        self.insert(self.rows(-500, 200, 1, 2))
+        # rows overwriting the rows in memory table, some columns with null values and some not written at all
+        self.insert(self.rows(100, 200, 1, 3))
+        self.insert([(r[0], r[1]) for r in self.rows(250, 150, 3, 4)], ["ts", "c1"])
+        self.insert([(r[0], r[3]) for r in self.rows(-100, 120, 1, 5)], ["ts", "c3"])
+        # duplicated keys in one submit
+        self.insert(self.rows(50, 150, 1, 6) + self.rows(100, 150, 1, 7))
+        # a submit below the threshold
+        self.insert(self.rows(600, 10, 1, 8))
+
+    def checkEqual(self, sql):
+        rowRes = tdSql.getResult(sql.format(tb="t_row"))
+        colRes = tdSql.getResult(sql.format(tb="t_col"))
+        if rowRes != colRes:
+            tdLog.exit(f"results differ, {len(rowRes)} rows in row format, {len(colRes)} rows in column format, sql:{sql}")
+        tdLog.info(f"{len(rowRes)} rows are the same in both formats, sql:{sql}")
+
+    def checkData(self):
+        dbname = self.dbname
+        for order in ["asc", "desc"]:
+            self.checkEqual(f"select * from {dbname}.{{tb}} order by ts {order}")
+            self.checkEqual(f"select * from {dbname}.{{tb}} where ts >= {self.ts + 95} and ts < {self.ts + 305} "
+                            f"order by ts {order}")
+        self.checkEqual(f"select count(*), count(c1), count(c2), count(c3), sum(c1), min(c2), max(c2) "
+                        f"from {dbname}.{{tb}}")
+        self.checkEqual(f"select first(*), last(*), last_row(*) from {dbname}.{{tb}}")
+        self.checkEqual(f"select _wstart, count(*), sum(c1), last(c3) from {dbname}.{{tb}} interval(100a)")
+
+        tdSql.query(f"select count(*) from {dbname}.t_col")
+        tdSql.checkData(0, 0, len(self.keys))
+
+    def run(self):
+        tdSql.execute(f"alter all dnodes 'memColumnarRows' '{self.columnarRows}'")
+        self.prepareData()
+        self.checkData()
+
+        # the rows in column format are committed the same as the rows in row format
+        tdSql.execute(f"flush database {self.dbname}")
+        self.checkData()
+
+        # rows in memory table over the committed ones
+        self.insert(self.rows(-50, 400, 1, 9))
+        self.checkData()
+        tdSql.execute("alter all dnodes 'memColumnarRows' '0'")
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,110 @@
+import taos
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    # the vnodes created with this option read ahead the file blocks, the depth is kept in vnode.json after a restart
+    updatecfgDict = {'tsdbPrefetchDepth': 8}
+
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.numOfTables = 4
+        self.numOfRows = 5000
+        self.maxRows = 200
+        self.ts = 1640966400000  # 2022-01-01 00:00:00 +08:00
+
+    def values(self, tb, start, end):
+        return " ".join([f"({self.ts + i * 1000}, {(i * 37 + tb) % 1000}, {i * 0.5}, 'v{tb}_{i}')"
+                         for i in range(start, end)])
+
+    def createDb(self, dbname):
+        tdSql.execute(f"drop database if exists {dbname}")
+        tdSql.execute(f"create database {dbname} vgroups 1 minrows 10 maxrows {self.maxRows} stt_trigger 1 "
+                      f"replica {self.replicaVar}")
+        tdSql.execute(f"create stable {dbname}.stb (ts timestamp, c1 int, c2 double, c3 binary(16)) tags (t1 int)")
+        for tb in range(self.numOfTables):
+            tdSql.execute(f"create table {dbname}.ct{tb} using {dbname}.stb tags ({tb})")
+            for start in range(0, self.numOfRows, 1000):
+                tdSql.execute(f"insert into {dbname}.ct{tb} values {self.values(tb, start, start + 1000)}")
+        tdSql.execute(f"flush database {dbname}")
+
+        # rows in the memory table over the file blocks
+        for tb in range(self.numOfTables):
+            tdSql.execute(f"insert into {dbname}.ct{tb} values {self.values(tb + 100, 2000, 2010)}")
+
+    def restartWithPrefetchDepth(self, depth):
+        tdDnodes.stop(1)
+        tdDnodes.cfg(1, "tsdbPrefetchDepth", depth)
+        tdDnodes.start(1)
+        tdSql.query("show dnode 1 variables like 'tsdbPrefetchDepth'")
+        tdSql.checkData(0, 2, depth)
+
+    def checkEqual(self, sql):
+        onRes = tdSql.getResult(sql.format(db="db_on"))
+        offRes = tdSql.getResult(sql.format(db="db_off"))
+        if onRes != offRes:
+            tdLog.exit(f"results differ, {len(onRes)} rows with prefetch, {len(offRes)} rows without, sql:{sql}")
+        tdLog.info(f"{len(onRes)} rows are the same with and without prefetch, sql:{sql}")
+
+    def checkScan(self):
+        start, end = self.ts + 1234 * 1000, self.ts + 3456 * 1000
+        for order in ["asc", "desc"]:
+            self.checkEqual(f"select * from {{db}}.ct0 order by ts {order}")
+            # only some of the columns are read ahead
+            self.checkEqual(f"select ts, c2 from {{db}}.ct1 order by ts {order}")
+            self.checkEqual(f"select * from {{db}}.ct2 where ts >= {start} and ts < {end} order by ts {order}")
+            self.checkEqual(f"select * from {{db}}.ct3 where c1 > 900 order by ts {order}")
+            self.checkEqual(f"select * from {{db}}.stb order by ts {order}, t1 {order}")
+
+        # the blocks passed with the SMA only, and the ones loaded in between
+        self.checkEqual("select count(*), sum(c1), min(c2), max(c2) from {db}.stb partition by tbname order by tbname")
+        self.checkEqual(f"select _wstart, count(*), sum(c1), last(c3) from {{db}}.ct0 interval(7s)")
+        self.checkEqual(f"select _wstart, count(*), max(c1) from {{db}}.ct1 where c1 < 100 interval(1m)")
+
+    # the reader is closed with the reads of the next blocks in flight
+    def checkEarlyClose(self):
+        for order in ["asc", "desc"]:
+            for offset in [0, 150, 1999, 4990]:
+                self.checkEqual(f"select * from {{db}}.ct0 order by ts {order} limit 5 offset {offset}")
+                self.checkEqual(f"select * from {{db}}.stb order by ts {order}, t1 {order} limit 10 offset {offset}")
+
+        conn = taos.connect(config=tdDnodes.getSimCfgPath())
+        try:
+            for i in range(50):
+                cursor = conn.cursor()
+                cursor.execute(f"select * from db_on.stb order by ts {['asc', 'desc'][i % 2]}")
+                cursor.fetchone()
+                cursor.close()
+        finally:
+            conn.close()
+
+        # the slots and the channel of the readers closed early are not reused by the later scans
+        self.checkScan()
+
+    def run(self):
+        self.createDb("db_on")
+        self.restartWithPrefetchDepth(0)
+        self.createDb("db_off")
+
+        self.checkScan()
+        self.checkEarlyClose()
+
+        # the same blocks read ahead once the memory table is flushed
+        tdSql.execute("flush database db_on")
+        tdSql.execute("flush database db_off")
+        self.checkScan()
+        self.checkEarlyClose()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,114 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "db"
+        self.numOfRows = 1000
+        self.maxRows = 200
+        self.ts = 1640966400000  # 2022-01-01 00:00:00 +08:00
+        # rows written to the memory table after the flush, in the middle of a file block:
+        # ct0: new rows between the file rows 250 and 260, and an update of the file row 300
+        # ct1: two runs of new rows in the same file block, with file rows between them
+        # ct2: new rows in the first and in the last file block
+        self.memRows = {
+            0: [(i, 500) for i in range(250, 260)] + [(300, 0)],
+            1: [(i, 500) for i in range(610, 613)] + [(i, 250) for i in range(680, 683)],
+            2: [(i, 700) for i in range(3, 6)] + [(i, 100) for i in range(990, 999)],
+        }
+
+    def fileRow(self, tb, i):
+        return (self.ts + i * 1000, (i * 37 + tb) % 1000, i * 0.5, f"f{tb}_{i}")
+
+    def memRow(self, tb, i, offset):
+        return (self.ts + i * 1000 + offset, -(i + 1), i * 0.25, f"m{tb}_{i}_{offset}")
+
+    def prepareData(self):
+        dbname = self.dbname
+        tdSql.execute(f"drop database if exists {dbname}")
+        tdSql.execute(f"create database {dbname} vgroups 1 minrows 10 maxrows {self.maxRows} stt_trigger 1 "
+                      f"replica {self.replicaVar}")
+        tdSql.execute(f"create stable {dbname}.stb (ts timestamp, c1 int, c2 double, c3 binary(16)) tags (t1 int)")
+
+        self.expected = {}
+        for tb in self.memRows:
+            tdSql.execute(f"create table {dbname}.ct{tb} using {dbname}.stb tags ({tb})")
+            rows = {}
+            for start in range(0, self.numOfRows, 500):
+                values = [self.fileRow(tb, i) for i in range(start, min(start + 500, self.numOfRows))]
+                tdSql.execute(f"insert into {dbname}.ct{tb} values " +
+                              " ".join([f"({ts}, {c1}, {c2}, '{c3}')" for (ts, c1, c2, c3) in values]))
+                rows.update({r[0]: r for r in values})
+            self.expected[tb] = rows
+        tdSql.execute(f"flush database {dbname}")
+
+        for tb, memRows in self.memRows.items():
+            values = [self.memRow(tb, i, offset) for (i, offset) in memRows]
+            tdSql.execute(f"insert into {dbname}.ct{tb} values " +
+                          " ".join([f"({ts}, {c1}, {c2}, '{c3}')" for (ts, c1, c2, c3) in values]))
+            self.expected[tb].update({r[0]: r for r in values})
+
+    def checkResult(self, sql, expected):
+        res = [tuple(r) for r in tdSql.getResult(sql)]
+        if res != expected:
+            first = next((i for i in range(min(len(res), len(expected))) if res[i] != expected[i]), None)
+            tdLog.exit(f"{len(res)} rows returned, {len(expected)} rows expected, first mismatch at {first}, sql:{sql}")
+        tdLog.info(f"{len(res)} rows returned as expected, sql:{sql}")
+
+    def checkScan(self, tb, order, start=None, end=None):
+        cond = ""
+        rows = sorted(self.expected[tb].values(), reverse=(order == "desc"))
+        if start is not None:
+            cond = f" where ts >= {start} and ts <= {end}"
+            rows = [r for r in rows if start <= r[0] <= end]
+        self.checkResult(f"select cast(ts as bigint), c1, c2, c3 from {self.dbname}.ct{tb}{cond} order by ts {order}",
+                         rows)
+        return rows
+
+    def checkAgg(self, tb, rows):
+        tdSql.query(f"select count(*), sum(c1), min(c1), max(c1) from {self.dbname}.ct{tb}")
+        tdSql.checkData(0, 0, len(rows))
+        tdSql.checkData(0, 1, sum([r[1] for r in rows]))
+        tdSql.checkData(0, 2, min([r[1] for r in rows]))
+        tdSql.checkData(0, 3, max([r[1] for r in rows]))
+
+    def checkOverlap(self):
+        for tb in self.memRows:
+            for order in ["asc", "desc"]:
+                rows = self.checkScan(tb, order)
+
+                # the window starts or ends within the overlapped file block
+                first, last = min(self.memRows[tb])[0], max(self.memRows[tb])[0]
+                self.checkScan(tb, order, self.ts + (first - 20) * 1000, self.ts + (last + 20) * 1000)
+                self.checkScan(tb, order, self.ts + (first - 1) * 1000 + 1, self.ts + (first + 1) * 1000)
+            self.checkAgg(tb, rows)
+
+        # the rows of all the tables, in the order of the timestamp
+        for order in ["asc", "desc"]:
+            rows = []
+            for tb in self.memRows:
+                rows += [(r[0], tb, r[1]) for r in self.expected[tb].values()]
+            rows.sort(key=lambda r: (r[0], r[1]), reverse=(order == "desc"))
+            self.checkResult(f"select cast(ts as bigint), t1, c1 from {self.dbname}.stb order by ts {order}, t1 {order}",
+                             rows)
+
+    def run(self):
+        self.prepareData()
+        self.checkOverlap()
+
+        # the same rows once the memory table is flushed
+        tdSql.execute(f"flush database {self.dbname}")
+        self.checkOverlap()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
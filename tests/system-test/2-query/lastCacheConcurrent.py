@@ -0,0 +1,158 @@
+import taos
+import threading
+import time
+
+from util.log import *
+from util.cases import *
+from util.sql import *
+from util.dnodes import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "db"
+        # more tables than the stripes of the last cache lock, so that some of them share a stripe and some do not
+        self.numOfTables = 48
+        self.numOfWriters = 3
+        self.numOfReaders = 4
+        self.rounds = 40
+        self.ts = 1640966400000  # 2022-01-01 00:00:00 +08:00
+        self.errors = []
+
+    def newCursor(self):
+        conn = taos.connect(config=tdDnodes.getSimCfgPath())
+        return conn, conn.cursor()
+
+    def row(self, tb, i):
+        return (self.ts + i * 1000, i * 1000 + tb, f"v{tb}_{i}")
+
+    def prepareData(self):
+        dbname = self.dbname
+        tdSql.execute(f"drop database if exists {dbname}")
+        tdSql.execute(f"create database {dbname} vgroups 1 cachemodel 'both' replica {self.replicaVar}")
+        tdSql.execute(f"create stable {dbname}.stb (ts timestamp, c1 int, c2 binary(16)) tags (t1 int)")
+        for tb in range(self.numOfTables):
+            ts, c1, c2 = self.row(tb, 0)
+            tdSql.execute(f"create table {dbname}.ct{tb} using {dbname}.stb tags ({tb})")
+            tdSql.execute(f"insert into {dbname}.ct{tb} values ({ts}, {c1}, '{c2}')")
+
+    # the cached last row of a table is one that was written as a whole, and is not older than a previous read of it
+    def checkRow(self, tb, res, minRound):
+        if len(res) != 1:
+            return f"ct{tb}: {len(res)} rows returned"
+        ts, c1, c2 = res[0]
+        i = c1 // 1000
+        if (round(ts.timestamp() * 1000), c1, c2) != self.row(tb, i):
+            return f"ct{tb}: inconsistent last row {res[0]}"
+        if i < minRound:
+            return f"ct{tb}: last row of round {i} returned after the one of round {minRound}"
+        return None
+
+    def writer(self, w):
+        conn, cursor = self.newCursor()
+        try:
+            for i in range(1, self.rounds + 1):
+                for tb in range(w, self.numOfTables, self.numOfWriters):
+                    ts, c1, c2 = self.row(tb, i)
+                    cursor.execute(f"insert into {self.dbname}.ct{tb} values ({ts}, {c1}, '{c2}')")
+        except Exception as e:
+            self.errors.append(f"writer {w}: {e}")
+        finally:
+            cursor.close()
+            conn.close()
+
+    def reader(self, r, monotonic):
+        conn, cursor = self.newCursor()
+        last = [0] * self.numOfTables
+        try:
+            while not self.done.is_set() and len(self.errors) == 0:
+                for tb in range(r, self.numOfTables, 2):
+                    for func in ["last_row", "last"]:
+                        cursor.execute(f"select {func}(ts), {func}(c1), {func}(c2) from {self.dbname}.ct{tb}")
+                        res = cursor.fetchall()
+                        err = self.checkRow(tb, res, last[tb] if monotonic else 0)
+                        if err is not None:
+                            self.errors.append(f"reader {r}, {func}: {err}")
+                            return
+                        last[tb] = res[0][1] // 1000
+        except Exception as e:
+            self.errors.append(f"reader {r}: {e}")
+        finally:
+            cursor.close()
+            conn.close()
+
+    # the commit writes back and locks all the stripes of the last cache at once
+    def flusher(self):
+        conn, cursor = self.newCursor()
+        try:
+            while not self.done.is_set() and len(self.errors) == 0:
+                cursor.execute(f"flush database {self.dbname}")
+                time.sleep(0.1)
+        except Exception as e:
+            self.errors.append(f"flusher: {e}")
+        finally:
+            cursor.close()
+            conn.close()
+
+    def runConcurrently(self, workers, monotonic):
+        self.done = threading.Event()
+        threads = [threading.Thread(target=self.reader, args=(r, monotonic)) for r in range(self.numOfReaders)]
+        threads.append(threading.Thread(target=self.flusher))
+        for t in threads:
+            t.start()
+        for t in workers:
+            t.start()
+        for t in workers:
+            t.join()
+        self.done.set()
+        for t in threads:
+            t.join()
+        if len(self.errors) > 0:
+            tdLog.exit("; ".join(self.errors))
+
+    def checkLastRows(self, i):
+        for func in ["last_row", "last"]:
+            for tb in range(self.numOfTables):
+                tdSql.query(f"select {func}(ts), {func}(c1), {func}(c2) from {self.dbname}.ct{tb}")
+                err = self.checkRow(tb, tdSql.queryResult, i)
+                if err is None and tdSql.queryResult[0][1] // 1000 != i:
+                    err = f"ct{tb}: last row of round {tdSql.queryResult[0][1] // 1000}, round {i} expected"
+                if err is not None:
+                    tdLog.exit(f"{func}: {err}")
+
+    def run(self):
+        self.prepareData()
+
+        # loads and updates of the tables in the same and in different stripes, while the cache is committed
+        writers = [threading.Thread(target=self.writer, args=(w,)) for w in range(self.numOfWriters)]
+        self.runConcurrently(writers, True)
+        self.checkLastRows(self.rounds)
+
+        # the cached last rows are invalidated by the deletion while they are loaded and committed
+        def deleter():
+            conn, cursor = self.newCursor()
+            try:
+                for tb in range(self.numOfTables):
+                    cursor.execute(f"delete from {self.dbname}.ct{tb} where ts = {self.row(tb, self.rounds)[0]}")
+            except Exception as e:
+                self.errors.append(f"deleter: {e}")
+            finally:
+                cursor.close()
+                conn.close()
+
+        self.runConcurrently([threading.Thread(target=deleter)], False)
+        self.checkLastRows(self.rounds - 1)
+
+        tdSql.execute(f"flush database {self.dbname}")
+        self.checkLastRows(self.rounds - 1)
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
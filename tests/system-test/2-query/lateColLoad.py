@@ -0,0 +1,104 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "db"
+        self.numOfTables = 3
+        self.numOfRows = 1000
+        self.errTable = 1
+        self.errRow = 550  # in the middle of the third file block of the table
+        self.ts = 1640966400000  # 2022-01-01 00:00:00 +08:00
+
+    def row(self, tb, i):
+        c3 = "210a12/02" if (tb == self.errTable and i == self.errRow) else f"202201/{i % 28 + 1:02d}"
+        return (self.ts + i * 1000, (i * 37 + tb) % 1000, i * 0.5, c3)
+
+    def prepareData(self):
+        dbname = self.dbname
+        # small file blocks, each of them is returned to the scan in one result block, so its late columns are loaded
+        # only after the filter is applied
+        tdSql.execute(f"drop database if exists {dbname}")
+        tdSql.execute(f"create database {dbname} vgroups 1 minrows 10 maxrows 200 replica {self.replicaVar}")
+        tdSql.execute(f"create stable {dbname}.stb (ts timestamp, c1 int, c2 double, c3 binary(16)) "
+                      f"tags (t1 int, t2 binary(8))")
+        for tb in range(self.numOfTables):
+            tdSql.execute(f"create table {dbname}.ct{tb} using {dbname}.stb tags ({tb}, 'tag{tb}')")
+            for start in range(0, self.numOfRows, 500):
+                rows = [f"({ts}, {c1}, {c2}, '{c3}')" for (ts, c1, c2, c3) in
+                        [self.row(tb, i) for i in range(start, min(start + 500, self.numOfRows))]]
+                tdSql.execute(f"insert into {dbname}.ct{tb} values " + " ".join(rows))
+        tdSql.execute(f"flush database {dbname}")
+
+    def checkResult(self, sql, expected):
+        res = [tuple(r) for r in tdSql.getResult(sql)]
+        if res != expected:
+            tdLog.exit(f"{len(res)} rows returned, {len(expected)} rows expected, sql:{sql}")
+        tdLog.info(f"{len(res)} rows returned as expected, sql:{sql}")
+
+    def expectedRows(self, tb, cond):
+        return [r for r in [self.row(tb, i) for i in range(self.numOfRows)] if cond(r)]
+
+    def checkFilter(self):
+        dbname = self.dbname
+        cols = "cast(ts as bigint), c1, c2, c3"
+
+        # none of the rows qualified, the late columns are not loaded
+        self.checkResult(f"select {cols} from {dbname}.ct0 where c1 < 0", [])
+        self.checkResult(f"select {cols} from {dbname}.stb where c1 >= 1000", [])
+        tdSql.query(f"select count(*), sum(c2) from {dbname}.stb where c1 < 0")
+        tdSql.checkData(0, 0, 0)
+
+        # all the rows qualified
+        self.checkResult(f"select {cols} from {dbname}.ct0 where c1 >= 0", self.expectedRows(0, lambda r: True))
+        self.checkResult(f"select {cols} from {dbname}.ct2 where c1 >= 0",
+                         [tuple(r) for r in tdSql.getResult(f"select {cols} from {dbname}.ct2")])
+
+        # some of the rows qualified
+        self.checkResult(f"select {cols} from {dbname}.ct0 where c1 % 7 = 0",
+                         self.expectedRows(0, lambda r: r[1] % 7 == 0))
+        self.checkResult(f"select {cols} from {dbname}.ct2 where c1 > 900 and c2 < 300",
+                         self.expectedRows(2, lambda r: r[1] > 900 and r[2] < 300))
+        self.checkResult(f"select c3, c2 from {dbname}.ct1 where c1 between 100 and 120",
+                         [(r[3], r[2]) for r in self.expectedRows(1, lambda r: 100 <= r[1] <= 120)])
+
+        # the tags in the filter, which are set to the block before the filter is applied
+        expected = []
+        for tb in range(self.numOfTables):
+            expected += [(r[0], f"tag{tb}", r[1], r[2]) for r in self.expectedRows(tb, lambda r: tb == 2 or r[1] > 990)]
+        expected.sort()
+        self.checkResult(f"select cast(ts as bigint), t2, c1, c2 from {dbname}.stb where t2 = 'tag2' or c1 > 990 "
+                         f"order by ts, t2", expected)
+        tdSql.query(f"select count(*), sum(c2) from {dbname}.stb where t1 = 1 and c1 % 2 = 0")
+        tdSql.checkData(0, 0, len(self.expectedRows(1, lambda r: r[1] % 2 == 0)))
+
+    def checkError(self):
+        dbname = self.dbname
+
+        # the filter fails at a row in the middle of a file block, while the late columns of the block are not loaded
+        tdSql.error(f"select c1, c2 from {dbname}.ct{self.errTable} where to_timestamp(c3, 'yyyyMM/dd') > 0")
+        tdSql.error(f"select c1, c2 from {dbname}.stb where to_timestamp(c3, 'yyyyMM/dd') > 0")
+
+        # the reader is released, and the memory table can be flushed
+        tdSql.execute(f"insert into {dbname}.ct0 values ({self.ts + self.numOfRows * 1000}, 1, 1.0, 'b')")
+        tdSql.execute(f"flush database {dbname}")
+        tdSql.query(f"select count(*) from {dbname}.stb where c1 >= 0")
+        tdSql.checkData(0, 0, self.numOfTables * self.numOfRows + 1)
+
+    def run(self):
+        self.prepareData()
+        self.checkFilter()
+        self.checkError()
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())
@@ -0,0 +1,96 @@
+from util.log import *
+from util.cases import *
+from util.sql import *
+
+
+class TDTestCase:
+    def init(self, conn, logSql, replicaVar=1):
+        self.replicaVar = int(replicaVar)
+        tdLog.debug("start to execute %s" % __file__)
+        tdSql.init(conn.cursor())
+
+        self.dbname = "db"
+        self.numOfTables = 4
+        self.numOfDays = 10
+        self.step = 5 * 60 * 1000  # one row every 5 minutes
+        self.ts = 1640966400000  # 2022-01-01 00:00:00 +08:00
+
+    def insertRows(self, tbname, start, end, seed):
+        rows = []
+        for ts in range(start, end, self.step):
+            i = (ts - self.ts) // self.step
+            rows.append(f"({ts}, {(i * seed) % 1000}, {i * 0.5}, 'b{i % 17}')")
+            if len(rows) == 500:
+                tdSql.execute(f"insert into {self.dbname}.{tbname} values " + " ".join(rows))
+                rows = []
+        if rows:
+            tdSql.execute(f"insert into {self.dbname}.{tbname} values " + " ".join(rows))
+
+    def prepareData(self):
+        dbname = self.dbname
+        # one fileset a day, all in one vnode, so that the scan is split by fileset
+        tdSql.execute(f"drop database if exists {dbname}")
+        tdSql.execute(f"create database {dbname} vgroups 1 duration 1d keep 3650 replica {self.replicaVar}")
+        tdSql.execute(f"create stable {dbname}.stb (ts timestamp, c1 int, c2 double, c3 binary(16)) tags (t1 int)")
+        for i in range(self.numOfTables):
+            tdSql.execute(f"create table {dbname}.ct{i} using {dbname}.stb tags ({i})")
+
+        end = self.ts + self.numOfDays * 86400 * 1000
+        for i in range(self.numOfTables):
+            self.insertRows(f"ct{i}", self.ts, end, i + 1)
+        tdSql.execute(f"flush database {dbname}")
+
+        # rows in the memory table, which update some rows of the files and add new ones in the gaps
+        for i in range(self.numOfTables):
+            self.insertRows(f"ct{i}", self.ts + 86400 * 1000, self.ts + 86400 * 1000 + self.step * 100, i + 7)
+            self.insertRows(f"ct{i}", self.ts + 7 * 86400 * 1000 + 1000, self.ts + 8 * 86400 * 1000, i + 11)
+
+    def setParallelScan(self, num):
+        tdSql.execute(f"alter all dnodes 'queryParallelScan' '{num}'")
+
+    def checkSameAsSerial(self, sqls):
+        self.setParallelScan(0)
+        expected = [tdSql.getResult(sql) for sql in sqls]
+
+        self.setParallelScan(4)
+        for sql, rows in zip(sqls, expected):
+            res = tdSql.getResult(sql)
+            if res != rows:
+                tdLog.exit(f"parallel scan returns {len(res)} rows, {len(rows)} rows expected, sql:{sql}")
+            tdLog.info(f"parallel scan returns the same {len(rows)} rows, sql:{sql}")
+
+        self.setParallelScan(0)
+
+    def run(self):
+        self.prepareData()
+        dbname = self.dbname
+        mid = self.ts + 3 * 86400 * 1000 + 12345
+        last = self.ts + 8 * 86400 * 1000 - 1
+
+        self.checkSameAsSerial([
+            # ordered scans, the rows of each table are returned in the scan order
+            f"select ts, c1, c2, c3 from {dbname}.ct1",
+            f"select ts, c1, c2, c3 from {dbname}.ct2 order by ts desc",
+            f"select ts, c1 from {dbname}.ct0 where ts >= {mid} and ts <= {last}",
+            f"select tbname, ts, c1, c3 from {dbname}.stb order by ts, tbname",
+            f"select tbname, ts, c1 from {dbname}.stb where c1 > 500 order by ts desc, tbname",
+            # aggregates, which take the blocks of any sub reader
+            f"select count(*), sum(c1), min(c2), max(c2), first(c1), last(c1) from {dbname}.stb",
+            f"select count(*), sum(c1), avg(c2) from {dbname}.stb where ts > {mid} and ts < {last}",
+            f"select tbname, count(*), sum(c1), last(c3) from {dbname}.stb partition by tbname order by tbname",
+            f"select c3, count(*), sum(c1) from {dbname}.stb group by c3 order by c3",
+            # windows, and the table groups scanned one after another, which reset the reader
+            f"select _wstart, count(*), sum(c1), first(c1), last(c1) from {dbname}.stb interval(1d)",
+            f"select tbname, _wstart, count(*), sum(c1) from {dbname}.stb partition by tbname interval(1d) "
+            f"order by tbname, _wstart",
+            f"select _wstart, count(*), max(c1) from {dbname}.ct3 where ts >= {mid} and ts <= {last} "
+            f"interval(6h) fill(prev)",
+            f"select a.ts, a.c1, b.c1 from {dbname}.ct0 a, {dbname}.ct1 b where a.ts = b.ts order by a.ts",
+        ])
+
+    def stop(self):
+        tdSql.close()
+        tdLog.success("%s successfully executed" % __file__)
+
+tdCases.addWindows(__file__, TDTestCase())
+tdCases.addLinux(__file__, TDTestCase())